@@ -48,6 +48,7 @@ extern "C"{
                                          INCLUDE FILES
 ==================================================================================================*/
 #include <stdint.h>
+#include <sys/uio.h>
 #ifdef USDPAA
 #include <usdpaa/compat.h>
 #include <flib/protoshared.h>
@@ -55,6 +56,7 @@ extern "C"{
 #include <compat.h>
 #endif
 #include "fsl_sec_config.h"
+#include "fsl_sec_time.h"
 /*==================================================================================================
                                        DEFINES AND MACROS
 ==================================================================================================*/
@@ -97,6 +99,9 @@ extern "C"{
 /** Indicates a RLC context that will decapsulate (decrypt) packets */
 #define RLC_DECAPSULATION  1
 
+/** Number of buckets of a latency histogram, see ::sec_latency_histogram_t */
+#define SEC_LATENCY_HIST_BUCKETS   ((33 - SEC_LATENCY_HIST_SUB_BUCKET_BITS) << SEC_LATENCY_HIST_SUB_BUCKET_BITS)
+
 /*==================================================================================================
                                              ENUMS
 ==================================================================================================*/
@@ -165,6 +170,32 @@ typedef enum sec_status_e
                                              @note ALL new status values MUST be added before ::SEC_STATUS_MAX_VALUE! */
 }sec_status_t;
 
+/** Kinds of contexts for which the latency of the jobs is measured separately,
+ * see sec_get_latency_stats(). */
+typedef enum sec_latency_class_e
+{
+    SEC_LATENCY_PDCP_CONTROL_PLANE = PDCP_CONTROL_PLANE,    /**< PDCP Control Plane contexts. */
+    SEC_LATENCY_PDCP_DATA_PLANE = PDCP_DATA_PLANE,          /**< PDCP Data Plane contexts. */
+    SEC_LATENCY_RLC,                                        /**< RLC contexts. */
+    SEC_LATENCY_CLASSES_NO                                  /**< Number of kinds of contexts. */
+}sec_latency_class_t;
+
+/** Types of the events of the binary trace, see sec_trace_enable(). */
+typedef enum sec_trace_event_type_e
+{
+    SEC_TRACE_SUBMIT = 1,           /**< A packet is submitted with sec_process_packet*(). arg: input packet length. */
+    SEC_TRACE_JR_FULL,              /**< A packet is rejected with ::SEC_JR_IS_FULL. arg: producer index. */
+    SEC_TRACE_DOORBELL,             /**< A job is enqueued to SEC. arg: producer index. */
+    SEC_TRACE_HARVEST,              /**< sec_poll*() dequeues the jobs done by SEC. arg: number of jobs. */
+    SEC_TRACE_CALLBACK_ENTER,       /**< The ::sec_out_cbk of a packet is called. arg: packet status. */
+    SEC_TRACE_CALLBACK_EXIT,        /**< The ::sec_out_cbk of a packet returned. arg: returned value. */
+    SEC_TRACE_JR_FLUSH,             /**< The jobs of a Job Ring are flushed. arg: number of jobs. */
+    SEC_TRACE_JR_RESET_BEGIN,       /**< A Job Ring is reset after a SEC error. arg: SEC error code. */
+    SEC_TRACE_JR_RESET_END,         /**< The Job Ring reset is over. arg: number of packets notified. */
+    SEC_TRACE_IRQ_ENABLE,           /**< The IRQs of a Job Ring are enabled again. */
+    SEC_TRACE_EVENT_TYPES_NO        /**< Number of event types, plus 1. */
+}sec_trace_event_type_t;
+
 /** Return codes for User Application registered callback ::sec_out_cbk.
  */
 typedef enum sec_ua_return_e
@@ -242,6 +273,19 @@ typedef const void* ua_context_handle_t;
  * @retval Returns the corresponding physical address.
 */
 typedef dma_addr_t (*sec_vtop)(void *v);
+
+/** @brief Function type used for physical to virtual address conversions
+ *
+ * Optionally provided by the user application upon initialization of the SEC driver.
+ * It is used by the driver for accessing on the CPU the packets that are not
+ * sent to SEC for processing (for example when the keystream cache is enabled
+ * on a context, see sec_enable_keystream_cache()).
+ *
+ * @param [in] p          Physical address to be converted.
+ *
+ * @retval Returns the corresponding virtual address.
+*/
+typedef void* (*sec_ptov)(dma_addr_t p);
 /**
     @}
  */
@@ -258,7 +302,7 @@ typedef struct sec_packet_s
     uint32_t        tail_offset;    /**< Offset from buffer head where tail room is reserved. */
     uint32_t        total_length;   /**< Total Data Length in all fragments including the parent buffer. */
     uint32_t        num_fragments;  /**< Is set only in the first fragment from a s/g packet.
-                                         It excludes the parent buffer. */
+                                         It excludes the parent buffer. At most #SEC_MAX_SG_FRAGMENTS. */
 #if defined(__powerpc64__) || defined(CONFIG_PHYS_64BIT)
     uint32_t        pad;         /**< Padding to multiple of L1_CACHE_BYTES. */
 #else
@@ -267,6 +311,22 @@ typedef struct sec_packet_s
 
 }sec_packet_t;
 
+/** Entry of a Scatter-Gather table in the format read by SEC.
+ * The layout is private to the driver, each entry takes #SEC_SG_TBL_SIZE bytes.
+ * See sec_build_sg_tbl(). */
+typedef struct sec_sg_tbl_entry sec_sg_tbl_entry_t;
+
+/** A packet submitted with sec_process_packet_burst(). The fields are the
+ * arguments of sec_process_packet_hfn_ov() for the packet. */
+typedef struct sec_burst_packet_s
+{
+    sec_context_handle_t sec_ctx_handle;    /**< The context of the packet. */
+    const sec_packet_t *in_packet;          /**< Input packet read by SEC. */
+    const sec_packet_t *out_packet;         /**< Output packet where SEC writes result. */
+    uint32_t hfn_ov_val;                    /**< The value of HFN, see sec_process_packet_hfn_ov(). */
+    ua_context_handle_t ua_ctx_handle;      /**< The handle to a User Application packet context. */
+}sec_burst_packet_t;
+
 /** Structure used to retrieve statistics from the US SEC PDCP driver. */
 typedef struct sec_statistics_s
 {
@@ -279,6 +339,134 @@ typedef struct sec_statistics_s
     uint32_t reserved[2];           /**< Reserved for future additions. */
 } __attribute__ ((aligned (32))) sec_statistics_t;
 
+/** Version of ::sec_statistics_ext_t filled by this version of the driver. */
+#define SEC_STATISTICS_EXT_VERSION  2
+
+/** Structure used to retrieve extended statistics of a Job Ring, see sec_get_stats_ext().
+ * New fields are only ever added at the end, with a new #SEC_STATISTICS_EXT_VERSION,
+ * so that UA built against an older version keeps working. */
+typedef struct sec_statistics_ext_s
+{
+    uint32_t version;               /**< Set by the driver to the version of the structure it filled. */
+    uint32_t size;                  /**< Set by UA to sizeof(sec_statistics_ext_t). The driver fills at most
+                                         this many bytes and sets it to the number of bytes it filled. */
+    sec_statistics_t jr;            /**< The same statistics as returned by sec_get_stats(). */
+    /* Version 1. All counters are cumulative since sec_init(). */
+    uint64_t packets_submitted;     /**< Packets accepted by sec_process_packet*(), on SEC or on the CPU. */
+    uint64_t bytes_submitted;       /**< Bytes of the input packets accepted by sec_process_packet*(). */
+    uint64_t packets_completed;     /**< Packets notified to UA, except the ones flushed after an error. */
+    uint64_t bytes_completed;       /**< Bytes of the output packets notified to UA. */
+    uint64_t jr_full;               /**< Packets rejected with ::SEC_JR_IS_FULL. */
+    uint64_t icv_failures;          /**< Packets notified with ::SEC_STATUS_MAC_I_CHECK_FAILED. */
+    uint64_t hfn_threshold_reached; /**< Packets notified with ::SEC_STATUS_HFN_THRESHOLD_REACHED. */
+    uint64_t error_packets;         /**< Packets flushed and notified with ::SEC_STATUS_ERROR after a SEC error. */
+    uint64_t jr_resets;             /**< Times the Job Ring was flushed and restarted after a SEC error. */
+    uint64_t empty_polls;           /**< Polls of the Job Ring that notified no packet. */
+    uint64_t irq_enables;           /**< Times the IRQs of the Job Ring were enabled again after a poll. */
+    /* Version 2. Divide empty_polls and packets_completed by polls for the empty poll
+     * ratio and the packets notified per poll. */
+    uint64_t polls;                 /**< Polls of the Job Ring by sec_poll() or sec_poll_job_ring(). */
+    uint64_t callback_ticks;        /**< Time spent in the callbacks of UA, in ticks of sec_time_read().
+                                         0 if #SEC_ENABLE_CALLBACK_TIMING is OFF. */
+    uint32_t poll_weight;           /**< Weight used by sec_poll() for the Job Ring, chosen by the tuning
+                                         of #SEC_ENABLE_POLL_AUTOTUNE. 0 if it is OFF or sec_poll() was not called. */
+    uint32_t poll_weight_changes;   /**< Times the tuning changed poll_weight. */
+} sec_statistics_ext_t;
+
+/** Structure used to retrieve from the US SEC PDCP driver the usage of the
+ * DMA-capable memory area provided by UA. All sizes are in bytes. */
+typedef struct sec_dma_mem_usage_s
+{
+    uint32_t total_size;                    /**< Size of the memory area. */
+    uint32_t used_size;                     /**< Memory currently allocated by the driver. */
+    uint32_t max_used_size;                 /**< Highest memory usage since sec_init(). */
+    uint32_t largest_free_size;             /**< Largest region that can still be allocated. */
+    uint32_t job_rings_no;                  /**< Number of valid entries in job_ring and ctx_pool. */
+    uint32_t job_ring[MAX_SEC_JOB_RINGS];   /**< Memory used by each job ring for the input and output rings,
+                                                 job descriptors and SG tables. */
+    uint32_t ctx_pool[MAX_SEC_JOB_RINGS];   /**< Memory used by the pool of SEC contexts of each job ring,
+                                                 for shared descriptors. */
+    uint32_t global_ctx_pool;               /**< Memory used by the global pool of SEC contexts,
+                                                 for shared descriptors. */
+} sec_dma_mem_usage_t;
+
+/** Histogram of the time from the submission of a packet to SEC until its
+ * dequeue by sec_poll*(), in ticks of sec_time_read(), see sec_time_ticks_to_ns().
+ * The latencies from 0 to 2^32-1 ticks are spread over #SEC_LATENCY_HIST_BUCKETS buckets, each power of 2 interval
+ * being split in 2^#SEC_LATENCY_HIST_SUB_BUCKET_BITS equal buckets.
+ * Use sec_get_latency_percentile() to read percentiles out of it. */
+typedef struct sec_latency_histogram_s
+{
+    uint64_t count;                                 /**< Number of latencies recorded. */
+    uint64_t sum;                                   /**< Sum of the latencies recorded. */
+    uint32_t min;                                   /**< Lowest latency recorded. */
+    uint32_t max;                                   /**< Highest latency recorded. */
+    uint64_t buckets[SEC_LATENCY_HIST_BUCKETS];     /**< Number of latencies recorded in each bucket. */
+} sec_latency_histogram_t;
+
+/** Latencies of the packets processed by SEC on a job ring, see sec_get_latency_stats(). */
+typedef struct sec_latency_stats_s
+{
+    sec_latency_histogram_t hist[SEC_LATENCY_CLASSES_NO];  /**< Indexed by ::sec_latency_class_t. */
+} sec_latency_stats_t;
+
+/** Counters of a SEC context, see sec_get_context_stats() and sec_get_contexts_stats().
+ * The counters are cumulative since the context was created. */
+typedef struct sec_context_stats_s
+{
+    sec_context_handle_t sec_ctx_handle;    /**< The context. */
+    sec_job_ring_handle_t jr_handle;        /**< The Job Ring the context is affined to. */
+    uint64_t packets;                       /**< Packets notified to UA, including the ones flushed. */
+    uint64_t bytes;                         /**< Bytes of the output packets notified to UA, except the ones flushed. */
+    uint64_t icv_failures;                  /**< Packets notified with ::SEC_STATUS_MAC_I_CHECK_FAILED. */
+    uint64_t hfn_threshold_reached;         /**< Packets notified with ::SEC_STATUS_HFN_THRESHOLD_REACHED. */
+    uint64_t overdue;                       /**< Packets notified with ::SEC_STATUS_OVERDUE or ::SEC_STATUS_LAST_OVERDUE. */
+    uint64_t errors;                        /**< Packets flushed and notified with ::SEC_STATUS_ERROR after a SEC error. */
+    uint32_t last_activity;                 /**< Time base when the last packet was notified, or when the
+                                                 context was created if no packet was notified yet. */
+    uint32_t idle_ticks;                    /**< Time base ticks elapsed since last_activity, when the counters were read. */
+    uint32_t packets_in_flight;             /**< Packets submitted and not yet notified. */
+    uint32_t retiring;                      /**< #TRUE if the context was deleted and still has packets in flight. */
+} sec_context_stats_t;
+
+/** Magic number at the start of a file written by sec_trace_dump(): "SECT".
+ * Read with the opposite byte order, it tells the file comes from a host of different endianness. */
+#define SEC_TRACE_FILE_MAGIC    0x53454354
+
+/** Version of the format of the files written by sec_trace_dump(). */
+#define SEC_TRACE_FILE_VERSION  1
+
+/** Returns the current time, in ticks of a free running counter. See sec_trace_set_clock(). */
+typedef uint64_t (*sec_trace_clock_t)(void);
+
+/** Start of a file written by sec_trace_dump(). It is followed by threads_no
+ * ::sec_trace_thread_header_t, each followed by the events of the thread. */
+typedef struct sec_trace_file_header_s
+{
+    uint32_t magic;                 /**< #SEC_TRACE_FILE_MAGIC. */
+    uint32_t version;               /**< #SEC_TRACE_FILE_VERSION. */
+    uint64_t ticks_per_second;      /**< Frequency of the clock of the timestamps. */
+    uint32_t threads_no;            /**< Number of threads that recorded events. */
+    uint32_t reserved;              /**< Reserved for future additions. */
+} sec_trace_file_header_t;
+
+/** Events of a thread in a file written by sec_trace_dump(). */
+typedef struct sec_trace_thread_header_s
+{
+    uint32_t thread_id;             /**< Kernel id of the thread, as shown by ps or top. */
+    uint32_t events_no;             /**< Number of ::sec_trace_event_t that follow, oldest first. */
+    uint64_t lost_no;               /**< Older events overwritten because the trace buffer was full. */
+} sec_trace_thread_header_t;
+
+/** An event of the binary trace. */
+typedef struct sec_trace_event_s
+{
+    uint64_t timestamp;             /**< Clock ticks, see sec_trace_set_clock(). */
+    uint16_t type;                  /**< One of ::sec_trace_event_type_t. */
+    uint16_t jr_id;                 /**< Id of the Job Ring. */
+    uint32_t arg;                   /**< Depends on the type, see ::sec_trace_event_type_t. */
+} sec_trace_event_t;
+
 /** Contains Job Ring descriptor info returned to the caller when sec_init() is invoked. */
 typedef struct sec_job_ring_descriptor_s
 {
@@ -402,10 +590,14 @@ typedef struct sec_rlc_context_info_s
 /** Configuration data structure that must be provided by UA when SEC user space driver is initialized */
 typedef struct sec_config_s
 {
-    void            *memory_area;           /**< UA provided- virtual memory of size #SEC_DMA_MEMORY_SIZE to be used internally
+    void            *memory_area;           /**< UA provided- virtual memory of size memory_area_size to be used internally
                                                  by the driver to allocate data (like SEC descriptors) that needs to be passed to
                                                  SEC device in physical addressing. */
 
+    uint32_t        memory_area_size;       /**< Size in bytes of memory_area. The size needed by a configuration is returned
+                                                 by sec_get_required_dma_size(). If 0, memory_area must have
+                                                 #SEC_DMA_MEMORY_SIZE bytes, enough for any configuration. */
+
     uint32_t        irq_coalescing_timer;   /**< Interrupt Coalescing Timer Threshold.
 
                                                  While interrupt coalescing is enabled (ICEN=1), this value determines the
@@ -430,8 +622,89 @@ typedef struct sec_config_s
     
     sec_vtop        sec_drv_vtop;           /**< Function to be used internally by the driver for virtual to physical 
                                                  address translation for internal structures. */
+
+    sec_ptov        sec_drv_ptov;           /**< Optional function to be used by the driver for physical to virtual
+                                                 address translation of packets processed on the CPU,
+                                                 see sec_enable_keystream_cache(), #SEC_ENABLE_HYBRID_DISPATCH
+                                                 and #SEC_ENABLE_NULL_PASSTHROUGH.
+                                                 If NULL, all the packets are processed by SEC, except in place
+                                                 User Plane packets of NULL algorithm contexts.
+                                                 The packets processed on the CPU raise no interrupt and are
+                                                 notified only by sec_poll() and sec_poll_job_ring(): these
+                                                 options require #SEC_NOTIFICATION_TYPE_POLL. */
 }sec_config_t;
 
+/**
+    @}
+ */
+
+/**
+    @addtogroup SecUserSpaceDriverBufPoolFunctions
+    @{
+ */
+
+/** Opaque handle of a pool of packet buffers, created with sec_buf_pool_create(). */
+typedef struct sec_buf_pool_s sec_buf_pool_t;
+
+/** Configuration of a pool of packet buffers. All the buffers of a pool have the same layout:
+ *  headroom bytes, followed by data_room bytes for the packet and tailroom bytes. */
+typedef struct sec_buf_pool_config_s
+{
+    void            *memory_area;       /**< UA provided DMA-capable memory from which the buffers are carved.
+                                             Must be physically contiguous and aligned to L1_CACHE_BYTES. */
+    uint32_t        memory_area_size;   /**< Size in bytes of memory_area. */
+    uint32_t        headroom;           /**< Bytes reserved at the start of each buffer.
+                                             Returned in sec_packet_t::offset. */
+    uint32_t        data_room;          /**< Bytes available in each buffer for the packet data. */
+    uint32_t        tailroom;           /**< Bytes reserved after the packet data. The tail room starts at
+                                             sec_packet_t::tail_offset. */
+    sec_vtop        vtop;               /**< Function used once, at pool creation, to find the physical address
+                                             of memory_area. */
+}sec_buf_pool_config_t;
+
+/**
+    @}
+ */
+
+/**
+    @addtogroup SecUserSpaceDriverSwCryptoFunctions
+    @{
+ */
+
+/** Describes one 128-EIA2 (AES-CMAC) MAC-I computation submitted to sec_sw_eia2_compute_batch().
+ *  The message is authenticated exactly as SEC does it for a PDCP Control Plane PDU:
+ *  MAC-I = CMAC(key, COUNT || BEARER || DIRECTION || 0^26 || message)[0..31]. */
+typedef struct sec_sw_eia2_job_s
+{
+    const uint8_t   *key;           /**< 128 bit integrity key. Regular (virtual) memory.
+                                         Consecutive jobs pointing to the same key share the key schedule. */
+    const uint8_t   *message;       /**< VIRTUAL address of the message: PDCP header + PDCP payload,
+                                         without the MAC-I. */
+    uint32_t        length;         /**< Length of the message in bytes. */
+    uint32_t        count;          /**< COUNT for this PDU: HFN concatenated with the PDCP sequence number. */
+    uint8_t         bearer;         /**< Radio bearer id, on 5 bits. */
+    uint8_t         direction;      /**< Direction can be uplink(#PDCP_UPLINK) or downlink(#PDCP_DOWNLINK). */
+    uint8_t         mac_i[4];       /**< Output: MAC-I computed for this message. */
+}sec_sw_eia2_job_t;
+
+/** Describes one KASUMI f8 ciphering operation submitted to sec_sw_kasumi_f8_batch().
+ *  The keystream is generated exactly as SEC does it for a RLC PDU ciphered with
+ *  #SEC_ALG_RLC_CRYPTO_KASUMI. Only the RLC payload is ciphered, the RLC header must be
+ *  copied by the caller. */
+typedef struct sec_sw_kasumi_f8_job_s
+{
+    const uint8_t   *key;           /**< 128 bit ciphering key (CK). Regular (virtual) memory.
+                                         Consecutive jobs pointing to the same key share the key schedule. */
+    const uint8_t   *in;            /**< VIRTUAL address of the RLC payload to be ciphered/deciphered. */
+    uint8_t         *out;           /**< VIRTUAL address where the result is written. Can be equal to
+                                         sec_sw_kasumi_f8_job_t::in for in-place ciphering. */
+    uint32_t        length;         /**< Length of the payload in bytes. */
+    uint32_t        count;          /**< COUNT-C for this PDU: HFN concatenated with the RLC sequence number,
+                                         i.e. (HFN << 7) | SN for UM and (HFN << 12) | SN for AM. */
+    uint8_t         bearer;         /**< Radio bearer id, on 5 bits. */
+    uint8_t         direction;      /**< Direction can be uplink(#RLC_UPLINK) or downlink(#RLC_DOWNLINK). */
+}sec_sw_kasumi_f8_job_t;
+
 /**
     @}
  */
@@ -483,6 +756,23 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
                            uint8_t job_rings_no,
                            const sec_job_ring_descriptor_t **job_ring_descriptors);
 
+/**
+ * @brief Returns the size of the DMA-capable memory area needed by sec_init().
+ *
+ * #SEC_DMA_MEMORY_SIZE is enough for #MAX_SEC_JOB_RINGS job rings. This function
+ * returns only what sec_init() allocates for the requested number of job rings
+ * and the options the driver was built with (for example #SEC_ENABLE_SCATTER_GATHER).
+ * Allocate sec_config_t::memory_area with this size and set it in
+ * sec_config_t::memory_area_size.
+ *
+ * @param [in]  sec_config_data         Configuration data that will be passed to sec_init().
+ * @param [in]  job_rings_no            The number of job rings that will be requested to sec_init().
+ *
+ * @retval Size in bytes or 0 if the parameters are not valid.
+ */
+uint32_t sec_get_required_dma_size(const sec_config_t *sec_config_data,
+                                   uint8_t job_rings_no);
+
 /**
  * @brief Release the resources used by the SEC user space driver.
  *
@@ -744,6 +1034,10 @@ sec_return_code_t sec_poll_job_ring(sec_job_ring_handle_t job_ring_handle,
  * The User Application must poll SEC driver using sec_poll() or sec_poll_job_ring() to
  * receive notifications of the processing completion status. The notifications are received
  * by UA by means of callback (see ::sec_out_cbk).
+ *
+ * The ::sec_packet_t structures of in_packet and out_packet must be kept by UA until
+ * the packet is notified, unless #SEC_ENABLE_PACKET_COPY is ON and the packet is not
+ * fragmented: then they are copied by the driver and can be reused right away.
  * 
  * @note The input packet and output packet must not both point to the same memory location!
  *
@@ -764,7 +1058,8 @@ sec_return_code_t sec_poll_job_ring(sec_job_ring_handle_t job_ring_handle,
  *                                   - input/output buffer address is invalid (e.g. NULL)
  *                                   - etc
  *
- * @retval ::SEC_JR_IS_FULL                  is returned if the JR is full
+ * @retval ::SEC_JR_IS_FULL                  is returned if the JR is full, or if all the SG tables
+ *                                           that fit a fragmented packet are used by packets in flight
  * @retval ::SEC_DRIVER_RELEASE_IN_PROGRESS  is returned if SEC driver release is in progress
  * @retval ::SEC_DRIVER_NOT_INITIALIZED      is returned if SEC driver is not yet initialized.
  * @retval ::SEC_CONTEXT_MARKED_FOR_DELETION is returned if the SEC context was marked for deletion.
@@ -827,7 +1122,8 @@ sec_return_code_t sec_process_packet(sec_context_handle_t sec_ctx_handle,
  *                                   - input/output buffer address is invalid (e.g. NULL)
  *                                   - etc
  *
- * @retval ::SEC_JR_IS_FULL                  is returned if the JR is full
+ * @retval ::SEC_JR_IS_FULL                  is returned if the JR is full, or if all the SG tables
+ *                                           that fit a fragmented packet are used by packets in flight
  * @retval ::SEC_DRIVER_RELEASE_IN_PROGRESS  is returned if SEC driver release is in progress
  * @retval ::SEC_DRIVER_NOT_INITIALIZED      is returned if SEC driver is not yet initialized.
  * @retval ::SEC_CONTEXT_MARKED_FOR_DELETION is returned if the SEC context was marked for deletion.
@@ -841,6 +1137,241 @@ sec_return_code_t sec_process_packet_hfn_ov(sec_context_handle_t sec_ctx_handle,
                                             const sec_packet_t *out_packet,
                                             uint32_t hfn_ov_val,
                                             ua_context_handle_t ua_ctx_handle);
+
+/**
+ * @brief Formats the Scatter-Gather table of a fragmented packet, to be submitted
+ *        with sec_process_packet_sg_tbl().
+ *
+ * All the fragments of the packet are validated. The table can then be submitted
+ * any number of times, as long as the fragments do not change, without the driver
+ * building or checking it again.
+ *
+ * @param [in]  packet      The first fragment of the packet, followed by the other
+ *                          packet->num_fragments fragments. packet->num_fragments must
+ *                          be between 1 and #SEC_MAX_SG_FRAGMENTS.
+ * @param [out] sg_tbl      DMA-capable memory of #SEC_SG_TBL_MEM_SIZE(packet->num_fragments)
+ *                          bytes, aligned to #SEC_SG_TBL_SIZE, owned by UA.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    when a fragment is invalid, or the fragments'
+ *                                      lengths do not add up to packet->total_length.
+ */
+sec_return_code_t sec_build_sg_tbl(const sec_packet_t *packet,
+                                   sec_sg_tbl_entry_t *sg_tbl);
+
+/**
+ * @brief Submit a packet for SEC processing, with Scatter-Gather tables
+ *        formatted by UA with sec_build_sg_tbl().
+ *
+ * Same as sec_process_packet_hfn_ov(), except that the driver does not build
+ * the SG tables of fragmented packets. The cost of the call does not depend
+ * on the number of fragments. The tables must not be changed or freed until
+ * the packet is notified to UA.
+ *
+ * @param [in]  sec_ctx_handle     The handle of the context associated to this packet.
+ * @param [in]  in_packet          Input packet read by SEC.
+ * @param [in]  in_sg_tbl_phys     Physical address of the SG table of in_packet.
+ *                                 Ignored if in_packet has no fragments.
+ * @param [in]  out_packet         Output packet where SEC writes result.
+ * @param [in]  out_sg_tbl_phys    Physical address of the SG table of out_packet.
+ *                                 Ignored if out_packet has no fragments.
+ * @param [in]  hfn_ov_val         The value of HFN, see sec_process_packet_hfn_ov().
+ * @param [in]  ua_ctx_handle      The handle to a User Application packet context.
+ *
+ * @retval Same as sec_process_packet_hfn_ov(). ::SEC_JR_IS_FULL is returned only if the JR is full.
+ */
+sec_return_code_t sec_process_packet_sg_tbl(sec_context_handle_t sec_ctx_handle,
+                                            const sec_packet_t *in_packet,
+                                            dma_addr_t in_sg_tbl_phys,
+                                            const sec_packet_t *out_packet,
+                                            dma_addr_t out_sg_tbl_phys,
+                                            uint32_t hfn_ov_val,
+                                            ua_context_handle_t ua_ctx_handle);
+
+/**
+ * @brief Registers a physically contiguous memory region from where UA allocates
+ *        the packets submitted with sec_process_packet_iov().
+ *
+ * Typically called once for each hugepage or DMA memory partition of UA, after sec_init().
+ * Regions must not overlap. The regions are forgotten by sec_init().
+ *
+ * The regions must not be changed while packets are submitted with sec_process_packet_iov()
+ * by any thread, nor while packets from the region are in flight.
+ *
+ * Available only when the driver is built with #SEC_ENABLE_IOV_SUBMISSION ON.
+ *
+ * @param [in]  vaddr       Virtual start address of the region.
+ * @param [in]  paddr       Physical start address of the region.
+ * @param [in]  size        Size in bytes of the region.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    if the region is empty or overlaps a registered region
+ * @retval ::SEC_OUT_OF_MEMORY          if #SEC_MAX_MEM_REGIONS regions are already registered
+ * @retval ::SEC_DRIVER_NOT_INITIALIZED is returned if SEC driver is not yet initialized.
+ */
+sec_return_code_t sec_register_mem_region(void *vaddr,
+                                          dma_addr_t paddr,
+                                          uint32_t size);
+
+/**
+ * @brief Unregisters a memory region registered with sec_register_mem_region().
+ *
+ * @param [in]  vaddr       Virtual start address of the region.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    if no region was registered at vaddr
+ * @retval ::SEC_DRIVER_NOT_INITIALIZED is returned if SEC driver is not yet initialized.
+ */
+sec_return_code_t sec_unregister_mem_region(void *vaddr);
+
+/**
+ * @brief Submit a packet for SEC processing, with the input and output packets
+ *        described by arrays of struct iovec with VIRTUAL addresses.
+ *
+ * Same as sec_process_packet_hfn_ov(), except that the driver translates the
+ * addresses, using the memory regions registered with sec_register_mem_region().
+ * Each iovec entry becomes one fragment of the packet. The translation of an entry
+ * takes constant time when it is in the same region as the previous one submitted
+ * on the job ring, and a binary search over the regions otherwise.
+ *
+ * The iovec arrays are not used after the function returns. The ::sec_packet_t
+ * structures passed to ::sec_out_cbk for such a packet are owned by the driver and
+ * valid only during the callback.
+ *
+ * The packet is always processed by SEC: the CPU paths of a context (see
+ * sec_enable_keystream_cache() and #SEC_ENABLE_HYBRID_DISPATCH) are not used.
+ *
+ * Available only when the driver is built with #SEC_ENABLE_IOV_SUBMISSION ON.
+ *
+ * @param [in]  sec_ctx_handle     The handle of the context associated to this packet.
+ * @param [in]  in_iov             Input packet read by SEC.
+ * @param [in]  in_iov_no          Number of entries in in_iov, between 1 and #SEC_IOV_MAX_FRAGMENTS.
+ * @param [in]  out_iov            Output packet where SEC writes result.
+ * @param [in]  out_iov_no         Number of entries in out_iov, between 1 and #SEC_IOV_MAX_FRAGMENTS.
+ * @param [in]  hfn_ov_val         The value of HFN, see sec_process_packet_hfn_ov().
+ * @param [in]  ua_ctx_handle      The handle to a User Application packet context.
+ *
+ * @retval Same as sec_process_packet_hfn_ov(). ::SEC_INVALID_INPUT_PARAM is also returned
+ *         if an entry is not inside a registered memory region.
+ */
+sec_return_code_t sec_process_packet_iov(sec_context_handle_t sec_ctx_handle,
+                                         const struct iovec *in_iov,
+                                         uint32_t in_iov_no,
+                                         const struct iovec *out_iov,
+                                         uint32_t out_iov_no,
+                                         uint32_t hfn_ov_val,
+                                         ua_context_handle_t ua_ctx_handle);
+
+/**
+ * @brief Submit a burst of packets for SEC processing, grouped by context.
+ *
+ * Each window of #SEC_BURST_REORDER_WINDOW packets of the burst is reordered so
+ * that the packets of the same context are enqueued back to back, in the order
+ * of the first packet of each context. SEC then fetches the shared descriptor of
+ * a context once per group, instead of once per packet when the bearers are
+ * interleaved. The packets of a context keep their relative order, across windows too.
+ *
+ * The packets are reordered IN PLACE, in the order they are enqueued. Each packet
+ * is then submitted as with sec_process_packet_hfn_ov(), until one of them fails.
+ * The packets not submitted are still ordered by context, UA can submit them again
+ * later starting from packets[*submitted_no].
+ *
+ * @param [in,out] packets         The packets. Reordered in submission order on return.
+ * @param [in]     packets_no      Number of packets.
+ * @param [out]    submitted_no    Number of packets submitted, at the start of packets.
+ *
+ * @retval ::SEC_SUCCESS                if all the packets were submitted
+ * @retval Otherwise, the error returned by sec_process_packet_hfn_ov() for
+ *         packets[*submitted_no], e.g. ::SEC_JR_IS_FULL.
+ */
+sec_return_code_t sec_process_packet_burst(sec_burst_packet_t *packets,
+                                           uint32_t packets_no,
+                                           uint32_t *submitted_no);
+
+/**
+ * @brief Sets the thresholds below which the fragmented packets submitted on a
+ *        job ring are linearized.
+ *
+ * A fragmented packet of at most max_length bytes, with at most max_fragments
+ * fragments (the parent buffer included), is copied by sec_process_packet() to a
+ * contiguous bounce buffer owned by the driver, and submitted to SEC without a
+ * SG table. The output is copied to the fragments of the output packet before the
+ * packet is notified to UA. Input and output packets are checked separately.
+ * Defaults are #SEC_SG_LINEARIZE_MAX_LENGTH and #SEC_SG_LINEARIZE_MAX_FRAGMENTS,
+ * if sec_config_t::sec_drv_ptov was provided.
+ *
+ * Must be called from the thread that submits packets on the job ring.
+ * Packets submitted with sec_process_packet_sg_tbl() are never linearized.
+ *
+ * @param [in]  job_ring_handle    The job ring.
+ * @param [in]  max_length         Maximum total length of a linearized packet, at most
+ *                                 #SEC_SG_BOUNCE_BUF_SIZE. 0 disables linearization.
+ * @param [in]  max_fragments      Maximum number of fragments of a linearized packet,
+ *                                 the parent buffer included.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    if max_length is too large, sec_config_t::sec_drv_ptov
+ *                                      was not provided, or #SEC_ENABLE_SG_LINEARIZATION is OFF.
+ * @retval ::SEC_DRIVER_NOT_INITIALIZED is returned if SEC driver is not yet initialized.
+ */
+sec_return_code_t sec_set_sg_linearization(sec_job_ring_handle_t job_ring_handle,
+                                           uint32_t max_length,
+                                           uint32_t max_fragments);
+
+/**
+ * @brief Enables the keystream cache on a PDCP User Plane context.
+ *
+ * For User Plane ciphering the keystream depends only on the key, COUNT, bearer and
+ * direction, so it can be generated before the PDU arrives. With the cache enabled,
+ * the keystream for the next COUNT values is generated on the CPU by
+ * sec_refill_keystream_cache(), ideally in the idle cycles of the producer thread.
+ * A PDU submitted with sec_process_packet_hfn_ov() whose COUNT is found in the cache
+ * and whose payload is at most #SEC_KEYSTREAM_CACHE_MAX_PAYLOAD bytes is then ciphered
+ * by XOR-ing it with the keystream, without going through SEC. Its notification is
+ * raised, as for any other packet, from the next sec_poll() or sec_poll_job_ring()
+ * call on the context's job ring, in submission order with the packets processed by SEC.
+ *
+ * PDUs for which there is no keystream in the cache, PDUs with fragments or PDUs
+ * submitted while SEC still processes other packets of the context are processed by SEC.
+ *
+ * The context must be a PDCP User Plane context with HFN override enabled
+ * (COUNT is known by the driver only when the HFN is provided with each packet),
+ * ciphered with #SEC_ALG_SNOW or #SEC_ALG_AES. The driver must be initialized with a
+ * valid sec_config_t::sec_drv_ptov function.
+ *
+ * Available only when the driver is built with #SEC_ENABLE_KEYSTREAM_CACHE ON, which
+ * requires #SEC_NOTIFICATION_TYPE_POLL: the PDUs ciphered on the CPU raise no interrupt.
+ *
+ * @param [in]  sec_ctx_handle     The handle of the context.
+ * @param [in]  next_count         The COUNT value (HFN and SN) of the next PDU to be submitted.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    when the context is not eligible for a keystream cache,
+ *                                      or the keystream cache support is disabled
+ * @retval ::SEC_DRIVER_NOT_INITIALIZED is returned if SEC driver is not yet initialized.
+ * @retval ::SEC_OUT_OF_MEMORY          when the memory for the cache cannot be allocated
+ */
+sec_return_code_t sec_enable_keystream_cache(sec_context_handle_t sec_ctx_handle,
+                                             uint32_t next_count);
+
+/**
+ * @brief Generates keystream for the next COUNT values of a context.
+ *
+ * Must be called from the producer thread of the context, the same thread that
+ * calls sec_process_packet_hfn_ov() for it.
+ *
+ * @param [in]  sec_ctx_handle     The handle of the context.
+ * @param [in]  budget             Maximum number of COUNT values to generate keystream for.
+ *                                 Bounds the time spent in this call.
+ * @param [out] entries_no         Number of COUNT values for which keystream was generated.
+ *                                 Can be NULL.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    when the keystream cache is not enabled on the context
+ */
+sec_return_code_t sec_refill_keystream_cache(sec_context_handle_t sec_ctx_handle,
+                                             uint32_t budget,
+                                             uint32_t *entries_no);
 /**
     @}
  */
@@ -907,6 +1438,343 @@ const char* sec_get_error_message(sec_return_code_t return_code);
  */
 sec_return_code_t sec_get_stats(sec_job_ring_handle_t job_ring_handle,
                                 sec_statistics_t * jr_stats);
+
+/** @brief Retrieves extended statistics on a SEC Job Ring.
+ *
+ * Retrieves the same statistics as sec_get_stats() and, if #SEC_ENABLE_JR_COUNTERS
+ * is ON, the cumulative counters of the Job Ring. UA sets jr_stats->size to the size of
+ * the structure it was built with; the driver fills the fields that fit and reports
+ * its own version in jr_stats->version.
+ *
+ * Can be called from any thread. The counters are updated by the threads that submit
+ * packets and poll the Job Ring while they are read.
+ *
+ * @param [in]     job_ring_handle The Job Ring handle.
+ * @param [in,out] jr_stats        Pointer to an extended statistics structure.
+ *
+ * @retval ::SEC_SUCCESS                    for successful execution.
+ * @retval ::SEC_INVALID_INPUT_PARAM        if jr_stats->size is too small for the version 1 fields
+ *                                          or #SEC_ENABLE_JR_COUNTERS is OFF.
+ */
+sec_return_code_t sec_get_stats_ext(sec_job_ring_handle_t job_ring_handle,
+                                    sec_statistics_ext_t * jr_stats);
+
+/** @brief Retrieves the usage of the DMA-capable memory area provided by UA
+ * in sec_config_t::memory_area.
+ *
+ * The memory used by each job ring and by each pool of SEC contexts is reported
+ * separately. Their sum is the memory currently used by the driver.
+ *
+ * @param [out] usage           Pointer to a memory usage structure.
+ *
+ * @retval ::SEC_SUCCESS                    for successful execution.
+ * @retval ::SEC_DRIVER_NOT_INITIALIZED     if sec_init() was not called.
+ */
+sec_return_code_t sec_get_dma_mem_usage(sec_dma_mem_usage_t *usage);
+
+/** @brief Retrieves the latencies of the packets processed by SEC on a Job Ring.
+ *
+ * The latency of a packet is measured from its submission with sec_process_packet*()
+ * until it is dequeued by sec_poll*(), just before its ::sec_out_cbk is called.
+ * It is kept in one of the histograms of @a latency_stats, by kind of context.
+ * The histograms are cumulative since sec_init(): the latencies of an interval
+ * are the difference of two readings.
+ *
+ * Can be called from any thread. The histograms are updated by the thread that polls
+ * the job ring while they are read, so a reading can be off by the packets
+ * dequeued meanwhile.
+ *
+ * @param [in]  job_ring_handle The Job Ring handle.
+ * @param [out] latency_stats   Pointer to a latency statistics structure.
+ *
+ * @retval ::SEC_SUCCESS                    for successful execution.
+ * @retval ::SEC_INVALID_INPUT_PARAM        if #SEC_ENABLE_LATENCY_STATS is OFF.
+ * @retval ::SEC_DRIVER_NOT_INITIALIZED     if sec_init() was not called.
+ */
+sec_return_code_t sec_get_latency_stats(sec_job_ring_handle_t job_ring_handle,
+                                        sec_latency_stats_t *latency_stats);
+
+/** @brief Returns a percentile of the latencies of a histogram.
+ *
+ * The result is the highest latency of the bucket where the percentile falls,
+ * so it is an upper bound, higher than the exact value by at most
+ * 1/2^#SEC_LATENCY_HIST_SUB_BUCKET_BITS of it.
+ *
+ * @param [in]  hist            A histogram retrieved with sec_get_latency_stats().
+ * @param [in]  percentile      The percentile, in hundredths of percent:
+ *                              e.g. 5000 for the median, 9900 for p99, 9990 for p99.9.
+ *                              Values above 10000 are taken as 10000.
+ *
+ * @return The percentile, in ticks of sec_time_read(). 0 if the histogram is empty,
+ *         or in debug builds if hist is NULL. hist must not be NULL in release builds.
+ */
+uint32_t sec_get_latency_percentile(const sec_latency_histogram_t *hist,
+                                    uint32_t percentile);
+
+/** @brief Retrieves the counters of a SEC context.
+ *
+ * Can be called from any thread. The counters are updated by the thread that polls
+ * the Job Ring of the context while they are read, so a reading can be off by the
+ * packets notified meanwhile.
+ *
+ * @param [in]  sec_ctx_handle  The handle of the context, returned by sec_create_pdcp_context()
+ *                              or sec_create_rlc_context().
+ * @param [out] ctx_stats       Pointer to a context statistics structure.
+ *
+ * @retval ::SEC_SUCCESS                    for successful execution.
+ * @retval ::SEC_INVALID_INPUT_PARAM        if the context handle is invalid or
+ *                                          #SEC_ENABLE_CONTEXT_STATS is OFF.
+ * @retval ::SEC_DRIVER_NOT_INITIALIZED     if sec_init() was not called.
+ */
+sec_return_code_t sec_get_context_stats(sec_context_handle_t sec_ctx_handle,
+                                        sec_context_stats_t *ctx_stats);
+
+/** @brief Retrieves the counters of all the SEC contexts in use, a batch at a time.
+ *
+ * The contexts are visited in the order they are laid out in memory by the driver,
+ * which makes exporting the counters of many contexts cheap. UA starts with *cursor
+ * set to 0 and calls the function again with the same cursor until it returns fewer
+ * than max_no entries. Contexts created or deleted during the iteration may or may
+ * not be reported. Deleted contexts are reported until their last packet is notified.
+ *
+ * Can be called from any thread, with the same caveat as sec_get_context_stats().
+ *
+ * @param [in,out] cursor       Position of the iteration. Set to 0 by UA for the first call.
+ * @param [out]    ctx_stats    Array of at least max_no context statistics structures.
+ * @param [in]     max_no       Maximum number of entries to fill.
+ * @param [out]    stats_no     Number of entries filled.
+ *
+ * @retval ::SEC_SUCCESS                    for successful execution.
+ * @retval ::SEC_INVALID_INPUT_PARAM        if an argument is NULL or #SEC_ENABLE_CONTEXT_STATS is OFF.
+ * @retval ::SEC_DRIVER_NOT_INITIALIZED     if sec_init() was not called.
+ */
+sec_return_code_t sec_get_contexts_stats(uint32_t *cursor,
+                                         sec_context_stats_t *ctx_stats,
+                                         uint32_t max_no,
+                                         uint32_t *stats_no);
+
+/** @brief Writes to stderr the messages held in the log ring.
+ *
+ * With #SEC_DRIVER_DEFERRED_LOGGING ON, the error messages of the per packet paths
+ * are kept in an in-memory log ring, so that the threads that submit and poll
+ * packets never block on stderr. If #SEC_LOG_DRAIN_PERIOD_MS is 0, UA calls this
+ * function from a thread of its choice to write them out. Otherwise a background
+ * thread does it, and this function can still be called to flush the log ring.
+ * Can be called at any time, from any thread, including before sec_init().
+ *
+ * @param [in]  max_no      Most messages to write.
+ * @param [out] drained_no  Number of messages written. Can be NULL.
+ *
+ * @retval ::SEC_SUCCESS    for successful execution.
+ */
+sec_return_code_t sec_drain_log(uint32_t max_no, uint32_t *drained_no);
+
+/** @brief Switches the recording of the binary event trace on or off.
+ *
+ * While on, every thread that submits or polls packets records the driver events
+ * it goes through in a trace buffer of its own, allocated when the thread records
+ * its first event. The oldest events are overwritten when a buffer is full.
+ * The buffers are kept after the threads exit, so that their events can be dumped.
+ * Can be called at any time, from any thread, including before sec_init().
+ *
+ * @param [in] enable   #TRUE to record events, #FALSE to stop.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution.
+ * @retval ::SEC_INVALID_INPUT_PARAM    if #SEC_ENABLE_TRACE is OFF.
+ */
+sec_return_code_t sec_trace_enable(uint32_t enable);
+
+/** @brief Sets the clock of the timestamps of the binary event trace.
+ *
+ * By default, the timestamps are taken with sec_time_read(). UA can provide its own
+ * clock, to trace in the same time base as its own measurements.
+ * Must be called while recording is off.
+ *
+ * @param [in] clock            The clock. NULL restores the default clock.
+ * @param [in] ticks_per_second Frequency of the clock. Ignored if clock is NULL.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution.
+ * @retval ::SEC_INVALID_INPUT_PARAM    if ticks_per_second is 0 or #SEC_ENABLE_TRACE is OFF.
+ */
+sec_return_code_t sec_trace_set_clock(sec_trace_clock_t clock, uint64_t ticks_per_second);
+
+/** @brief Discards the events recorded until now by all the threads. */
+void sec_trace_clear(void);
+
+/** @brief Writes the events recorded by all the threads to a binary file.
+ *
+ * The format of the file is described by ::sec_trace_file_header_t. The sec_trace_dump
+ * tool converts it to the Chrome trace format or to CTF. For a consistent timeline,
+ * recording should be switched off with sec_trace_enable() before.
+ *
+ * @param [in] file_name    Name of the file to write.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution.
+ * @retval ::SEC_INVALID_INPUT_PARAM    if the file cannot be written or #SEC_ENABLE_TRACE is OFF.
+ */
+sec_return_code_t sec_trace_dump(const char *file_name);
+/**
+    @}
+ */
+
+/**
+    @addtogroup SecUserSpaceDriverSwCryptoFunctions
+    @{
+ */
+/** @brief Computes on the CPU the 128-EIA2 MAC-I for a batch of messages.
+ *
+ * The jobs can belong to different PDCP Control Plane contexts, each one carrying its
+ * own key, COUNT, bearer and direction. The messages are processed #SEC_SW_CRYPTO_LANES
+ * at a time: when a short message is finished, the next job from the batch takes
+ * its lane, so that messages of different lengths can be mixed freely.
+ *
+ * The function does not use the SEC device and does not require sec_init() to be called.
+ * It is meant for small Control Plane PDUs, for which the cost of a round trip
+ * through a Job Ring exceeds the cost of the computation itself.
+ *
+ * For integrity verification (decapsulation), compare the computed sec_sw_eia2_job_t::mac_i
+ * against the MAC-I received at the end of the PDU.
+ *
+ * @param [in,out] jobs     Array of jobs. The MAC-I of each job is written in sec_sw_eia2_job_t::mac_i.
+ * @param [in]     jobs_no  Number of jobs in the array.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    when at least one invalid parameter was provided
+ */
+sec_return_code_t sec_sw_eia2_compute_batch(sec_sw_eia2_job_t *jobs, uint32_t jobs_no);
+
+/** @brief Ciphers or deciphers on the CPU a batch of RLC payloads with KASUMI f8.
+ *
+ * The jobs can belong to different RLC UM or AM contexts, each one carrying its own
+ * key, COUNT-C, bearer and direction. The payloads are processed #SEC_SW_CRYPTO_LANES
+ * at a time, with the KASUMI rounds of all lanes interleaved. When a payload is finished,
+ * the next job from the batch takes its lane.
+ *
+ * The function does not use the SEC device and does not require sec_init() to be called.
+ * It is meant for taking over the overflow of a busy Job Ring and for small,
+ * latency critical PDUs. Since f8 is a stream cipher, the same call is used for both
+ * ciphering and deciphering.
+ *
+ * @param [in,out] jobs     Array of jobs.
+ * @param [in]     jobs_no  Number of jobs in the array.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    when at least one invalid parameter was provided
+ */
+sec_return_code_t sec_sw_kasumi_f8_batch(sec_sw_kasumi_f8_job_t *jobs, uint32_t jobs_no);
+/**
+    @}
+ */
+
+/**
+    @addtogroup SecUserSpaceDriverBufPoolFunctions
+    @{
+ */
+/** @brief Creates a pool of fixed size packet buffers in a DMA-capable memory area.
+ *
+ * The memory area is split in as many buffers as fit, each one rounded up to a multiple
+ * of L1_CACHE_BYTES. The physical address of a buffer is computed from its index and
+ * the physical address of the memory area, so no translation is needed at run time.
+ *
+ * The pool does not use the SEC device and does not require sec_init() to be called.
+ * The pool structure itself is allocated from regular memory.
+ *
+ * @param [in]  config          Pool configuration.
+ * @param [out] pool            Handle of the created pool.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    when at least one invalid parameter was provided,
+ *                                      or the memory area cannot hold a single buffer
+ * @retval ::SEC_OUT_OF_MEMORY          when the pool structure cannot be allocated
+ */
+sec_return_code_t sec_buf_pool_create(const sec_buf_pool_config_t *config,
+                                      sec_buf_pool_t **pool);
+
+/** @brief Destroys a pool created with sec_buf_pool_create().
+ *
+ * The memory area is not freed, it still belongs to UA. No other thread may use
+ * the pool while it is destroyed.
+ *
+ * @param [in]  pool            The pool.
+ */
+void sec_buf_pool_destroy(sec_buf_pool_t *pool);
+
+/** @brief Allocates a number of buffers from a pool.
+ *
+ * Each packet is filled in with the PHYSICAL address of the buffer,
+ * sec_packet_t::offset set to the headroom, sec_packet_t::tail_offset set to the
+ * headroom plus the data room and a length of 0.
+ *
+ * The first #SEC_BUF_POOL_MAX_CACHES threads that use a pool get a cache of free buffers
+ * which is accessed without any lock. The shared list of free buffers of the pool is only
+ * locked when the cache of the calling thread runs empty.
+ *
+ * Either all the buffers are allocated, or none.
+ *
+ * @param [in]  pool            The pool.
+ * @param [out] packets         Array of packets_no packets.
+ * @param [in]  packets_no      Number of buffers to allocate.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution
+ * @retval ::SEC_INVALID_INPUT_PARAM    when at least one invalid parameter was provided
+ * @retval ::SEC_OUT_OF_MEMORY          when there are not enough free buffers
+ */
+sec_return_code_t sec_buf_pool_alloc_bulk(sec_buf_pool_t *pool,
+                                          sec_packet_t *packets,
+                                          uint32_t packets_no);
+
+/** @brief Returns a number of buffers to a pool.
+ *
+ * The buffers are identified by sec_packet_t::address, which can point anywhere inside the buffer.
+ * A buffer can be freed by a different thread than the one which allocated it.
+ *
+ * @param [in]  pool            The pool.
+ * @param [in]  packets         Array of packets_no packets.
+ * @param [in]  packets_no      Number of buffers to free.
+ */
+void sec_buf_pool_free_bulk(sec_buf_pool_t *pool,
+                            const sec_packet_t *packets,
+                            uint32_t packets_no);
+
+/** @brief Returns to the shared list of free buffers the buffers cached by the calling thread.
+ *
+ * Must be called by a thread that used the pool before it exits, otherwise the buffers in
+ * its cache are not available to the other threads.
+ *
+ * @param [in]  pool            The pool.
+ */
+void sec_buf_pool_flush_cache(sec_buf_pool_t *pool);
+
+/** @brief Returns the number of free buffers of a pool, including the ones cached by threads.
+ *
+ * The value is only accurate while no other thread allocates or frees buffers.
+ *
+ * @param [in]  pool            The pool.
+ *
+ * @retval Number of free buffers.
+ */
+uint32_t sec_buf_pool_get_free_no(sec_buf_pool_t *pool);
+
+/** @brief Converts a virtual address inside the memory area of a pool to a physical address.
+ *
+ * The translation only uses the addresses of the memory area, found when the pool was created,
+ * so it takes constant time and does not call the vtop function of the pool.
+ *
+ * @param [in]  pool            The pool.
+ * @param [in]  v               Virtual address.
+ *
+ * @retval Returns the corresponding physical address.
+ */
+dma_addr_t sec_buf_pool_vtop(const sec_buf_pool_t *pool, void *v);
+
+/** @brief Converts a physical address inside the memory area of a pool to a virtual address.
+ *
+ * @param [in]  pool            The pool.
+ * @param [in]  p               Physical address.
+ *
+ * @retval Returns the corresponding virtual address.
+ */
+void* sec_buf_pool_ptov(const sec_buf_pool_t *pool, dma_addr_t p);
 /**
     @}
  */
@@ -77,6 +77,11 @@ extern "C"{
     @defgroup SecUserSpaceDriverErrorFunctions SEC Driver Error Handling Functions
     @ingroup SecUserSpaceDriverFunctions
     This sub-module documents SEC user space driver error handling functions.
+
+    @defgroup SecUserSpaceDriverSwCryptoFunctions SEC Driver Software Cryptography Functions
+    @ingroup SecUserSpaceDriverFunctions
+    This sub-module documents the cryptographic kernels that the SEC user space driver
+    runs on the CPU cores, without SEC device involvement.
  */
 
  /** @mainpage SEC User Space Driver API Main Page
@@ -194,6 +199,52 @@ extern "C"{
  */
 #define SEC_ENABLE_SCATTER_GATHER ON
 
+/** Copy short fragmented packets to a contiguous bounce buffer of the job, instead
+ * of describing them to SEC with a SG table, which SEC has to fetch before the data.
+ * The output of such a packet is copied back to its fragments when it is dequeued.
+ * The thresholds below which packets are linearized can be changed at runtime with
+ * sec_set_sg_linearization(). Requires sec_config_t::sec_drv_ptov.
+ * Valid only if #SEC_ENABLE_SCATTER_GATHER is ON.
+ * Valid values:
+ * ON - linearize short fragmented packets
+ * OFF - always use SG tables for fragmented packets
+ */
+#define SEC_ENABLE_SG_LINEARIZATION ON
+
+/** Enable the submission of packets described by arrays of struct iovec with
+ * virtual addresses, see sec_process_packet_iov(). The addresses are translated
+ * by the driver, with the memory regions registered by UA with
+ * sec_register_mem_region().
+ * Each job ring then keeps the translated packets of every job, 256 KB per job
+ * ring with the default values, see #SEC_IOV_MAX_FRAGMENTS.
+ * Valid values:
+ * ON - enable sec_process_packet_iov()
+ * OFF - packets are submitted only with physical addresses
+ */
+#define SEC_ENABLE_IOV_SUBMISSION OFF
+
+/** Copy the ::sec_packet_t structures of contiguous packets into the job when
+ * they are submitted, instead of keeping pointers to them. UA can then build them
+ * in temporary memory (e.g. on the stack) and reuse it as soon as sec_process_packet()
+ * returns. The structures passed to ::sec_out_cbk are the copies, valid only during
+ * the callback. Fragmented packets are still referenced by pointer and must be
+ * kept by UA until they are notified.
+ * Valid values:
+ * ON - copy contiguous packets into the job
+ * OFF - UA keeps all the packets until they are notified
+ */
+#define SEC_ENABLE_PACKET_COPY OFF
+
+/** Number of packets that sec_process_packet_burst() groups by context before
+ * enqueuing them. SEC does not fetch again the shared descriptor of a job that uses
+ * the same context as the previous job, so packets of interleaved bearers are
+ * cheaper to process when they are enqueued back to back.
+ * The packets of a context keep their order. Grouping takes up to
+ * (SEC_BURST_REORDER_WINDOW^2)/2 comparisons per window.
+ * 1 disables grouping, the packets are enqueued in the order of the burst.
+ */
+#define SEC_BURST_REORDER_WINDOW  32
+
 /** Name of UIO device. Each user space SEC job ring will have a corresponding UIO device
  * with the name sec-channelX, where X is the job ring id.
  * Maximum length is #SEC_UIO_MAX_DEVICE_NAME_LENGTH.
@@ -271,27 +322,102 @@ extern "C"{
 /** Maximum number of entries in a SG table, per direction (in/out) */
 #define SEC_MAX_SG_TBL_ENTRIES          32
 
-/** DMA memory required for SG tables: number of entries in the job ring
- * multiplied by the maximum number of entries in a SG table multiplied by
- * the the number of SG tables per job (one for the input packet, one for the
- * output packet) i.e. 2
+/** Maximum number of fragments of a packet, excluding the parent buffer.
+ * A packet with more fragments than fit in a table of #SEC_MAX_SG_TBL_ENTRIES
+ * entries uses a chain of such tables: the last entry of each table has the
+ * extension bit set and points to the next table of the chain.
  */
-#define SEC_DMA_MEM_SG_SIZE         (SEC_JOB_RING_SIZE * SEC_MAX_SG_TBL_ENTRIES * SEC_SG_TBL_SIZE * 2)
+#define SEC_MAX_SG_FRAGMENTS            256
+
+/** The SG tables of a job ring are not reserved per job. They are kept in a pool
+ * with several classes of tables, by number of entries, and each packet takes
+ * at submit time a table from the smallest class that fits its fragments.
+ * If that class is exhausted, a table from a bigger class is used.
+ * The table is returned to the pool when the packet is dequeued.
+ *
+ * Number of entries of the tables in each class. A packet with N fragments
+ * needs N + 1 entries (#sec_packet_t::num_fragments excludes the parent buffer).
+ * The last class must have #SEC_MAX_SG_TBL_ENTRIES entries.
+ */
+#define SEC_SG_TBL_CLASS_SMALL_ENTRIES  4
+#define SEC_SG_TBL_CLASS_MEDIUM_ENTRIES 8
+#define SEC_SG_TBL_CLASS_LARGE_ENTRIES  SEC_MAX_SG_TBL_ENTRIES
+
+/** Number of tables in each class, per job ring. Must be powers of 2.
+ * The small tables are enough for every job of the job ring to have both an input
+ * and an output table with up to 3 fragments.
+ */
+#define SEC_SG_TBL_CLASS_SMALL_NO       (SEC_JOB_RING_SIZE * 2)
+#define SEC_SG_TBL_CLASS_MEDIUM_NO      (SEC_JOB_RING_SIZE / 2)
+#define SEC_SG_TBL_CLASS_LARGE_NO       (SEC_JOB_RING_SIZE / 8)
+
+/** Number of tables of #SEC_MAX_SG_TBL_ENTRIES entries needed for a packet with
+ * num_fragments fragments. Every table of a chain, except the last one, loses
+ * one entry to the extension entry.
+ */
+#define SEC_SG_TBL_CHAIN_LEN(num_fragments) \
+    (((num_fragments) + SEC_MAX_SG_TBL_ENTRIES - 2) / (SEC_MAX_SG_TBL_ENTRIES - 1))
+
+/** Size in bytes of a SG table formatted by UA with sec_build_sg_tbl(),
+ * for a packet with num_fragments fragments. Such a table is never chained.
+ */
+#define SEC_SG_TBL_MEM_SIZE(num_fragments)  (((num_fragments) + 1) * SEC_SG_TBL_SIZE)
+
+/** DMA memory required for the SG tables of a job ring: all the tables of all the classes */
+#define SEC_DMA_MEM_SG_TBLS_SIZE    ((SEC_SG_TBL_CLASS_SMALL_NO * SEC_SG_TBL_CLASS_SMALL_ENTRIES + \
+                                      SEC_SG_TBL_CLASS_MEDIUM_NO * SEC_SG_TBL_CLASS_MEDIUM_ENTRIES + \
+                                      SEC_SG_TBL_CLASS_LARGE_NO * SEC_SG_TBL_CLASS_LARGE_ENTRIES) * \
+                                     SEC_SG_TBL_SIZE)
+
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+/** Size in bytes of a bounce buffer. Each job has one for the input and one
+ * for the output packet. Packets longer than this are never linearized. */
+#define SEC_SG_BOUNCE_BUF_SIZE          128
+
+/** Default thresholds for linearizing a fragmented packet: total length in bytes,
+ * and number of fragments including the parent buffer. */
+#define SEC_SG_LINEARIZE_MAX_LENGTH     SEC_SG_BOUNCE_BUF_SIZE
+#define SEC_SG_LINEARIZE_MAX_FRAGMENTS  4
+
+/** DMA memory required for the bounce buffers of a job ring */
+#define SEC_DMA_MEM_SG_BOUNCE_SIZE      (SEC_JOB_RING_SIZE * 2 * SEC_SG_BOUNCE_BUF_SIZE)
+#else // (SEC_ENABLE_SG_LINEARIZATION == ON)
+#define SEC_DMA_MEM_SG_BOUNCE_SIZE      0
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
+
+/** DMA memory required for Scatter-Gather support in a job ring: the SG tables,
+ * followed by the bounce buffers */
+#define SEC_DMA_MEM_SG_SIZE             (SEC_DMA_MEM_SG_TBLS_SIZE + SEC_DMA_MEM_SG_BOUNCE_SIZE)
 
 #endif // (SEC_ENABLE_SCATTER_GATHER == ON)
 
+/** Maximum number of struct iovec entries of a packet submitted with
+ * sec_process_packet_iov(). Each job of a job ring stores the translated
+ * input and output packets, in regular memory: a job ring uses
+ * SEC_JOB_RING_SIZE * 2 * SEC_IOV_MAX_FRAGMENTS * sizeof(sec_packet_t) bytes.
+ */
+#define SEC_IOV_MAX_FRAGMENTS           8
+
+/** Maximum number of memory regions registered with sec_register_mem_region().
+ * Lookups are done with a binary search over the regions, sorted by address.
+ */
+#define SEC_MAX_MEM_REGIONS             64
+
 /** When calling sec_init() UA will provide an area of virtual memory
  *  of size #SEC_DMA_MEMORY_SIZE to be  used internally by the driver
+ *  (or of the smaller size returned by sec_get_required_dma_size())
  *  to allocate data (like SEC descriptors) that needs to be passed to
  *  SEC device in physical addressing and later on retrieved from SEC device.
  *  At initialization the UA provides specialized ptov/vtop functions/macros to
- *  translate addresses allocated from this memory area. */
+ *  translate addresses allocated from this memory area.
+ *  The shared descriptors are reserved twice: with one job ring, the pool of
+ *  contexts of the job ring and the global pool have #SEC_MAX_PDCP_CONTEXTS each. */
 #if (SEC_ENABLE_SCATTER_GATHER == ON)
-#define SEC_DMA_MEMORY_SIZE     ( (SEC_CRYPTO_DESCRIPTOR_SIZE) * (SEC_MAX_PDCP_CONTEXTS) + \
+#define SEC_DMA_MEMORY_SIZE     ( (SEC_CRYPTO_DESCRIPTOR_SIZE) * (SEC_MAX_PDCP_CONTEXTS) * 2 + \
                                   (SEC_DMA_MEM_JOB_RING_SIZE) * (MAX_SEC_JOB_RINGS) + \
                                   (SEC_DMA_MEM_SG_SIZE) * (MAX_SEC_JOB_RINGS) )
 #else // (SEC_ENABLE_SCATTER_GATHER == ON)
-#define SEC_DMA_MEMORY_SIZE     ( (SEC_CRYPTO_DESCRIPTOR_SIZE) * (SEC_MAX_PDCP_CONTEXTS) + \
+#define SEC_DMA_MEMORY_SIZE     ( (SEC_CRYPTO_DESCRIPTOR_SIZE) * (SEC_MAX_PDCP_CONTEXTS) * 2 + \
                                   (SEC_DMA_MEM_JOB_RING_SIZE) * (MAX_SEC_JOB_RINGS) )
 #endif // (SEC_ENABLE_SCATTER_GATHER == ON)
 
@@ -334,6 +460,35 @@ extern "C"{
  */
 #define SEC_DRIVER_LOGGING_LEVEL SEC_DRIVER_LOG_ERROR
 
+/** Enable or disable deferred logging of the messages from per packet error paths.
+ * These messages are rate limited per call site, see #SEC_LOG_RATE_LIMIT_BURST.
+ * When ON, they are formatted into a lock-free in-memory log ring instead of being
+ * written to stderr by the thread that polls or submits packets. The log ring is
+ * written to stderr by a background thread, see #SEC_LOG_DRAIN_PERIOD_MS, or by UA
+ * with sec_drain_log().
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_DRIVER_DEFERRED_LOGGING OFF
+
+/** Number of messages the log ring can hold. Messages logged while the log ring
+ * is full are dropped and counted. Must be a power of 2.
+ */
+#define SEC_LOG_RING_SIZE           256
+
+/** Period in milliseconds of the background thread started by sec_init() to write
+ * the log ring to stderr. With 0, no thread is started and UA calls sec_drain_log().
+ */
+#define SEC_LOG_DRAIN_PERIOD_MS     100
+
+/** Most messages logged by a rate limited call site in an interval of
+ * #SEC_LOG_RATE_LIMIT_INTERVAL seconds. The messages over the limit are counted
+ * and the count is reported with the next message logged by the call site.
+ */
+#define SEC_LOG_RATE_LIMIT_BURST    10
+
+/** Length in seconds of the rate limiting interval. */
+#define SEC_LOG_RATE_LIMIT_INTERVAL 1
+
 /***************************************/
 /* SEC JOB RING related configuration. */
 /***************************************/
@@ -353,6 +508,212 @@ extern "C"{
  */
 #define SEC_JOB_RING_SIZE       512
 
+/** Enable or disable the measurement of the latency of the jobs processed by SEC,
+ * from their submission with sec_process_packet*() to their dequeue in sec_poll*().
+ * The latencies are kept per job ring, in a log-linear histogram for each kind of
+ * context (see ::sec_latency_class_t), and are retrieved with sec_get_latency_stats().
+ * Costs a time base reading per packet submitted and per poll that dequeues jobs.
+ * Packets processed on the CPU and packets flushed after an error are not measured.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_LATENCY_STATS        OFF
+
+/** Enable or disable the cumulative counters of each job ring: packets and bytes
+ * submitted and notified, rejections because the job ring was full, integrity
+ * check failures, HFN threshold events, errors, empty polls and IRQ re-enables.
+ * They are retrieved with sec_get_stats_ext(). The counters written on submission
+ * and on poll lay on different cache lines, so that the producer and the consumer
+ * threads of a job ring don't share them.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_JR_COUNTERS          ON
+
+/** Enable or disable the counters of each SEC context: packets and bytes notified,
+ * integrity check failures, HFN threshold events, overdue notifications, errors and
+ * the time of the last notification. They are written only by the thread that polls
+ * the job ring of the context, on a cache line of their own, and are retrieved with
+ * sec_get_context_stats() or, for all the contexts at once, sec_get_contexts_stats().
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_CONTEXT_STATS        OFF
+
+/** Enable or disable the measurement of the time spent in the callbacks of UA,
+ * per job ring. It is retrieved with sec_get_stats_ext(), together with the number
+ * of polls, to tell how much of the poll time is UA's own processing.
+ * Costs two time base readings per packet notified. Requires #SEC_ENABLE_JR_COUNTERS.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_CALLBACK_TIMING      OFF
+
+/** Enable or disable the automatic tuning of the weight of sec_poll(), per job ring.
+ * The weight given to sec_poll() is the starting point. Every #SEC_POLL_AUTOTUNE_WINDOW
+ * polls of a job ring, its weight is doubled if most polls stopped at the weight while
+ * they notified less than #SEC_POLL_AUTOTUNE_TARGET packets on average, or while the
+ * jobs waited more than #SEC_POLL_AUTOTUNE_LATENCY_BUDGET_US on average. It is lowered
+ * by a quarter, not below #SEC_POLL_AUTOTUNE_TARGET, if no poll stopped at the weight
+ * and the polls notified less than half of it, so that a burst on one job ring
+ * does not delay the others. The weight in use is retrieved with sec_get_stats_ext().
+ * Costs a time base reading per packet submitted and per poll that dequeues jobs.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_POLL_AUTOTUNE        OFF
+
+/** Number of polls of a job ring by sec_poll() between two adjustments of its weight */
+#define SEC_POLL_AUTOTUNE_WINDOW        64
+
+/** Packets notified per poll of a job ring that the tuning of the weight aims at */
+#define SEC_POLL_AUTOTUNE_TARGET        16
+
+/** Average time, in microseconds, from submission to dequeue of a job above which
+ * the weight of its job ring is raised */
+#define SEC_POLL_AUTOTUNE_LATENCY_BUDGET_US 100
+
+/** Enable or disable the binary event trace. Each thread that submits or polls
+ * packets records the driver events it goes through (submit, doorbell, jobs done,
+ * callbacks, job ring flush and reset, IRQ re-enable) with a timestamp, in a buffer
+ * of its own. Recording is switched on and off at run time with sec_trace_enable()
+ * and the buffers are saved with sec_trace_dump(), for the sec_trace_dump tool.
+ * When OFF, no code is generated for the trace points.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_TRACE            OFF
+
+/** Number of events kept in the trace buffer of each thread. When the buffer is full,
+ * the oldest events are overwritten. Must be a power of 2.
+ */
+#define SEC_TRACE_BUFFER_SIZE           8192
+
+/** Enable or disable the serialization of the counter readings taken by the driver
+ * for its latency histograms, context counters, trace and CPU cost estimates.
+ * When ON, a reading waits for the previous instructions to complete and holds back
+ * the next ones, see sec_time_read_start(). Intervals of a few hundred cycles are then
+ * measured accurately, at the cost of a pipeline drain per reading.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_TIME_SERIALIZE              OFF
+
+/** Each power of 2 interval of latencies is split in 2^N buckets of the latency
+ * histograms, so a latency is known with an error of at most 1/2^N.
+ * Valid values are from 1 to 8.
+ */
+#define SEC_LATENCY_HIST_SUB_BUCKET_BITS    3
+
+/*****************************************************/
+/* Software cryptographic kernels configuration.     */
+/*****************************************************/
+
+/** Number of independent packets processed in lock step by the software
+ * cryptographic kernels (for example sec_sw_eia2_compute_batch()).
+ * The cipher rounds of all the lanes are interleaved so that the table
+ * lookups of one packet overlap with those of the other packets.
+ * Valid values are from 1 to 8.
+ */
+#define SEC_SW_CRYPTO_LANES     4
+
+/** Select the implementation of the software AES-128 engine.
+ * When OFF, AES uses 4 KB of T-tables indexed with bytes of the state, which
+ * is fast but leaks information about the key through cache timing to any code
+ * sharing the core or its caches. When ON, the S-box is computed with
+ * arithmetic on 4 packed bytes, without table lookups or branches that depend
+ * on the key or data, at several times the cost per block.
+ * The keystream cache and the hybrid dispatcher cipher the packets of live
+ * contexts with this engine: set this option ON when enabling them on a core
+ * shared with code that is not trusted with the keys.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_SW_AES_CONSTANT_TIME    OFF
+
+/** Enable or disable the keystream cache for PDCP User Plane contexts
+ * ciphered with SNOW f8 or AES-CTR. When enabled, sec_enable_keystream_cache()
+ * can be used to have the keystream for the next COUNT values generated on the
+ * CPU ahead of time, so that ciphering a PDU reduces to an XOR.
+ * The PDUs ciphered on the CPU raise no interrupt, so the cache can be enabled only
+ * when #SEC_NOTIFICATION_TYPE is #SEC_NOTIFICATION_TYPE_POLL.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_KEYSTREAM_CACHE      OFF
+
+/** Number of COUNT values for which keystream is kept pre-generated, per context.
+ * Must be a power of 2.
+ */
+#define SEC_KEYSTREAM_CACHE_DEPTH       32
+
+/** Maximum PDCP payload size, in bytes, that can be ciphered from the keystream cache.
+ * Longer PDUs are always submitted to SEC. Must be a multiple of 16.
+ */
+#define SEC_KEYSTREAM_CACHE_MAX_PAYLOAD 128
+
+/** Enable or disable the hybrid dispatcher. When enabled, the packets of PDCP
+ * User Plane contexts with HFN override, ciphered with SNOW f8 or AES-CTR, can be
+ * ciphered on the CPU instead of being sent to SEC. The choice is made per packet,
+ * based on the payload size, the job ring occupancy and the measured SEC completion
+ * latency. Packets of a context are notified in the order they were submitted.
+ * Takes effect only if UA configures sec_config_t::sec_drv_ptov.
+ * The packets ciphered on the CPU raise no interrupt, so the dispatcher can be enabled
+ * only when #SEC_NOTIFICATION_TYPE is #SEC_NOTIFICATION_TYPE_POLL.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_HYBRID_DISPATCH      OFF
+
+/** Payloads of at most this size, in bytes, are always ciphered on the CPU when
+ * the context allows it: they would spend more time in the job ring round trip
+ * than in ciphering.
+ */
+#define SEC_HYBRID_SMALL_PAYLOAD        64
+
+/** Maximum payload size, in bytes, ever ciphered on the CPU by the hybrid dispatcher.
+ * Must be a multiple of 16.
+ */
+#define SEC_HYBRID_MAX_PAYLOAD          512
+
+/** Number of jobs in flight in a job ring above which SEC is considered congested
+ * and packets of up to #SEC_HYBRID_MAX_PAYLOAD bytes are ciphered on the CPU.
+ */
+#define SEC_HYBRID_RING_BUSY_THRESHOLD  (SEC_JOB_RING_SIZE / 4)
+
+/** Weight of a new sample in the moving averages of SEC completion latency and of
+ * CPU ciphering cost, as a power of 2: each sample contributes 1/2^N.
+ */
+#define SEC_HYBRID_EWMA_SHIFT           3
+
+/** Enable or disable the CPU pass-through for PDCP contexts that use only NULL
+ * algorithms: User Plane with EEA0 and Control Plane with EEA0/EIA0. Their packets
+ * are copied (with the zero MAC-I appended or removed for Control Plane) on the CPU
+ * and notified on the next poll, without a SEC job. In place User Plane packets are
+ * not touched at all. Packets are copied only if UA configures sec_config_t::sec_drv_ptov.
+ * Control Plane contexts are passed through only with HFN override enabled.
+ * The packets completed on the CPU raise no interrupt, so the pass-through can be
+ * enabled only when #SEC_NOTIFICATION_TYPE is #SEC_NOTIFICATION_TYPE_POLL.
+ * Valid values are #ON or #OFF.
+ */
+#define SEC_ENABLE_NULL_PASSTHROUGH     OFF
+
+/** Packets processed on the CPU are kept in a ring of their own until notified.
+ * Derived from the options above, do not change.
+ */
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON) || (SEC_ENABLE_HYBRID_DISPATCH == ON) || \
+    (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+#define SEC_ENABLE_CPU_JOBS             ON
+#else
+#define SEC_ENABLE_CPU_JOBS             OFF
+#endif
+
+/*****************************************************/
+/* Packet buffer pool configuration.                 */
+/*****************************************************/
+
+/** Maximum number of threads that get a cache of free buffers in every
+ * pool created with sec_buf_pool_create(). Further threads allocate and free
+ * directly from the shared list of free buffers of the pool, under a lock.
+ */
+#define SEC_BUF_POOL_MAX_CACHES         16
+
+/** Number of free buffers kept in the cache of a thread. When the cache is
+ * empty or full, half of this number of buffers are moved at once from or
+ * to the shared list of free buffers.
+ */
+#define SEC_BUF_POOL_CACHE_SIZE         64
+
 /***************************************************/
 /* Interrupt coalescing related configuration.     */
 /* NOTE: SEC hardware enabled interrupt            */
@@ -0,0 +1,226 @@
+/* Copyright (c) 2011 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FSL_SEC_TIME_H
+#define FSL_SEC_TIME_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+/**
+    @addtogroup SecUserSpaceDriverFunctions
+    @{
+ */
+
+/*==================================================================================================
+                                         INCLUDE FILES
+==================================================================================================*/
+#include <stdint.h>
+#include <time.h>
+/*==================================================================================================
+                                       DEFINES AND MACROS
+==================================================================================================*/
+/** Name of the counter read by sec_time_read(), as reported by the benchmarks:
+ *  - "tsc"     the Time Stamp Counter on x86,
+ *  - "cntvct"  the virtual count of the Generic Timer on ARMv8,
+ *  - "tb"      the time base on Power Architecture,
+ *  - "ns"      CLOCK_MONOTONIC, in nanoseconds, elsewhere. */
+#if defined(__x86_64__) || defined(__i386__)
+#define SEC_TIME_SOURCE     "tsc"
+#elif defined(__aarch64__)
+#define SEC_TIME_SOURCE     "cntvct"
+#elif defined(__powerpc__)
+#define SEC_TIME_SOURCE     "tb"
+#else
+#define SEC_TIME_SOURCE     "ns"
+#endif
+
+/** Number of nanoseconds in a second */
+#define SEC_TIME_NS_PER_SECOND  1000000000ULL
+
+/** Duration of the calibration of the counter, where its frequency is not published */
+#define SEC_TIME_CALIBRATION_MS 20
+
+/*==================================================================================================
+                                             ENUMS
+==================================================================================================*/
+
+/*==================================================================================================
+                                 STRUCTURES AND OTHER TYPEDEFS
+==================================================================================================*/
+
+/*==================================================================================================
+                                 GLOBAL VARIABLE DECLARATIONS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     FUNCTION PROTOTYPES
+==================================================================================================*/
+/** @brief Reads the free running counter of the core, see #SEC_TIME_SOURCE.
+ *
+ * The reading is not ordered with the surrounding instructions: the core can take
+ * it before the previous instructions are done or after the next ones started.
+ * This is the cheapest reading, right for timestamps and for intervals long
+ * compared to the depth of the pipeline, e.g. the latency of a packet.
+ * Use sec_time_read_start() and sec_time_read_end() to measure short sections of code.
+ *
+ * Only the difference between two readings is meaningful. Convert it with
+ * sec_time_ticks_to_ns() to compare measurements taken on different platforms.
+ *
+ * @return The counter, in ticks of sec_time_get_frequency().
+ */
+static inline uint64_t sec_time_read(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+
+    asm volatile("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((uint64_t)hi << 32) | lo;
+#elif defined(__aarch64__)
+    uint64_t cnt;
+
+    asm volatile("mrs %0, cntvct_el0" : "=r" (cnt));
+    return cnt;
+#elif defined(__powerpc64__)
+    uint64_t tb;
+
+    asm volatile("mftb %0" : "=r" (tb));
+    return tb;
+#elif defined(__powerpc__)
+    uint32_t tbu, tbl, tbu2;
+
+    // Read the upper half again, in case the lower half wrapped in between
+    do
+    {
+        asm volatile("mftbu %0" : "=r" (tbu));
+        asm volatile("mftb %0" : "=r" (tbl));
+        asm volatile("mftbu %0" : "=r" (tbu2));
+    }while(tbu != tbu2);
+
+    return ((uint64_t)tbu << 32) | tbl;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * SEC_TIME_NS_PER_SECOND + ts.tv_nsec;
+#endif
+}
+
+/** @brief Reads the counter at the start of a measured section of code.
+ *
+ * The reading is taken after all the previous instructions are done and
+ * before the next ones start, so the section is measured alone.
+ *
+ * @return The counter, in ticks of sec_time_get_frequency().
+ */
+static inline uint64_t sec_time_read_start(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+
+    asm volatile("lfence\n\trdtsc\n\tlfence" : "=a" (lo), "=d" (hi) : : "memory");
+    return ((uint64_t)hi << 32) | lo;
+#elif defined(__aarch64__)
+    uint64_t cnt;
+
+    asm volatile("isb\n\tmrs %0, cntvct_el0\n\tisb" : "=r" (cnt) : : "memory");
+    return cnt;
+#elif defined(__powerpc__)
+    uint64_t tb;
+
+    asm volatile("isync" : : : "memory");
+    tb = sec_time_read();
+    asm volatile("isync" : : : "memory");
+    return tb;
+#else
+    return sec_time_read();
+#endif
+}
+
+/** @brief Reads the counter at the end of a measured section of code.
+ *
+ * The reading is taken after all the instructions of the section are done and
+ * before the next instructions start.
+ *
+ * @return The counter, in ticks of sec_time_get_frequency().
+ */
+static inline uint64_t sec_time_read_end(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+
+    // rdtscp waits for the previous instructions, lfence holds back the next ones
+    asm volatile("rdtscp\n\tlfence" : "=a" (lo), "=d" (hi) : : "ecx", "memory");
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return sec_time_read_start();
+#endif
+}
+
+/** @brief Returns the frequency of the counter read by sec_time_read().
+ *
+ * The frequency is read from the architecture where it is published (CNTFRQ_EL0
+ * on ARMv8, the "timebase" line of /proc/cpuinfo on Power Architecture) and
+ * calibrated against CLOCK_MONOTONIC_RAW otherwise (the TSC on x86), which
+ * takes #SEC_TIME_CALIBRATION_MS milliseconds. This is done on the first call only,
+ * so call it once before measuring, e.g. during the initialization of the application.
+ * Can be called at any time, from any thread, including before sec_init().
+ *
+ * @return The frequency, in ticks per second.
+ */
+uint64_t sec_time_get_frequency(void);
+
+/** @brief Converts a number of ticks of sec_time_read() to nanoseconds.
+ *
+ * @param [in] ticks    The ticks, e.g. the difference between two readings of the counter.
+ *
+ * @return The nanoseconds.
+ */
+uint64_t sec_time_ticks_to_ns(uint64_t ticks);
+
+/**
+    @}
+ */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* FSL_SEC_TIME_H */
@@ -0,0 +1,468 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "fsl_sec.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Number of buffers moved at once between the cache of a thread and the shared list of free buffers */
+#define SEC_BUF_POOL_CACHE_MOVE_SIZE    (SEC_BUF_POOL_CACHE_SIZE / 2)
+
+/** Value of the thread id before the thread used any pool */
+#define SEC_BUF_POOL_NO_THREAD_ID       (-1)
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/** Free buffers cached by one thread. Only the owner thread accesses it, so no lock is needed.
+ *  Each cache is on its own cachelines so that threads do not invalidate each other's caches. */
+typedef struct sec_buf_pool_cache_s
+{
+    uint32_t count;                             /*< Number of buffers in the cache */
+    uint32_t bufs[SEC_BUF_POOL_CACHE_SIZE];     /*< Indexes of the cached buffers */
+}____cacheline_aligned sec_buf_pool_cache_t;
+
+/** Pool of packet buffers */
+struct sec_buf_pool_s
+{
+    uint8_t         *start;         /*< Virtual address of the memory area */
+    dma_addr_t      phys_start;     /*< Physical address of the memory area */
+    uint32_t        buf_size;       /*< Size of a buffer, rounded up to a multiple of L1_CACHE_BYTES */
+    uint32_t        headroom;       /*< Headroom of a buffer */
+    uint32_t        data_room;      /*< Data room of a buffer */
+    uint32_t        bufs_no;        /*< Number of buffers in the pool */
+    pthread_mutex_t mutex;          /*< Protects free_bufs and free_no */
+    uint32_t        free_no;        /*< Number of buffers in free_bufs */
+    uint32_t        *free_bufs;     /*< Shared stack with the indexes of the free buffers */
+    sec_buf_pool_cache_t caches[SEC_BUF_POOL_MAX_CACHES];  /*< Per thread caches of free buffers */
+};
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+/** Id of the calling thread, used to select its cache in every pool */
+static __thread int32_t g_buf_pool_thread_id = SEC_BUF_POOL_NO_THREAD_ID;
+
+/** Number of thread ids handed out so far */
+static int32_t g_buf_pool_threads_no = 0;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/** @brief Returns the cache of the calling thread in a pool, or NULL if
+ * the thread has no cache.
+ *
+ * @param [in]  pool    The pool.
+ */
+static inline sec_buf_pool_cache_t* buf_pool_get_cache(sec_buf_pool_t *pool);
+
+/** @brief Fills in a packet for a buffer.
+ *
+ * @param [in]  pool    The pool.
+ * @param [in]  idx     Index of the buffer.
+ * @param [out] packet  The packet.
+ */
+static inline void buf_pool_fill_packet(sec_buf_pool_t *pool, uint32_t idx, sec_packet_t *packet);
+
+/** @brief Finds the index of the buffer a physical address belongs to.
+ *
+ * @param [in]  pool    The pool.
+ * @param [in]  address Physical address inside the buffer.
+ * @param [out] idx     Index of the buffer.
+ *
+ * @retval 0 for success
+ * @retval other if the address is outside of the pool
+ */
+static inline int buf_pool_get_index(sec_buf_pool_t *pool, dma_addr_t address, uint32_t *idx);
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+static inline sec_buf_pool_cache_t* buf_pool_get_cache(sec_buf_pool_t *pool)
+{
+    if (unlikely(g_buf_pool_thread_id == SEC_BUF_POOL_NO_THREAD_ID))
+    {
+        // Thread ids are shared by all the pools and never reused. Threads that get
+        // an id bigger than the number of caches work directly on the shared list.
+        g_buf_pool_thread_id = __sync_fetch_and_add(&g_buf_pool_threads_no, 1);
+    }
+
+    if (g_buf_pool_thread_id >= SEC_BUF_POOL_MAX_CACHES)
+    {
+        return NULL;
+    }
+    return &pool->caches[g_buf_pool_thread_id];
+}
+
+static inline void buf_pool_fill_packet(sec_buf_pool_t *pool, uint32_t idx, sec_packet_t *packet)
+{
+    packet->address = pool->phys_start + (dma_addr_t)idx * pool->buf_size;
+    packet->offset = pool->headroom;
+    packet->length = 0;
+    packet->tail_offset = pool->headroom + pool->data_room;
+    packet->total_length = 0;
+    packet->num_fragments = 0;
+}
+
+static inline int buf_pool_get_index(sec_buf_pool_t *pool, dma_addr_t address, uint32_t *idx)
+{
+    dma_addr_t offset = address - pool->phys_start;
+
+    // Also catches addresses below phys_start, for which the subtraction wraps around
+    if (unlikely(offset >= (dma_addr_t)pool->bufs_no * pool->buf_size))
+    {
+        return 1;
+    }
+    *idx = (uint32_t)(offset / pool->buf_size);
+    return 0;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+sec_return_code_t sec_buf_pool_create(const sec_buf_pool_config_t *config,
+                                      sec_buf_pool_t **pool)
+{
+    sec_buf_pool_t *new_pool = NULL;
+    uint32_t buf_size = 0;
+    uint32_t i = 0;
+    int ret = 0;
+
+    if (config == NULL || pool == NULL || config->memory_area == NULL || config->vtop == NULL)
+    {
+        SEC_ERROR("Invalid buffer pool configuration");
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    if (((uintptr_t)config->memory_area & (L1_CACHE_BYTES - 1)) != 0)
+    {
+        SEC_ERROR("Buffer pool memory area %p is not cacheline aligned", config->memory_area);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    buf_size = config->headroom + config->data_room + config->tailroom;
+    buf_size = (buf_size + L1_CACHE_BYTES - 1) & ~(L1_CACHE_BYTES - 1);
+    if (config->data_room == 0 || buf_size > config->memory_area_size)
+    {
+        SEC_ERROR("Buffer pool memory area of %u bytes cannot hold buffers of %u bytes",
+                  config->memory_area_size, buf_size);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    ret = posix_memalign((void**)&new_pool, L1_CACHE_BYTES, sizeof(sec_buf_pool_t));
+    if (ret != 0)
+    {
+        SEC_ERROR("Cannot allocate buffer pool structure");
+        return SEC_OUT_OF_MEMORY;
+    }
+    memset(new_pool, 0, sizeof(sec_buf_pool_t));
+
+    new_pool->bufs_no = config->memory_area_size / buf_size;
+    new_pool->free_bufs = malloc(new_pool->bufs_no * sizeof(uint32_t));
+    if (new_pool->free_bufs == NULL)
+    {
+        SEC_ERROR("Cannot allocate list of free buffers for %u buffers", new_pool->bufs_no);
+        free(new_pool);
+        return SEC_OUT_OF_MEMORY;
+    }
+
+    new_pool->start = config->memory_area;
+    new_pool->phys_start = config->vtop(config->memory_area);
+    new_pool->buf_size = buf_size;
+    new_pool->headroom = config->headroom;
+    new_pool->data_room = config->data_room;
+
+    // Lowest indexes on top of the stack, so that the first buffers handed out
+    // are at the start of the memory area
+    for (i = 0; i < new_pool->bufs_no; i++)
+    {
+        new_pool->free_bufs[i] = new_pool->bufs_no - 1 - i;
+    }
+    new_pool->free_no = new_pool->bufs_no;
+    pthread_mutex_init(&new_pool->mutex, NULL);
+
+    SEC_INFO("Created buffer pool with %u buffers of %u bytes at %p",
+             new_pool->bufs_no, buf_size, config->memory_area);
+
+    *pool = new_pool;
+    return SEC_SUCCESS;
+}
+
+void sec_buf_pool_destroy(sec_buf_pool_t *pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->free_bufs);
+    free(pool);
+}
+
+sec_return_code_t sec_buf_pool_alloc_bulk(sec_buf_pool_t *pool,
+                                          sec_packet_t *packets,
+                                          uint32_t packets_no)
+{
+    sec_buf_pool_cache_t *cache = NULL;
+    uint32_t cached_no = 0;
+    uint32_t move_no = 0;
+    uint32_t i = 0;
+
+    if (unlikely(pool == NULL || packets == NULL))
+    {
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    cache = buf_pool_get_cache(pool);
+
+    // Fast path: all the buffers are taken from the cache of this thread, without any lock
+    if (likely(cache != NULL && cache->count >= packets_no))
+    {
+        for (i = 0; i < packets_no; i++)
+        {
+            buf_pool_fill_packet(pool, cache->bufs[--cache->count], &packets[i]);
+        }
+        return SEC_SUCCESS;
+    }
+
+    cached_no = (cache != NULL) ? cache->count : 0;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    if (cached_no + pool->free_no < packets_no)
+    {
+        pthread_mutex_unlock(&pool->mutex);
+        return SEC_OUT_OF_MEMORY;
+    }
+
+    // Empty the cache first, then take the rest from the shared list
+    for (i = 0; i < cached_no; i++)
+    {
+        buf_pool_fill_packet(pool, cache->bufs[--cache->count], &packets[i]);
+    }
+    for (; i < packets_no; i++)
+    {
+        buf_pool_fill_packet(pool, pool->free_bufs[--pool->free_no], &packets[i]);
+    }
+
+    // Refill the cache for the next allocations, while still holding the lock
+    if (cache != NULL)
+    {
+        move_no = SEC_BUF_POOL_CACHE_MOVE_SIZE;
+        if (move_no > pool->free_no)
+        {
+            move_no = pool->free_no;
+        }
+        for (i = 0; i < move_no; i++)
+        {
+            cache->bufs[cache->count++] = pool->free_bufs[--pool->free_no];
+        }
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return SEC_SUCCESS;
+}
+
+void sec_buf_pool_free_bulk(sec_buf_pool_t *pool,
+                            const sec_packet_t *packets,
+                            uint32_t packets_no)
+{
+    sec_buf_pool_cache_t *cache = NULL;
+    uint32_t idx = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+    if (unlikely(pool == NULL || packets == NULL))
+    {
+        return;
+    }
+
+    cache = buf_pool_get_cache(pool);
+
+    if (cache == NULL)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        for (i = 0; i < packets_no; i++)
+        {
+            if (unlikely(buf_pool_get_index(pool, packets[i].address, &idx) != 0))
+            {
+                SEC_ERROR("Buffer with address 0x%llx is not from this pool",
+                          (unsigned long long)packets[i].address);
+                continue;
+            }
+            if (unlikely(pool->free_no == pool->bufs_no))
+            {
+                SEC_ERROR("More buffers freed than allocated, buffer %u is dropped", idx);
+                continue;
+            }
+            pool->free_bufs[pool->free_no++] = idx;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+        return;
+    }
+
+    for (i = 0; i < packets_no; i++)
+    {
+        if (unlikely(buf_pool_get_index(pool, packets[i].address, &idx) != 0))
+        {
+            SEC_ERROR("Buffer with address 0x%llx is not from this pool",
+                      (unsigned long long)packets[i].address);
+            continue;
+        }
+
+        // Cache full: move the oldest half of it to the shared list
+        if (unlikely(cache->count == SEC_BUF_POOL_CACHE_SIZE))
+        {
+            pthread_mutex_lock(&pool->mutex);
+            if (likely(pool->free_no + SEC_BUF_POOL_CACHE_MOVE_SIZE <= pool->bufs_no))
+            {
+                memcpy(&pool->free_bufs[pool->free_no], cache->bufs,
+                       SEC_BUF_POOL_CACHE_MOVE_SIZE * sizeof(uint32_t));
+                pool->free_no += SEC_BUF_POOL_CACHE_MOVE_SIZE;
+            }
+            else
+            {
+                SEC_ERROR("More buffers freed than allocated, %u buffers are dropped",
+                          SEC_BUF_POOL_CACHE_MOVE_SIZE);
+            }
+            pthread_mutex_unlock(&pool->mutex);
+
+            for (j = SEC_BUF_POOL_CACHE_MOVE_SIZE; j < SEC_BUF_POOL_CACHE_SIZE; j++)
+            {
+                cache->bufs[j - SEC_BUF_POOL_CACHE_MOVE_SIZE] = cache->bufs[j];
+            }
+            cache->count -= SEC_BUF_POOL_CACHE_MOVE_SIZE;
+        }
+        cache->bufs[cache->count++] = idx;
+    }
+}
+
+void sec_buf_pool_flush_cache(sec_buf_pool_t *pool)
+{
+    sec_buf_pool_cache_t *cache = NULL;
+
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    cache = buf_pool_get_cache(pool);
+    if (cache == NULL || cache->count == 0)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    if (likely(pool->free_no + cache->count <= pool->bufs_no))
+    {
+        memcpy(&pool->free_bufs[pool->free_no], cache->bufs, cache->count * sizeof(uint32_t));
+        pool->free_no += cache->count;
+    }
+    else
+    {
+        SEC_ERROR("More buffers freed than allocated, %u buffers are dropped", cache->count);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    cache->count = 0;
+}
+
+uint32_t sec_buf_pool_get_free_no(sec_buf_pool_t *pool)
+{
+    uint32_t free_no = 0;
+    int i = 0;
+
+    if (pool == NULL)
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    free_no = pool->free_no;
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < SEC_BUF_POOL_MAX_CACHES; i++)
+    {
+        free_no += pool->caches[i].count;
+    }
+
+    return free_no;
+}
+
+dma_addr_t sec_buf_pool_vtop(const sec_buf_pool_t *pool, void *v)
+{
+    SEC_ASSERT(pool != NULL, 0, "NULL pool handle");
+
+    return pool->phys_start + (dma_addr_t)((uint8_t*)v - pool->start);
+}
+
+void* sec_buf_pool_ptov(const sec_buf_pool_t *pool, dma_addr_t p)
+{
+    SEC_ASSERT(pool != NULL, NULL, "NULL pool handle");
+
+    return pool->start + (p - pool->phys_start);
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,144 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SEC_BURST_H
+#define SEC_BURST_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include <string.h>
+#include "fsl_sec.h"
+#include "sec_utils.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+#if (SEC_BURST_REORDER_WINDOW < 1)
+#error "SEC_BURST_REORDER_WINDOW must be at least 1"
+#endif
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Reorders a window of a burst so that the packets of each context are
+ * consecutive.
+ *
+ * The contexts are ordered by their first packet in the window, and the packets
+ * of a context keep their relative order. The comparisons are done on the context
+ * handles only, so that the contexts are not read.
+ *
+ * @param [in,out] packets      The packets of the window.
+ * @param [in]     packets_no   Number of packets, at most #SEC_BURST_REORDER_WINDOW.
+ *
+ * @retval The number of contexts in the window, i.e. the number of shared
+ *         descriptor fetches needed by SEC for the window.
+ */
+static inline uint32_t group_burst_by_context(sec_burst_packet_t *packets,
+                                              uint32_t packets_no)
+{
+    sec_burst_packet_t window[SEC_BURST_REORDER_WINDOW];
+    uint8_t grouped[SEC_BURST_REORDER_WINDOW];
+    uint32_t groups_no = 0;
+    uint32_t out = 0;
+    uint32_t i, j;
+
+    ASSERT(packets_no <= SEC_BURST_REORDER_WINDOW);
+
+    if (packets_no < 2)
+    {
+        return packets_no;
+    }
+
+    memcpy(window, packets, packets_no * sizeof(sec_burst_packet_t));
+    memset(grouped, 0, packets_no);
+
+    for (i = 0; i < packets_no; i++)
+    {
+        if (grouped[i])
+        {
+            continue;
+        }
+        groups_no++;
+
+        // Packet i is the first of its context, the other ones follow it
+        packets[out++] = window[i];
+        for (j = i + 1; j < packets_no; j++)
+        {
+            if (grouped[j] == 0 &&
+                window[j].sec_ctx_handle == window[i].sec_ctx_handle)
+            {
+                grouped[j] = 1;
+                packets[out++] = window[j];
+            }
+        }
+    }
+    ASSERT(out == packets_no);
+
+    return groups_no;
+}
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_BURST_H */
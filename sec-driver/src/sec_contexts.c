@@ -191,8 +191,13 @@ static void free_in_use_context(sec_contexts_pool_t * pool, sec_context_t * ctx)
     ctx->state = SEC_CONTEXT_UNUSED;
     ctx->pi = 0;
     ctx->ci = 0;
+#if (SEC_ENABLE_CPU_JOBS == ON)
+    ctx->hw_pi = 0;
+    ctx->hw_ci = 0;
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
     ctx->notify_packet_cbk = NULL;
     ctx->jr_handle = NULL;
+    ctx->dpovrd_en = FALSE;
     ctx->crypto_info.pdcp_crypto_info = NULL;
 
     // add context to free list
@@ -232,8 +237,13 @@ static void node_modify_after_delete(struct list_head *node)
     ctx->state = SEC_CONTEXT_UNUSED;
     ctx->pi = 0;
     ctx->ci = 0;
+#if (SEC_ENABLE_CPU_JOBS == ON)
+    ctx->hw_pi = 0;
+    ctx->hw_ci = 0;
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
     ctx->notify_packet_cbk = NULL;
     ctx->jr_handle = NULL;
+    ctx->dpovrd_en = FALSE;
 
 }
 
@@ -274,13 +284,14 @@ static void run_contexts_garbage_colector(sec_contexts_pool_t * pool)
 
 sec_return_code_t init_contexts_pool(sec_contexts_pool_t * pool,
                                      uint32_t number_of_contexts,
-                                     void **dma_mem,
+                                     sec_dma_mem_arena_t *dma_arena,
                                      uint8_t thread_safe)
 {
     int i = 0;
     sec_context_t * ctx = NULL;
 
     ASSERT(pool != NULL);
+    ASSERT(dma_arena != NULL);
     ASSERT(thread_safe == THREAD_SAFE_POOL || thread_safe == THREAD_UNSAFE_POOL);
 
     if (number_of_contexts == 0)
@@ -288,6 +299,18 @@ sec_return_code_t init_contexts_pool(sec_contexts_pool_t * pool,
         return SEC_INVALID_INPUT_PARAM;
     }
 
+    // Allocate the shared descriptors of all the contexts in one region
+    pool->dma_arena = dma_arena;
+    pool->dma_mem_size = 0;
+    pool->sh_descs = dma_mem_alloc(dma_arena,
+                                   number_of_contexts * SEC_CRYPTO_DESCRIPTOR_SIZE,
+                                   L1_CACHE_BYTES,
+                                   &pool->dma_mem_size);
+    if (pool->sh_descs == NULL)
+    {
+        return SEC_OUT_OF_MEMORY;
+    }
+
     // init lists
     list_init(&pool->free_list, thread_safe);
     list_init(&pool->retire_list, thread_safe);
@@ -299,6 +322,10 @@ sec_return_code_t init_contexts_pool(sec_contexts_pool_t * pool,
     if (pool->sec_contexts == NULL)
     {
         // failed to allocate memory
+        dma_mem_free(dma_arena, pool->sh_descs,
+                     number_of_contexts * SEC_CRYPTO_DESCRIPTOR_SIZE,
+                     &pool->dma_mem_size);
+        pool->sh_descs = NULL;
         return SEC_OUT_OF_MEMORY;
     }
 
@@ -315,13 +342,8 @@ sec_return_code_t init_contexts_pool(sec_contexts_pool_t * pool,
         ctx->ci = 0;
         ctx->pool = pool;
 
-        SEC_ASSERT ((uintptr_t)*dma_mem % L1_CACHE_BYTES == 0,
-                      SEC_INVALID_INPUT_PARAM,
-                      "Current memory position is not cacheline aligned."
-                      "Context= %p", ctx);
-        ctx->sh_desc = (struct sec_sd_t*)*dma_mem;
+        ctx->sh_desc = (struct sec_sd_t*)((uint8_t*)pool->sh_descs + i * SEC_CRYPTO_DESCRIPTOR_SIZE);
         memset(ctx->sh_desc, 0, SEC_CRYPTO_DESCRIPTOR_SIZE);
-        *dma_mem += SEC_CRYPTO_DESCRIPTOR_SIZE;
 
         ctx->sh_desc_phys = g_sec_vtop(ctx->sh_desc);
 
@@ -340,6 +362,7 @@ sec_return_code_t init_contexts_pool(sec_contexts_pool_t * pool,
         pool->free_list.add_tail(&pool->free_list, &ctx->node);
     }
 
+    pool->no_of_contexts = number_of_contexts;
     pool->is_initialized = TRUE;
 
     return SEC_SUCCESS;
@@ -367,6 +390,11 @@ void destroy_contexts_pool(sec_contexts_pool_t * pool)
         pool->sec_contexts = NULL;
     }
 
+    // return the shared descriptors to the DMA memory arena
+    dma_mem_free(pool->dma_arena, pool->sh_descs,
+                 pool->no_of_contexts * SEC_CRYPTO_DESCRIPTOR_SIZE,
+                 &pool->dma_mem_size);
+
     memset(pool, 0, sizeof(sec_contexts_pool_t));
 }
 
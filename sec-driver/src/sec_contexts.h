@@ -49,6 +49,10 @@ extern "C"{
 #include "fsl_sec.h"
 #include "sec_utils.h"
 #include "sec_hw_specific.h"
+#include "sec_dma_mem.h"
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#include "sec_sw_crypto.h"
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
 
 /*==================================================================================================
                                        DEFINES AND MACROS
@@ -59,6 +63,10 @@ extern "C"{
 #define THREAD_SAFE_POOL    THREAD_SAFE_LIST
 #define THREAD_UNSAFE_POOL  THREAD_UNSAFE_LIST
 
+/** DMA memory allocated by init_contexts_pool() for a pool of contexts_no contexts */
+#define SEC_CONTEXTS_POOL_DMA_MEM_SIZE(contexts_no) \
+    SEC_DMA_MEM_REGION_SIZE((contexts_no) * SEC_CRYPTO_DESCRIPTOR_SIZE)
+
 /** Get number of in flight packets yet to be processed for this context. */
 #define CONTEXT_GET_PACKETS_NO(ctx) ((ctx)->pi - (ctx)->ci)
 /** Increment producer index for this context */
@@ -66,6 +74,29 @@ extern "C"{
 /** Increment consumer index for this context */
 #define CONTEXT_CONSUME_PACKET(ctx) ((ctx)->ci++)
 
+#if (SEC_ENABLE_CPU_JOBS == ON)
+/** Get number of packets submitted to SEC hardware and not yet notified for this context. */
+#define CONTEXT_GET_HW_PACKETS_NO(ctx)  ((ctx)->hw_pi - (ctx)->hw_ci)
+/** Increment producer index of packets enqueued to SEC hardware for this context */
+#define CONTEXT_ADD_HW_PACKET(ctx)      ((ctx)->hw_pi++)
+/** Increment consumer index of packets dequeued from SEC hardware for this context.
+ *  The job must be read before the producer sees it consumed. */
+#define CONTEXT_CONSUME_HW_PACKET(ctx)  do { __sync_synchronize(); (ctx)->hw_ci++; } while(0)
+#else
+#define CONTEXT_ADD_HW_PACKET(ctx)
+#define CONTEXT_CONSUME_HW_PACKET(ctx)
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+/** Add value to a counter of this context */
+#define CONTEXT_COUNT(ctx, counter, value)  ((ctx)->counters.counter += (value))
+/** Record the time base of the last notification for this context */
+#define CONTEXT_SET_ACTIVITY(ctx, tb)       ((ctx)->counters.last_activity = (tb))
+#else
+#define CONTEXT_COUNT(ctx, counter, value)
+#define CONTEXT_SET_ACTIVITY(ctx, tb)
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+
 /** Validation bit pattern. A valid sec_context_t item would contain
  * this pattern at predefined position/s in the item itself. */
 #define CONTEXT_VALIDATION_PATTERN  0xF0A955CD
@@ -87,6 +118,22 @@ typedef enum sec_context_usage_e
 /** Forward structure declaration */
 typedef struct sec_context_t sec_context_t;
 
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+/** Counters of a SEC context. Written only by the thread that polls the job ring
+ * of the context, so they are kept on a cache line apart from pi, written by the
+ * producer thread. Cleared when the context is created. */
+typedef struct sec_context_counters_s
+{
+    uint64_t packets;
+    uint64_t bytes;
+    uint64_t icv_failures;
+    uint64_t hfn_threshold_reached;
+    uint64_t overdue;
+    uint64_t errors;
+    uint32_t last_activity;
+}____cacheline_aligned sec_context_counters_t;
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+
 /** The declaration of a context pool. */
 typedef struct sec_contexts_pool_s
 {
@@ -103,6 +150,12 @@ typedef struct sec_contexts_pool_s
     uint16_t is_initialized;
     /* SEC contexts in this pool */
     struct sec_context_t *sec_contexts;
+    /* Shared descriptors of the contexts, allocated from DMA-capable memory */
+    struct sec_sd_t *sh_descs;
+    /* The DMA memory arena from where the shared descriptors were allocated */
+    sec_dma_mem_arena_t *dma_arena;
+    /* Number of bytes of DMA-capable memory allocated by this pool */
+    uint32_t dma_mem_size;
 
 }sec_contexts_pool_t;
 
@@ -165,6 +218,44 @@ struct sec_context_t
     dma_addr_t              sh_desc_phys;
      /** Enable DPOVRD mechanism for this context */
      uint32_t               dpovrd_en;
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+    /** Keystream pre-generated on the CPU for the next COUNT values.
+     *  NULL if the keystream cache is not enabled for this context. */
+    struct sec_ks_cache_t *ks_cache;
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+    /** #TRUE if the packets of this context can be ciphered on the CPU by the
+     *  hybrid dispatcher. Set when the context is created. */
+    uint32_t cpu_capable;
+    /** Expanded AES key used on the CPU. Valid if cpu_capable is set and the
+     *  cipher algorithm is AES. */
+    uint32_t sw_aes_rk[SEC_SW_AES128_RK_WORDS];
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#if (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+    /** #TRUE if the packets of this context are only copied, so that they can be
+     *  processed on the CPU without a SEC job. Set when the context is created. */
+    uint32_t null_passthrough;
+#endif // (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+#if (SEC_ENABLE_LATENCY_STATS == ON)
+    /** Histogram of the job ring where the latencies of the packets of this
+     *  context are recorded. Set when the context is created. */
+    sec_latency_class_t latency_class;
+#endif // (SEC_ENABLE_LATENCY_STATS == ON)
+#if (SEC_ENABLE_CPU_JOBS == ON)
+    /** Number of packets of this context enqueued to SEC hardware.
+     *  Packets processed on the CPU are not counted here.
+     *  Written only by the producer thread. */
+    uint32_t hw_pi;
+    /** Number of packets of this context dequeued from SEC hardware.
+     *  Written only by the consumer thread. A stale value read by the producer
+     *  can only make it see more packets in flight than there are. The producer
+     *  issues a barrier after reading it, before it uses the CPU job ring. */
+    uint32_t hw_ci;
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+    /** Counters of the packets notified for this context. */
+    sec_context_counters_t counters;
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
     /** Validation pattern at end of structure. */
     uint32_t end_pattern;
 }____cacheline_aligned;
@@ -188,14 +279,15 @@ struct sec_context_t
  *
  * @param [in] pool                Pointer to a sec context pool structure.
  * @param [in] number_of_contexts  The number of contexts to allocated for this pool.
- * @param [in,out] dma_mem         DMA-capable memory area from where to
- *                                 allocate shared descriptors.
+ * @param [in,out] dma_arena       DMA memory arena from where to allocate
+ *                                 shared descriptors. They are returned to the
+ *                                 arena by destroy_contexts_pool().
  * @param [in] thread_safe         Configure the thread safeness.
  *                                 Valid values: #THREAD_SAFE_POOL, #THREAD_UNSAFE_POOL
  */
 sec_return_code_t init_contexts_pool(sec_contexts_pool_t *pool,
                                      uint32_t number_of_contexts,
-                                     void **dma_mem,
+                                     sec_dma_mem_arena_t *dma_arena,
                                      uint8_t thread_safe);
 
 /** @brief Destroy a pool of sec contexts.
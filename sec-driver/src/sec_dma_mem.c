@@ -0,0 +1,306 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <string.h>
+#include "fsl_sec.h"
+#include "sec_dma_mem.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+sec_return_code_t dma_mem_init(sec_dma_mem_arena_t *arena, void *start, uint32_t size)
+{
+    ASSERT(arena != NULL);
+
+    if ((uintptr_t)start % L1_CACHE_BYTES != 0)
+    {
+        SEC_ERROR("DMA memory area %p is not cacheline aligned", start);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    memset(arena, 0, sizeof(sec_dma_mem_arena_t));
+    pthread_mutex_init(&arena->mutex, NULL);
+
+    arena->start = start;
+    // Keep the end cacheline aligned too, all regions are multiples of a cacheline
+    arena->size = size & ~(uint32_t)(L1_CACHE_BYTES - 1);
+
+    if (arena->size != 0)
+    {
+        arena->free_regions[0].offset = 0;
+        arena->free_regions[0].size = arena->size;
+        arena->free_regions_no = 1;
+    }
+
+    return SEC_SUCCESS;
+}
+
+void* dma_mem_alloc(sec_dma_mem_arena_t *arena,
+                    uint32_t size,
+                    uint32_t alignment,
+                    uint32_t *account)
+{
+    sec_dma_mem_region_t *region = NULL;
+    uint32_t region_size = SEC_DMA_MEM_REGION_SIZE(size);
+    uint32_t offset = 0;
+    uint32_t pad = 0;
+    uint32_t tail = 0;
+    uint8_t *ptr = NULL;
+    int i = 0;
+
+    ASSERT(arena != NULL);
+
+    if (alignment < L1_CACHE_BYTES)
+    {
+        alignment = L1_CACHE_BYTES;
+    }
+    if (size == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&arena->mutex);
+
+    for (i = 0; i < arena->free_regions_no; i++)
+    {
+        region = &arena->free_regions[i];
+
+        // Alignment is required for the virtual address, not for the offset
+        offset = (((uintptr_t)arena->start + region->offset + alignment - 1) &
+                  ~(uintptr_t)(alignment - 1)) - (uintptr_t)arena->start;
+        pad = offset - region->offset;
+        if (pad > region->size || region->size - pad < region_size)
+        {
+            continue;
+        }
+        tail = region->size - pad - region_size;
+
+        if (pad != 0 && tail != 0)
+        {
+            // The region is split in two, one more entry is needed
+            if (arena->free_regions_no == SEC_DMA_MEM_MAX_FREE_REGIONS)
+            {
+                continue;
+            }
+            memmove(&arena->free_regions[i + 2], &arena->free_regions[i + 1],
+                    (arena->free_regions_no - i - 1) * sizeof(sec_dma_mem_region_t));
+            arena->free_regions[i + 1].offset = offset + region_size;
+            arena->free_regions[i + 1].size = tail;
+            arena->free_regions_no++;
+            region->size = pad;
+        }
+        else if (pad != 0)
+        {
+            region->size = pad;
+        }
+        else if (tail != 0)
+        {
+            region->offset += region_size;
+            region->size = tail;
+        }
+        else
+        {
+            memmove(&arena->free_regions[i], &arena->free_regions[i + 1],
+                    (arena->free_regions_no - i - 1) * sizeof(sec_dma_mem_region_t));
+            arena->free_regions_no--;
+        }
+
+        arena->used_size += region_size;
+        if (arena->used_size > arena->max_used_size)
+        {
+            arena->max_used_size = arena->used_size;
+        }
+        if (account != NULL)
+        {
+            *account += region_size;
+        }
+        ptr = arena->start + offset;
+        break;
+    }
+
+    pthread_mutex_unlock(&arena->mutex);
+
+    if (ptr == NULL)
+    {
+        SEC_ERROR("No free DMA memory for %u bytes (used %u of %u bytes)",
+                  region_size, arena->used_size, arena->size);
+    }
+
+    return ptr;
+}
+
+void dma_mem_free(sec_dma_mem_arena_t *arena,
+                  void *ptr,
+                  uint32_t size,
+                  uint32_t *account)
+{
+    sec_dma_mem_region_t *prev = NULL;
+    sec_dma_mem_region_t *next = NULL;
+    uint32_t region_size = SEC_DMA_MEM_REGION_SIZE(size);
+    uint32_t offset = 0;
+    int i = 0;
+
+    ASSERT(arena != NULL);
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    if ((uint8_t*)ptr < arena->start || region_size > arena->size ||
+        (uintptr_t)ptr - (uintptr_t)arena->start > arena->size - region_size)
+    {
+        SEC_ERROR("Region %p of %u bytes is outside DMA memory area %p", ptr, size, arena->start);
+        return;
+    }
+    offset = (uintptr_t)ptr - (uintptr_t)arena->start;
+
+    pthread_mutex_lock(&arena->mutex);
+
+    // Find the free regions around this one
+    for (i = 0; i < arena->free_regions_no && arena->free_regions[i].offset < offset; i++);
+    prev = (i > 0) ? &arena->free_regions[i - 1] : NULL;
+    next = (i < arena->free_regions_no) ? &arena->free_regions[i] : NULL;
+
+    if ((prev != NULL && prev->offset + prev->size > offset) ||
+        (next != NULL && offset + region_size > next->offset))
+    {
+        pthread_mutex_unlock(&arena->mutex);
+        SEC_ERROR("Region %p of %u bytes is already free", ptr, size);
+        return;
+    }
+
+    if (prev != NULL && prev->offset + prev->size == offset &&
+        next != NULL && offset + region_size == next->offset)
+    {
+        prev->size += region_size + next->size;
+        memmove(next, next + 1, (arena->free_regions_no - i - 1) * sizeof(sec_dma_mem_region_t));
+        arena->free_regions_no--;
+    }
+    else if (prev != NULL && prev->offset + prev->size == offset)
+    {
+        prev->size += region_size;
+    }
+    else if (next != NULL && offset + region_size == next->offset)
+    {
+        next->offset = offset;
+        next->size += region_size;
+    }
+    else if (arena->free_regions_no < SEC_DMA_MEM_MAX_FREE_REGIONS)
+    {
+        memmove(&arena->free_regions[i + 1], &arena->free_regions[i],
+                (arena->free_regions_no - i) * sizeof(sec_dma_mem_region_t));
+        arena->free_regions[i].offset = offset;
+        arena->free_regions[i].size = region_size;
+        arena->free_regions_no++;
+    }
+    else
+    {
+        // Still accounted as freed, but it cannot be reused until the arena is reinitialized
+        SEC_ERROR("Too many free DMA memory regions, region %p of %u bytes is lost", ptr, size);
+    }
+
+    arena->used_size -= region_size;
+    if (account != NULL)
+    {
+        *account -= region_size;
+    }
+
+    pthread_mutex_unlock(&arena->mutex);
+}
+
+uint32_t dma_mem_get_largest_free(sec_dma_mem_arena_t *arena)
+{
+    uint32_t largest = 0;
+    int i = 0;
+
+    ASSERT(arena != NULL);
+
+    pthread_mutex_lock(&arena->mutex);
+    for (i = 0; i < arena->free_regions_no; i++)
+    {
+        if (arena->free_regions[i].size > largest)
+        {
+            largest = arena->free_regions[i].size;
+        }
+    }
+    pthread_mutex_unlock(&arena->mutex);
+
+    return largest;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,165 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SEC_DMA_MEM_H
+#define SEC_DMA_MEM_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include <pthread.h>
+#include "fsl_sec.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+/** Maximum number of disjoint free regions tracked by a DMA memory arena.
+ * Adjacent free regions are merged, so the limit is reached only if the
+ * arena is badly fragmented. */
+#define SEC_DMA_MEM_MAX_FREE_REGIONS    64
+
+/** Size of a region allocated for size bytes. Regions are multiples of a
+ * cacheline, so that no two users share a cacheline written by SEC. */
+#define SEC_DMA_MEM_REGION_SIZE(size)   \
+    (((size) + L1_CACHE_BYTES - 1) & ~(uint32_t)(L1_CACHE_BYTES - 1))
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+/** A free region of a DMA memory arena */
+typedef struct sec_dma_mem_region_s
+{
+    uint32_t offset;                        /*< Offset of the region from the start of the arena */
+    uint32_t size;                          /*< Size of the region in bytes */
+}sec_dma_mem_region_t;
+
+/** The DMA-capable memory area provided by UA, from where the driver allocates
+ * the data structures accessed by SEC.
+ *
+ * The free regions are kept sorted by offset and adjacent ones are merged when
+ * memory is freed. Every allocation is charged to an account kept by its user,
+ * so that the consumption of each job ring and context pool is known exactly.
+ */
+typedef struct sec_dma_mem_arena_s
+{
+    uint8_t *start;                         /*< Virtual start address of the area */
+    uint32_t size;                          /*< Size of the area in bytes */
+    uint32_t used_size;                     /*< Bytes currently allocated */
+    uint32_t max_used_size;                 /*< Highest value reached by used_size */
+    uint32_t free_regions_no;               /*< Number of valid entries in free_regions */
+    sec_dma_mem_region_t free_regions[SEC_DMA_MEM_MAX_FREE_REGIONS]; /*< Free regions, sorted by offset */
+    pthread_mutex_t mutex;                  /*< Serializes allocations from different threads */
+}sec_dma_mem_arena_t;
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Initializes a DMA memory arena over a memory area, all of it free.
+ *
+ * @param [out] arena       The arena.
+ * @param [in]  start       Start of the memory area. Must be cacheline aligned.
+ * @param [in]  size        Size of the memory area in bytes.
+ *
+ * @retval #SEC_SUCCESS for success
+ * @retval #SEC_INVALID_INPUT_PARAM if the memory area is not cacheline aligned
+ */
+sec_return_code_t dma_mem_init(sec_dma_mem_arena_t *arena, void *start, uint32_t size);
+
+/** @brief Allocates a region from a DMA memory arena.
+ *
+ * The first free region large enough is used. The size is rounded up with
+ * #SEC_DMA_MEM_REGION_SIZE and the start is aligned to at least a cacheline.
+ *
+ * @param [in,out] arena        The arena.
+ * @param [in]     size         Number of bytes requested.
+ * @param [in]     alignment    Required alignment, a power of 2.
+ * @param [in,out] account      Number of bytes allocated by the user, incremented with
+ *                              the size of the region. Can be NULL.
+ *
+ * @retval Start of the region or NULL if no free region is large enough.
+ */
+void* dma_mem_alloc(sec_dma_mem_arena_t *arena,
+                    uint32_t size,
+                    uint32_t alignment,
+                    uint32_t *account);
+
+/** @brief Returns a region to a DMA memory arena, to be reused by later allocations.
+ *
+ * @param [in,out] arena        The arena.
+ * @param [in]     ptr          Start of the region, as returned by dma_mem_alloc(). Can be NULL.
+ * @param [in]     size         Number of bytes requested when the region was allocated.
+ * @param [in,out] account      The account charged by dma_mem_alloc(). Can be NULL.
+ */
+void dma_mem_free(sec_dma_mem_arena_t *arena,
+                  void *ptr,
+                  uint32_t size,
+                  uint32_t *account);
+
+/** @brief Returns the size of the largest free region of a DMA memory arena.
+ *
+ * @param [in] arena    The arena.
+ *
+ * @retval Size in bytes.
+ */
+uint32_t dma_mem_get_largest_free(sec_dma_mem_arena_t *arena);
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_DMA_MEM_H */
@@ -46,9 +46,26 @@ extern "C" {
 #include "sec_pdcp.h"
 #include "sec_rlc.h"
 #include "sec_hw_specific.h"
+#include "sec_dma_mem.h"
+#include "sec_burst.h"
+#include "sec_latency.h"
+#include "sec_log.h"
+#include "sec_trace.h"
 #if (SEC_ENABLE_SCATTER_GATHER == ON)
 #include "sec_sg_utils.h"
 #endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+#include "sec_keystream_cache.h"
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+#if (SEC_ENABLE_CPU_JOBS == ON)
+#include "sec_sw_crypto.h"
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+#include "sec_mem_map.h"
+#endif // (SEC_ENABLE_IOV_SUBMISSION == ON)
+#if (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+#include "sec_null_passthrough.h"
+#endif // (SEC_ENABLE_NULL_PASSTHROUGH == ON)
 #include <stdio.h>
 
 /*==================================================================================================
@@ -66,6 +83,10 @@ extern "C" {
 /** Define an invalid value for a pthread key. */
 #define SEC_PTHREAD_KEY_INVALID     ((pthread_key_t)(~0))
 
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON) && ((SEC_HYBRID_MAX_PAYLOAD % SEC_SW_AES_BLOCK_SIZE) != 0)
+#error "SEC_HYBRID_MAX_PAYLOAD must be a multiple of 16!"
+#endif
+
 
 /**  Macro for the initialization of the g_sec_errno thread-local key. */
 #define SEC_INIT_ERRNO_KEY() \
@@ -118,6 +139,16 @@ typedef struct sec_job_t sec_job_t;
 
 /** Forward structure declaration */
 typedef struct sec_descriptor_t sec_descriptor_t;
+
+#if (SEC_JOB_STORES_PACKETS == ON)
+/** Packets of a dequeued job that were stored by the driver, saved for the
+ * callback. The job can be reused by the producer thread once it is freed. */
+typedef struct sec_saved_packets_s
+{
+    sec_packet_t in[SEC_JOB_MAX_STORED_FRAGMENTS];   /*< Input packet and its fragments */
+    sec_packet_t out[SEC_JOB_MAX_STORED_FRAGMENTS];  /*< Output packet and its fragments */
+}sec_saved_packets_t;
+#endif // (SEC_JOB_STORES_PACKETS == ON)
 /*==================================================================================================
                                       LOCAL CONSTANTS
 ==================================================================================================*/
@@ -145,6 +176,16 @@ static unsigned int g_last_jr_assigned = 0;
 /* Global context pool */
 static sec_contexts_pool_t g_ctx_pool;
 
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+/* #SEC_POLL_AUTOTUNE_LATENCY_BUDGET_US converted to time base ticks in sec_init() */
+static uint32_t g_poll_latency_budget = 0;
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+/* Memory regions registered by UA, for the packets submitted with sec_process_packet_iov() */
+static sec_mem_map_t g_mem_map;
+#endif // (SEC_ENABLE_IOV_SUBMISSION == ON)
+
 /** String representation for values from  ::sec_status_t
  * @note Order of values from g_status_string MUST match the same order
  *       used to define status values in ::sec_status_t ! */
@@ -187,10 +228,9 @@ static const char g_return_code_descriptions[][MAX_STRING_REPRESENTATION_LENGTH]
 /*==================================================================================================
                                      GLOBAL VARIABLES
 ==================================================================================================*/
-/** Start address for DMA-able memory area configured by UA */
-void* g_dma_mem_start = NULL;
-/** Current address for unused DMA-able memory area configured by UA */
-void* g_dma_mem_free = NULL;
+/** DMA-able memory area configured by UA, from where the driver allocates
+ * the rings, descriptors and SG tables accessed by SEC */
+sec_dma_mem_arena_t g_dma_arena;
 /** A key used to access the SEC driver's errno variable on a thread-local basis.
  * The SEC driver uses this variable similar to libc's errno for
  * passing error codes to the User Application. */
@@ -205,6 +245,11 @@ uint32_t g_sec_errno_value = SEC_SUCCESS;
  */
 sec_vtop g_sec_vtop = NULL;
 
+/** Global function for physical to virtual translation of the packets
+ * processed on the CPU. Optional, can be NULL.
+ */
+sec_ptov g_sec_ptov = NULL;
+
 /*==================================================================================================
                                  LOCAL FUNCTION PROTOTYPES
 ==================================================================================================*/
@@ -259,6 +304,16 @@ static void hw_flush_job_ring(sec_job_ring_t *job_ring,
  */
 static void flush_job_rings();
 
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+/** @brief Account one poll of a job ring done by sec_poll() and, at the end
+ * of a window of #SEC_POLL_AUTOTUNE_WINDOW polls, adjust the weight of the job ring.
+ *
+ * @param [in,out] job_ring         Job ring
+ * @param [in]     notified_packets Number of packets notified by the poll
+ */
+static void poll_autotune(sec_job_ring_t *job_ring, uint32_t notified_packets);
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+
 /** @brief Handle packet that generated error in SEC engine.
  * Identify the exact type of error and handle the error.
  * Depending on the error type, the job ring could be reset.
@@ -289,6 +344,198 @@ static void sec_handle_packet_error(sec_job_ring_t *job_ring,
 static int sec_update_job_descriptor(sec_context_t *ctx,
                                      sec_job_t *job,
                                      sec_descriptor_t *descriptor);
+
+#if (SEC_JOB_STORES_PACKETS == ON)
+/** @brief Saves the input and output packets of a dequeued job for the callback,
+ * if they are stored by the driver in the job or in the job ring. The packets
+ * owned by UA are not copied.
+ *
+ * @param [in]  job_ring        The job ring.
+ * @param [in]  job             The job, about to be freed.
+ * @param [out] saved_job       Its in_packet and out_packet are set to the packets
+ *                              to be notified to UA.
+ * @param [out] saved_packets   Storage for the saved packets.
+ */
+static inline void save_job_packets(const sec_job_ring_t *job_ring,
+                                    const sec_job_t *job,
+                                    sec_job_t *saved_job,
+                                    sec_saved_packets_t *saved_packets);
+#endif // (SEC_JOB_STORES_PACKETS == ON)
+
+#if (SEC_ENABLE_CPU_JOBS == ON)
+/** @brief Notify to UA the packets processed on the CPU for a job ring, or silently
+ * discard them.
+ *
+ * @param [in,out] job_ring         The job ring.
+ * @param [in]     limit            The maximum number of packets to notify.
+ *                                  If set to negative value, all available packets are notified.
+ * @param [in]     do_notify        Can be #TRUE or #FALSE. Indicates if packets are to be
+ *                                  discarded or notified to UA.
+ * @param [out]    stop_processing  Is set to #TRUE if User App callback returned #SEC_RETURN_STOP.
+ *                                  Can be NULL if do_notify is #FALSE.
+ *
+ * @retval Number of packets notified or discarded.
+ */
+static uint32_t cpu_poll_job_ring(sec_job_ring_t *job_ring,
+                                  int32_t limit,
+                                  uint32_t do_notify,
+                                  int *stop_processing);
+
+/** @brief Add a packet processed on the CPU to the ring of CPU jobs of a job ring,
+ * to be notified to UA on the next poll. The caller checks there is room in the ring.
+ *
+ * @param [in] job_ring         The job ring of the context.
+ * @param [in] sec_context      The SEC context.
+ * @param [in] in_packet        Input packet.
+ * @param [in] out_packet       Output packet.
+ * @param [in] ua_ctx_handle    The UA handle for the packet.
+ * @param [in] status           The status to notify.
+ */
+static inline void enqueue_cpu_job(sec_job_ring_t *job_ring,
+                                   sec_context_t *sec_context,
+                                   const sec_packet_t *in_packet,
+                                   const sec_packet_t *out_packet,
+                                   ua_context_handle_t ua_ctx_handle,
+                                   sec_status_t status);
+
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON) || (SEC_ENABLE_HYBRID_DISPATCH == ON)
+/** @brief Check if the packets of a PDCP context can be ciphered on the CPU:
+ * User Plane, HFN override, SNOW or AES with a 16 byte key, 7 or 12 bit SN
+ * and a P2V function configured by UA.
+ *
+ * @param [in] sec_context      The SEC context.
+ *
+ * @retval #TRUE or #FALSE
+ */
+static uint32_t pdcp_context_is_cpu_capable(sec_context_t *sec_context);
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON) || (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+/** @brief Try to cipher a PDCP User Plane packet on the CPU, using the keystream
+ * pre-generated for its COUNT.
+ *
+ * The packet is processed on the CPU only if keystream is available for it,
+ * it is not fragmented, it fits in a keystream cache entry and SEC has no other packets
+ * of this context in flight (so that the packets are notified to UA in order).
+ * The packet is notified to UA on the next poll of the job ring.
+ *
+ * @param [in] job_ring         The job ring of the context.
+ * @param [in] sec_context      The SEC context, having the keystream cache enabled.
+ * @param [in] in_packet        Input packet.
+ * @param [in] out_packet       Output packet.
+ * @param [in] hfn_ov_val       The HFN of the packet.
+ * @param [in] ua_ctx_handle    The UA handle for the packet.
+ *
+ * @retval #TRUE if the packet was processed on the CPU
+ * @retval #FALSE if the packet must be submitted to SEC
+ */
+static uint32_t process_packet_from_ks_cache(sec_job_ring_t *job_ring,
+                                             sec_context_t *sec_context,
+                                             const sec_packet_t *in_packet,
+                                             const sec_packet_t *out_packet,
+                                             uint32_t hfn_ov_val,
+                                             ua_context_handle_t ua_ctx_handle);
+
+/** @brief Release the keystream caches of the contexts from a pool
+ * that were not deleted by UA before sec_release().
+ *
+ * @param [in] pool     The pool of contexts.
+ */
+static void release_keystream_caches(sec_contexts_pool_t *pool);
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+
+#if (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+/** @brief Try to complete a packet of a NULL algorithm context on the CPU,
+ * see null_passthrough_process_packet(). The packet is notified to UA on the
+ * next poll of the job ring.
+ *
+ * @param [in] job_ring         The job ring of the context.
+ * @param [in] sec_context      The SEC context, with null_passthrough set.
+ * @param [in] in_packet        Input packet.
+ * @param [in] out_packet       Output packet.
+ * @param [in] hfn_ov_val       The HFN of the packet, if HFN override is enabled.
+ * @param [in] ua_ctx_handle    The UA handle for the packet.
+ *
+ * @retval #TRUE if the packet was processed on the CPU
+ * @retval #FALSE if the packet must be submitted to SEC
+ */
+static uint32_t process_null_packet_on_cpu(sec_job_ring_t *job_ring,
+                                           sec_context_t *sec_context,
+                                           const sec_packet_t *in_packet,
+                                           const sec_packet_t *out_packet,
+                                           uint32_t hfn_ov_val,
+                                           ua_context_handle_t ua_ctx_handle);
+#endif // (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+/** @brief Decide if a PDCP User Plane packet is ciphered on the CPU rather than
+ * on SEC and, if so, cipher it.
+ *
+ * Only packets of contexts without packets in flight in SEC are considered, so that
+ * the packets are notified to UA in order. A packet goes to the CPU if its payload is
+ * at most #SEC_HYBRID_SMALL_PAYLOAD bytes or, for payloads of up to #SEC_HYBRID_MAX_PAYLOAD
+ * bytes, if the job ring is congested or the measured SEC completion latency exceeds
+ * the estimated time to cipher the payload on the CPU.
+ * The packet is notified to UA on the next poll of the job ring.
+ *
+ * @param [in] job_ring         The job ring of the context.
+ * @param [in] sec_context      The SEC context, CPU capable.
+ * @param [in] in_packet        Input packet.
+ * @param [in] out_packet       Output packet.
+ * @param [in] hfn_ov_val       The HFN of the packet.
+ * @param [in] ua_ctx_handle    The UA handle for the packet.
+ *
+ * @retval #TRUE if the packet was processed on the CPU
+ * @retval #FALSE if the packet must be submitted to SEC
+ */
+static uint32_t dispatch_packet_to_cpu(sec_job_ring_t *job_ring,
+                                       sec_context_t *sec_context,
+                                       const sec_packet_t *in_packet,
+                                       const sec_packet_t *out_packet,
+                                       uint32_t hfn_ov_val,
+                                       ua_context_handle_t ua_ctx_handle);
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+
+#if (SEC_ENABLE_SCATTER_GATHER == ON)
+/** @brief Describes a packet to SEC for one direction of a job: either linearized
+ * in the bounce buffer of the job, if it is below the linearization thresholds of
+ * the job ring, or with SG tables taken from the pool of the job ring.
+ *
+ * @param [in] job_ring         The job ring of the job.
+ * @param [in] sg_ctx           The Scatter Gather context of the job.
+ * @param [in] packet           The packet.
+ * @param [in] dir              The 'direction' of the packet (input or output)
+ *
+ * @retval Same as build_sg_context()
+ */
+static inline sec_return_code_t prepare_sg_context(sec_job_ring_t *job_ring,
+                                                   sec_sg_context_t *sg_ctx,
+                                                   const sec_packet_t *packet,
+                                                   sec_sg_context_type_t dir);
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+
+/** @brief Submits a packet to the job ring of its context.
+ * Common part of sec_process_packet_hfn_ov() and sec_process_packet_sg_tbl().
+ *
+ * @param [in] sec_ctx_handle   The SEC context.
+ * @param [in] in_packet        Input packet.
+ * @param [in] out_packet       Output packet.
+ * @param [in] hfn_ov_val       The HFN of the packet.
+ * @param [in] ua_ctx_handle    The UA handle for the packet.
+ * @param [in] sg_tbls_phys     NULL to build the SG tables of fragmented packets from the
+ *                              pool of the job ring. Otherwise, the physical addresses of
+ *                              the input and output SG tables formatted by UA.
+ * @param [in] hw_only          If TRUE, the packet is always submitted to SEC. Used when the
+ *                              packets are stored in the job that is about to be enqueued.
+ */
+static sec_return_code_t process_packet(sec_context_handle_t sec_ctx_handle,
+                                        const sec_packet_t *in_packet,
+                                        const sec_packet_t *out_packet,
+                                        uint32_t hfn_ov_val,
+                                        ua_context_handle_t ua_ctx_handle,
+                                        const dma_addr_t *sg_tbls_phys,
+                                        uint32_t hw_only);
 /*==================================================================================================
                                      LOCAL FUNCTIONS
 ==================================================================================================*/
@@ -315,12 +562,18 @@ static void hw_flush_job_ring(sec_job_ring_t * job_ring,
     sec_context_t *sec_context = NULL;
     sec_job_t *job = NULL;
     sec_job_t saved_job;
+#if (SEC_JOB_STORES_PACKETS == ON)
+    sec_saved_packets_t saved_packets;
+#endif // (SEC_JOB_STORES_PACKETS == ON)
     sec_status_t new_status;
     int32_t jobs_no_to_discard = 0;
     int32_t discarded_packets_no = 0;
     int32_t number_of_jobs_available = 0;
     int ret;
     dma_addr_t  current_desc = 0;
+#if (SEC_ENABLE_CALLBACK_TIMING == ON)
+    uint32_t cbk_start = 0;
+#endif // (SEC_ENABLE_CALLBACK_TIMING == ON)
 
     SEC_DEBUG("Jr[%p] pi[%d] ci[%d].Flushing jr id %d.packet status[%d]."
               "SEC error code[0x%x]. notify packet=[%d]",
@@ -331,6 +584,7 @@ static void hw_flush_job_ring(sec_job_ring_t * job_ring,
 
     // Discard all jobs
     jobs_no_to_discard = number_of_jobs_available;
+    SEC_TRACE(SEC_TRACE_JR_FLUSH, job_ring->jr_id, jobs_no_to_discard);
 
     SEC_DEBUG("Jr[%p] pi[%d] ci[%d].Discarding %d packets",
               job_ring, job_ring->pidx, job_ring->cidx, jobs_no_to_discard);
@@ -359,11 +613,19 @@ static void hw_flush_job_ring(sec_job_ring_t * job_ring,
             // copy into a temporary job the fields from the job we need to raise callback
             // this is done to free the slot before the callback is called,
             // which we cannot control in terms of how much processing it will do.
+#if (SEC_JOB_STORES_PACKETS == ON)
+            save_job_packets(job_ring, job, &saved_job, &saved_packets);
+#else // (SEC_JOB_STORES_PACKETS == ON)
             saved_job.in_packet = job->in_packet;
             saved_job.out_packet = job->out_packet;
+#endif // (SEC_JOB_STORES_PACKETS == ON)
             saved_job.ua_handle = job->ua_handle;
         }
 
+#if (SEC_ENABLE_SCATTER_GATHER == ON)
+        release_sg_context(&job_ring->sg_tbl_pool, job->sg_ctx);
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+
         // Now increment the consumer index for the current job ring,
         // AFTER saving job in temporary location!
         // Increment the consumer index for the current job ring
@@ -384,17 +646,29 @@ static void hw_flush_job_ring(sec_job_ring_t * job_ring,
                 // no more packets can be submitted for it.
                 new_status = (CONTEXT_GET_PACKETS_NO(sec_context) > 1) ?
                     SEC_STATUS_OVERDUE : SEC_STATUS_LAST_OVERDUE;
+                CONTEXT_COUNT(sec_context, overdue, 1);
+            }
+            else if(new_status == SEC_STATUS_ERROR)
+            {
+                CONTEXT_COUNT(sec_context, errors, 1);
             }
+            CONTEXT_COUNT(sec_context, packets, 1);
+            CONTEXT_SET_ACTIVITY(sec_context, sec_get_timebase());
 
             // call the callback
+            SEC_TRACE(SEC_TRACE_CALLBACK_ENTER, job_ring->jr_id, new_status);
+            SEC_CBK_TIMING_START(cbk_start);
             ret = sec_context->notify_packet_cbk(saved_job.in_packet,
                     saved_job.out_packet,
                     saved_job.ua_handle,
                     new_status,
                     error_code);
+            SEC_CBK_TIMING_STOP(job_ring, cbk_start);
+            SEC_TRACE(SEC_TRACE_CALLBACK_EXIT, job_ring->jr_id, ret);
 
             // consume processed packet for this sec context
             CONTEXT_CONSUME_PACKET(sec_context);
+            CONTEXT_CONSUME_HW_PACKET(sec_context);
 
             // UA requested to exit
             if (ret == SEC_RETURN_STOP)
@@ -408,6 +682,7 @@ static void hw_flush_job_ring(sec_job_ring_t * job_ring,
         {
             // consume processed packet for this sec context
             CONTEXT_CONSUME_PACKET(sec_context);
+            CONTEXT_CONSUME_HW_PACKET(sec_context);
         }
     }
 
@@ -426,6 +701,9 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
     sec_context_t *sec_context = NULL;
     sec_job_t *job = NULL;
     sec_job_t saved_job;
+#if (SEC_JOB_STORES_PACKETS == ON)
+    sec_saved_packets_t saved_packets;
+#endif // (SEC_JOB_STORES_PACKETS == ON)
 
     int32_t jobs_no_to_notify = 0; // the number of done jobs to notify to UA
     sec_status_t status = SEC_STATUS_SUCCESS;
@@ -435,6 +713,12 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
     uint32_t sec_error_code = 0;
     int ret = 0;
     uint32_t do_driver_shutdown = FALSE;
+#if (SEC_POLL_TIMESTAMP == ON)
+    uint32_t now = 0;
+#endif // (SEC_POLL_TIMESTAMP == ON)
+#if (SEC_ENABLE_CALLBACK_TIMING == ON)
+    uint32_t cbk_start = 0;
+#endif // (SEC_ENABLE_CALLBACK_TIMING == ON)
 
     dma_addr_t current_desc;
 
@@ -449,6 +733,7 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
         SEC_ERRNO_SET(sec_error_code);
         return SEC_PROCESSING_ERROR;
     }
+    SEC_JR_COUNT(job_ring, rx_counters, polls, 1);
 
     // Compute the number of notifications that need to be raised to UA
     // If limit < 0 -> notify all done jobs
@@ -458,13 +743,42 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
 
     // compute the number of jobs available in the job ring based on the
     // producer and consumer index values.
+#if (SEC_ENABLE_CPU_JOBS == ON)
+    // Packets processed on the CPU were submitted before any packet
+    // still in flight in SEC for the same context, so notify them first.
+    notified_packets_no = cpu_poll_job_ring(job_ring, limit, TRUE, stop_processing);
+    if (*stop_processing == TRUE)
+    {
+        *packets_no = notified_packets_no;
+        return SEC_SUCCESS;
+    }
+    if (limit > 0)
+    {
+        limit -= notified_packets_no;
+    }
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+
     number_of_jobs_available = hw_get_no_finished_jobs(job_ring);
 
     jobs_no_to_notify = (limit < 0 || limit > number_of_jobs_available) ? number_of_jobs_available : limit;
+#if (SEC_ENABLE_CPU_JOBS == ON)
+    jobs_no_to_notify += notified_packets_no;
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+#if (SEC_POLL_TIMESTAMP == ON)
+    // One reading of the time base is enough for all the jobs dequeued now
+    if (jobs_no_to_notify > notified_packets_no)
+    {
+        now = sec_get_timebase();
+    }
+#endif // (SEC_POLL_TIMESTAMP == ON)
 
     SEC_DEBUG("Jr[%p] pi[%d] ci[%d].Jobs submitted %d.Jobs to notify %d",
               job_ring, job_ring->pidx, job_ring->cidx,
               number_of_jobs_available, jobs_no_to_notify);
+    if (jobs_no_to_notify > notified_packets_no)
+    {
+        SEC_TRACE(SEC_TRACE_HARVEST, job_ring->jr_id, jobs_no_to_notify - notified_packets_no);
+    }
 
     while(jobs_no_to_notify > notified_packets_no)
     {
@@ -490,7 +804,9 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
         {
             sec_error_code = 0;
             status = SEC_STATUS_HFN_THRESHOLD_REACHED;
-            SEC_INFO("SEC context[%p] in pkt[%p] out pkt[%p]."
+            SEC_JR_COUNT(job_ring, rx_counters, hfn_threshold_reached, 1);
+            CONTEXT_COUNT(job->sec_context, hfn_threshold_reached, 1);
+            SEC_DEBUG("SEC context[%p] in pkt[%p] out pkt[%p]."
                           "HFN threshold reached.",
                           job->sec_context, job->in_packet, job->out_packet);
         }
@@ -503,7 +819,11 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
         {
             sec_error_code = 0;
             status = SEC_STATUS_MAC_I_CHECK_FAILED;
-            SEC_ERROR("SEC context[%p] in pkt[%p] out pkt[%p]."
+            // Counted, not logged: a burst of failed packets, e.g. from a key
+            // mismatch, must not stall the poll thread on stderr.
+            SEC_JR_COUNT(job_ring, rx_counters, icv_failures, 1);
+            CONTEXT_COUNT(job->sec_context, icv_failures, 1);
+            SEC_DEBUG("SEC context[%p] in pkt[%p] out pkt[%p]."
                           "Integrity check FAILED!.",
                           job->sec_context, job->in_packet, job->out_packet);
         }
@@ -515,7 +835,7 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
                 // Errno value is thread-local.
                 SEC_ERRNO_SET(sec_error_code);
 
-                SEC_ERROR("Packet at cidx %d generated error 0x%x on job ring with id %d\n",
+                SEC_ERROR_RL("Packet at cidx %d generated error 0x%x on job ring with id %d\n",
                           job_ring->cidx, sec_error_code, job_ring->jr_id);
 
                 // flush jobs from JR, with error code set to callback
@@ -533,10 +853,43 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
         // copy into a temporary job the fields from the job we need to raise callback
         // this is done to free the slot before the callback is called,
         // which we cannot control in terms of how much processing it will do.
+#if (SEC_JOB_STORES_PACKETS == ON)
+        save_job_packets(job_ring, job, &saved_job, &saved_packets);
+#else // (SEC_JOB_STORES_PACKETS == ON)
         saved_job.in_packet = job->in_packet;
         saved_job.out_packet = job->out_packet;
+#endif // (SEC_JOB_STORES_PACKETS == ON)
         saved_job.ua_handle = job->ua_handle;
 
+        SEC_JR_COUNT(job_ring, rx_counters, packets, 1);
+        SEC_JR_COUNT(job_ring, rx_counters, bytes, SEC_PACKET_LENGTH(saved_job.out_packet));
+        CONTEXT_COUNT(sec_context, packets, 1);
+        CONTEXT_COUNT(sec_context, bytes, SEC_PACKET_LENGTH(saved_job.out_packet));
+        CONTEXT_SET_ACTIVITY(sec_context, now);
+
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+        // Moving average of the time from enqueue to dequeue, as seen by UA
+        job_ring->hw_latency += (int32_t)((now - job->submit_tb) - job_ring->hw_latency) >>
+                                SEC_HYBRID_EWMA_SHIFT;
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#if (SEC_ENABLE_LATENCY_STATS == ON)
+        sec_latency_record(&job_ring->latency_stats.hist[sec_context->latency_class],
+                           now - job->submit_tb);
+#endif // (SEC_ENABLE_LATENCY_STATS == ON)
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+        job_ring->poll_tuner.latency_sum += (uint32_t)(now - job->submit_tb);
+        job_ring->poll_tuner.latency_no++;
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+
+#if (SEC_ENABLE_SCATTER_GATHER == ON)
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+        // Before the bounce buffers of the job can be used by a new job
+        scatter_bounce_buf(job->sg_ctx, job->out_packet, g_sec_ptov);
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
+        // The SG tables of the job can be taken by new jobs
+        release_sg_context(&job_ring->sg_tbl_pool, job->sg_ctx);
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+
         // now increment the consumer index for the current job ring,
         // AFTER saving job in temporary location!
         job_ring->cidx = SEC_CIRCULAR_COUNTER(job_ring->cidx, SEC_JOB_RING_SIZE);
@@ -554,16 +907,22 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
             // no more packets can be submitted for it.
             status = (CONTEXT_GET_PACKETS_NO(sec_context) > 1) ?
                      SEC_STATUS_OVERDUE : SEC_STATUS_LAST_OVERDUE;
+            CONTEXT_COUNT(sec_context, overdue, 1);
         }
         // call the callback
+        SEC_TRACE(SEC_TRACE_CALLBACK_ENTER, job_ring->jr_id, status);
+        SEC_CBK_TIMING_START(cbk_start);
         ret = sec_context->notify_packet_cbk(saved_job.in_packet,
                                              saved_job.out_packet,
                                              saved_job.ua_handle,
                                              status,
                                              0); // no error
+        SEC_CBK_TIMING_STOP(job_ring, cbk_start);
+        SEC_TRACE(SEC_TRACE_CALLBACK_EXIT, job_ring->jr_id, ret);
 
         // consume processed packet for this sec context
         CONTEXT_CONSUME_PACKET(sec_context);
+        CONTEXT_CONSUME_HW_PACKET(sec_context);
         notified_packets_no++;
 
         // UA requested to exit
@@ -576,6 +935,10 @@ static uint32_t hw_poll_job_ring(sec_job_ring_t *job_ring,
     }
 
     *packets_no = notified_packets_no;
+    if (notified_packets_no == 0)
+    {
+        SEC_JR_COUNT(job_ring, rx_counters, empty_polls, 1);
+    }
 
     return SEC_SUCCESS;
 }
@@ -589,6 +952,11 @@ static void flush_job_rings()
     {
         job_ring = &g_job_rings[i];
 
+#if (SEC_ENABLE_CPU_JOBS == ON)
+        // Discard the packets processed on the CPU
+        cpu_poll_job_ring(job_ring, -1, FALSE, NULL);
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+
         // Producer index is frozen. If consumer index is not equal
         // with producer index, then we have packets to flush.
         while(job_ring->pidx != job_ring->cidx)
@@ -602,6 +970,64 @@ static void flush_job_rings()
     }
 }
 
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+static void poll_autotune(sec_job_ring_t *job_ring, uint32_t notified_packets)
+{
+    sec_poll_tuner_t *tuner = &job_ring->poll_tuner;
+    uint32_t weight = tuner->weight;
+    uint32_t packets_per_poll = 0;
+    uint32_t latency = 0;
+
+    tuner->polls++;
+    tuner->packets += notified_packets;
+    if (notified_packets == weight)
+    {
+        tuner->saturated_polls++;
+    }
+    if (tuner->polls < SEC_POLL_AUTOTUNE_WINDOW)
+    {
+        return;
+    }
+
+    packets_per_poll = tuner->packets / tuner->polls;
+    if (tuner->latency_no != 0)
+    {
+        latency = (uint32_t)(tuner->latency_sum / tuner->latency_no);
+    }
+
+    if (tuner->saturated_polls * 2 >= tuner->polls &&
+        (packets_per_poll < SEC_POLL_AUTOTUNE_TARGET || latency > g_poll_latency_budget))
+    {
+        // The job ring has more done jobs than the weight lets out at each poll
+        // and they wait too long or come out in too small batches.
+        weight = (weight * 2 > SEC_JOB_RING_SIZE) ? SEC_JOB_RING_SIZE : weight * 2;
+    }
+    else if (tuner->saturated_polls == 0 && latency <= g_poll_latency_budget &&
+             weight > SEC_POLL_AUTOTUNE_TARGET && packets_per_poll < weight / 2)
+    {
+        // The weight is much larger than needed. Lower it, so that a burst
+        // on this job ring cannot hold back the other job rings for long.
+        weight -= weight / 4;
+        weight = (weight < SEC_POLL_AUTOTUNE_TARGET) ? SEC_POLL_AUTOTUNE_TARGET : weight;
+    }
+
+    if (weight != tuner->weight)
+    {
+        SEC_DEBUG("Jr[%p]. Poll weight %d -> %d. Packets per poll %d, saturated polls %d/%d, latency %d",
+                  job_ring, tuner->weight, weight, packets_per_poll,
+                  tuner->saturated_polls, tuner->polls, latency);
+        tuner->weight = weight;
+        tuner->weight_changes++;
+    }
+
+    tuner->polls = 0;
+    tuner->saturated_polls = 0;
+    tuner->packets = 0;
+    tuner->latency_no = 0;
+    tuner->latency_sum = 0;
+}
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+
 static void sec_handle_packet_error(sec_job_ring_t *job_ring,
                                     uint32_t sec_error_code,
                                     uint32_t *notified_packets,
@@ -611,6 +1037,8 @@ static void sec_handle_packet_error(sec_job_ring_t *job_ring,
 
     ASSERT(notified_packets != NULL);
 
+    SEC_TRACE(SEC_TRACE_JR_RESET_BEGIN, job_ring->jr_id, sec_error_code);
+
     // Job ring will be restarted, change its state so that
     // no new packets can be submitted by UA on this job ring.
     job_ring->jr_state = SEC_JOB_RING_STATE_RESET;
@@ -627,12 +1055,391 @@ static void sec_handle_packet_error(sec_job_ring_t *job_ring,
                       SEC_STATUS_ERROR, // the status to be set for each packet when notified to UA
                       sec_error_code,
                       notified_packets);
+    SEC_JR_COUNT(job_ring, rx_counters, error_packets, *notified_packets);
+    SEC_JR_COUNT(job_ring, rx_counters, jr_resets, 1);
     {
         // Job ring can be used again by UA
         job_ring->jr_state = SEC_JOB_RING_STATE_STARTED;
     }
+    SEC_TRACE(SEC_TRACE_JR_RESET_END, job_ring->jr_id, *notified_packets);
+}
+
+
+#if (SEC_ENABLE_CPU_JOBS == ON)
+static uint32_t cpu_poll_job_ring(sec_job_ring_t *job_ring,
+                                  int32_t limit,
+                                  uint32_t do_notify,
+                                  int *stop_processing)
+{
+    sec_context_t *sec_context = NULL;
+    struct sec_cpu_job_t *cpu_job = NULL;
+    struct sec_cpu_job_t saved_job;
+    sec_status_t status;
+    uint32_t jobs_no_to_notify = 0;
+    uint32_t notified_packets_no = 0;
+    int ret;
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+    uint32_t now = 0;
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+#if (SEC_ENABLE_CALLBACK_TIMING == ON)
+    uint32_t cbk_start = 0;
+#endif // (SEC_ENABLE_CALLBACK_TIMING == ON)
+
+    jobs_no_to_notify = SEC_JOB_RING_NUMBER_OF_ITEMS(SEC_JOB_RING_SIZE,
+                                                     job_ring->cpu_pidx,
+                                                     job_ring->cpu_cidx);
+    // Read the jobs only after seeing them published by the producer
+    __sync_synchronize();
+    if (limit >= 0 && limit < jobs_no_to_notify)
+    {
+        jobs_no_to_notify = limit;
+    }
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+    if (jobs_no_to_notify > 0 && do_notify == TRUE)
+    {
+        now = sec_get_timebase();
+    }
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+
+    while(jobs_no_to_notify > notified_packets_no)
+    {
+        cpu_job = &job_ring->cpu_jobs[job_ring->cpu_cidx];
+        sec_context = cpu_job->sec_context;
+
+        // Free the slot before the callback is called, same as for the jobs processed by SEC
+        saved_job = *cpu_job;
+#if (SEC_ENABLE_PACKET_COPY == ON)
+        saved_job.in_packet = &saved_job.packet_copies[0];
+        saved_job.out_packet = &saved_job.packet_copies[1];
+#endif // (SEC_ENABLE_PACKET_COPY == ON)
+        // The slot can be reused by the producer only after the job was read
+        __sync_synchronize();
+        job_ring->cpu_cidx = SEC_CIRCULAR_COUNTER(job_ring->cpu_cidx, SEC_JOB_RING_SIZE);
+        notified_packets_no++;
+
+        if(do_notify == FALSE)
+        {
+            CONTEXT_CONSUME_PACKET(sec_context);
+            continue;
+        }
+
+        status = saved_job.status;
+        SEC_JR_COUNT(job_ring, rx_counters, packets, 1);
+        SEC_JR_COUNT(job_ring, rx_counters, bytes, SEC_PACKET_LENGTH(saved_job.out_packet));
+        CONTEXT_COUNT(sec_context, packets, 1);
+        CONTEXT_COUNT(sec_context, bytes, SEC_PACKET_LENGTH(saved_job.out_packet));
+        CONTEXT_SET_ACTIVITY(sec_context, now);
+        if (status == SEC_STATUS_HFN_THRESHOLD_REACHED)
+        {
+            SEC_JR_COUNT(job_ring, rx_counters, hfn_threshold_reached, 1);
+            CONTEXT_COUNT(sec_context, hfn_threshold_reached, 1);
+        }
+        if(sec_context->state == SEC_CONTEXT_RETIRING)
+        {
+            status = (CONTEXT_GET_PACKETS_NO(sec_context) > 1) ?
+                     SEC_STATUS_OVERDUE : SEC_STATUS_LAST_OVERDUE;
+            CONTEXT_COUNT(sec_context, overdue, 1);
+        }
+
+        SEC_TRACE(SEC_TRACE_CALLBACK_ENTER, job_ring->jr_id, status);
+        SEC_CBK_TIMING_START(cbk_start);
+        ret = sec_context->notify_packet_cbk(saved_job.in_packet,
+                                             saved_job.out_packet,
+                                             saved_job.ua_handle,
+                                             status,
+                                             0); // no error
+        SEC_CBK_TIMING_STOP(job_ring, cbk_start);
+        SEC_TRACE(SEC_TRACE_CALLBACK_EXIT, job_ring->jr_id, ret);
+
+        // consume processed packet for this sec context
+        CONTEXT_CONSUME_PACKET(sec_context);
+
+        // UA requested to exit
+        if (ret == SEC_RETURN_STOP)
+        {
+            *stop_processing = TRUE;
+            break;
+        }
+    }
+
+    return notified_packets_no;
+}
+
+static inline void enqueue_cpu_job(sec_job_ring_t *job_ring,
+                                   sec_context_t *sec_context,
+                                   const sec_packet_t *in_packet,
+                                   const sec_packet_t *out_packet,
+                                   ua_context_handle_t ua_ctx_handle,
+                                   sec_status_t status)
+{
+    struct sec_cpu_job_t *cpu_job = &job_ring->cpu_jobs[job_ring->cpu_pidx];
+
+    cpu_job->sec_context = sec_context;
+#if (SEC_ENABLE_PACKET_COPY == ON)
+    cpu_job->packet_copies[0] = *in_packet;
+    cpu_job->packet_copies[1] = *out_packet;
+    in_packet = &cpu_job->packet_copies[0];
+    out_packet = &cpu_job->packet_copies[1];
+#endif // (SEC_ENABLE_PACKET_COPY == ON)
+    cpu_job->in_packet = in_packet;
+    cpu_job->out_packet = out_packet;
+    cpu_job->ua_handle = ua_ctx_handle;
+    cpu_job->status = status;
+
+    // keep count of submitted packets for this sec context
+    CONTEXT_ADD_PACKET(sec_context);
+
+    // The job must be complete before the consumer sees it published
+    __sync_synchronize();
+    job_ring->cpu_pidx = SEC_CIRCULAR_COUNTER(job_ring->cpu_pidx, SEC_JOB_RING_SIZE);
+}
+
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON) || (SEC_ENABLE_HYBRID_DISPATCH == ON)
+static uint32_t pdcp_context_is_cpu_capable(sec_context_t *sec_context)
+{
+    const sec_pdcp_context_info_t *pdcp_crypto_info = sec_context->crypto_info.pdcp_crypto_info;
+
+    // The COUNT of a packet is known on the CPU only if UA provides the HFN
+    return (g_sec_ptov != NULL &&
+            sec_context->dpovrd_en == TRUE &&
+            pdcp_crypto_info->user_plane == PDCP_DATA_PLANE &&
+            (pdcp_crypto_info->cipher_algorithm == SEC_ALG_SNOW ||
+             pdcp_crypto_info->cipher_algorithm == SEC_ALG_AES) &&
+            pdcp_crypto_info->cipher_key_len == SEC_SW_AES_BLOCK_SIZE &&
+            (pdcp_crypto_info->sn_size == SEC_PDCP_SN_SIZE_7 ||
+             pdcp_crypto_info->sn_size == SEC_PDCP_SN_SIZE_12)) ? TRUE : FALSE;
+}
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON) || (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+static uint32_t process_packet_from_ks_cache(sec_job_ring_t *job_ring,
+                                             sec_context_t *sec_context,
+                                             const sec_packet_t *in_packet,
+                                             const sec_packet_t *out_packet,
+                                             uint32_t hfn_ov_val,
+                                             ua_context_handle_t ua_ctx_handle)
+{
+    const sec_pdcp_context_info_t *pdcp_crypto_info = sec_context->crypto_info.pdcp_crypto_info;
+    const uint8_t *ks = NULL;
+    const uint8_t *in = NULL;
+    uint8_t *out = NULL;
+    uint32_t hdr_len;
+    uint32_t payload_len;
+    uint32_t sn;
+
+    // Packets processed by SEC for this context must be notified first
+    if (CONTEXT_GET_HW_PACKETS_NO(sec_context) != 0 ||
+        in_packet->num_fragments != 0 ||
+        out_packet->num_fragments != 0 ||
+        out_packet->length < in_packet->length ||
+        SEC_JOB_RING_IS_FULL(job_ring->cpu_pidx, job_ring->cpu_cidx,
+                             SEC_JOB_RING_SIZE, SEC_JOB_RING_SIZE))
+    {
+        return FALSE;
+    }
+    // The consumer is done with the CPU job slot and with the SEC jobs it counted
+    __sync_synchronize();
+
+    hdr_len = (pdcp_crypto_info->sn_size == SEC_PDCP_SN_SIZE_7) ? 1 : 2;
+    if (in_packet->length <= hdr_len)
+    {
+        return FALSE;
+    }
+    payload_len = in_packet->length - hdr_len;
+    if (payload_len > SEC_KEYSTREAM_CACHE_MAX_PAYLOAD)
+    {
+        return FALSE;
+    }
+
+    in = (const uint8_t*)g_sec_ptov(in_packet->address) + in_packet->offset;
+    out = (uint8_t*)g_sec_ptov(out_packet->address) + out_packet->offset;
+
+    sn = (pdcp_crypto_info->sn_size == SEC_PDCP_SN_SIZE_7) ?
+         (in[0] & 0x7F) : (((in[0] & 0x0F) << 8) | in[1]);
+
+    ks = sec_ks_cache_lookup(sec_context->ks_cache,
+                             (hfn_ov_val << pdcp_crypto_info->sn_size) | sn);
+    if (ks == NULL)
+    {
+        return FALSE;
+    }
+
+    // The PDCP header is not ciphered
+    if (out != in)
+    {
+        memcpy(out, in, hdr_len);
+    }
+    sec_sw_xor(out + hdr_len, in + hdr_len, ks, payload_len);
+
+    enqueue_cpu_job(job_ring, sec_context, in_packet, out_packet, ua_ctx_handle,
+                    (hfn_ov_val >= pdcp_crypto_info->hfn_threshold) ?
+                    SEC_STATUS_HFN_THRESHOLD_REACHED : SEC_STATUS_SUCCESS);
+
+    return TRUE;
+}
+
+static void release_keystream_caches(sec_contexts_pool_t *pool)
+{
+    int i;
+
+    if (pool->is_initialized == FALSE)
+    {
+        return;
+    }
+
+    for (i = 0; i < pool->no_of_contexts; i++)
+    {
+        sec_ks_cache_destroy(pool->sec_contexts[i].ks_cache);
+        pool->sec_contexts[i].ks_cache = NULL;
+    }
+}
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+static uint32_t dispatch_packet_to_cpu(sec_job_ring_t *job_ring,
+                                       sec_context_t *sec_context,
+                                       const sec_packet_t *in_packet,
+                                       const sec_packet_t *out_packet,
+                                       uint32_t hfn_ov_val,
+                                       ua_context_handle_t ua_ctx_handle)
+{
+    const sec_pdcp_context_info_t *pdcp_crypto_info = sec_context->crypto_info.pdcp_crypto_info;
+    uint8_t ks[SEC_HYBRID_MAX_PAYLOAD];
+    const uint8_t *in = NULL;
+    uint8_t *out = NULL;
+    uint32_t hdr_len;
+    uint32_t payload_len;
+    uint32_t blocks_no;
+    uint32_t jobs_in_flight;
+    uint32_t hw_latency;
+    uint32_t idle_periods;
+    uint32_t now;
+    uint32_t start;
+    uint32_t sn;
+
+    // Packets processed by SEC for this context must be notified first
+    if (CONTEXT_GET_HW_PACKETS_NO(sec_context) != 0 ||
+        in_packet->num_fragments != 0 ||
+        out_packet->num_fragments != 0 ||
+        out_packet->length < in_packet->length ||
+        SEC_JOB_RING_IS_FULL(job_ring->cpu_pidx, job_ring->cpu_cidx,
+                             SEC_JOB_RING_SIZE, SEC_JOB_RING_SIZE))
+    {
+        return FALSE;
+    }
+    // The consumer is done with the CPU job slot and with the SEC jobs it counted
+    __sync_synchronize();
+
+    hdr_len = (pdcp_crypto_info->sn_size == SEC_PDCP_SN_SIZE_7) ? 1 : 2;
+    if (in_packet->length <= hdr_len)
+    {
+        return FALSE;
+    }
+    payload_len = in_packet->length - hdr_len;
+    if (payload_len > SEC_HYBRID_MAX_PAYLOAD)
+    {
+        return FALSE;
+    }
+
+    if (payload_len > SEC_HYBRID_SMALL_PAYLOAD)
+    {
+        blocks_no = (payload_len + SEC_SW_AES_BLOCK_SIZE - 1) / SEC_SW_AES_BLOCK_SIZE;
+        jobs_in_flight = SEC_JOB_RING_NUMBER_OF_ITEMS(SEC_JOB_RING_SIZE,
+                                                      job_ring->pidx,
+                                                      job_ring->cidx);
+
+        // The SEC latency is measured only on the packets SEC processes. While SEC is idle,
+        // halve it for every measured latency elapsed since a packet was last sent to SEC,
+        // so that packets are sent again to SEC and measure it anew. The average itself
+        // is written only by the consumer thread.
+        hw_latency = job_ring->hw_latency;
+        now = sec_get_timebase();
+        if (jobs_in_flight == 0 && hw_latency != 0)
+        {
+            idle_periods = (now - job_ring->hw_dispatch_tb) / hw_latency;
+            hw_latency = (idle_periods < 32) ? (hw_latency >> idle_periods) : 0;
+        }
+
+        if (jobs_in_flight < SEC_HYBRID_RING_BUSY_THRESHOLD &&
+            hw_latency <= job_ring->cpu_block_cost * blocks_no)
+        {
+            job_ring->hw_dispatch_tb = now;
+            return FALSE;
+        }
+    }
+
+    in = (const uint8_t*)g_sec_ptov(in_packet->address) + in_packet->offset;
+    out = (uint8_t*)g_sec_ptov(out_packet->address) + out_packet->offset;
+
+    sn = (pdcp_crypto_info->sn_size == SEC_PDCP_SN_SIZE_7) ?
+         (in[0] & 0x7F) : (((in[0] & 0x0F) << 8) | in[1]);
+
+    start = sec_get_timebase();
+
+    sec_sw_pdcp_keystream(pdcp_crypto_info->cipher_algorithm,
+                          pdcp_crypto_info->cipher_key,
+                          sec_context->sw_aes_rk,
+                          (hfn_ov_val << pdcp_crypto_info->sn_size) | sn,
+                          pdcp_crypto_info->bearer,
+                          pdcp_crypto_info->packet_direction,
+                          ks,
+                          payload_len);
+
+    // The PDCP header is not ciphered
+    if (out != in)
+    {
+        memcpy(out, in, hdr_len);
+    }
+    sec_sw_xor(out + hdr_len, in + hdr_len, ks, payload_len);
+
+    // Moving average of the CPU cost of a 16 byte block
+    blocks_no = (payload_len + SEC_SW_AES_BLOCK_SIZE - 1) / SEC_SW_AES_BLOCK_SIZE;
+    job_ring->cpu_block_cost += (int32_t)((sec_get_timebase() - start) / blocks_no -
+                                          job_ring->cpu_block_cost) >> SEC_HYBRID_EWMA_SHIFT;
+
+    enqueue_cpu_job(job_ring, sec_context, in_packet, out_packet, ua_ctx_handle,
+                    (hfn_ov_val >= pdcp_crypto_info->hfn_threshold) ?
+                    SEC_STATUS_HFN_THRESHOLD_REACHED : SEC_STATUS_SUCCESS);
+
+    return TRUE;
 }
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+
+#if (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+static uint32_t process_null_packet_on_cpu(sec_job_ring_t *job_ring,
+                                           sec_context_t *sec_context,
+                                           const sec_packet_t *in_packet,
+                                           const sec_packet_t *out_packet,
+                                           uint32_t hfn_ov_val,
+                                           ua_context_handle_t ua_ctx_handle)
+{
+    const sec_pdcp_context_info_t *pdcp_crypto_info = sec_context->crypto_info.pdcp_crypto_info;
+    sec_status_t status = SEC_STATUS_SUCCESS;
+
+    if (SEC_JOB_RING_IS_FULL(job_ring->cpu_pidx, job_ring->cpu_cidx,
+                             SEC_JOB_RING_SIZE, SEC_JOB_RING_SIZE) ||
+        null_passthrough_process_packet(pdcp_crypto_info,
+                                        CONTEXT_GET_HW_PACKETS_NO(sec_context),
+                                        in_packet, out_packet, g_sec_ptov) == FALSE)
+    {
+        return FALSE;
+    }
+    // The consumer is done with the CPU job slot and with the SEC jobs it counted
+    __sync_synchronize();
+
+#ifdef USDPAA
+    if (hfn_ov_val >= pdcp_crypto_info->hfn_threshold)
+    {
+        status = SEC_STATUS_HFN_THRESHOLD_REACHED;
+    }
+#endif
 
+    enqueue_cpu_job(job_ring, sec_context, in_packet, out_packet, ua_ctx_handle, status);
+
+    return TRUE;
+}
+#endif // (SEC_ENABLE_NULL_PASSTHROUGH == ON)
 
 /*==================================================================================================
                                      GLOBAL FUNCTIONS
@@ -644,6 +1451,7 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
 {
     int i = 0;
     int ret = 0;
+    uint32_t dma_mem_size = 0;
 
     // Validate driver state
     SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_IDLE,
@@ -665,6 +1473,16 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
                 SEC_INVALID_INPUT_PARAM,
                 "Configured memory is not cacheline aligned");
 
+    // DMA memory area must be large enough for this configuration
+    dma_mem_size = (sec_config_data->memory_area_size != 0) ?
+                   sec_config_data->memory_area_size : SEC_DMA_MEMORY_SIZE;
+    if (dma_mem_size < sec_get_required_dma_size(sec_config_data, job_rings_no))
+    {
+        SEC_ERROR("Configured memory of %u bytes is smaller than the %u bytes required for %d job rings",
+                  dma_mem_size, sec_get_required_dma_size(sec_config_data, job_rings_no), job_rings_no);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
     // Must check the user passed a valid function for V2P translation.
     SEC_ASSERT (sec_config_data->sec_drv_vtop != NULL,
                 SEC_INVALID_INPUT_PARAM,
@@ -672,6 +1490,12 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
 
     // Update V2P function
     g_sec_vtop = sec_config_data->sec_drv_vtop;
+    g_sec_ptov = sec_config_data->sec_drv_ptov;
+
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+    // Regions registered before a previous sec_release() are forgotten
+    mem_map_init(&g_mem_map);
+#endif // (SEC_ENABLE_IOV_SUBMISSION == ON)
 
     // Initialize per-thread-local errno variable
 
@@ -693,11 +1517,18 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
     g_job_rings_no = job_rings_no;
     memset(g_job_rings, 0, sizeof(g_job_rings));
     SEC_INFO("Configuring %d number of SEC job rings", g_job_rings_no);
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+    g_poll_latency_budget = (uint32_t)(sec_time_get_frequency() / 1000000 *
+                                       SEC_POLL_AUTOTUNE_LATENCY_BUDGET_US);
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
 
     // Configure DMA-capable memory area assigned to the driver by UA
-    g_dma_mem_start = sec_config_data->memory_area;
-    g_dma_mem_free = g_dma_mem_start;
-    SEC_INFO("Using DMA memory area with start address = %p\n", g_dma_mem_start);
+    ret = dma_mem_init(&g_dma_arena, sec_config_data->memory_area, dma_mem_size);
+    if (ret != SEC_SUCCESS)
+    {
+        return ret;
+    }
+    SEC_INFO("Using DMA memory area with start address = %p\n", sec_config_data->memory_area);
 
     // Read configuration data from DTS (Device Tree Specification).
     ret = sec_configure(g_job_rings_no, g_job_rings);
@@ -712,7 +1543,7 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
         // create/delete contexts for a certain JR (also known as the producer of the JR).
         ret = init_contexts_pool(&(g_job_rings[i].ctx_pool),
                                  MAX_SEC_CONTEXTS_PER_POOL,
-                                 &g_dma_mem_free,
+                                 &g_dma_arena,
                                  THREAD_UNSAFE_POOL);
         if (ret != SEC_SUCCESS)
         {
@@ -738,7 +1569,7 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
         }
 
         // Initialize job ring
-        ret = init_job_ring(&g_job_rings[i], &g_dma_mem_free, sec_config_data->work_mode
+        ret = init_job_ring(&g_job_rings[i], &g_dma_arena, sec_config_data->work_mode
                 , sec_config_data->irq_coalescing_timer & 0xFFFF
                 , sec_config_data->irq_coalescing_count & 0xFF
                 );
@@ -759,7 +1590,7 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
     // We need thread synchronizations mechanisms for this pool.
     ret = init_contexts_pool(&g_ctx_pool,
                              MAX_SEC_CONTEXTS_PER_POOL,
-                             &g_dma_mem_free,
+                             &g_dma_arena,
                              THREAD_SAFE_POOL);
     if (ret != SEC_SUCCESS)
     {
@@ -770,22 +1601,20 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
         return ret;
     }
 
-    /* Now check if I've overrun the memory 'segment' allocated by the UA
-     * TODO: Add some tests for this
-     */
-    if((uintptr_t)g_dma_mem_free - (uintptr_t)g_dma_mem_start < SEC_DMA_MEMORY_SIZE)
+    // Start writing out the deferred log messages
+    ret = sec_log_start();
+    if (ret != SEC_SUCCESS)
     {
-        SEC_INFO("Allocated %u KB for SEC driver, remaining free %u KB",
-                ((uintptr_t)g_dma_mem_free - (uintptr_t)g_dma_mem_start)/1024,
-                (SEC_DMA_MEMORY_SIZE - ((uintptr_t)g_dma_mem_free - (uintptr_t)g_dma_mem_start))/1024);
+        SEC_ERROR("Failed to start deferred logging. Starting sec_release()");
+        sec_release();
+        g_driver_state = SEC_DRIVER_STATE_IDLE;
+        return ret;
     }
-    else
-    {
-        SEC_ERROR("Overrun the memory allocated for SEC driver! (requested: %u KB, configured %u KB)",
-                  ((uintptr_t)g_dma_mem_free - (uintptr_t)g_dma_mem_start)/1024,
-                  SEC_DMA_MEMORY_SIZE/1024);
 
-    }
+    // Allocations never overrun the memory area, they fail instead
+    SEC_INFO("Allocated %u KB for SEC driver, remaining free %u KB",
+             g_dma_arena.used_size / 1024,
+             (g_dma_arena.size - g_dma_arena.used_size) / 1024);
 
     // Remember initial work mode
     g_sec_work_mode = sec_config_data->work_mode;
@@ -799,6 +1628,23 @@ sec_return_code_t sec_init(const sec_config_t *sec_config_data,
     return SEC_SUCCESS;
 }
 
+uint32_t sec_get_required_dma_size(const sec_config_t *sec_config_data,
+                                   uint8_t job_rings_no)
+{
+    uint32_t contexts_per_pool;
+
+    if (sec_config_data == NULL || job_rings_no == 0 || job_rings_no > MAX_SEC_JOB_RINGS)
+    {
+        return 0;
+    }
+
+    // Same layout as in sec_init(): a pool of contexts per job ring plus the global pool
+    contexts_per_pool = SEC_MAX_PDCP_CONTEXTS / job_rings_no;
+
+    return job_rings_no * SEC_JOB_RING_DMA_MEM_SIZE +
+           (job_rings_no + 1) * SEC_CONTEXTS_POOL_DMA_MEM_SIZE(contexts_per_pool);
+}
+
 sec_return_code_t sec_release()
 {
     int i;
@@ -817,6 +1663,9 @@ sec_return_code_t sec_release()
 
     for (i = 0; i < g_job_rings_no; i++)
     {
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+        release_keystream_caches(&(g_job_rings[i].ctx_pool));
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
         // destroy the contexts pool per JR
         destroy_contexts_pool(&(g_job_rings[i].ctx_pool));
 
@@ -825,8 +1674,14 @@ sec_return_code_t sec_release()
     g_job_rings_no = 0;
 
     // destroy the global context pool also
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+    release_keystream_caches(&g_ctx_pool);
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
     destroy_contexts_pool(&g_ctx_pool);
 
+    // Write out the messages logged until now
+    sec_log_stop();
+
     memset(g_job_ring_handles, 0, sizeof(g_job_ring_handles));
     g_driver_state = SEC_DRIVER_STATE_IDLE;
 
@@ -881,6 +1736,12 @@ static inline sec_return_code_t create_context(sec_context_t **ctx,
     // Set the JR handle.
     (*ctx)->jr_handle = (sec_job_ring_handle_t)job_ring;
 
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+    // No packet was notified yet for the new context. It is idle since now.
+    memset(&(*ctx)->counters, 0, sizeof((*ctx)->counters));
+    CONTEXT_SET_ACTIVITY(*ctx, sec_get_timebase());
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+
     return SEC_SUCCESS;
 }
 
@@ -938,6 +1799,16 @@ sec_return_code_t sec_create_rlc_context(sec_job_ring_handle_t job_ring_handle,
                   job_ring_handle, ctx);
     }
 
+#if (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+    ctx->null_passthrough = FALSE;
+#endif // (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+    ctx->cpu_capable = FALSE;
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#if (SEC_ENABLE_LATENCY_STATS == ON)
+    ctx->latency_class = SEC_LATENCY_RLC;
+#endif // (SEC_ENABLE_LATENCY_STATS == ON)
+
     // set the notification callback per context
     ctx->notify_packet_cbk = rlc_ctx_nfo->notify_packet;
 
@@ -1000,6 +1871,21 @@ sec_return_code_t sec_create_pdcp_context (sec_job_ring_handle_t job_ring_handle
                   job_ring_handle, ctx);
     }
 
+#if (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+    ctx->null_passthrough = null_passthrough_context_eligible(pdcp_ctx_info, ctx->dpovrd_en);
+#endif // (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+    ctx->cpu_capable = pdcp_context_is_cpu_capable(ctx);
+    if (ctx->cpu_capable == TRUE && pdcp_ctx_info->cipher_algorithm == SEC_ALG_AES)
+    {
+        sec_sw_aes128_expand_key(pdcp_ctx_info->cipher_key, ctx->sw_aes_rk);
+    }
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#if (SEC_ENABLE_LATENCY_STATS == ON)
+    ctx->latency_class = (pdcp_ctx_info->user_plane == PDCP_DATA_PLANE) ?
+                         SEC_LATENCY_PDCP_DATA_PLANE : SEC_LATENCY_PDCP_CONTROL_PLANE;
+#endif // (SEC_ENABLE_LATENCY_STATS == ON)
+
     // set the notification callback per context
     ctx->notify_packet_cbk = pdcp_ctx_info->notify_packet;
 
@@ -1041,6 +1927,12 @@ sec_return_code_t sec_delete_pdcp_context (sec_context_handle_t sec_ctx_handle)
     pool = sec_context->pool;
     ASSERT (pool != NULL);
 
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+    // No more packets can be submitted on this context, the keystream is not needed anymore.
+    sec_ks_cache_destroy(sec_context->ks_cache);
+    sec_context->ks_cache = NULL;
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+
     // Now try to free the current context. If there are packets
     // in flight the context will be retired (not freed). The context
     // will be freed in the next garbage collector call.
@@ -1058,6 +1950,7 @@ sec_return_code_t sec_poll(int32_t limit, uint32_t weight, uint32_t *packets_no)
     int32_t ret = SEC_SUCCESS;
     int32_t no_more_packets_on_jrs = 0;
     int32_t jr_limit = 0; // limit computed per JR
+    uint32_t jr_weight = weight; // weight used for a JR
 
     // Validate driver state
     SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
@@ -1095,6 +1988,15 @@ sec_return_code_t sec_poll(int32_t limit, uint32_t weight, uint32_t *packets_no)
         {
             job_ring = &g_job_rings[i];
 
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+            // The weight given by UA is only the starting point
+            if (job_ring->poll_tuner.weight == 0)
+            {
+                job_ring->poll_tuner.weight = weight;
+            }
+            jr_weight = job_ring->poll_tuner.weight;
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+
             // Compute the limit for this JR
             // If there are less packets to notify than configured weight,
             // then notify the smaller number of packets.
@@ -1102,7 +2004,7 @@ sec_return_code_t sec_poll(int32_t limit, uint32_t weight, uint32_t *packets_no)
             // how many packets do we have until reaching the budget?
             packets_left_to_notify = (limit > 0) ? (limit - notified_packets_no) : limit;
             // calculate budget per job ring
-            jr_limit = (packets_left_to_notify < weight) ? packets_left_to_notify  : weight ;
+            jr_limit = (packets_left_to_notify < jr_weight) ? packets_left_to_notify  : jr_weight ;
 
             // Poll one JR
             ret = hw_poll_job_ring(job_ring,
@@ -1114,6 +2016,14 @@ sec_return_code_t sec_poll(int32_t limit, uint32_t weight, uint32_t *packets_no)
             SEC_DEBUG("Jr[%p].Jobs notified[%d]. UA cbk ret STOP[%d]",
                       job_ring, notified_packets_no_per_jr, stop_processing);
 
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+            // Only the polls bounded by the weight tell something about it
+            if (jr_limit == jr_weight)
+            {
+                poll_autotune(job_ring, notified_packets_no_per_jr);
+            }
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+
 
 
             // Update flag used to identify if there are no more notifications
@@ -1223,14 +2133,47 @@ sec_return_code_t sec_poll_job_ring(sec_job_ring_handle_t job_ring_handle,
     return SEC_SUCCESS;
 }
 
-int sec_update_job_descriptor(sec_context_t *ctx,
-                              sec_job_t *job,
-                              sec_descriptor_t *descriptor)
+#if (SEC_JOB_STORES_PACKETS == ON)
+static inline void save_job_packets(const sec_job_ring_t *job_ring,
+                                    const sec_job_t *job,
+                                    sec_job_t *saved_job,
+                                    sec_saved_packets_t *saved_packets)
 {
-    dma_addr_t  phys_addr;
-    uint32_t    offset = 0;
-    uint32_t    length = 0;
-    int ret = SEC_SUCCESS;
+    const sec_packet_t *packets[2] = {job->in_packet, job->out_packet};
+    sec_packet_t *saved[2] = {saved_packets->in, saved_packets->out};
+    uint32_t stored = FALSE;
+    int i = 0;
+
+    for (i = 0; i < 2; i++)
+    {
+        stored = FALSE;
+#if (SEC_ENABLE_PACKET_COPY == ON)
+        stored = (packets[i] == &job->packet_copies[i]);
+#endif // (SEC_ENABLE_PACKET_COPY == ON)
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+        stored = stored || (packets[i] == job_ring->iov_packets[job - job_ring->jobs][i]);
+#endif // (SEC_ENABLE_IOV_SUBMISSION == ON)
+
+        if (stored == TRUE)
+        {
+            memcpy(saved[i], packets[i], (packets[i]->num_fragments + 1) * sizeof(sec_packet_t));
+            packets[i] = saved[i];
+        }
+    }
+
+    saved_job->in_packet = packets[0];
+    saved_job->out_packet = packets[1];
+}
+#endif // (SEC_JOB_STORES_PACKETS == ON)
+
+int sec_update_job_descriptor(sec_context_t *ctx,
+                              sec_job_t *job,
+                              sec_descriptor_t *descriptor)
+{
+    dma_addr_t  phys_addr;
+    uint32_t    offset = 0;
+    uint32_t    length = 0;
+    int ret = SEC_SUCCESS;
 
     SEC_JD_INIT(descriptor);
     SEC_JD_SET_SD(descriptor,
@@ -1247,6 +2190,14 @@ int sec_update_job_descriptor(sec_context_t *ctx,
         offset = 0;
         length = SG_CONTEXT_GET_LEN_OUT(job->sg_ctx);
     }
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+    else if( job->sg_ctx->out_bounce_en )
+    {
+        phys_addr = job->sg_ctx->bounce_buf_phy + SEC_SG_BOUNCE_BUF_SIZE;
+        offset = 0;
+        length = SG_CONTEXT_GET_LEN_OUT(job->sg_ctx);
+    }
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
     else
 #endif // SEC_ENABLE_SCATTER_GATHER == ON
     {
@@ -1268,6 +2219,14 @@ int sec_update_job_descriptor(sec_context_t *ctx,
         offset = 0;
         length = SG_CONTEXT_GET_LEN_IN(job->sg_ctx);
     }
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+    else if( job->sg_ctx->in_bounce_en )
+    {
+        phys_addr = job->sg_ctx->bounce_buf_phy;
+        offset = 0;
+        length = SG_CONTEXT_GET_LEN_IN(job->sg_ctx);
+    }
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
     else
 #endif // (SEC_ENABLE_SCATTER_GATHER == ON)
     {
@@ -1292,6 +2251,28 @@ int sec_update_job_descriptor(sec_context_t *ctx,
 
     return ret;
 }
+#if (SEC_ENABLE_SCATTER_GATHER == ON)
+static inline sec_return_code_t prepare_sg_context(sec_job_ring_t *job_ring,
+                                                   sec_sg_context_t *sg_ctx,
+                                                   const sec_packet_t *packet,
+                                                   sec_sg_context_type_t dir)
+{
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+    // For short packets with few fragments, a copy costs less than SEC fetching
+    // a SG table before the data
+    if (packet->num_fragments != 0 &&
+        packet->num_fragments < job_ring->sg_linearize_max_fragments &&
+        packet->total_length <= job_ring->sg_linearize_max_length &&
+        linearize_sg_packet(sg_ctx, packet, dir, g_sec_ptov) == TRUE)
+    {
+        return SEC_SUCCESS;
+    }
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
+
+    return build_sg_context(&job_ring->sg_tbl_pool, sg_ctx, packet, dir, packet->num_fragments);
+}
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+
 sec_return_code_t sec_process_packet(sec_context_handle_t sec_ctx_handle,
                                      const sec_packet_t *in_packet,
                                      const sec_packet_t *out_packet,
@@ -1309,6 +2290,217 @@ sec_return_code_t sec_process_packet_hfn_ov(sec_context_handle_t sec_ctx_handle,
                                             const sec_packet_t *out_packet,
                                             uint32_t hfn_ov_val,
                                             ua_context_handle_t ua_ctx_handle)
+{
+    return process_packet(sec_ctx_handle,
+                          in_packet,
+                          out_packet,
+                          hfn_ov_val,
+                          ua_ctx_handle,
+                          NULL,
+                          FALSE);
+}
+
+sec_return_code_t sec_build_sg_tbl(const sec_packet_t *packet,
+                                   sec_sg_tbl_entry_t *sg_tbl)
+{
+    SEC_ASSERT(packet != NULL, SEC_INVALID_INPUT_PARAM, "packet is NULL");
+    SEC_ASSERT(sg_tbl != NULL, SEC_INVALID_INPUT_PARAM, "sg_tbl is NULL");
+
+#if (SEC_ENABLE_SCATTER_GATHER == ON)
+    return format_sg_tbl(packet, sg_tbl);
+#else // (SEC_ENABLE_SCATTER_GATHER == ON)
+    SEC_ERROR("Please enable Scatter Gather support");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+}
+
+sec_return_code_t sec_process_packet_sg_tbl(sec_context_handle_t sec_ctx_handle,
+                                            const sec_packet_t *in_packet,
+                                            dma_addr_t in_sg_tbl_phys,
+                                            const sec_packet_t *out_packet,
+                                            dma_addr_t out_sg_tbl_phys,
+                                            uint32_t hfn_ov_val,
+                                            ua_context_handle_t ua_ctx_handle)
+{
+    dma_addr_t sg_tbls_phys[2] = {in_sg_tbl_phys, out_sg_tbl_phys};
+
+    return process_packet(sec_ctx_handle,
+                          in_packet,
+                          out_packet,
+                          hfn_ov_val,
+                          ua_ctx_handle,
+                          sg_tbls_phys,
+                          FALSE);
+}
+
+sec_return_code_t sec_register_mem_region(void *vaddr,
+                                          dma_addr_t paddr,
+                                          uint32_t size)
+{
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    SEC_ASSERT(vaddr != NULL, SEC_INVALID_INPUT_PARAM, "vaddr is NULL");
+
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+    return mem_map_add(&g_mem_map, vaddr, paddr, size);
+#else // (SEC_ENABLE_IOV_SUBMISSION == ON)
+    SEC_ERROR("Please enable iovec submission support");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_IOV_SUBMISSION == ON)
+}
+
+sec_return_code_t sec_unregister_mem_region(void *vaddr)
+{
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+    return mem_map_remove(&g_mem_map, vaddr);
+#else // (SEC_ENABLE_IOV_SUBMISSION == ON)
+    SEC_ERROR("Please enable iovec submission support");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_IOV_SUBMISSION == ON)
+}
+
+sec_return_code_t sec_process_packet_iov(sec_context_handle_t sec_ctx_handle,
+                                         const struct iovec *in_iov,
+                                         uint32_t in_iov_no,
+                                         const struct iovec *out_iov,
+                                         uint32_t out_iov_no,
+                                         uint32_t hfn_ov_val,
+                                         ua_context_handle_t ua_ctx_handle)
+{
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+    sec_context_t *sec_context = (sec_context_t *)sec_ctx_handle;
+    sec_job_ring_t *job_ring = NULL;
+    sec_packet_t *in_packet = NULL;
+    sec_packet_t *out_packet = NULL;
+
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    // Validate input arguments
+    SEC_ASSERT(sec_ctx_handle != NULL, SEC_INVALID_INPUT_PARAM, "sec_ctx_handle is NULL");
+    SEC_ASSERT(in_iov != NULL, SEC_INVALID_INPUT_PARAM, "in_iov is NULL");
+    SEC_ASSERT(out_iov != NULL, SEC_INVALID_INPUT_PARAM, "out_iov is NULL");
+    SEC_ASSERT(COND_EXPR1_EQ_AND_EXPR2_EQ(sec_context->start_pattern,
+                                          CONTEXT_VALIDATION_PATTERN,
+                                          sec_context->end_pattern,
+                                          CONTEXT_VALIDATION_PATTERN),
+               SEC_INVALID_INPUT_PARAM,
+               "sec_ctx_handle is invalid");
+
+    if (in_iov_no == 0 || in_iov_no > SEC_IOV_MAX_FRAGMENTS ||
+        out_iov_no == 0 || out_iov_no > SEC_IOV_MAX_FRAGMENTS)
+    {
+        SEC_ERROR_RL("Packets must have between 1 and %d iovec entries", SEC_IOV_MAX_FRAGMENTS);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    job_ring = (sec_job_ring_t *)sec_context->jr_handle;
+    ASSERT(job_ring != NULL);
+
+    // Don't translate a packet that cannot be enqueued
+    if( SEC_JOB_RING_IS_FULL(job_ring->pidx, job_ring->cidx,
+                              SEC_JOB_RING_SIZE,SEC_JOB_RING_SIZE ) )
+    {
+        SEC_JR_COUNT(job_ring, tx_counters, jr_full, 1);
+        return SEC_JR_IS_FULL;
+    }
+
+    // The translated packets are stored in the job that will carry them,
+    // they are valid until the job is dequeued
+    in_packet = job_ring->iov_packets[job_ring->pidx][0];
+    out_packet = job_ring->iov_packets[job_ring->pidx][1];
+
+    if (mem_map_iov_to_packet(&g_mem_map, in_iov, in_iov_no,
+                              &job_ring->mem_map_hint, in_packet) != SEC_SUCCESS ||
+        mem_map_iov_to_packet(&g_mem_map, out_iov, out_iov_no,
+                              &job_ring->mem_map_hint, out_packet) != SEC_SUCCESS)
+    {
+        SEC_ERROR_RL("Packet is not in a registered memory region");
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    return process_packet(sec_ctx_handle,
+                          in_packet,
+                          out_packet,
+                          hfn_ov_val,
+                          ua_ctx_handle,
+                          NULL,
+                          TRUE);
+#else // (SEC_ENABLE_IOV_SUBMISSION == ON)
+    SEC_ERROR("Please enable iovec submission support");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_IOV_SUBMISSION == ON)
+}
+
+sec_return_code_t sec_process_packet_burst(sec_burst_packet_t *packets,
+                                           uint32_t packets_no,
+                                           uint32_t *submitted_no)
+{
+    sec_return_code_t ret = SEC_SUCCESS;
+    uint32_t window_no = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+    SEC_ASSERT(packets != NULL, SEC_INVALID_INPUT_PARAM, "packets is NULL");
+    SEC_ASSERT(submitted_no != NULL, SEC_INVALID_INPUT_PARAM, "submitted_no is NULL");
+
+    *submitted_no = 0;
+
+    while (i < packets_no)
+    {
+        window_no = packets_no - i;
+        if (window_no > SEC_BURST_REORDER_WINDOW)
+        {
+            window_no = SEC_BURST_REORDER_WINDOW;
+        }
+
+        // The packets of a context are consecutive in the window and a context
+        // is in one job ring, so SEC reuses its shared descriptor for the group
+        group_burst_by_context(&packets[i], window_no);
+
+        for (j = 0; j < window_no; j++, i++)
+        {
+            // Driver state and arguments are validated for each packet
+            ret = process_packet(packets[i].sec_ctx_handle,
+                                 packets[i].in_packet,
+                                 packets[i].out_packet,
+                                 packets[i].hfn_ov_val,
+                                 packets[i].ua_ctx_handle,
+                                 NULL,
+                                 FALSE);
+            if (ret != SEC_SUCCESS)
+            {
+                *submitted_no = i;
+                return ret;
+            }
+        }
+    }
+
+    *submitted_no = packets_no;
+
+    return SEC_SUCCESS;
+}
+
+static sec_return_code_t process_packet(sec_context_handle_t sec_ctx_handle,
+                                        const sec_packet_t *in_packet,
+                                        const sec_packet_t *out_packet,
+                                        uint32_t hfn_ov_val,
+                                        ua_context_handle_t ua_ctx_handle,
+                                        const dma_addr_t *sg_tbls_phys,
+                                        uint32_t hw_only)
 {
     int ret = SEC_SUCCESS;
     sec_job_t *job = NULL;
@@ -1334,8 +2526,8 @@ sec_return_code_t sec_process_packet_hfn_ov(sec_context_handle_t sec_ctx_handle,
 #warning "There should be a validation for maximum packet length"
 #if (SEC_ENABLE_SCATTER_GATHER == ON)
 #warning "Add some more validation here"
-    SEC_ASSERT(in_packet->num_fragments < SEC_MAX_SG_TBL_ENTRIES, SEC_INVALID_INPUT_PARAM, "in_packet->num_fragments too large");
-    SEC_ASSERT(out_packet->num_fragments < SEC_MAX_SG_TBL_ENTRIES, SEC_INVALID_INPUT_PARAM, "out_packet->num_fragments too large");
+    SEC_ASSERT(in_packet->num_fragments <= SEC_MAX_SG_FRAGMENTS, SEC_INVALID_INPUT_PARAM, "in_packet->num_fragments too large");
+    SEC_ASSERT(out_packet->num_fragments <= SEC_MAX_SG_FRAGMENTS, SEC_INVALID_INPUT_PARAM, "out_packet->num_fragments too large");
 #else // (SEC_ENABLE_SCATTER_GATHER == ON)
     SEC_ASSERT(in_packet->num_fragments == 0, SEC_INVALID_INPUT_PARAM, "Please enable Scatter Gather support");
     SEC_ASSERT(out_packet->num_fragments == 0, SEC_INVALID_INPUT_PARAM, "Please enable Scatter Gather support");
@@ -1366,12 +2558,49 @@ sec_return_code_t sec_process_packet_hfn_ov(sec_context_handle_t sec_ctx_handle,
                "Job ring with id %d is currently resetting. "
                "Can use it again after reset is over(when sec_poll function/s return)", job_ring->jr_id);
 
+    SEC_TRACE(SEC_TRACE_SUBMIT, job_ring->jr_id, SEC_PACKET_LENGTH(in_packet));
+
+#if (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+    if (sec_context->null_passthrough == TRUE && hw_only == FALSE &&
+        process_null_packet_on_cpu(job_ring, sec_context, in_packet, out_packet,
+                                   hfn_ov_val, ua_ctx_handle) == TRUE)
+    {
+        SEC_JR_COUNT(job_ring, tx_counters, packets, 1);
+        SEC_JR_COUNT(job_ring, tx_counters, bytes, SEC_PACKET_LENGTH(in_packet));
+        return SEC_SUCCESS;
+    }
+#endif // (SEC_ENABLE_NULL_PASSTHROUGH == ON)
+
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+    if (sec_context->ks_cache != NULL && hw_only == FALSE &&
+        process_packet_from_ks_cache(job_ring, sec_context, in_packet, out_packet,
+                                     hfn_ov_val, ua_ctx_handle) == TRUE)
+    {
+        SEC_JR_COUNT(job_ring, tx_counters, packets, 1);
+        SEC_JR_COUNT(job_ring, tx_counters, bytes, SEC_PACKET_LENGTH(in_packet));
+        return SEC_SUCCESS;
+    }
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+    if (sec_context->cpu_capable == TRUE && hw_only == FALSE &&
+        dispatch_packet_to_cpu(job_ring, sec_context, in_packet, out_packet,
+                               hfn_ov_val, ua_ctx_handle) == TRUE)
+    {
+        SEC_JR_COUNT(job_ring, tx_counters, packets, 1);
+        SEC_JR_COUNT(job_ring, tx_counters, bytes, SEC_PACKET_LENGTH(in_packet));
+        return SEC_SUCCESS;
+    }
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+
     if( SEC_JOB_RING_IS_FULL(job_ring->pidx, job_ring->cidx,
                               SEC_JOB_RING_SIZE,SEC_JOB_RING_SIZE ) )
     {
         SEC_DEBUG("Jr[%p] pi[%d] ci[%d].Job Ring is full.",
                           job_ring, job_ring->pidx, job_ring->cidx);
-                return SEC_JR_IS_FULL;
+        SEC_JR_COUNT(job_ring, tx_counters, jr_full, 1);
+        SEC_TRACE(SEC_TRACE_JR_FULL, job_ring->jr_id, job_ring->pidx);
+        return SEC_JR_IS_FULL;
     }
 
     SEC_DEBUG("Jr[%p] pi[%d] ci[%d].Before sending packet",
@@ -1381,29 +2610,68 @@ sec_return_code_t sec_process_packet_hfn_ov(sec_context_handle_t sec_ctx_handle,
     job = &job_ring->jobs[job_ring->pidx];
 #if (SEC_ENABLE_SCATTER_GATHER == ON)
 
-    ret = build_sg_context(job->sg_ctx,in_packet,SEC_SG_CONTEXT_TYPE_IN,in_packet->num_fragments);
-    if( ret != SEC_SUCCESS )
+    if( sg_tbls_phys != NULL )
     {
-        SEC_ERROR("Error creating Scatter-Gather table for input packet: %s",sec_get_error_message(ret));
-        return ret;
+        // SG tables formatted by UA with sec_build_sg_tbl(), nothing to build
+        SEC_ASSERT(in_packet->num_fragments == 0 || sg_tbls_phys[0] != 0,
+                   SEC_INVALID_INPUT_PARAM, "in_sg_tbl_phys is 0");
+        SEC_ASSERT(out_packet->num_fragments == 0 || sg_tbls_phys[1] != 0,
+                   SEC_INVALID_INPUT_PARAM, "out_sg_tbl_phys is 0");
+
+        use_sg_tbl(job->sg_ctx, in_packet, SEC_SG_CONTEXT_TYPE_IN, sg_tbls_phys[0]);
+        use_sg_tbl(job->sg_ctx, out_packet, SEC_SG_CONTEXT_TYPE_OUT, sg_tbls_phys[1]);
     }
-
-    ret = build_sg_context(job->sg_ctx,out_packet,SEC_SG_CONTEXT_TYPE_OUT,out_packet->num_fragments);
-    if( ret != SEC_SUCCESS )
+    else
     {
-        SEC_ERROR("Error creating Scatter-Gather table for output packet: %s",sec_get_error_message(ret));
-        return ret;
+        ret = prepare_sg_context(job_ring, job->sg_ctx, in_packet, SEC_SG_CONTEXT_TYPE_IN);
+        if( ret == SEC_SUCCESS )
+        {
+            ret = prepare_sg_context(job_ring, job->sg_ctx, out_packet, SEC_SG_CONTEXT_TYPE_OUT);
+        }
+        if( ret != SEC_SUCCESS )
+        {
+            // The job is not submitted, give back the SG tables already taken
+            release_sg_context(&job_ring->sg_tbl_pool, job->sg_ctx);
+
+            // SEC_JR_IS_FULL means that all the SG tables that fit this packet
+            // are used by jobs in flight, UA must poll before retrying
+            if( ret != SEC_JR_IS_FULL )
+            {
+                SEC_ERROR_RL("Error creating Scatter-Gather table: %s",sec_get_error_message(ret));
+            }
+            else
+            {
+                SEC_JR_COUNT(job_ring, tx_counters, jr_full, 1);
+            }
+            return ret;
+        }
     }
 
 #endif // (SEC_ENABLE_SCATTER_GATHER == ON)
 
     // update job with crypto context and in/out packet data
+#if (SEC_ENABLE_PACKET_COPY == ON)
+    // Contiguous packets are copied into the job, UA can reuse its structures right away
+    if (in_packet->num_fragments == 0)
+    {
+        job->packet_copies[0] = *in_packet;
+        in_packet = &job->packet_copies[0];
+    }
+    if (out_packet->num_fragments == 0)
+    {
+        job->packet_copies[1] = *out_packet;
+        out_packet = &job->packet_copies[1];
+    }
+#endif // (SEC_ENABLE_PACKET_COPY == ON)
     job->in_packet = in_packet;
     job->out_packet = out_packet;
 
     job->sec_context = sec_context;
     job->ua_handle = ua_ctx_handle;
     job->dpovrd_value = hfn_ov_val;
+#if (SEC_JOB_TIMESTAMPS == ON)
+    job->submit_tb = sec_get_timebase();
+#endif // (SEC_JOB_TIMESTAMPS == ON)
 
     // update descriptor with pointers to input/output data and pointers to crypto information
     ASSERT(job->descr != NULL);
@@ -1418,17 +2686,121 @@ sec_return_code_t sec_process_packet_hfn_ov(sec_context_handle_t sec_ctx_handle,
 
     // keep count of submitted packets for this sec context
     CONTEXT_ADD_PACKET(sec_context);
+    CONTEXT_ADD_HW_PACKET(sec_context);
 
     // Set ptr in input ring to current descriptor
     job_ring->input_ring[job_ring->pidx] = job->descr_phys_addr;
 
     // Notify HW that a new job is enqueued
     hw_enqueue_packet_on_job_ring(job_ring);
+    SEC_TRACE(SEC_TRACE_DOORBELL, job_ring->jr_id, job_ring->pidx);
 
     // increment the producer index for the current job ring
     job_ring->pidx = SEC_CIRCULAR_COUNTER(job_ring->pidx, SEC_JOB_RING_SIZE);
 
+    SEC_JR_COUNT(job_ring, tx_counters, packets, 1);
+    SEC_JR_COUNT(job_ring, tx_counters, bytes, SEC_PACKET_LENGTH(in_packet));
+
+    return SEC_SUCCESS;
+}
+
+sec_return_code_t sec_enable_keystream_cache(sec_context_handle_t sec_ctx_handle,
+                                             uint32_t next_count)
+{
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+    const sec_pdcp_context_info_t *pdcp_crypto_info = NULL;
+    sec_context_t * sec_context = (sec_context_t *)sec_ctx_handle;
+
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    // Validate input arguments
+    SEC_ASSERT(sec_context != NULL, SEC_INVALID_INPUT_PARAM, "sec_ctx_handle is NULL");
+    SEC_ASSERT(COND_EXPR1_EQ_AND_EXPR2_EQ(sec_context->start_pattern,
+                                          CONTEXT_VALIDATION_PATTERN,
+                                          sec_context->end_pattern,
+                                          CONTEXT_VALIDATION_PATTERN),
+               SEC_INVALID_INPUT_PARAM,
+               "sec_ctx_handle is invalid");
+    SEC_ASSERT(sec_context->state == SEC_CONTEXT_USED,
+               SEC_CONTEXT_MARKED_FOR_DELETION,
+               "SEC context is marked for deletion.");
+    // Only User Plane contexts ciphered with SNOW or AES, for which UA provides
+    // the HFN with every packet, can have their keystream generated in advance.
+    // These checks are done also in release builds: a keystream cache on any
+    // other context would corrupt the packets.
+    pdcp_crypto_info = sec_context->crypto_info.pdcp_crypto_info;
+    if (pdcp_context_is_cpu_capable(sec_context) == FALSE)
+    {
+        SEC_ERROR("Context %p is not eligible for a keystream cache. A P2V function, HFN override, "
+                  "PDCP User Plane, SNOW or AES ciphering with a 16 byte key and 7 or 12 bit SN are required",
+                  sec_context);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    // Enabling the cache again resynchronizes it on a new COUNT
+    sec_ks_cache_destroy(sec_context->ks_cache);
+    sec_context->ks_cache = sec_ks_cache_create(pdcp_crypto_info, next_count);
+    if (sec_context->ks_cache == NULL)
+    {
+        SEC_ERROR("Failed to allocate keystream cache for context %p", sec_context);
+        return SEC_OUT_OF_MEMORY;
+    }
+
+    SEC_DEBUG("Context %p: keystream cache enabled from COUNT 0x%x", sec_context, next_count);
+
     return SEC_SUCCESS;
+#else
+    SEC_ERROR("Keystream cache support is disabled, see SEC_ENABLE_KEYSTREAM_CACHE");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+}
+
+sec_return_code_t sec_refill_keystream_cache(sec_context_handle_t sec_ctx_handle,
+                                             uint32_t budget,
+                                             uint32_t *entries_no)
+{
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+    sec_context_t * sec_context = (sec_context_t *)sec_ctx_handle;
+    uint32_t generated = 0;
+
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    // Validate input arguments
+    SEC_ASSERT(sec_context != NULL, SEC_INVALID_INPUT_PARAM, "sec_ctx_handle is NULL");
+    SEC_ASSERT(COND_EXPR1_EQ_AND_EXPR2_EQ(sec_context->start_pattern,
+                                          CONTEXT_VALIDATION_PATTERN,
+                                          sec_context->end_pattern,
+                                          CONTEXT_VALIDATION_PATTERN),
+               SEC_INVALID_INPUT_PARAM,
+               "sec_ctx_handle is invalid");
+
+    // The cache is released when the context is deleted
+    if (sec_context->ks_cache == NULL)
+    {
+        SEC_DEBUG("Keystream cache is not enabled on context %p", sec_context);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    generated = sec_ks_cache_refill(sec_context->ks_cache, budget);
+
+    if (entries_no != NULL)
+    {
+        *entries_no = generated;
+    }
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Keystream cache support is disabled, see SEC_ENABLE_KEYSTREAM_CACHE");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_KEYSTREAM_CACHE == ON)
 }
 
 int32_t sec_get_last_error(void)
@@ -1460,6 +2832,39 @@ const char* sec_get_error_message(sec_return_code_t return_code)
 }
 
 
+sec_return_code_t sec_set_sg_linearization(sec_job_ring_handle_t job_ring_handle,
+                                           uint32_t max_length,
+                                           uint32_t max_fragments)
+{
+#if (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+    sec_job_ring_t * job_ring =  (sec_job_ring_t *)job_ring_handle;
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    SEC_ASSERT(job_ring_handle != NULL, SEC_INVALID_INPUT_PARAM, "job_ring_handle is NULL");
+
+#if (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+    if (max_length > SEC_SG_BOUNCE_BUF_SIZE || (max_length != 0 && g_sec_ptov == NULL))
+    {
+        SEC_ERROR("Cannot linearize packets of %d bytes", max_length);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    job_ring->sg_linearize_max_length = max_length;
+    job_ring->sg_linearize_max_fragments = max_fragments;
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Linearization of fragmented packets is not enabled");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+}
+
 sec_return_code_t sec_get_stats(sec_job_ring_handle_t job_ring_handle,sec_statistics_t* sec_stat)
 {
     sec_job_ring_t * job_ring =  (sec_job_ring_t *)job_ring_handle;
@@ -1487,6 +2892,230 @@ sec_return_code_t sec_get_stats(sec_job_ring_handle_t job_ring_handle,sec_statis
 
     return SEC_SUCCESS;
 }
+
+sec_return_code_t sec_get_stats_ext(sec_job_ring_handle_t job_ring_handle,
+                                    sec_statistics_ext_t *sec_stat)
+{
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    sec_job_ring_t * job_ring =  (sec_job_ring_t *)job_ring_handle;
+    sec_statistics_ext_t stats;
+    int ret;
+
+    SEC_ASSERT(sec_stat != NULL, SEC_INVALID_INPUT_PARAM, "sec_stat is NULL");
+    SEC_ASSERT(sec_stat->size >= offsetof(sec_statistics_ext_t, irq_enables) + sizeof(uint64_t),
+               SEC_INVALID_INPUT_PARAM, "sec_stat->size %d is too small", sec_stat->size);
+
+    memset(&stats, 0, sizeof(stats));
+
+    ret = sec_get_stats(job_ring_handle, &stats.jr);
+    if (ret != SEC_SUCCESS)
+    {
+        return ret;
+    }
+
+    stats.version = SEC_STATISTICS_EXT_VERSION;
+    stats.packets_submitted = job_ring->tx_counters.packets;
+    stats.bytes_submitted = job_ring->tx_counters.bytes;
+    stats.jr_full = job_ring->tx_counters.jr_full;
+    stats.packets_completed = job_ring->rx_counters.packets;
+    stats.bytes_completed = job_ring->rx_counters.bytes;
+    stats.icv_failures = job_ring->rx_counters.icv_failures;
+    stats.hfn_threshold_reached = job_ring->rx_counters.hfn_threshold_reached;
+    stats.error_packets = job_ring->rx_counters.error_packets;
+    stats.jr_resets = job_ring->rx_counters.jr_resets;
+    stats.empty_polls = job_ring->rx_counters.empty_polls;
+    stats.irq_enables = job_ring->rx_counters.irq_enables;
+    stats.polls = job_ring->rx_counters.polls;
+    stats.callback_ticks = job_ring->rx_counters.callback_ticks;
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+    stats.poll_weight = job_ring->poll_tuner.weight;
+    stats.poll_weight_changes = job_ring->poll_tuner.weight_changes;
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+
+    // UA built with an older, shorter structure gets only the fields it knows about
+    stats.size = (sec_stat->size < sizeof(stats)) ? sec_stat->size : sizeof(stats);
+    memcpy(sec_stat, &stats, stats.size);
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Job ring counters are not enabled");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+}
+
+sec_return_code_t sec_get_latency_stats(sec_job_ring_handle_t job_ring_handle,
+                                        sec_latency_stats_t *latency_stats)
+{
+#if (SEC_ENABLE_LATENCY_STATS == ON)
+    sec_job_ring_t * job_ring =  (sec_job_ring_t *)job_ring_handle;
+
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    SEC_ASSERT(job_ring != NULL, SEC_INVALID_INPUT_PARAM, "job_ring_handle is NULL");
+    SEC_ASSERT(latency_stats != NULL, SEC_INVALID_INPUT_PARAM, "latency_stats is NULL");
+
+    memcpy(latency_stats, &job_ring->latency_stats, sizeof(sec_latency_stats_t));
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Latency statistics are not enabled");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_LATENCY_STATS == ON)
+}
+
+uint32_t sec_get_latency_percentile(const sec_latency_histogram_t *hist,
+                                    uint32_t percentile)
+{
+    SEC_ASSERT(hist != NULL, 0, "hist is NULL");
+
+    // Checked also in release builds: a larger value would rank past the last latency
+    if (percentile > 10000)
+    {
+        percentile = 10000;
+    }
+
+    return sec_latency_percentile(hist, percentile);
+}
+
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+static void get_context_stats(const sec_context_t *sec_context,
+                              uint32_t now,
+                              sec_context_stats_t *ctx_stats)
+{
+    ctx_stats->sec_ctx_handle = (sec_context_handle_t)sec_context;
+    ctx_stats->jr_handle = sec_context->jr_handle;
+    ctx_stats->packets = sec_context->counters.packets;
+    ctx_stats->bytes = sec_context->counters.bytes;
+    ctx_stats->icv_failures = sec_context->counters.icv_failures;
+    ctx_stats->hfn_threshold_reached = sec_context->counters.hfn_threshold_reached;
+    ctx_stats->overdue = sec_context->counters.overdue;
+    ctx_stats->errors = sec_context->counters.errors;
+    ctx_stats->last_activity = sec_context->counters.last_activity;
+    ctx_stats->idle_ticks = now - ctx_stats->last_activity;
+    ctx_stats->packets_in_flight = CONTEXT_GET_PACKETS_NO(sec_context);
+    ctx_stats->retiring = (sec_context->state == SEC_CONTEXT_RETIRING) ? TRUE : FALSE;
+}
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+
+sec_return_code_t sec_get_context_stats(sec_context_handle_t sec_ctx_handle,
+                                        sec_context_stats_t *ctx_stats)
+{
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+    const sec_context_t *sec_context = (const sec_context_t *)sec_ctx_handle;
+
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    SEC_ASSERT(sec_context != NULL, SEC_INVALID_INPUT_PARAM, "sec_ctx_handle is NULL");
+    SEC_ASSERT(ctx_stats != NULL, SEC_INVALID_INPUT_PARAM, "ctx_stats is NULL");
+
+    // Validate that context handle contains valid bit patterns
+    SEC_ASSERT(COND_EXPR1_EQ_AND_EXPR2_EQ(sec_context->start_pattern,
+                                          CONTEXT_VALIDATION_PATTERN,
+                                          sec_context->end_pattern,
+                                          CONTEXT_VALIDATION_PATTERN),
+               SEC_INVALID_INPUT_PARAM,
+               "sec_ctx_handle is invalid");
+
+    get_context_stats(sec_context, sec_get_timebase(), ctx_stats);
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Context statistics are not enabled");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+}
+
+sec_return_code_t sec_get_contexts_stats(uint32_t *cursor,
+                                         sec_context_stats_t *ctx_stats,
+                                         uint32_t max_no,
+                                         uint32_t *stats_no)
+{
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+    sec_contexts_pool_t *pool = NULL;
+    const sec_context_t *sec_context = NULL;
+    uint32_t pool_start = 0;
+    uint32_t index;
+    uint32_t now;
+    int i;
+
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    SEC_ASSERT(cursor != NULL, SEC_INVALID_INPUT_PARAM, "cursor is NULL");
+    SEC_ASSERT(ctx_stats != NULL, SEC_INVALID_INPUT_PARAM, "ctx_stats is NULL");
+    SEC_ASSERT(stats_no != NULL, SEC_INVALID_INPUT_PARAM, "stats_no is NULL");
+
+    now = sec_get_timebase();
+    *stats_no = 0;
+
+    // The cursor is an index in the pools of the job rings followed by the global pool,
+    // as if their arrays of contexts were laid one after the other.
+    index = *cursor;
+    for (i = 0; i <= g_job_rings_no && *stats_no < max_no; i++)
+    {
+        pool = (i < g_job_rings_no) ? &g_job_rings[i].ctx_pool : &g_ctx_pool;
+
+        for (; index < pool_start + pool->no_of_contexts && *stats_no < max_no; index++)
+        {
+            sec_context = &pool->sec_contexts[index - pool_start];
+            if (sec_context->state == SEC_CONTEXT_UNUSED)
+            {
+                continue;
+            }
+            get_context_stats(sec_context, now, &ctx_stats[*stats_no]);
+            (*stats_no)++;
+        }
+        pool_start += pool->no_of_contexts;
+    }
+    *cursor = index;
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Context statistics are not enabled");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+}
+
+sec_return_code_t sec_get_dma_mem_usage(sec_dma_mem_usage_t *usage)
+{
+    int i;
+
+    // Validate driver state
+    SEC_ASSERT(g_driver_state == SEC_DRIVER_STATE_STARTED,
+               (g_driver_state == SEC_DRIVER_STATE_RELEASE) ?
+               SEC_DRIVER_RELEASE_IN_PROGRESS : SEC_DRIVER_NOT_INITIALIZED,
+               "Driver release is in progress or driver not initialized");
+
+    SEC_ASSERT(usage != NULL, SEC_INVALID_INPUT_PARAM, "usage is NULL");
+
+    memset(usage, 0, sizeof(sec_dma_mem_usage_t));
+
+    usage->total_size = g_dma_arena.size;
+    usage->used_size = g_dma_arena.used_size;
+    usage->max_used_size = g_dma_arena.max_used_size;
+    usage->largest_free_size = dma_mem_get_largest_free(&g_dma_arena);
+
+    usage->job_rings_no = g_job_rings_no;
+    for (i = 0; i < g_job_rings_no; i++)
+    {
+        usage->job_ring[i] = g_job_rings[i].dma_mem_size;
+        usage->ctx_pool[i] = g_job_rings[i].ctx_pool.dma_mem_size;
+    }
+    usage->global_ctx_pool = g_ctx_pool.dma_mem_size;
+
+    return SEC_SUCCESS;
+}
 /*================================================================================================*/
 
 #ifdef __cplusplus
@@ -42,6 +42,7 @@ extern "C" {
 #include "sec_utils.h"
 #include "sec_hw_specific.h"
 #include "sec_config.h"
+#include "sec_trace.h"
 
 /*==================================================================================================
                                      LOCAL DEFINES
@@ -69,6 +70,8 @@ extern "C" {
 /* Job rings used for communication with SEC HW */
 sec_job_ring_t g_job_rings[MAX_SEC_JOB_RINGS];
 extern sec_vtop g_sec_vtop;
+/** @brief Physical to virtual address conversion callback */
+extern sec_ptov g_sec_ptov;
 
 /*==================================================================================================
                                  LOCAL FUNCTION PROTOTYPES
@@ -81,7 +84,7 @@ extern sec_vtop g_sec_vtop;
 /*==================================================================================================
                                      GLOBAL FUNCTIONS
 ==================================================================================================*/
-int init_job_ring(sec_job_ring_t * job_ring, void **dma_mem, int startup_work_mode
+int init_job_ring(sec_job_ring_t * job_ring, sec_dma_mem_arena_t *dma_arena, int startup_work_mode
         , uint16_t irq_coalescing_timer, uint8_t irq_coalescing_count
         )
 {
@@ -89,39 +92,36 @@ int init_job_ring(sec_job_ring_t * job_ring, void **dma_mem, int startup_work_mo
     int i = 0;
 
     ASSERT(job_ring != NULL);
-    ASSERT(dma_mem != NULL);
+    ASSERT(dma_arena != NULL);
 
     SEC_INFO("Job ring %d UIO fd = %d", job_ring->jr_id, job_ring->uio_fd);
 
-    // Memory area must start from cacheline-aligned boundary.
+    // Every region allocated from the arena starts from a cacheline-aligned boundary.
     // Each job entry is itself aligned to cacheline.
-    SEC_ASSERT ((uintptr_t)*dma_mem % L1_CACHE_BYTES == 0,
-            SEC_INVALID_INPUT_PARAM,
-            "Current memory position is not cacheline aligned."
-            "Job ring id = %d", job_ring->jr_id);
-
-    // Allocate mem for input and output ring
-    ASSERT(job_ring->input_ring == NULL);
+    job_ring->dma_arena = dma_arena;
+    job_ring->dma_mem_size = 0;
 
     // Allocate memory for input ring
-    job_ring->input_ring = *dma_mem;
+    ASSERT(job_ring->input_ring == NULL);
+    job_ring->input_ring = dma_mem_alloc(dma_arena, SEC_DMA_MEM_INPUT_RING_SIZE,
+                                         L1_CACHE_BYTES, &job_ring->dma_mem_size);
+    if (job_ring->input_ring == NULL)
+    {
+        SEC_ERROR("Failed to allocate input ring for job ring id %d", job_ring->jr_id);
+        return SEC_OUT_OF_MEMORY;
+    }
     memset(job_ring->input_ring, 0, SEC_DMA_MEM_INPUT_RING_SIZE);
-    *dma_mem += SEC_DMA_MEM_INPUT_RING_SIZE;
 
     // Allocate memory for output ring
     ASSERT(job_ring->output_ring == NULL);
-
-    SEC_ASSERT ((uintptr_t)*dma_mem % L1_CACHE_BYTES == 0,
-            SEC_INVALID_INPUT_PARAM,
-            "Current memory position is not cacheline aligned."
-            "Job ring id = %d", job_ring->jr_id);
-    SEC_ASSERT ((uintptr_t)*dma_mem % L1_CACHE_BYTES == 0,
-                                SEC_INVALID_INPUT_PARAM,
-                                "Current memory position is not cacheline aligned."
-                                "Job ring id = %d", job_ring->jr_id);
-    job_ring->output_ring = *dma_mem;
+    job_ring->output_ring = dma_mem_alloc(dma_arena, SEC_DMA_MEM_OUTPUT_RING_SIZE,
+                                          L1_CACHE_BYTES, &job_ring->dma_mem_size);
+    if (job_ring->output_ring == NULL)
+    {
+        SEC_ERROR("Failed to allocate output ring for job ring id %d", job_ring->jr_id);
+        return SEC_OUT_OF_MEMORY;
+    }
     memset(job_ring->output_ring, 0, SEC_DMA_MEM_OUTPUT_RING_SIZE);
-    *dma_mem += SEC_DMA_MEM_OUTPUT_RING_SIZE;
 
     // Reset job ring in SEC hw and configure job ring registers
     ret = hw_reset_job_ring(job_ring);
@@ -147,19 +147,39 @@ int init_job_ring(sec_job_ring_t * job_ring, void **dma_mem, int startup_work_mo
     // Allocate job items from the DMA-capable memory area provided by UA
     ASSERT(job_ring->descriptors == NULL);
 
-    job_ring->descriptors = *dma_mem;
+    job_ring->descriptors = dma_mem_alloc(dma_arena, SEC_DMA_MEM_DESCRIPTORS,
+                                          L1_CACHE_BYTES, &job_ring->dma_mem_size);
+    if (job_ring->descriptors == NULL)
+    {
+        SEC_ERROR("Failed to allocate descriptors for job ring id %d", job_ring->jr_id);
+        return SEC_OUT_OF_MEMORY;
+    }
 
     /* Store base address here. It will be used for 'lookups' in sec_poll() */
     job_ring->descriptors_base_addr = g_sec_vtop(job_ring->descriptors);
     
     memset(job_ring->descriptors, 0, SEC_DMA_MEM_DESCRIPTORS);
-    *dma_mem += SEC_DMA_MEM_DESCRIPTORS;
 
-    // TODO: check that we do not use more DMA mem than actually allocated/reserved for us by User App.
-    // Options:
-    // - check if used more than #SEC_DMA_MEMORY_SIZE and/or
-    // - implement wrapper functions that access dma_mem and maintain/increment size of dma mem used -> central point of
-    // accessing dma mem -> central point of check for boundary issues!
+#if (SEC_ENABLE_SCATTER_GATHER == ON)
+    // The SG tables are shared by all the jobs, through the pool of SG tables.
+    // A job takes a table only for a fragmented packet, sized for its fragments.
+    ASSERT(job_ring->sg_tbls == NULL);
+    job_ring->sg_tbls = dma_mem_alloc(dma_arena, SEC_DMA_MEM_SG_SIZE,
+                                      L1_CACHE_BYTES, &job_ring->dma_mem_size);
+    if (job_ring->sg_tbls == NULL)
+    {
+        SEC_ERROR("Failed to allocate SG tables for job ring id %d", job_ring->jr_id);
+        return SEC_OUT_OF_MEMORY;
+    }
+    memset(job_ring->sg_tbls, 0, SEC_DMA_MEM_SG_SIZE);
+    init_sg_tbl_pool(&job_ring->sg_tbl_pool, job_ring->sg_tbls, g_sec_vtop(job_ring->sg_tbls));
+
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+    // Linearization copies the fragments, so it needs their virtual addresses
+    job_ring->sg_linearize_max_length = (g_sec_ptov != NULL) ? SEC_SG_LINEARIZE_MAX_LENGTH : 0;
+    job_ring->sg_linearize_max_fragments = SEC_SG_LINEARIZE_MAX_FRAGMENTS;
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON)
 
     for(i = 0; i < SEC_JOB_RING_SIZE; i++)
     {
@@ -171,25 +191,16 @@ int init_job_ring(sec_job_ring_t * job_ring, void **dma_mem, int startup_work_mo
 
 #if (SEC_ENABLE_SCATTER_GATHER == ON)
         job_ring->jobs[i].sg_ctx = &job_ring->sg_ctxs[i];
-
-        // Need two SG tables, one for input packet, the other for the output
-        SEC_ASSERT ((uintptr_t)*dma_mem % L1_CACHE_BYTES == 0,
-                        SEC_INVALID_INPUT_PARAM,
-                        "Current jobs[i]->sg_ctx [i=%d] input SG table is not cacheline aligned.", i);
-        job_ring->sg_ctxs[i].in_sg_tbl = (struct sec_sg_tbl_entry*)*dma_mem;
-        memset(job_ring->sg_ctxs[i].in_sg_tbl, 0, sizeof(struct sec_sg_tbl_entry) * SEC_MAX_SG_TBL_ENTRIES);
-        *dma_mem += sizeof(struct sec_sg_tbl_entry) * SEC_MAX_SG_TBL_ENTRIES;
-
-        SEC_ASSERT ((uintptr_t)*dma_mem % L1_CACHE_BYTES == 0,
-                                SEC_INVALID_INPUT_PARAM,
-                                "Current jobs[i]->sg_ctx [i=%d] output SG table is not cacheline aligned.", i);
-        job_ring->sg_ctxs[i].out_sg_tbl = (struct sec_sg_tbl_entry*)*dma_mem;
-        memset(job_ring->sg_ctxs[i].out_sg_tbl, 0, sizeof(struct sec_sg_tbl_entry) * SEC_MAX_SG_TBL_ENTRIES);
-        *dma_mem += sizeof(struct sec_sg_tbl_entry) * SEC_MAX_SG_TBL_ENTRIES;
-
-        job_ring->sg_ctxs[i].in_sg_tbl_phy = g_sec_vtop(job_ring->sg_ctxs[i].in_sg_tbl);
-        job_ring->sg_ctxs[i].out_sg_tbl_phy = g_sec_vtop(job_ring->sg_ctxs[i].out_sg_tbl);
-
+        job_ring->sg_ctxs[i].in_sg_tbl_en = 0;
+        job_ring->sg_ctxs[i].out_sg_tbl_en = 0;
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+        // The bounce buffers come after the SG tables
+        job_ring->sg_ctxs[i].bounce_buf = (uint8_t*)job_ring->sg_tbls + SEC_DMA_MEM_SG_TBLS_SIZE +
+                                          i * 2 * SEC_SG_BOUNCE_BUF_SIZE;
+        job_ring->sg_ctxs[i].bounce_buf_phy = g_sec_vtop(job_ring->sg_ctxs[i].bounce_buf);
+        job_ring->sg_ctxs[i].in_bounce_en = 0;
+        job_ring->sg_ctxs[i].out_bounce_en = 0;
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
 #endif // (SEC_ENABLE_SCATTER_GATHER == ON)
     }
 
@@ -201,6 +212,21 @@ int init_job_ring(sec_job_ring_t * job_ring, void **dma_mem, int startup_work_mo
     hw_job_ring_enable_coalescing(job_ring);
 #endif // SEC_INT_COALESCING_ENABLE == ON
 
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+    // Nothing measured yet: packets go to the CPU only by size or ring occupancy
+    job_ring->hw_latency = 0;
+    job_ring->cpu_block_cost = 0;
+    job_ring->hw_dispatch_tb = 0;
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    // IRQs enabled above at startup are not counted
+    memset(&job_ring->tx_counters, 0, sizeof(job_ring->tx_counters));
+    memset(&job_ring->rx_counters, 0, sizeof(job_ring->rx_counters));
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+#if (SEC_ENABLE_LATENCY_STATS == ON)
+    memset(&job_ring->latency_stats, 0, sizeof(job_ring->latency_stats));
+#endif // (SEC_ENABLE_LATENCY_STATS == ON)
+
     job_ring->jr_state = SEC_JOB_RING_STATE_STARTED;
 
     return SEC_SUCCESS;
@@ -238,6 +264,21 @@ int shutdown_job_ring(sec_job_ring_t * job_ring)
         close(job_ring->uio_fd);
     }
 
+    // Return the DMA-capable memory of this job ring to the arena
+    if (job_ring->dma_arena != NULL)
+    {
+#if (SEC_ENABLE_SCATTER_GATHER == ON)
+        dma_mem_free(job_ring->dma_arena, job_ring->sg_tbls,
+                     SEC_DMA_MEM_SG_SIZE, &job_ring->dma_mem_size);
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+        dma_mem_free(job_ring->dma_arena, job_ring->descriptors,
+                     SEC_DMA_MEM_DESCRIPTORS, &job_ring->dma_mem_size);
+        dma_mem_free(job_ring->dma_arena, job_ring->output_ring,
+                     SEC_DMA_MEM_OUTPUT_RING_SIZE, &job_ring->dma_mem_size);
+        dma_mem_free(job_ring->dma_arena, job_ring->input_ring,
+                     SEC_DMA_MEM_INPUT_RING_SIZE, &job_ring->dma_mem_size);
+    }
+
     memset(job_ring, 0, sizeof(sec_job_ring_t));
 
     return SEC_SUCCESS;
@@ -269,6 +310,8 @@ void uio_job_ring_enable_irqs(sec_job_ring_t *job_ring)
                         "Failed to request SEC engine to enable job done and "
                         "error IRQs through UIO control. Job ring id %d. Reset SEC driver!",
                         job_ring->jr_id);
+    SEC_JR_COUNT(job_ring, rx_counters, irq_enables, 1);
+    SEC_TRACE(SEC_TRACE_IRQ_ENABLE, job_ring->jr_id, 0);
     SEC_DEBUG("Jr[%p]. Enabled IRQs on jr id %d", job_ring, job_ring->jr_id);
 }
 
@@ -81,6 +81,76 @@
  * capacity of SEC's hardware FIFO. */
 #define SEC_JOB_RING_IS_FULL            FIFO_IS_FULL
 
+/** DMA memory allocated by init_job_ring() for a job ring */
+#if (SEC_ENABLE_SCATTER_GATHER == ON)
+#define SEC_JOB_RING_DMA_MEM_SIZE   (SEC_DMA_MEM_REGION_SIZE(SEC_DMA_MEM_INPUT_RING_SIZE) + \
+                                     SEC_DMA_MEM_REGION_SIZE(SEC_DMA_MEM_OUTPUT_RING_SIZE) + \
+                                     SEC_DMA_MEM_REGION_SIZE(SEC_DMA_MEM_DESCRIPTORS) + \
+                                     SEC_DMA_MEM_REGION_SIZE(SEC_DMA_MEM_SG_SIZE))
+#else // (SEC_ENABLE_SCATTER_GATHER == ON)
+#define SEC_JOB_RING_DMA_MEM_SIZE   (SEC_DMA_MEM_REGION_SIZE(SEC_DMA_MEM_INPUT_RING_SIZE) + \
+                                     SEC_DMA_MEM_REGION_SIZE(SEC_DMA_MEM_OUTPUT_RING_SIZE) + \
+                                     SEC_DMA_MEM_REGION_SIZE(SEC_DMA_MEM_DESCRIPTORS))
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+
+/** Jobs can point to packets stored by the driver, that must be saved before the job is freed */
+#if (SEC_ENABLE_PACKET_COPY == ON) || (SEC_ENABLE_IOV_SUBMISSION == ON)
+#define SEC_JOB_STORES_PACKETS  ON
+#else
+#define SEC_JOB_STORES_PACKETS  OFF
+#endif
+
+/** Jobs are timestamped when they are enqueued */
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON) || (SEC_ENABLE_LATENCY_STATS == ON) || \
+    (SEC_ENABLE_POLL_AUTOTUNE == ON)
+#define SEC_JOB_TIMESTAMPS  ON
+#else
+#define SEC_JOB_TIMESTAMPS  OFF
+#endif
+
+/** The time base is read once per poll that dequeues jobs */
+#if (SEC_JOB_TIMESTAMPS == ON) || (SEC_ENABLE_CONTEXT_STATS == ON)
+#define SEC_POLL_TIMESTAMP  ON
+#else
+#define SEC_POLL_TIMESTAMP  OFF
+#endif
+
+/** Most fragments of a packet stored by the driver for a job */
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+#define SEC_JOB_MAX_STORED_FRAGMENTS    SEC_IOV_MAX_FRAGMENTS
+#else
+#define SEC_JOB_MAX_STORED_FRAGMENTS    1
+#endif
+
+/** Add to a cumulative counter of a job ring, see ::sec_jr_tx_counters_t and ::sec_jr_rx_counters_t */
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+#define SEC_JR_COUNT(job_ring, counters, counter, value)    ((job_ring)->counters.counter += (value))
+#else
+#define SEC_JR_COUNT(job_ring, counters, counter, value)
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+
+#if (SEC_ENABLE_CALLBACK_TIMING == ON) && (SEC_ENABLE_JR_COUNTERS == OFF)
+#error "SEC_ENABLE_CALLBACK_TIMING requires SEC_ENABLE_JR_COUNTERS"
+#endif
+
+/* Packets processed on the CPU raise no interrupt, they are notified only by polling */
+#if (SEC_ENABLE_CPU_JOBS == ON) && (SEC_NOTIFICATION_TYPE != SEC_NOTIFICATION_TYPE_POLL)
+#error "SEC_ENABLE_KEYSTREAM_CACHE, SEC_ENABLE_HYBRID_DISPATCH and SEC_ENABLE_NULL_PASSTHROUGH require SEC_NOTIFICATION_TYPE_POLL"
+#endif
+
+/** Time the callbacks of UA, see #SEC_ENABLE_CALLBACK_TIMING */
+#if (SEC_ENABLE_CALLBACK_TIMING == ON)
+#define SEC_CBK_TIMING_START(start)         ((start) = sec_get_timebase())
+#define SEC_CBK_TIMING_STOP(job_ring, start) \
+    SEC_JR_COUNT(job_ring, rx_counters, callback_ticks, (uint32_t)(sec_get_timebase() - (start)))
+#else
+#define SEC_CBK_TIMING_START(start)
+#define SEC_CBK_TIMING_STOP(job_ring, start)
+#endif // (SEC_ENABLE_CALLBACK_TIMING == ON)
+
+/** Number of data bytes of a packet, contiguous or fragmented */
+#define SEC_PACKET_LENGTH(packet)   ((packet)->num_fragments == 0 ? (packet)->length : (packet)->total_length)
+
 /*==============================================================================
                                     ENUMS
 ==============================================================================*/
@@ -102,10 +172,74 @@ struct sec_job_t
     const sec_packet_t *in_packet;      /*< Input packet */
     const sec_packet_t *out_packet;     /*< Output packet */
     ua_context_handle_t ua_handle;      /*< UA handle for the context this packet belongs to */
+#if (SEC_ENABLE_PACKET_COPY == ON)
+    sec_packet_t packet_copies[2];      /*< Copies of the input and output packets, if they are
+                                         * not fragmented. in_packet and out_packet point here. */
+#endif // (SEC_ENABLE_PACKET_COPY == ON)
     uint32_t dpovrd_value;              /*< Value to be loaded in the DPOVRD register, if DPOVRD mechanism
                                          * is enabled. */
+#if (SEC_JOB_TIMESTAMPS == ON)
+    uint32_t submit_tb;                 /*< Time base when the job was enqueued, see sec_get_timebase() */
+#endif // (SEC_JOB_TIMESTAMPS == ON)
 }____cacheline_aligned;
 
+#if (SEC_ENABLE_CPU_JOBS == ON)
+/** Packet processed on the CPU, waiting to be notified to UA on the next poll */
+struct sec_cpu_job_t
+{
+    sec_context_t *sec_context;         /*< SEC context this packet belongs to */
+    const sec_packet_t *in_packet;      /*< Input packet */
+    const sec_packet_t *out_packet;     /*< Output packet */
+    ua_context_handle_t ua_handle;      /*< UA handle for the context this packet belongs to */
+    sec_status_t status;                /*< Status to be notified to UA */
+#if (SEC_ENABLE_PACKET_COPY == ON)
+    sec_packet_t packet_copies[2];      /*< Copies of the input and output packets.
+                                            The packets processed on the CPU are never fragmented. */
+#endif // (SEC_ENABLE_PACKET_COPY == ON)
+};
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+/** Cumulative counters of a job ring written by the producer thread */
+typedef struct sec_jr_tx_counters_s
+{
+    uint64_t packets;                   /*< Packets accepted */
+    uint64_t bytes;                     /*< Bytes of the input packets accepted */
+    uint64_t jr_full;                   /*< Packets rejected with SEC_JR_IS_FULL */
+}____cacheline_aligned sec_jr_tx_counters_t;
+
+/** Cumulative counters of a job ring written by the consumer thread */
+typedef struct sec_jr_rx_counters_s
+{
+    uint64_t packets;                   /*< Packets notified, without the ones flushed after an error */
+    uint64_t bytes;                     /*< Bytes of the output packets notified */
+    uint64_t icv_failures;              /*< Packets notified with SEC_STATUS_MAC_I_CHECK_FAILED */
+    uint64_t hfn_threshold_reached;     /*< Packets notified with SEC_STATUS_HFN_THRESHOLD_REACHED */
+    uint64_t error_packets;             /*< Packets flushed after a SEC error */
+    uint64_t jr_resets;                 /*< Flushes and restarts of the job ring after a SEC error */
+    uint64_t empty_polls;               /*< Polls that notified no packet */
+    uint64_t irq_enables;               /*< IRQ re-enables */
+    uint64_t polls;                     /*< Polls */
+    uint64_t callback_ticks;            /*< Time base ticks spent in the callbacks of UA */
+}____cacheline_aligned sec_jr_rx_counters_t;
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+/** State of the tuning of the weight of sec_poll() for a job ring. Written by the consumer thread. */
+typedef struct sec_poll_tuner_s
+{
+    uint32_t weight;                    /*< Weight in use. 0 until the first sec_poll(), which sets
+                                            it to the weight given by UA. */
+    uint32_t weight_changes;            /*< Times the weight was changed */
+    uint32_t polls;                     /*< Polls by sec_poll() in the current window */
+    uint32_t saturated_polls;           /*< Polls of the window that stopped at the weight */
+    uint32_t packets;                   /*< Packets notified by the polls of the window */
+    uint32_t latency_no;                /*< Jobs dequeued in the window */
+    uint64_t latency_sum;               /*< Sum of the times, in time base ticks, from enqueue
+                                            to dequeue of the jobs of the window */
+}____cacheline_aligned sec_poll_tuner_t;
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+
 struct sec_outring_entry {
     dma_addr_t  desc;                   /*< Pointer to completed descriptor */
     uint32_t    status;                 /*< Status for completed descriptor */
@@ -153,9 +287,58 @@ struct sec_job_ring_t
     int map_size;                               /*< SEC's register memory map size. */
     sec_job_ring_state_t jr_state;              /*< The state of this job ring */
     sec_contexts_pool_t ctx_pool;               /*< Pool of SEC contexts */
+    sec_dma_mem_arena_t *dma_arena;             /*< DMA memory arena from where the rings, descriptors
+                                                    and SG tables of this job ring were allocated */
+    uint32_t dma_mem_size;                      /*< Number of bytes of DMA-capable memory allocated
+                                                    by this job ring, without the pool of SEC contexts */
 #if (SEC_ENABLE_SCATTER_GATHER == ON)
     sec_sg_context_t sg_ctxs[SEC_JOB_RING_SIZE]; /*< Scatter Gather contexts for this jobring */
+    sec_sg_tbl_pool_t sg_tbl_pool;              /*< Pool of SG tables, taken by the jobs with fragmented packets */
+    struct sec_sg_tbl_entry *sg_tbls;           /*< DMA-capable memory of all the SG tables of the pool,
+                                                    followed by the bounce buffers of the jobs */
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+    uint32_t sg_linearize_max_length;           /*< Fragmented packets of at most this many bytes ... */
+    uint32_t sg_linearize_max_fragments;        /*< ... and with at most this many fragments, including the parent
+                                                    buffer, are linearized. Written by the producer thread. */
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
 #endif // (SEC_ENABLE_SCATTER_GATHER == ON)
+#if (SEC_ENABLE_IOV_SUBMISSION == ON)
+    sec_packet_t iov_packets[SEC_JOB_RING_SIZE][2][SEC_IOV_MAX_FRAGMENTS]; /*< Input and output packets of each job,
+                                                    translated by sec_process_packet_iov() */
+    uint32_t mem_map_hint;                      /*< Memory region of the last packet submitted with
+                                                    sec_process_packet_iov(). Written by the producer thread. */
+#endif // (SEC_ENABLE_IOV_SUBMISSION == ON)
+#if (SEC_ENABLE_CPU_JOBS == ON)
+    struct sec_cpu_job_t cpu_jobs[SEC_JOB_RING_SIZE]; /*< Ring of packets processed on the CPU by the producer
+                                                          thread, notified to UA by the consumer thread. */
+    uint32_t cpu_pidx ____cacheline_aligned;    /*< Producer index for the ring of CPU jobs.
+                                                    @note: cpu_cidx and cpu_pidx are accessed from different
+                                                    threads, they lay on different cachelines to avoid
+                                                    false sharing, same as cidx and pidx. */
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+    uint32_t cpu_block_cost;                    /*< Moving average of the time, in time base ticks, to cipher
+                                                    16 bytes on the CPU. Written by the producer thread. */
+    uint32_t hw_dispatch_tb;                    /*< Time base when the hybrid dispatcher last sent a packet
+                                                    to SEC. Written by the producer thread. */
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+    uint32_t cpu_cidx ____cacheline_aligned;    /*< Consumer index for the ring of CPU jobs */
+#if (SEC_ENABLE_HYBRID_DISPATCH == ON)
+    uint32_t hw_latency;                        /*< Moving average of the time, in time base ticks, from
+                                                    enqueuing a job to dequeuing it. Written by the consumer
+                                                    thread, read by the producer thread. */
+#endif // (SEC_ENABLE_HYBRID_DISPATCH == ON)
+#endif // (SEC_ENABLE_CPU_JOBS == ON)
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    sec_jr_tx_counters_t tx_counters;           /*< Counters written by the producer thread */
+    sec_jr_rx_counters_t rx_counters;           /*< Counters written by the consumer thread */
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+#if (SEC_ENABLE_POLL_AUTOTUNE == ON)
+    sec_poll_tuner_t poll_tuner;                /*< Tuning of the weight of sec_poll() for this job ring */
+#endif // (SEC_ENABLE_POLL_AUTOTUNE == ON)
+#if (SEC_ENABLE_LATENCY_STATS == ON)
+    sec_latency_stats_t latency_stats;          /*< Latencies of the jobs dequeued from this job ring.
+                                                    Written by the consumer thread. */
+#endif // (SEC_ENABLE_LATENCY_STATS == ON)
 }____cacheline_aligned;
 /*==============================================================================
                                  CONSTANTS
@@ -174,8 +357,9 @@ extern struct sec_job_ring_t g_job_rings[MAX_SEC_JOB_RINGS];
 ==============================================================================*/
 /** @brief Initialize the software and hardware resources tied to a job ring.
  * @param [in,out] job_ring             The job ring
- * @param [in,out] dma_mem              DMA-capable memory area from where to
- *                                      allocate SEC descriptors.
+ * @param [in,out] dma_arena            DMA memory arena from where to allocate the
+ *                                      input/output rings, SEC descriptors and SG tables.
+ *                                      They are returned to the arena by shutdown_job_ring().
  * @param [in]     startup_work_mode    The work mode to configure a job ring at startup.
  *                                      Used only when #SEC_NOTIFICATION_TYPE is set to
  *                                      #SEC_NOTIFICATION_TYPE_NAPI.
@@ -189,7 +373,7 @@ extern struct sec_job_ring_t g_job_rings[MAX_SEC_JOB_RINGS];
  * @retval  other for error
  *
  */
-int init_job_ring(struct sec_job_ring_t *job_ring, void **dma_mem,int startup_work_mode
+int init_job_ring(struct sec_job_ring_t *job_ring, sec_dma_mem_arena_t *dma_arena, int startup_work_mode
         ,uint16_t irq_coalescing_timer, uint8_t irq_coalescing_count
     );
 
@@ -0,0 +1,198 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <stdlib.h>
+#include <string.h>
+#include "fsl_sec.h"
+#include "sec_keystream_cache.h"
+#include "sec_sw_crypto.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Get the keystream entry for a COUNT value */
+#define KS_CACHE_ENTRY(cache, count)    ((cache)->ks[(count) & (SEC_KEYSTREAM_CACHE_DEPTH - 1)])
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+struct sec_ks_cache_t* sec_ks_cache_create(const sec_pdcp_context_info_t *pdcp_crypto_info,
+                                           uint32_t next_count)
+{
+    struct sec_ks_cache_t *cache = NULL;
+
+    ASSERT(pdcp_crypto_info != NULL);
+    ASSERT(pdcp_crypto_info->cipher_algorithm == SEC_ALG_SNOW ||
+           pdcp_crypto_info->cipher_algorithm == SEC_ALG_AES);
+
+    cache = malloc(sizeof(struct sec_ks_cache_t));
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    cache->first_count = next_count;
+    cache->next_count = next_count;
+    cache->cipher_algorithm = pdcp_crypto_info->cipher_algorithm;
+    cache->bearer = pdcp_crypto_info->bearer;
+    cache->direction = pdcp_crypto_info->packet_direction;
+    cache->sn_size = pdcp_crypto_info->sn_size;
+    cache->key = pdcp_crypto_info->cipher_key;
+
+    if (cache->cipher_algorithm == SEC_ALG_AES)
+    {
+        sec_sw_aes128_expand_key(cache->key, cache->aes_rk);
+    }
+
+    return cache;
+}
+
+void sec_ks_cache_destroy(struct sec_ks_cache_t *cache)
+{
+    free(cache);
+}
+
+uint32_t sec_ks_cache_refill(struct sec_ks_cache_t *cache, uint32_t budget)
+{
+    uint32_t counts[SEC_SW_CRYPTO_LANES];
+    uint8_t *ks[SEC_SW_CRYPTO_LANES];
+    uint32_t generated = 0;
+    uint32_t lanes_no;
+    uint32_t l;
+
+    ASSERT(cache != NULL);
+
+    while (generated < budget && SEC_KS_CACHE_ENTRIES(cache) < SEC_KEYSTREAM_CACHE_DEPTH)
+    {
+        // Generate as many entries in parallel as allowed by budget and free space
+        lanes_no = SEC_KEYSTREAM_CACHE_DEPTH - SEC_KS_CACHE_ENTRIES(cache);
+        if (lanes_no > budget - generated)
+        {
+            lanes_no = budget - generated;
+        }
+        if (lanes_no > SEC_SW_CRYPTO_LANES)
+        {
+            lanes_no = SEC_SW_CRYPTO_LANES;
+        }
+
+        for (l = 0; l < lanes_no; l++)
+        {
+            counts[l] = cache->next_count + l;
+            ks[l] = KS_CACHE_ENTRY(cache, counts[l]);
+        }
+
+        if (cache->cipher_algorithm == SEC_ALG_SNOW)
+        {
+            sec_sw_snow3g_keystream_lanes(cache->key, counts, cache->bearer, cache->direction,
+                                          ks, SEC_KEYSTREAM_CACHE_MAX_PAYLOAD, lanes_no);
+        }
+        else
+        {
+            // The AES blocks of one entry are already encrypted in lock step
+            for (l = 0; l < lanes_no; l++)
+            {
+                sec_sw_pdcp_keystream(SEC_ALG_AES, cache->key, cache->aes_rk, counts[l],
+                                      cache->bearer, cache->direction,
+                                      ks[l], SEC_KEYSTREAM_CACHE_MAX_PAYLOAD);
+            }
+        }
+
+        cache->next_count += lanes_no;
+        generated += lanes_no;
+    }
+
+    return generated;
+}
+
+const uint8_t* sec_ks_cache_lookup(struct sec_ks_cache_t *cache, uint32_t count)
+{
+    const uint8_t *ks = NULL;
+
+    ASSERT(cache != NULL);
+
+    // Unsigned arithmetic handles the wrap around of COUNT
+    if (count - cache->first_count < SEC_KS_CACHE_ENTRIES(cache))
+    {
+        ks = KS_CACHE_ENTRY(cache, count);
+        cache->first_count = count + 1;
+    }
+    else
+    {
+        // COUNT jumped (lost PDUs, reordering or HFN resync): restart after it
+        cache->first_count = count + 1;
+        cache->next_count = count + 1;
+    }
+
+    return ks;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
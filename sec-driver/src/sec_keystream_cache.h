@@ -0,0 +1,151 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEC_KEYSTREAM_CACHE_H
+#define SEC_KEYSTREAM_CACHE_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include "fsl_sec.h"
+#include "sec_sw_crypto.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+#if (SEC_KEYSTREAM_CACHE_DEPTH & (SEC_KEYSTREAM_CACHE_DEPTH - 1)) != 0
+#error "SEC_KEYSTREAM_CACHE_DEPTH must be a power of 2!"
+#endif
+
+#if (SEC_KEYSTREAM_CACHE_MAX_PAYLOAD % SEC_SW_AES_BLOCK_SIZE) != 0
+#error "SEC_KEYSTREAM_CACHE_MAX_PAYLOAD must be a multiple of 16!"
+#endif
+
+/** Number of pre-generated COUNT values currently held in a keystream cache */
+#define SEC_KS_CACHE_ENTRIES(cache) ((cache)->next_count - (cache)->first_count)
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+/** Keystream pre-generated for the next COUNT values of a PDCP User Plane context.
+ *
+ * The entries for COUNT values in [first_count, next_count) are valid. The entry
+ * for a COUNT value is stored at index COUNT modulo #SEC_KEYSTREAM_CACHE_DEPTH.
+ * The cache is accessed only by the producer thread of the context, so no
+ * synchronization is needed.
+ */
+struct sec_ks_cache_t
+{
+    uint32_t first_count;                   /*< Oldest COUNT value for which keystream is available */
+    uint32_t next_count;                    /*< Next COUNT value for which keystream will be generated */
+    uint8_t  cipher_algorithm;              /*< #SEC_ALG_SNOW or #SEC_ALG_AES */
+    uint8_t  bearer;                        /*< Radio bearer id */
+    uint8_t  direction;                     /*< Packet direction: uplink or downlink */
+    uint8_t  sn_size;                       /*< Sequence number size in bits: 7 or 12 */
+    const uint8_t *key;                     /*< Ciphering key, 16 bytes */
+    uint32_t aes_rk[SEC_SW_AES128_RK_WORDS];/*< Expanded AES key, valid only for #SEC_ALG_AES */
+    uint8_t  ks[SEC_KEYSTREAM_CACHE_DEPTH][SEC_KEYSTREAM_CACHE_MAX_PAYLOAD]; /*< Keystream entries */
+};
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Allocates and initializes an empty keystream cache for a PDCP User Plane context.
+ *
+ * @param [in] pdcp_crypto_info     Crypto info of the context. Cipher algorithm must be
+ *                                  #SEC_ALG_SNOW or #SEC_ALG_AES, with a 16 byte key.
+ * @param [in] next_count           First COUNT value for which keystream is to be generated.
+ *
+ * @retval Pointer to the cache or NULL if no memory is available.
+ */
+struct sec_ks_cache_t* sec_ks_cache_create(const sec_pdcp_context_info_t *pdcp_crypto_info,
+                                           uint32_t next_count);
+
+/** @brief Releases a keystream cache.
+ *
+ * @param [in] cache    The cache. Can be NULL.
+ */
+void sec_ks_cache_destroy(struct sec_ks_cache_t *cache);
+
+/** @brief Generates keystream for the next COUNT values, until the cache
+ * is full or budget entries were generated.
+ *
+ * @param [in,out] cache    The cache.
+ * @param [in]     budget   Maximum number of entries to generate.
+ *
+ * @retval Number of entries generated.
+ */
+uint32_t sec_ks_cache_refill(struct sec_ks_cache_t *cache, uint32_t budget);
+
+/** @brief Returns the keystream for a COUNT value and consumes it, together
+ * with all the entries for older COUNT values.
+ *
+ * On a miss the cache is resynchronized, so that the next refill starts
+ * generating keystream from COUNT + 1.
+ *
+ * @param [in,out] cache    The cache.
+ * @param [in]     count    The COUNT value.
+ *
+ * @retval Pointer to #SEC_KEYSTREAM_CACHE_MAX_PAYLOAD bytes of keystream or NULL on a miss.
+ */
+const uint8_t* sec_ks_cache_lookup(struct sec_ks_cache_t *cache, uint32_t count);
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_KEYSTREAM_CACHE_H */
@@ -0,0 +1,201 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SEC_LATENCY_H
+#define SEC_LATENCY_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include "fsl_sec.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+#if (SEC_LATENCY_HIST_SUB_BUCKET_BITS < 1) || (SEC_LATENCY_HIST_SUB_BUCKET_BITS > 8)
+#error "SEC_LATENCY_HIST_SUB_BUCKET_BITS must be between 1 and 8"
+#endif
+
+/** Number of linear sub-buckets per power of 2 */
+#define SEC_LATENCY_HIST_SUB_BUCKETS    (1 << SEC_LATENCY_HIST_SUB_BUCKET_BITS)
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Returns the histogram bucket of a latency.
+ *
+ * Latencies below #SEC_LATENCY_HIST_SUB_BUCKETS have a bucket each. Above, each
+ * power of 2 interval [2^e, 2^(e+1)) is split in #SEC_LATENCY_HIST_SUB_BUCKETS
+ * equal buckets, so that the width of a bucket is at most 1/#SEC_LATENCY_HIST_SUB_BUCKETS
+ * of the latencies it holds.
+ *
+ * @param [in] latency  Latency, in time base ticks.
+ * @return The bucket index, less than #SEC_LATENCY_HIST_BUCKETS.
+ */
+static inline uint32_t sec_latency_bucket(uint32_t latency)
+{
+    uint32_t msb;
+
+    if (latency < SEC_LATENCY_HIST_SUB_BUCKETS)
+    {
+        return latency;
+    }
+
+    // Position of the most significant bit, at least SEC_LATENCY_HIST_SUB_BUCKET_BITS
+    msb = 31 - __builtin_clz(latency);
+
+    return ((msb - SEC_LATENCY_HIST_SUB_BUCKET_BITS + 1) << SEC_LATENCY_HIST_SUB_BUCKET_BITS) +
+           ((latency >> (msb - SEC_LATENCY_HIST_SUB_BUCKET_BITS)) & (SEC_LATENCY_HIST_SUB_BUCKETS - 1));
+}
+
+/** @brief Returns the highest latency that falls in a histogram bucket.
+ *
+ * @param [in] bucket   Bucket index, less than #SEC_LATENCY_HIST_BUCKETS.
+ * @return The highest latency of the bucket, in time base ticks.
+ */
+static inline uint32_t sec_latency_bucket_max(uint32_t bucket)
+{
+    uint32_t shift;
+
+    if (bucket < SEC_LATENCY_HIST_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    // Buckets of the power of 2 interval number k are 2^(k-1) ticks wide
+    shift = (bucket >> SEC_LATENCY_HIST_SUB_BUCKET_BITS) - 1;
+
+    return (uint32_t)((((uint64_t)(bucket & (SEC_LATENCY_HIST_SUB_BUCKETS - 1)) +
+                        SEC_LATENCY_HIST_SUB_BUCKETS + 1) << shift) - 1);
+}
+
+/** @brief Records a latency in a histogram.
+ *
+ * Called only by the consumer thread of a job ring, no synchronization is needed.
+ *
+ * @param [in,out] hist     The histogram.
+ * @param [in]     latency  Latency, in time base ticks.
+ */
+static inline void sec_latency_record(sec_latency_histogram_t *hist, uint32_t latency)
+{
+    if (hist->count == 0 || latency < hist->min)
+    {
+        hist->min = latency;
+    }
+    if (latency > hist->max)
+    {
+        hist->max = latency;
+    }
+    hist->count++;
+    hist->sum += latency;
+    hist->buckets[sec_latency_bucket(latency)]++;
+}
+
+/** @brief Returns a percentile of the latencies of a histogram,
+ * see sec_get_latency_percentile().
+ *
+ * @param [in] hist         The histogram.
+ * @param [in] percentile   The percentile, in hundredths of percent.
+ * @return The highest latency of the bucket where the percentile falls, in time base ticks.
+ */
+static inline uint32_t sec_latency_percentile(const sec_latency_histogram_t *hist,
+                                              uint32_t percentile)
+{
+    uint64_t rank;
+    uint64_t count = 0;
+    uint32_t i;
+
+    if (hist->count == 0)
+    {
+        return 0;
+    }
+
+    // Number of latencies up to and including the percentile, at least one
+    rank = (hist->count * percentile + 9999) / 10000;
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    for (i = 0; i < SEC_LATENCY_HIST_BUCKETS; i++)
+    {
+        count += hist->buckets[i];
+        if (count >= rank)
+        {
+            break;
+        }
+    }
+
+    // The histogram may be read while updated, never report more than was seen
+    if (i == SEC_LATENCY_HIST_BUCKETS || sec_latency_bucket_max(i) > hist->max)
+    {
+        return hist->max;
+    }
+
+    return sec_latency_bucket_max(i);
+}
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_LATENCY_H */
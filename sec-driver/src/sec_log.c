@@ -0,0 +1,300 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include "fsl_sec.h"
+#include "sec_log.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+/** A message in the log ring */
+typedef struct sec_log_entry_s
+{
+    /** Set to the position of the message plus 1 once the message is written */
+    volatile uint32_t seq;
+    /** Messages suppressed by the call site before this one */
+    uint32_t suppressed_no;
+    /** The message, null terminated */
+    char msg[SEC_LOG_MSG_SIZE];
+}sec_log_entry_t;
+
+/** Log ring with any number of writers and one reader at a time. A writer claims a
+ *  position by advancing head with compare and swap, formats the message in its
+ *  slot and publishes it by setting the slot's seq. The reader advances tail. */
+typedef struct sec_log_ring_s
+{
+    /** Next position to be claimed by a writer */
+    volatile uint32_t head;
+    /** Messages dropped because the log ring was full */
+    volatile uint32_t dropped_no;
+    /** Next position to be read. On its own cache line, written only by the reader. */
+    volatile uint32_t tail ____cacheline_aligned;
+    /** The messages */
+    sec_log_entry_t entries[SEC_LOG_RING_SIZE] ____cacheline_aligned;
+}sec_log_ring_t;
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static sec_log_ring_t g_log_ring;
+
+/* Serializes the readers of the log ring */
+static pthread_mutex_t g_log_drain_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#if (SEC_DRIVER_DEFERRED_LOGGING == ON) && (SEC_LOG_DRAIN_PERIOD_MS > 0)
+/* The background thread that drains the log ring */
+static pthread_t g_log_thread;
+/* #TRUE while the background thread runs */
+static volatile int g_log_thread_running = FALSE;
+#endif
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+/* Current time in seconds. The coarse clock is read without a system call. */
+static uint32_t log_get_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+
+    return (uint32_t)ts.tv_sec;
+}
+
+static void log_ring_vwrite(uint32_t suppressed_no, const char *format, va_list args)
+{
+    sec_log_entry_t *entry;
+    uint32_t head;
+
+    // Claim a position, unless the reader did not free its slot yet
+    do
+    {
+        head = g_log_ring.head;
+        if (head - g_log_ring.tail >= SEC_LOG_RING_SIZE)
+        {
+            __sync_fetch_and_add(&g_log_ring.dropped_no, 1);
+            return;
+        }
+    }while(!__sync_bool_compare_and_swap(&g_log_ring.head, head, head + 1));
+
+    entry = &g_log_ring.entries[head & (SEC_LOG_RING_SIZE - 1)];
+    entry->suppressed_no = suppressed_no;
+    vsnprintf(entry->msg, sizeof(entry->msg), format, args);
+
+    // The message must be complete before the reader sees it published
+    __sync_synchronize();
+    entry->seq = head + 1;
+}
+
+#if (SEC_DRIVER_DEFERRED_LOGGING == ON) && (SEC_LOG_DRAIN_PERIOD_MS > 0)
+static void* log_drain_thread(void *arg)
+{
+    while (g_log_thread_running == TRUE)
+    {
+        usleep(SEC_LOG_DRAIN_PERIOD_MS * 1000);
+        sec_log_ring_drain(stderr, SEC_LOG_RING_SIZE);
+    }
+
+    return NULL;
+}
+#endif
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+void sec_log_rate_limited(sec_log_site_t *site, const char *format, ...)
+{
+    uint32_t suppressed_no = 0;
+    va_list args;
+
+    if (!sec_log_site_allow(site, log_get_seconds(), &suppressed_no))
+    {
+        return;
+    }
+
+    va_start(args, format);
+#if (SEC_DRIVER_DEFERRED_LOGGING == ON)
+    log_ring_vwrite(suppressed_no, format, args);
+#else
+    if (suppressed_no != 0)
+    {
+        fprintf(stderr, "(%u similar messages suppressed) ", suppressed_no);
+    }
+    vfprintf(stderr, format, args);
+#endif // (SEC_DRIVER_DEFERRED_LOGGING == ON)
+    va_end(args);
+}
+
+void sec_log_ring_write(uint32_t suppressed_no, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    log_ring_vwrite(suppressed_no, format, args);
+    va_end(args);
+}
+
+uint32_t sec_log_ring_drain(FILE *stream, uint32_t max_no)
+{
+    sec_log_entry_t *entry;
+    uint32_t drained_no = 0;
+    uint32_t dropped_no;
+    uint32_t tail;
+    size_t length;
+
+    ASSERT(stream != NULL);
+
+    pthread_mutex_lock(&g_log_drain_lock);
+
+    dropped_no = g_log_ring.dropped_no;
+    if (dropped_no != 0)
+    {
+        __sync_fetch_and_sub(&g_log_ring.dropped_no, dropped_no);
+        fprintf(stream, "%u messages dropped, the log ring was full\n", dropped_no);
+    }
+
+    tail = g_log_ring.tail;
+    while (drained_no < max_no)
+    {
+        entry = &g_log_ring.entries[tail & (SEC_LOG_RING_SIZE - 1)];
+        // A claimed position may still be written, messages are read in order
+        if (entry->seq != tail + 1)
+        {
+            break;
+        }
+        // Read the message only after seeing it published
+        __sync_synchronize();
+
+        if (entry->suppressed_no != 0)
+        {
+            fprintf(stream, "(%u similar messages suppressed) ", entry->suppressed_no);
+        }
+        fputs(entry->msg, stream);
+        // A truncated message lost its end of line
+        length = strlen(entry->msg);
+        if (length == 0 || entry->msg[length - 1] != '\n')
+        {
+            fputc('\n', stream);
+        }
+
+        // The slot can be reused by writers only after the message was read
+        __sync_synchronize();
+        tail++;
+        g_log_ring.tail = tail;
+        drained_no++;
+    }
+
+    pthread_mutex_unlock(&g_log_drain_lock);
+
+    return drained_no;
+}
+
+sec_return_code_t sec_log_start(void)
+{
+#if (SEC_DRIVER_DEFERRED_LOGGING == ON) && (SEC_LOG_DRAIN_PERIOD_MS > 0)
+    if (g_log_thread_running == TRUE)
+    {
+        return SEC_SUCCESS;
+    }
+
+    g_log_thread_running = TRUE;
+    if (pthread_create(&g_log_thread, NULL, log_drain_thread, NULL) != 0)
+    {
+        g_log_thread_running = FALSE;
+        SEC_ERROR("Failed to create the thread that drains the log ring");
+        return SEC_OUT_OF_MEMORY;
+    }
+#endif
+    return SEC_SUCCESS;
+}
+
+void sec_log_stop(void)
+{
+#if (SEC_DRIVER_DEFERRED_LOGGING == ON) && (SEC_LOG_DRAIN_PERIOD_MS > 0)
+    if (g_log_thread_running == TRUE)
+    {
+        g_log_thread_running = FALSE;
+        pthread_join(g_log_thread, NULL);
+    }
+#endif
+    sec_log_ring_drain(stderr, SEC_LOG_RING_SIZE);
+}
+
+sec_return_code_t sec_drain_log(uint32_t max_no, uint32_t *drained_no)
+{
+    uint32_t messages_no;
+
+    messages_no = sec_log_ring_drain(stderr, max_no);
+    if (drained_no != NULL)
+    {
+        *drained_no = messages_no;
+    }
+
+    return SEC_SUCCESS;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,189 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SEC_LOG_H
+#define SEC_LOG_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include <stdio.h>
+#include "fsl_sec.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+#if (SEC_LOG_RING_SIZE & (SEC_LOG_RING_SIZE - 1)) != 0
+#error "SEC_LOG_RING_SIZE must be a power of 2"
+#endif
+
+/** Most characters of a message in the log ring, including the terminating null character.
+ *  Longer messages are truncated. */
+#define SEC_LOG_MSG_SIZE    128
+
+#if SEC_DRIVER_LOGGING == OFF
+/** No logging of rate limited error messages */
+#define SEC_ERROR_RL(format, ...)
+#else
+/** Log an error message from a per packet path, at most #SEC_LOG_RATE_LIMIT_BURST times
+ *  every #SEC_LOG_RATE_LIMIT_INTERVAL seconds from this call site. The message is written
+ *  to the log ring if #SEC_DRIVER_DEFERRED_LOGGING is ON, else to stderr. */
+#define SEC_ERROR_RL(format, ...) \
+    do { \
+        static sec_log_site_t sec_log_site; \
+        sec_log_rate_limited(&sec_log_site, "%s() (%s@%d): " format "\n", \
+                             __FUNCTION__, __FILE__, __LINE__ , ##__VA_ARGS__); \
+    } while(0)
+#endif // SEC_DRIVER_LOGGING == OFF
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+/** Rate limiting state of a call site of #SEC_ERROR_RL. It is updated without locks
+ *  by all the threads that reach the call site: a race can only let an extra message
+ *  through or miss one from the suppressed count. */
+typedef struct sec_log_site_s
+{
+    /** Second when the current rate limiting interval started */
+    uint32_t interval_start;
+    /** Messages logged in the current interval */
+    uint32_t messages_no;
+    /** Messages suppressed since the last one logged */
+    uint32_t suppressed_no;
+}sec_log_site_t;
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Decides if a call site can log a message now.
+ *
+ * @param [in,out] site             Rate limiting state of the call site.
+ * @param [in]     now              Current time, in seconds.
+ * @param [out]    suppressed_no    Messages suppressed by the call site since the last
+ *                                  one logged. Valid if the message can be logged.
+ * @return #TRUE if the message can be logged, #FALSE if it is suppressed.
+ */
+static inline int sec_log_site_allow(sec_log_site_t *site,
+                                     uint32_t now,
+                                     uint32_t *suppressed_no)
+{
+    if (now - site->interval_start >= SEC_LOG_RATE_LIMIT_INTERVAL)
+    {
+        site->interval_start = now;
+        site->messages_no = 0;
+    }
+
+    if (site->messages_no >= SEC_LOG_RATE_LIMIT_BURST)
+    {
+        site->suppressed_no++;
+        return 0;
+    }
+
+    site->messages_no++;
+    *suppressed_no = site->suppressed_no;
+    site->suppressed_no = 0;
+
+    return 1;
+}
+
+/** @brief Logs a message from a rate limited call site. Used by #SEC_ERROR_RL.
+ *
+ * @param [in,out] site     Rate limiting state of the call site.
+ * @param [in]     format   printf() like format of the message.
+ */
+void sec_log_rate_limited(sec_log_site_t *site, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/** @brief Formats a message into the log ring.
+ *
+ * Can be called by any number of threads at the same time, without locks.
+ * If the log ring is full, the message is dropped and counted.
+ *
+ * @param [in] suppressed_no    Messages suppressed before this one, reported with it.
+ * @param [in] format           printf() like format of the message.
+ */
+void sec_log_ring_write(uint32_t suppressed_no, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/** @brief Writes the oldest messages of the log ring to a stream and frees their slots.
+ *
+ * Calls from different threads are serialized.
+ *
+ * @param [in] stream   The stream, e.g. stderr.
+ * @param [in] max_no   Most messages to write.
+ * @return The number of messages written, not counting the reports of dropped messages.
+ */
+uint32_t sec_log_ring_drain(FILE *stream, uint32_t max_no);
+
+/** @brief Starts the background thread that drains the log ring, if
+ * #SEC_DRIVER_DEFERRED_LOGGING is ON and #SEC_LOG_DRAIN_PERIOD_MS is not 0.
+ *
+ * @retval ::SEC_SUCCESS            for successful execution.
+ * @retval ::SEC_OUT_OF_MEMORY      if the thread could not be created.
+ */
+sec_return_code_t sec_log_start(void);
+
+/** @brief Stops the background thread started by sec_log_start() and drains
+ * whatever is left in the log ring. */
+void sec_log_stop(void);
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_LOG_H */
@@ -0,0 +1,161 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <string.h>
+#include "fsl_sec.h"
+#include "sec_utils.h"
+#include "sec_mem_map.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+void mem_map_init(sec_mem_map_t *map)
+{
+    ASSERT(map != NULL);
+
+    memset(map, 0, sizeof(sec_mem_map_t));
+}
+
+sec_return_code_t mem_map_add(sec_mem_map_t *map, void *start, dma_addr_t phys, uint32_t size)
+{
+    uintptr_t region_start = (uintptr_t)start;
+    uint32_t i = 0;
+
+    ASSERT(map != NULL);
+
+    if (size == 0 || region_start + size < region_start)
+    {
+        SEC_ERROR("Invalid memory region %p of %d bytes", start, size);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    if (map->regions_no == SEC_MAX_MEM_REGIONS)
+    {
+        SEC_ERROR("Cannot register more than %d memory regions", SEC_MAX_MEM_REGIONS);
+        return SEC_OUT_OF_MEMORY;
+    }
+
+    // Find where the region goes, to keep the regions sorted
+    while (i < map->regions_no && map->regions[i].start < region_start)
+    {
+        i++;
+    }
+
+    // Only the neighbours can overlap with the new region
+    if ((i > 0 && map->regions[i - 1].end > region_start) ||
+        (i < map->regions_no && map->regions[i].start < region_start + size))
+    {
+        SEC_ERROR("Memory region %p of %d bytes overlaps a registered region", start, size);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    memmove(&map->regions[i + 1],
+            &map->regions[i],
+            (map->regions_no - i) * sizeof(sec_mem_map_region_t));
+
+    map->regions[i].start = region_start;
+    map->regions[i].end = region_start + size;
+    map->regions[i].phys_start = phys;
+    map->regions_no++;
+
+    return SEC_SUCCESS;
+}
+
+sec_return_code_t mem_map_remove(sec_mem_map_t *map, void *start)
+{
+    uint32_t i = 0;
+
+    ASSERT(map != NULL);
+
+    for (i = 0; i < map->regions_no; i++)
+    {
+        if (map->regions[i].start == (uintptr_t)start)
+        {
+            memmove(&map->regions[i],
+                    &map->regions[i + 1],
+                    (map->regions_no - i - 1) * sizeof(sec_mem_map_region_t));
+            map->regions_no--;
+
+            return SEC_SUCCESS;
+        }
+    }
+
+    SEC_ERROR("No memory region registered at %p", start);
+    return SEC_INVALID_INPUT_PARAM;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,250 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef SEC_MEM_MAP_H
+#define SEC_MEM_MAP_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include <sys/uio.h>
+#include "fsl_sec.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+/** A physically contiguous memory region registered by UA */
+typedef struct sec_mem_map_region_s
+{
+    uintptr_t start;                        /*< Virtual start address of the region */
+    uintptr_t end;                          /*< Virtual address of the first byte after the region */
+    dma_addr_t phys_start;                  /*< Physical start address of the region */
+}sec_mem_map_region_t;
+
+/** The memory regions registered by UA, used to translate the virtual addresses
+ * of the packets submitted with sec_process_packet_iov().
+ *
+ * The regions are kept sorted by start address and do not overlap, so that the
+ * region of an address is found with a binary search. The map is not locked:
+ * it must not be changed while other threads translate addresses with it.
+ */
+typedef struct sec_mem_map_s
+{
+    uint32_t regions_no;                    /*< Number of valid entries in regions */
+    sec_mem_map_region_t regions[SEC_MAX_MEM_REGIONS]; /*< Registered regions, sorted by start address */
+}sec_mem_map_t;
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Initializes an empty memory map.
+ *
+ * @param [out] map         The memory map.
+ */
+void mem_map_init(sec_mem_map_t *map);
+
+/** @brief Adds a memory region to a memory map.
+ *
+ * @param [in,out] map      The memory map.
+ * @param [in]     start    Virtual start address of the region.
+ * @param [in]     phys     Physical start address of the region.
+ * @param [in]     size     Size of the region in bytes.
+ *
+ * @retval #SEC_SUCCESS for success
+ * @retval #SEC_INVALID_INPUT_PARAM if the region is empty, wraps around the end of
+ *         the address space or overlaps a region already in the map
+ * @retval #SEC_OUT_OF_MEMORY if the map already has #SEC_MAX_MEM_REGIONS regions
+ */
+sec_return_code_t mem_map_add(sec_mem_map_t *map, void *start, dma_addr_t phys, uint32_t size);
+
+/** @brief Removes a memory region from a memory map.
+ *
+ * @param [in,out] map      The memory map.
+ * @param [in]     start    Virtual start address of the region, as given to mem_map_add().
+ *
+ * @retval #SEC_SUCCESS for success
+ * @retval #SEC_INVALID_INPUT_PARAM if no region starts at this address
+ */
+sec_return_code_t mem_map_remove(sec_mem_map_t *map, void *start);
+
+/** @brief Translates a virtual address range to a physical address.
+ *
+ * The region found by the previous lookup of the caller is tried first: the
+ * packets of a thread usually come from the same few regions (e.g. hugepages),
+ * so most lookups take constant time. Otherwise the region is found with a
+ * binary search.
+ *
+ * @param [in]     map      The memory map.
+ * @param [in]     v        Virtual address.
+ * @param [in]     length   Number of bytes from v that must be in the same region.
+ * @param [in,out] hint     Index of the region of the previous lookup of the caller.
+ *                          Updated with the region of v.
+ * @param [out]    p        The physical address of v.
+ *
+ * @retval #SEC_SUCCESS for success
+ * @retval #SEC_INVALID_INPUT_PARAM if the range is not inside a registered region
+ */
+static inline sec_return_code_t mem_map_vtop(const sec_mem_map_t *map,
+                                             const void *v,
+                                             uint32_t length,
+                                             uint32_t *hint,
+                                             dma_addr_t *p)
+{
+    uintptr_t addr = (uintptr_t)v;
+    const sec_mem_map_region_t *region = NULL;
+    uint32_t low = 0;
+    uint32_t high = map->regions_no;
+    uint32_t mid = 0;
+
+    if (*hint < map->regions_no &&
+        addr >= map->regions[*hint].start &&
+        addr < map->regions[*hint].end)
+    {
+        region = &map->regions[*hint];
+    }
+    else
+    {
+        // Find the last region that starts at or before addr
+        while (low < high)
+        {
+            mid = (low + high) / 2;
+            if (map->regions[mid].start <= addr)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        if (low == 0 || addr >= map->regions[low - 1].end)
+        {
+            return SEC_INVALID_INPUT_PARAM;
+        }
+        *hint = low - 1;
+        region = &map->regions[low - 1];
+    }
+
+    if (region->end - addr < length)
+    {
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    *p = region->phys_start + (dma_addr_t)(addr - region->start);
+
+    return SEC_SUCCESS;
+}
+
+/** @brief Translates an array of struct iovec to a packet, with one fragment per entry.
+ *
+ * @param [in]     map      The memory map.
+ * @param [in]     iov      Array of iov_no entries, with virtual addresses.
+ * @param [in]     iov_no   Number of entries, at least 1.
+ * @param [in,out] hint     See mem_map_vtop().
+ * @param [out]    packet   Array of iov_no packets: the first fragment of the packet,
+ *                          followed by the other iov_no - 1 fragments.
+ *
+ * @retval #SEC_SUCCESS for success
+ * @retval #SEC_INVALID_INPUT_PARAM if an entry is empty, too long, or not inside
+ *         a registered region
+ */
+static inline sec_return_code_t mem_map_iov_to_packet(const sec_mem_map_t *map,
+                                                      const struct iovec *iov,
+                                                      uint32_t iov_no,
+                                                      uint32_t *hint,
+                                                      sec_packet_t *packet)
+{
+    uint32_t total_length = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < iov_no; i++)
+    {
+        if (iov[i].iov_len == 0 ||
+            (uint32_t)iov[i].iov_len != iov[i].iov_len ||
+            total_length + (uint32_t)iov[i].iov_len < total_length)
+        {
+            return SEC_INVALID_INPUT_PARAM;
+        }
+        if (mem_map_vtop(map, iov[i].iov_base, iov[i].iov_len, hint, &packet[i].address) != SEC_SUCCESS)
+        {
+            return SEC_INVALID_INPUT_PARAM;
+        }
+        packet[i].length = iov[i].iov_len;
+        packet[i].offset = 0;
+        packet[i].tail_offset = iov[i].iov_len;
+        packet[i].total_length = 0;
+        packet[i].num_fragments = 0;
+        total_length += iov[i].iov_len;
+    }
+
+    packet[0].total_length = total_length;
+    packet[0].num_fragments = iov_no - 1;
+
+    return SEC_SUCCESS;
+}
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_MEM_MAP_H */
@@ -0,0 +1,211 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef SEC_NULL_PASSTHROUGH_H
+#define SEC_NULL_PASSTHROUGH_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include <string.h>
+#include "fsl_sec.h"
+#include "sec_utils.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+/** Longest frame copied by the NULL algorithm descriptors. Longer frames are
+ * sent to SEC, which reports the error. */
+#define NULL_PASSTHROUGH_MAX_LENGTH     0xFFF
+
+/** Size of the MAC-I appended by PDCP Control Plane with EIA0 */
+#define NULL_PASSTHROUGH_MAC_I_LENGTH   4
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Check if a PDCP context uses only NULL algorithms and its packets can be
+ * completed on the CPU with the same result as the NULL algorithm descriptors.
+ *
+ * @param [in] pdcp_crypto_info The PDCP parameters of the context.
+ * @param [in] dpovrd_en        #TRUE if UA provides the HFN with every packet.
+ *
+ * @retval #TRUE or #FALSE
+ */
+static inline uint32_t null_passthrough_context_eligible(const sec_pdcp_context_info_t *pdcp_crypto_info,
+                                                         uint32_t dpovrd_en)
+{
+    if (pdcp_crypto_info->cipher_algorithm != SEC_ALG_NULL)
+    {
+        return FALSE;
+    }
+
+#ifdef USDPAA
+    // The PDCP protocol descriptors keep the HFN and report the HFN threshold and,
+    // for Control Plane, verify the MAC-I. The HFN is known on the CPU only if UA
+    // provides it with every packet.
+    return (pdcp_crypto_info->user_plane == PDCP_DATA_PLANE &&
+            dpovrd_en == TRUE) ? TRUE : FALSE;
+#else
+    // The NULL algorithm descriptors only copy the frame. Control Plane packets are
+    // completed on the CPU only if UA provides the HFN with every packet, so that
+    // the HFN SEC keeps for the context is never left behind.
+    return (pdcp_crypto_info->user_plane == PDCP_DATA_PLANE ||
+            (pdcp_crypto_info->integrity_algorithm == SEC_ALG_NULL &&
+             dpovrd_en == TRUE)) ? TRUE : FALSE;
+#endif
+}
+
+/** @brief Complete a packet of a NULL algorithm context on the CPU.
+ *
+ * User Plane packets are copied, Control Plane packets are copied and have the zero
+ * MAC-I appended (encapsulation) or removed (decapsulation). The copy is skipped
+ * for in place User Plane packets. The packet is processed only if SEC has no other
+ * packets of the context in flight, so that the packets are notified in order, if it
+ * is not fragmented and if the output buffer is large enough. Otherwise the packets
+ * are left untouched.
+ *
+ * @param [in] pdcp_crypto_info The PDCP parameters of the context, see
+ *                              null_passthrough_context_eligible().
+ * @param [in] hw_packets_no    Packets of the context submitted to SEC and not yet notified.
+ * @param [in] in_packet        Input packet.
+ * @param [in] out_packet       Output packet.
+ * @param [in] ptov             Physical to virtual address translation function of UA,
+ *                              may be NULL.
+ *
+ * @retval #TRUE if the packet was processed on the CPU
+ * @retval #FALSE if the packet must be submitted to SEC
+ */
+static inline uint32_t null_passthrough_process_packet(const sec_pdcp_context_info_t *pdcp_crypto_info,
+                                                       uint32_t hw_packets_no,
+                                                       const sec_packet_t *in_packet,
+                                                       const sec_packet_t *out_packet,
+                                                       sec_ptov ptov)
+{
+    const uint8_t *in = NULL;
+    uint8_t *out = NULL;
+    uint32_t out_length = in_packet->length;
+
+    // Packets processed by SEC for this context must be notified first
+    if (hw_packets_no != 0 ||
+        in_packet->num_fragments != 0 ||
+        out_packet->num_fragments != 0 ||
+        in_packet->length > NULL_PASSTHROUGH_MAX_LENGTH)
+    {
+        return FALSE;
+    }
+
+    if (pdcp_crypto_info->user_plane == PDCP_CONTROL_PLANE)
+    {
+        if (pdcp_crypto_info->protocol_direction == PDCP_ENCAPSULATION)
+        {
+            out_length += NULL_PASSTHROUGH_MAC_I_LENGTH;
+        }
+        else if (in_packet->length >= NULL_PASSTHROUGH_MAC_I_LENGTH)
+        {
+            out_length -= NULL_PASSTHROUGH_MAC_I_LENGTH;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+
+    if (out_packet->length < out_length)
+    {
+        return FALSE;
+    }
+
+    // An in place User Plane packet is already the result
+    if (pdcp_crypto_info->user_plane == PDCP_DATA_PLANE &&
+        in_packet->address + in_packet->offset == out_packet->address + out_packet->offset)
+    {
+        return TRUE;
+    }
+
+    if (ptov == NULL)
+    {
+        return FALSE;
+    }
+
+    in = (const uint8_t*)ptov(in_packet->address) + in_packet->offset;
+    out = (uint8_t*)ptov(out_packet->address) + out_packet->offset;
+
+    if (out != in)
+    {
+        memmove(out, in, (out_length < in_packet->length) ? out_length : in_packet->length);
+    }
+    if (out_length > in_packet->length)
+    {
+        // EIA0 MAC-I
+        memset(out + in_packet->length, 0, NULL_PASSTHROUGH_MAC_I_LENGTH);
+    }
+
+    return TRUE;
+}
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_NULL_PASSTHROUGH_H */
@@ -44,6 +44,7 @@ extern "C"{
                                          INCLUDE FILES
 ==================================================================================================*/
 #include <unistd.h>
+#include <string.h>
 
 #include "list.h"
 #include "fsl_sec.h"
@@ -86,6 +87,19 @@ extern "C"{
 
 #define SG_TBL_SET_FINAL(sg_entry)              ( (sg_entry).final = 1 )
 
+#define SG_TBL_SET_EXT(sg_entry)                ( (sg_entry).ext = 1 )
+
+/** Number of classes of SG tables in the pool of a job ring */
+#define SEC_SG_TBL_CLASSES_NO                   3
+
+/** Total number of SG tables in the pool of a job ring */
+#define SEC_SG_TBL_POOL_TBLS_NO     (SEC_SG_TBL_CLASS_SMALL_NO + SEC_SG_TBL_CLASS_MEDIUM_NO + \
+                                     SEC_SG_TBL_CLASS_LARGE_NO)
+
+#if (SEC_SG_TBL_CHAIN_LEN(SEC_MAX_SG_FRAGMENTS) > SEC_SG_TBL_CLASS_LARGE_NO)
+#error "Not enough large SG tables for a packet with SEC_MAX_SG_FRAGMENTS fragments"
+#endif
+
 #if (SEC_DRIVER_LOGGING == ON) && (SEC_DRIVER_LOGGING_LEVEL == SEC_DRIVER_LOG_DEBUG)
 #define DUMP_SG_TBL(sg_tbl) {                                               \
     int __i = 0;                                                            \
@@ -99,7 +113,7 @@ extern "C"{
                     (uint32_t)((uint32_t*)(((&((sg_tbl)[__i])))) + __j),    \
                     *((uint32_t*)(&((sg_tbl)[__i])) + __j) );               \
         }                                                                   \
-    }while((sg_tbl)[__i++].final != 1);                                     \
+    }while((sg_tbl)[__i].final != 1 && (sg_tbl)[__i++].ext != 1);           \
 }
 #else //(SEC_DRIVER_LOGGING == ON) && (SEC_DRIVER_LOGGING_LEVEL == SEC_DRIVER_LOG_DEBUG)
 #define DUMP_SG_TBL(sg_tbl)
@@ -149,6 +163,34 @@ struct sec_sg_tbl_entry{
     uint32_t    offset:13;
 } PACKED;
 
+/** A class of SG tables with the same number of entries.
+ * The free tables are kept in a ring of table indexes. Tables are taken from the
+ * ring by the producer thread of the job ring, in build_sg_context(), and returned
+ * by the consumer thread, in release_sg_context(). Each index is written by only
+ * one thread, so no lock is needed. */
+typedef struct sec_sg_tbl_class_s
+{
+    struct sec_sg_tbl_entry *tbls;      /*< First table of the class. The tables are contiguous. */
+    dma_addr_t tbls_phys;               /*< Physical address of the first table */
+    uint32_t entries_no;                /*< Number of entries of each table */
+    uint32_t tbls_no;                   /*< Number of tables in the class. Power of 2. */
+    uint16_t *free_tbls;                /*< Ring of tbls_no indexes of free tables */
+    uint32_t take_idx;                  /*< Free running index of the next free table to take.
+                                            Written by the producer thread. */
+    uint32_t return_idx;                /*< Free running index where the next returned table is stored.
+                                            Written by the consumer thread. */
+}sec_sg_tbl_class_t;
+
+/** Pool of SG tables of a job ring, with classes ordered by number of entries */
+typedef struct sec_sg_tbl_pool_s
+{
+    sec_sg_tbl_class_t classes[SEC_SG_TBL_CLASSES_NO];      /*< Classes of SG tables */
+    uint16_t free_tbls[SEC_SG_TBL_POOL_TBLS_NO];            /*< Storage for the rings of free tables
+                                                                of all the classes */
+    uint16_t chain_next[SEC_SG_TBL_CLASS_LARGE_NO];         /*< For each table of the last class,
+                                                                the next table of its chain */
+}sec_sg_tbl_pool_t;
+
 /** Structure defining a Scatter-Gather context for a job */
 typedef struct{
 
@@ -180,6 +222,39 @@ typedef struct{
     /** Output SG table physical address */
     dma_addr_t out_sg_tbl_phy;
 
+    /** Class of the pool the input SG table was taken from */
+    uint16_t in_sg_tbl_class;
+
+    /** Index of the input SG table in its class. For a chain, the first table. */
+    uint16_t in_sg_tbl_idx;
+
+    /** Number of chained input SG tables */
+    uint16_t in_sg_tbls_no;
+
+    /** Class of the pool the output SG table was taken from */
+    uint16_t out_sg_tbl_class;
+
+    /** Index of the output SG table in its class. For a chain, the first table. */
+    uint16_t out_sg_tbl_idx;
+
+    /** Number of chained output SG tables */
+    uint16_t out_sg_tbls_no;
+
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+    /** Bounce buffers of the job: #SEC_SG_BOUNCE_BUF_SIZE bytes for the
+     * input packet, followed by as many for the output packet */
+    uint8_t *bounce_buf;
+
+    /** Physical address of the bounce buffers */
+    dma_addr_t bounce_buf_phy;
+
+    /** Set if the input packet was copied to the input bounce buffer */
+    uint32_t in_bounce_en;
+
+    /** Set if SEC writes the output packet to the output bounce buffer */
+    uint32_t out_bounce_en;
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
+
 }sec_sg_context_t;
 
 
@@ -195,9 +270,300 @@ typedef struct{
                                      FUNCTION PROTOTYPES
 ==================================================================================================*/
 
+/** @brief Initializes the pool of SG tables of a job ring. All the tables are free.
+ *
+ * @param [in,out] pool     The pool.
+ * @param [in]  sg_tbls     DMA-capable memory of #SEC_DMA_MEM_SG_SIZE bytes for all the tables.
+ * @param [in]  sg_tbls_phy Physical address of sg_tbls.
+ */
+static inline void init_sg_tbl_pool(sec_sg_tbl_pool_t *pool,
+                                    struct sec_sg_tbl_entry *sg_tbls,
+                                    dma_addr_t sg_tbls_phy)
+{
+    // Number of entries and number of tables of each class, from the smallest tables
+    static const uint32_t sg_tbl_classes[SEC_SG_TBL_CLASSES_NO][2] =
+    {
+        {SEC_SG_TBL_CLASS_SMALL_ENTRIES, SEC_SG_TBL_CLASS_SMALL_NO},
+        {SEC_SG_TBL_CLASS_MEDIUM_ENTRIES, SEC_SG_TBL_CLASS_MEDIUM_NO},
+        {SEC_SG_TBL_CLASS_LARGE_ENTRIES, SEC_SG_TBL_CLASS_LARGE_NO},
+    };
+    sec_sg_tbl_class_t *sg_class = NULL;
+    uint16_t *free_tbls = pool->free_tbls;
+    uint32_t i = 0;
+    int class_idx = 0;
+
+    // The tables of a class are contiguous, the small tables first
+    for (class_idx = 0; class_idx < SEC_SG_TBL_CLASSES_NO; class_idx++)
+    {
+        sg_class = &pool->classes[class_idx];
+
+        sg_class->tbls = sg_tbls;
+        sg_class->tbls_phys = sg_tbls_phy;
+        sg_class->entries_no = sg_tbl_classes[class_idx][0];
+        sg_class->tbls_no = sg_tbl_classes[class_idx][1];
+        ASSERT((sg_class->tbls_no & (sg_class->tbls_no - 1)) == 0);
+
+        sg_class->free_tbls = free_tbls;
+        for (i = 0; i < sg_class->tbls_no; i++)
+        {
+            sg_class->free_tbls[i] = i;
+        }
+        sg_class->take_idx = 0;
+        sg_class->return_idx = sg_class->tbls_no;
+
+        sg_tbls += sg_class->tbls_no * sg_class->entries_no;
+        sg_tbls_phy += sg_class->tbls_no * sg_class->entries_no * SEC_SG_TBL_SIZE;
+        free_tbls += sg_class->tbls_no;
+    }
+}
+
+/** @brief Returns to their class a table, or a chain of tables, of the pool.
+ *
+ * @param [in]  pool        The pool of SG tables of the job ring.
+ * @param [in]  class_idx   The class of the tables.
+ * @param [in]  tbl_idx     Index of the first table in its class.
+ * @param [in]  tbls_no     Number of tables in the chain. 0 for a table owned by UA.
+ */
+static inline void release_sg_tbls(sec_sg_tbl_pool_t *pool,
+                                   uint16_t class_idx,
+                                   uint16_t tbl_idx,
+                                   uint16_t tbls_no)
+{
+    sec_sg_tbl_class_t *sg_class = &pool->classes[class_idx];
+    uint32_t return_idx = sg_class->return_idx;
+
+    if (tbls_no == 0)
+    {
+        return;
+    }
+
+    while (tbls_no != 0)
+    {
+        sg_class->free_tbls[return_idx & (sg_class->tbls_no - 1)] = tbl_idx;
+        return_idx++;
+        if (--tbls_no != 0)
+        {
+            // Only tables of the last class are chained
+            tbl_idx = pool->chain_next[tbl_idx];
+        }
+    }
+
+    // The indexes must be stored before the producer sees the tables returned
+    __sync_synchronize();
+    sg_class->return_idx = return_idx;
+}
+
+/** @brief Returns to the pool the SG tables taken by build_sg_context() for a job.
+ * Called when the job is dequeued, or when the job could not be submitted.
+ *
+ * @param [in]  pool        The pool of SG tables of the job ring.
+ * @param [in]  sg_ctx      The Scatter Gather context of the job.
+ */
+static inline void release_sg_context(sec_sg_tbl_pool_t *pool, sec_sg_context_t *sg_ctx)
+{
+    if (sg_ctx->in_sg_tbl_en == 1)
+    {
+        release_sg_tbls(pool, sg_ctx->in_sg_tbl_class, sg_ctx->in_sg_tbl_idx, sg_ctx->in_sg_tbls_no);
+        sg_ctx->in_sg_tbl_en = 0;
+    }
+
+    if (sg_ctx->out_sg_tbl_en == 1)
+    {
+        release_sg_tbls(pool, sg_ctx->out_sg_tbl_class, sg_ctx->out_sg_tbl_idx, sg_ctx->out_sg_tbls_no);
+        sg_ctx->out_sg_tbl_en = 0;
+    }
+
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+    sg_ctx->in_bounce_en = 0;
+    sg_ctx->out_bounce_en = 0;
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
+}
+
+/** @brief Formats the SG table of a fragmented packet in memory owned by UA.
+ * Unlike build_sg_context(), all the fragments are validated in every build,
+ * because the table is meant to be built once and submitted many times.
+ *
+ * @param [in]  packet      The first fragment of the packet.
+ * @param [out] sg_tbl      Table of packet[0].num_fragments + 1 entries.
+ *
+ * @retval ::SEC_SUCCESS                for successful execution.
+ * @retval ::SEC_INVALID_INPUT_PARAM    if the fragments are invalid.
+ */
+static inline sec_return_code_t format_sg_tbl(const sec_packet_t *packet,
+                                              struct sec_sg_tbl_entry *sg_tbl)
+{
+    uint32_t num_fragments = packet[0].num_fragments;
+    uint32_t length = 0;
+    uint32_t i = 0;
+
+    if (num_fragments == 0 || num_fragments > SEC_MAX_SG_FRAGMENTS)
+    {
+        SEC_ERROR("Invalid number of fragments: %d", num_fragments);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    for (i = 0; i <= num_fragments; i++)
+    {
+        if (packet[i].address == 0 ||
+            (packet[i].offset & 0x1FFFFFFF) != packet[i].offset ||
+            (packet[i].length & 0x3FFFFFFF) != packet[i].length)
+        {
+            SEC_ERROR("Fragment %d is invalid", i);
+            return SEC_INVALID_INPUT_PARAM;
+        }
+        length += packet[i].length;
+
+        SG_TBL_SET_ADDRESS(sg_tbl[i], packet[i].address);
+        SG_TBL_SET_LENGTH_OFF(sg_tbl[i], packet[i].length, packet[i].offset);
+    }
+    SG_TBL_SET_FINAL(sg_tbl[num_fragments]);
+
+    if (length != packet[0].total_length)
+    {
+        SEC_ERROR("Packets' fragment length (%d) is not equal to the total buffer length (%d)",
+                  length, packet[0].total_length);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    return SEC_SUCCESS;
+}
+
+/** @brief Populates a Scatter Gather context for a job with a table owned by UA,
+ * formatted with format_sg_tbl(). No table is taken from the pool, so
+ * release_sg_context() leaves the pool unchanged for this direction.
+ *
+ * @param [in]  sg_ctx      The Scatter Gather context to be populated.
+ * @param [in]  packet      The first fragment of the packet.
+ * @param [in]  dir         The 'direction' of the packet (input or output)
+ * @param [in]  sg_tbl_phy  Physical address of the table. Ignored if the packet has no fragments.
+ */
+static inline void use_sg_tbl(sec_sg_context_t *sg_ctx,
+                              const sec_packet_t *packet,
+                              sec_sg_context_type_t dir,
+                              dma_addr_t sg_tbl_phy)
+{
+    uint32_t sg_tbl_en = (packet[0].num_fragments != 0);
+
+    if (dir == SEC_SG_CONTEXT_TYPE_IN)
+    {
+        sg_ctx->in_sg_tbl_en = sg_tbl_en;
+        sg_ctx->in_sg_tbl = NULL;
+        sg_ctx->in_sg_tbl_phy = sg_tbl_phy;
+        sg_ctx->in_sg_tbls_no = 0;
+        sg_ctx->in_total_length = packet[0].total_length;
+    }
+    else
+    {
+        sg_ctx->out_sg_tbl_en = sg_tbl_en;
+        sg_ctx->out_sg_tbl = NULL;
+        sg_ctx->out_sg_tbl_phy = sg_tbl_phy;
+        sg_ctx->out_sg_tbls_no = 0;
+        sg_ctx->out_total_length = packet[0].total_length;
+    }
+}
+
+#if (SEC_ENABLE_SG_LINEARIZATION == ON)
+/** @brief Linearizes a fragmented packet into the bounce buffer of the job, for
+ * the given direction. The input packet is copied now. The output packet is copied
+ * from the bounce buffer to its fragments by scatter_bounce_buf(), once SEC is done.
+ *
+ * @param [in]  sg_ctx      The Scatter Gather context of the job.
+ * @param [in]  packet      The first fragment of the packet.
+ * @param [in]  dir         The 'direction' of the packet (input or output)
+ * @param [in]  ptov        P2V function for the fragments.
+ *
+ * @retval #TRUE if the packet was linearized.
+ * @retval #FALSE if it is longer than a bounce buffer or its fragments do not add
+ *         up to its total length. A SG table must be used.
+ */
+static inline uint32_t linearize_sg_packet(sec_sg_context_t *sg_ctx,
+                                           const sec_packet_t *packet,
+                                           sec_sg_context_type_t dir,
+                                           sec_ptov ptov)
+{
+    uint32_t total_length = packet[0].total_length;
+    uint32_t length = 0;
+    uint32_t i = 0;
+
+    if (total_length > SEC_SG_BOUNCE_BUF_SIZE)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i <= packet[0].num_fragments; i++)
+    {
+        if (unlikely(length + packet[i].length > total_length))
+        {
+            return FALSE;
+        }
+        if (dir == SEC_SG_CONTEXT_TYPE_IN)
+        {
+            memcpy(sg_ctx->bounce_buf + length,
+                   (uint8_t*)ptov(packet[i].address) + packet[i].offset,
+                   packet[i].length);
+        }
+        length += packet[i].length;
+    }
+    if (unlikely(length != total_length))
+    {
+        return FALSE;
+    }
+
+    if (dir == SEC_SG_CONTEXT_TYPE_IN)
+    {
+        sg_ctx->in_sg_tbl_en = 0;
+        sg_ctx->in_bounce_en = 1;
+        sg_ctx->in_total_length = total_length;
+    }
+    else
+    {
+        sg_ctx->out_sg_tbl_en = 0;
+        sg_ctx->out_bounce_en = 1;
+        sg_ctx->out_total_length = total_length;
+    }
+
+    return TRUE;
+}
+
+/** @brief Copies the output of a job from its output bounce buffer to the
+ * fragments of the output packet, if the output packet was linearized.
+ *
+ * @param [in]  sg_ctx      The Scatter Gather context of the job.
+ * @param [in]  packet      The first fragment of the output packet.
+ * @param [in]  ptov        P2V function for the fragments.
+ */
+static inline void scatter_bounce_buf(const sec_sg_context_t *sg_ctx,
+                                      const sec_packet_t *packet,
+                                      sec_ptov ptov)
+{
+    const uint8_t *bounce_buf = sg_ctx->bounce_buf + SEC_SG_BOUNCE_BUF_SIZE;
+    uint32_t i = 0;
+
+    if (likely(sg_ctx->out_bounce_en == 0))
+    {
+        return;
+    }
+
+    // The fragments were checked against the total length by linearize_sg_packet()
+    for (i = 0; i <= packet[0].num_fragments; i++)
+    {
+        memcpy((uint8_t*)ptov(packet[i].address) + packet[i].offset,
+               bounce_buf,
+               packet[i].length);
+        bounce_buf += packet[i].length;
+    }
+}
+#endif // (SEC_ENABLE_SG_LINEARIZATION == ON)
+
 /** @brief Populates the relevant data structures of a Scatter Gather contex for a job.
  * The function checks if there is a need to construct a Scatter-Gather table for input
- * or output packets (depending if there is 1 or more fragments)
+ * or output packets (depending if there is 1 or more fragments).
+ * The table is taken from the pool of the job ring. A packet with more fragments
+ * than fit in one table gets a chain of tables, linked by extension entries.
+ * On error, the caller must return the tables taken so far with release_sg_context().
+ *
+ * @param [in]  pool        The pool of SG tables of the job ring.
+ *
  * @param [in]  sg_ctx      The Scatter Gather context to be populated.
  *
  * @param [in]  packet      Pointer to a packet for which the Scatter Gather 
@@ -210,10 +576,11 @@ typedef struct{
                             to physical addresses
  */
 
-__attribute__((always_inline)) static sec_return_code_t   build_sg_context(sec_sg_context_t *sg_ctx,
-                                     const sec_packet_t *packet,
-                                     sec_sg_context_type_t dir,
-                                     int num_fragments)
+static inline __attribute__((always_inline)) sec_return_code_t build_sg_context(sec_sg_tbl_pool_t *pool,
+                                                                                sec_sg_context_t *sg_ctx,
+                                                                                const sec_packet_t *packet,
+                                                                                sec_sg_context_type_t dir,
+                                                                                int num_fragments)
 {
     uint32_t     *sg_tbl_en;
 #ifdef DEBUG
@@ -221,7 +588,14 @@ __attribute__((always_inline)) static sec_return_code_t   build_sg_context(sec_s
 #endif
     uint32_t    total_length;
     int         i = 0;
+    int         class_idx = 0;
+    uint32_t    entry_idx = 0;
+    uint32_t    j = 0;
+    uint32_t    tbls_no = 0;
+    uint16_t    tbl_idx = 0;
+    uint16_t    next_tbl_idx = 0;
     struct sec_sg_tbl_entry    *sg_tbl = NULL;
+    sec_sg_tbl_class_t *sg_class = NULL;
     sec_return_code_t ret = SEC_SUCCESS;
 
     __builtin_prefetch(packet);
@@ -243,12 +617,93 @@ __attribute__((always_inline)) static sec_return_code_t   build_sg_context(sec_s
     
     total_length = packet[0].total_length;
 
-    sg_tbl = (dir == SEC_SG_CONTEXT_TYPE_IN ?   \
-            sg_ctx->in_sg_tbl : sg_ctx->out_sg_tbl);
+    if (likely(num_fragments < SEC_SG_TBL_CLASS_LARGE_ENTRIES))
+    {
+        // Take a table from the smallest class that fits all the fragments and
+        // still has free tables
+        tbls_no = 1;
+        for (class_idx = 0; class_idx < SEC_SG_TBL_CLASSES_NO; class_idx++)
+        {
+            sg_class = &pool->classes[class_idx];
+            if (sg_class->entries_no > num_fragments &&
+                sg_class->return_idx != sg_class->take_idx)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        // Too many fragments for one table, take a chain of tables from the last class
+        tbls_no = SEC_SG_TBL_CHAIN_LEN(num_fragments);
+        class_idx = SEC_SG_TBL_CLASSES_NO - 1;
+        sg_class = &pool->classes[class_idx];
+        if (sg_class->return_idx - sg_class->take_idx < tbls_no)
+        {
+            class_idx = SEC_SG_TBL_CLASSES_NO;
+        }
+    }
+    if (unlikely(class_idx == SEC_SG_TBL_CLASSES_NO))
+    {
+        SEC_DEBUG("No free SG table for %d fragments", num_fragments);
+        return SEC_JR_IS_FULL;
+    }
+    // Read the free table indexes only after seeing them returned by the consumer
+    __sync_synchronize();
+
+    tbl_idx = sg_class->free_tbls[sg_class->take_idx & (sg_class->tbls_no - 1)];
+    sg_class->take_idx++;
+
+    sg_tbl = sg_class->tbls + tbl_idx * sg_class->entries_no;
+
+    if (dir == SEC_SG_CONTEXT_TYPE_IN)
+    {
+        sg_ctx->in_sg_tbl = sg_tbl;
+        sg_ctx->in_sg_tbl_phy = sg_class->tbls_phys + tbl_idx * sg_class->entries_no * SEC_SG_TBL_SIZE;
+        sg_ctx->in_sg_tbl_class = class_idx;
+        sg_ctx->in_sg_tbl_idx = tbl_idx;
+        sg_ctx->in_sg_tbls_no = tbls_no;
+    }
+    else
+    {
+        sg_ctx->out_sg_tbl = sg_tbl;
+        sg_ctx->out_sg_tbl_phy = sg_class->tbls_phys + tbl_idx * sg_class->entries_no * SEC_SG_TBL_SIZE;
+        sg_ctx->out_sg_tbl_class = class_idx;
+        sg_ctx->out_sg_tbl_idx = tbl_idx;
+        sg_ctx->out_sg_tbls_no = tbls_no;
+    }
+
+    // Link the rest of the chain, if any
+    for (j = 1, next_tbl_idx = tbl_idx; j < tbls_no; j++)
+    {
+        pool->chain_next[next_tbl_idx] = sg_class->free_tbls[sg_class->take_idx & (sg_class->tbls_no - 1)];
+        next_tbl_idx = pool->chain_next[next_tbl_idx];
+        sg_class->take_idx++;
+    }
+
+    // The tables now belong to this job, even if the fragments turn out to be invalid
+    *sg_tbl_en = 1;
 
 
     do{
-        __builtin_prefetch(&sg_tbl[i+1]);
+        // The last entry of a table is an extension entry pointing to the next
+        // table of the chain, unless it can hold the last fragment
+        if (unlikely(entry_idx == sg_class->entries_no - 1 && i < num_fragments))
+        {
+            next_tbl_idx = pool->chain_next[tbl_idx];
+
+            SG_TBL_SET_ADDRESS(sg_tbl[entry_idx],
+                               sg_class->tbls_phys + next_tbl_idx * sg_class->entries_no * SEC_SG_TBL_SIZE);
+            SG_TBL_SET_LENGTH_OFF(sg_tbl[entry_idx], 0, 0);
+            SG_TBL_SET_EXT(sg_tbl[entry_idx]);
+            DUMP_SG_TBL(sg_tbl);
+
+            tbl_idx = next_tbl_idx;
+            sg_tbl = sg_class->tbls + tbl_idx * sg_class->entries_no;
+            entry_idx = 0;
+        }
+
+        __builtin_prefetch(&sg_tbl[entry_idx+1]);
         __builtin_prefetch(&packet[i+1]);
 
         SEC_DEBUG("Processing SG fragment %d",i);
@@ -263,12 +718,13 @@ __attribute__((always_inline)) static sec_return_code_t   build_sg_context(sec_s
         SEC_ASSERT( (packet[i].offset & 0x1FFFFFFF) == packet[i].offset, SEC_INVALID_INPUT_PARAM, 
                     "Fragment %d offset is invalid : %d",i,packet[i].offset)
 
-        SG_TBL_SET_ADDRESS(sg_tbl[i],packet[i].address);
-        SG_TBL_SET_LENGTH_OFF(sg_tbl[i], packet[i].length,  packet[i].offset);
+        SG_TBL_SET_ADDRESS(sg_tbl[entry_idx],packet[i].address);
+        SG_TBL_SET_LENGTH_OFF(sg_tbl[entry_idx], packet[i].length,  packet[i].offset);
+        entry_idx++;
 
     }while( ++i <= num_fragments);
 
-    SG_TBL_SET_FINAL(sg_tbl[--i]);
+    SG_TBL_SET_FINAL(sg_tbl[entry_idx - 1]);
 
     SEC_ASSERT(tmp_len == total_length, SEC_INVALID_INPUT_PARAM,
                "Packets' fragment length (%d) is not equal to the total buffer length (%d)",
@@ -277,9 +733,6 @@ __attribute__((always_inline)) static sec_return_code_t   build_sg_context(sec_s
         sg_ctx->in_total_length = total_length;
     else
         sg_ctx->out_total_length = total_length;
-    
-    // Enable SG for this direction
-    *sg_tbl_en = 1;
 
     SEC_DEBUG("Created scatter gather table: @ 0x%08x",(uint32_t)sg_tbl);
     DUMP_SG_TBL(sg_tbl);
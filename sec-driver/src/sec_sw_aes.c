@@ -0,0 +1,647 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "fsl_sec.h"
+#include "sec_sw_crypto.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Number of rounds for AES-128 */
+#define AES128_ROUNDS           10
+
+/** Size of the COUNT || BEARER || DIRECTION || 0^26 prefix that 128-EIA2
+ * prepends to the message before running AES-CMAC over it. */
+#define EIA2_PREFIX_SIZE        8
+
+/** Size in bytes of the MAC-I */
+#define EIA2_MAC_I_SIZE         4
+
+/** Constant used for deriving the CMAC subkeys (R_128 from NIST SP 800-38B) */
+#define CMAC_RB                 0x87
+
+/** Rotate right a 32 bit word */
+#define ROR32(x, n)             (((x) >> (n)) | ((x) << (32 - (n))))
+
+#if (SEC_SW_CRYPTO_LANES < 1) || (SEC_SW_CRYPTO_LANES > 8)
+#error "Invalid value for SEC_SW_CRYPTO_LANES!"
+#endif
+
+#if (SEC_SW_AES_CONSTANT_TIME == ON)
+/** Rotate left a 32 bit word */
+#define ROL32(x, n)             ROR32((x), 32 - (n))
+
+/** Each byte of a 32 bit word set to the same value */
+#define BYTES_X4(b)             (0x01010101U * (uint32_t)(b))
+
+/** Rotate left each of the 4 bytes of a 32 bit word */
+#define ROL8_X4(x, n)           ((((x) << (n)) & BYTES_X4((0xFF << (n)) & 0xFF)) | \
+                                 (((x) >> (8 - (n))) & BYTES_X4(0xFF >> (8 - (n)))))
+#endif // (SEC_SW_AES_CONSTANT_TIME == ON)
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+/** State of one lane of the multi-buffer 128-EIA2 kernel */
+typedef struct eia2_lane_s
+{
+    sec_sw_eia2_job_t   *job;                           /*< Job currently processed on this lane. NULL if lane is idle. */
+    const uint8_t       *key;                           /*< Key the round keys were expanded from */
+    uint32_t            rk[SEC_SW_AES128_RK_WORDS];     /*< AES round keys */
+    uint8_t             k1[SEC_SW_AES_BLOCK_SIZE];      /*< CMAC subkey used for a complete last block */
+    uint8_t             k2[SEC_SW_AES_BLOCK_SIZE];      /*< CMAC subkey used for a padded last block */
+    uint8_t             prefix[EIA2_PREFIX_SIZE];       /*< COUNT || BEARER || DIRECTION || 0^26 */
+    uint8_t             state[SEC_SW_AES_BLOCK_SIZE];   /*< CBC-MAC chaining value */
+    uint32_t            total_length;                   /*< Length of prefix + message */
+    uint32_t            blocks_no;                      /*< Number of AES blocks in prefix + message */
+    uint32_t            next_block;                     /*< Index of the next block to be processed */
+}eia2_lane_t;
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+#if (SEC_SW_AES_CONSTANT_TIME == OFF)
+/** AES S-box */
+static const uint8_t aes_sbox[256] = {
+    0x63,0x7c,0x77,0x7b,0xf2,0x6b,0x6f,0xc5,
+    0x30,0x01,0x67,0x2b,0xfe,0xd7,0xab,0x76,
+    0xca,0x82,0xc9,0x7d,0xfa,0x59,0x47,0xf0,
+    0xad,0xd4,0xa2,0xaf,0x9c,0xa4,0x72,0xc0,
+    0xb7,0xfd,0x93,0x26,0x36,0x3f,0xf7,0xcc,
+    0x34,0xa5,0xe5,0xf1,0x71,0xd8,0x31,0x15,
+    0x04,0xc7,0x23,0xc3,0x18,0x96,0x05,0x9a,
+    0x07,0x12,0x80,0xe2,0xeb,0x27,0xb2,0x75,
+    0x09,0x83,0x2c,0x1a,0x1b,0x6e,0x5a,0xa0,
+    0x52,0x3b,0xd6,0xb3,0x29,0xe3,0x2f,0x84,
+    0x53,0xd1,0x00,0xed,0x20,0xfc,0xb1,0x5b,
+    0x6a,0xcb,0xbe,0x39,0x4a,0x4c,0x58,0xcf,
+    0xd0,0xef,0xaa,0xfb,0x43,0x4d,0x33,0x85,
+    0x45,0xf9,0x02,0x7f,0x50,0x3c,0x9f,0xa8,
+    0x51,0xa3,0x40,0x8f,0x92,0x9d,0x38,0xf5,
+    0xbc,0xb6,0xda,0x21,0x10,0xff,0xf3,0xd2,
+    0xcd,0x0c,0x13,0xec,0x5f,0x97,0x44,0x17,
+    0xc4,0xa7,0x7e,0x3d,0x64,0x5d,0x19,0x73,
+    0x60,0x81,0x4f,0xdc,0x22,0x2a,0x90,0x88,
+    0x46,0xee,0xb8,0x14,0xde,0x5e,0x0b,0xdb,
+    0xe0,0x32,0x3a,0x0a,0x49,0x06,0x24,0x5c,
+    0xc2,0xd3,0xac,0x62,0x91,0x95,0xe4,0x79,
+    0xe7,0xc8,0x37,0x6d,0x8d,0xd5,0x4e,0xa9,
+    0x6c,0x56,0xf4,0xea,0x65,0x7a,0xae,0x08,
+    0xba,0x78,0x25,0x2e,0x1c,0xa6,0xb4,0xc6,
+    0xe8,0xdd,0x74,0x1f,0x4b,0xbd,0x8b,0x8a,
+    0x70,0x3e,0xb5,0x66,0x48,0x03,0xf6,0x0e,
+    0x61,0x35,0x57,0xb9,0x86,0xc1,0x1d,0x9e,
+    0xe1,0xf8,0x98,0x11,0x69,0xd9,0x8e,0x94,
+    0x9b,0x1e,0x87,0xe9,0xce,0x55,0x28,0xdf,
+    0x8c,0xa1,0x89,0x0d,0xbf,0xe6,0x42,0x68,
+    0x41,0x99,0x2d,0x0f,0xb0,0x54,0xbb,0x16};
+
+/** AES encryption table: for each input byte x the column {02}.S[x], S[x], S[x], {03}.S[x].
+ * The tables for the other three byte positions are rotations of this one. */
+static const uint32_t aes_te0[256] = {
+    0xc66363a5, 0xf87c7c84, 0xee777799, 0xf67b7b8d,
+    0xfff2f20d, 0xd66b6bbd, 0xde6f6fb1, 0x91c5c554,
+    0x60303050, 0x02010103, 0xce6767a9, 0x562b2b7d,
+    0xe7fefe19, 0xb5d7d762, 0x4dababe6, 0xec76769a,
+    0x8fcaca45, 0x1f82829d, 0x89c9c940, 0xfa7d7d87,
+    0xeffafa15, 0xb25959eb, 0x8e4747c9, 0xfbf0f00b,
+    0x41adadec, 0xb3d4d467, 0x5fa2a2fd, 0x45afafea,
+    0x239c9cbf, 0x53a4a4f7, 0xe4727296, 0x9bc0c05b,
+    0x75b7b7c2, 0xe1fdfd1c, 0x3d9393ae, 0x4c26266a,
+    0x6c36365a, 0x7e3f3f41, 0xf5f7f702, 0x83cccc4f,
+    0x6834345c, 0x51a5a5f4, 0xd1e5e534, 0xf9f1f108,
+    0xe2717193, 0xabd8d873, 0x62313153, 0x2a15153f,
+    0x0804040c, 0x95c7c752, 0x46232365, 0x9dc3c35e,
+    0x30181828, 0x379696a1, 0x0a05050f, 0x2f9a9ab5,
+    0x0e070709, 0x24121236, 0x1b80809b, 0xdfe2e23d,
+    0xcdebeb26, 0x4e272769, 0x7fb2b2cd, 0xea75759f,
+    0x1209091b, 0x1d83839e, 0x582c2c74, 0x341a1a2e,
+    0x361b1b2d, 0xdc6e6eb2, 0xb45a5aee, 0x5ba0a0fb,
+    0xa45252f6, 0x763b3b4d, 0xb7d6d661, 0x7db3b3ce,
+    0x5229297b, 0xdde3e33e, 0x5e2f2f71, 0x13848497,
+    0xa65353f5, 0xb9d1d168, 0x00000000, 0xc1eded2c,
+    0x40202060, 0xe3fcfc1f, 0x79b1b1c8, 0xb65b5bed,
+    0xd46a6abe, 0x8dcbcb46, 0x67bebed9, 0x7239394b,
+    0x944a4ade, 0x984c4cd4, 0xb05858e8, 0x85cfcf4a,
+    0xbbd0d06b, 0xc5efef2a, 0x4faaaae5, 0xedfbfb16,
+    0x864343c5, 0x9a4d4dd7, 0x66333355, 0x11858594,
+    0x8a4545cf, 0xe9f9f910, 0x04020206, 0xfe7f7f81,
+    0xa05050f0, 0x783c3c44, 0x259f9fba, 0x4ba8a8e3,
+    0xa25151f3, 0x5da3a3fe, 0x804040c0, 0x058f8f8a,
+    0x3f9292ad, 0x219d9dbc, 0x70383848, 0xf1f5f504,
+    0x63bcbcdf, 0x77b6b6c1, 0xafdada75, 0x42212163,
+    0x20101030, 0xe5ffff1a, 0xfdf3f30e, 0xbfd2d26d,
+    0x81cdcd4c, 0x180c0c14, 0x26131335, 0xc3ecec2f,
+    0xbe5f5fe1, 0x359797a2, 0x884444cc, 0x2e171739,
+    0x93c4c457, 0x55a7a7f2, 0xfc7e7e82, 0x7a3d3d47,
+    0xc86464ac, 0xba5d5de7, 0x3219192b, 0xe6737395,
+    0xc06060a0, 0x19818198, 0x9e4f4fd1, 0xa3dcdc7f,
+    0x44222266, 0x542a2a7e, 0x3b9090ab, 0x0b888883,
+    0x8c4646ca, 0xc7eeee29, 0x6bb8b8d3, 0x2814143c,
+    0xa7dede79, 0xbc5e5ee2, 0x160b0b1d, 0xaddbdb76,
+    0xdbe0e03b, 0x64323256, 0x743a3a4e, 0x140a0a1e,
+    0x924949db, 0x0c06060a, 0x4824246c, 0xb85c5ce4,
+    0x9fc2c25d, 0xbdd3d36e, 0x43acacef, 0xc46262a6,
+    0x399191a8, 0x319595a4, 0xd3e4e437, 0xf279798b,
+    0xd5e7e732, 0x8bc8c843, 0x6e373759, 0xda6d6db7,
+    0x018d8d8c, 0xb1d5d564, 0x9c4e4ed2, 0x49a9a9e0,
+    0xd86c6cb4, 0xac5656fa, 0xf3f4f407, 0xcfeaea25,
+    0xca6565af, 0xf47a7a8e, 0x47aeaee9, 0x10080818,
+    0x6fbabad5, 0xf0787888, 0x4a25256f, 0x5c2e2e72,
+    0x381c1c24, 0x57a6a6f1, 0x73b4b4c7, 0x97c6c651,
+    0xcbe8e823, 0xa1dddd7c, 0xe874749c, 0x3e1f1f21,
+    0x964b4bdd, 0x61bdbddc, 0x0d8b8b86, 0x0f8a8a85,
+    0xe0707090, 0x7c3e3e42, 0x71b5b5c4, 0xcc6666aa,
+    0x904848d8, 0x06030305, 0xf7f6f601, 0x1c0e0e12,
+    0xc26161a3, 0x6a35355f, 0xae5757f9, 0x69b9b9d0,
+    0x17868691, 0x99c1c158, 0x3a1d1d27, 0x279e9eb9,
+    0xd9e1e138, 0xebf8f813, 0x2b9898b3, 0x22111133,
+    0xd26969bb, 0xa9d9d970, 0x078e8e89, 0x339494a7,
+    0x2d9b9bb6, 0x3c1e1e22, 0x15878792, 0xc9e9e920,
+    0x87cece49, 0xaa5555ff, 0x50282878, 0xa5dfdf7a,
+    0x038c8c8f, 0x59a1a1f8, 0x09898980, 0x1a0d0d17,
+    0x65bfbfda, 0xd7e6e631, 0x844242c6, 0xd06868b8,
+    0x824141c3, 0x299999b0, 0x5a2d2d77, 0x1e0f0f11,
+    0x7bb0b0cb, 0xa85454fc, 0x6dbbbbd6, 0x2c16163a};
+#endif // (SEC_SW_AES_CONSTANT_TIME == OFF)
+
+/** AES key schedule round constants */
+static const uint32_t aes_rcon[AES128_ROUNDS] = {
+    0x01000000, 0x02000000, 0x04000000, 0x08000000, 0x10000000,
+    0x20000000, 0x40000000, 0x80000000, 0x1b000000, 0x36000000
+};
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+/** @brief Derives the CMAC subkeys K1 and K2 for the key loaded on a lane.
+ *
+ * @param [in,out] lane     The lane. Round keys must be already expanded.
+ */
+static void eia2_lane_derive_subkeys(eia2_lane_t *lane);
+
+/** @brief Starts processing a new job on a lane.
+ *
+ * @param [in,out] lane     The lane.
+ * @param [in]     job      The job.
+ */
+static void eia2_lane_load_job(eia2_lane_t *lane, sec_sw_eia2_job_t *job);
+
+/** @brief Folds the next message block of a lane into its CBC-MAC state.
+ *
+ * @param [in,out] lane     The lane.
+ */
+static void eia2_lane_absorb_block(eia2_lane_t *lane);
+
+#if (SEC_SW_AES_CONSTANT_TIME == ON)
+/** @brief Multiplies in GF(2^8) each of the 4 bytes of a word by the byte at the same
+ * position in another word. Runs in constant time: no branch and no memory access
+ * depend on the operands.
+ *
+ * @param [in] a    First operands.
+ * @param [in] b    Second operands.
+ *
+ * @retval The 4 products.
+ */
+static inline uint32_t aes_gf_mul_x4(uint32_t a, uint32_t b);
+
+/** @brief Applies the AES S-box to each of the 4 bytes of a word, in constant time.
+ * The S-box is computed as the inverse in GF(2^8) followed by the affine transform,
+ * instead of being looked up in a table indexed with secret data.
+ *
+ * @param [in] x    Input bytes.
+ *
+ * @retval The substituted bytes.
+ */
+static inline uint32_t aes_sub_word_ct(uint32_t x);
+
+/** @brief Encrypts one AES-128 block in constant time.
+ *
+ * @param [in]     rk       Round keys.
+ * @param [in,out] block    The block, encrypted in place.
+ */
+static void aes128_encrypt_block_ct(const uint32_t *rk, uint8_t *block);
+#endif // (SEC_SW_AES_CONSTANT_TIME == ON)
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+static void eia2_lane_derive_subkeys(eia2_lane_t *lane)
+{
+    uint8_t l[SEC_SW_AES_BLOCK_SIZE];
+    uint8_t *block = l;
+    const uint32_t *rk = lane->rk;
+    int i;
+
+    // L = AES(K, 0^128)
+    memset(l, 0, sizeof(l));
+    sec_sw_aes128_encrypt_lanes(&rk, &block, 1);
+
+    // K1 = L << 1, xor Rb if MSB(L) is set
+    for (i = 0; i < SEC_SW_AES_BLOCK_SIZE - 1; i++)
+    {
+        lane->k1[i] = (uint8_t)((l[i] << 1) | (l[i + 1] >> 7));
+    }
+    lane->k1[SEC_SW_AES_BLOCK_SIZE - 1] = (uint8_t)(l[SEC_SW_AES_BLOCK_SIZE - 1] << 1);
+    if (l[0] & 0x80)
+    {
+        lane->k1[SEC_SW_AES_BLOCK_SIZE - 1] ^= CMAC_RB;
+    }
+
+    // K2 = K1 << 1, xor Rb if MSB(K1) is set
+    for (i = 0; i < SEC_SW_AES_BLOCK_SIZE - 1; i++)
+    {
+        lane->k2[i] = (uint8_t)((lane->k1[i] << 1) | (lane->k1[i + 1] >> 7));
+    }
+    lane->k2[SEC_SW_AES_BLOCK_SIZE - 1] = (uint8_t)(lane->k1[SEC_SW_AES_BLOCK_SIZE - 1] << 1);
+    if (lane->k1[0] & 0x80)
+    {
+        lane->k2[SEC_SW_AES_BLOCK_SIZE - 1] ^= CMAC_RB;
+    }
+}
+
+static void eia2_lane_load_job(eia2_lane_t *lane, sec_sw_eia2_job_t *job)
+{
+    // Jobs of the same context usually come grouped in a batch,
+    // do not expand the same key again.
+    if (lane->key != job->key)
+    {
+        sec_sw_aes128_expand_key(job->key, lane->rk);
+        eia2_lane_derive_subkeys(lane);
+        lane->key = job->key;
+    }
+
+    SEC_SW_PUT_U32_BE(lane->prefix, job->count);
+    lane->prefix[4] = (uint8_t)(((job->bearer & 0x1F) << 3) | ((job->direction & 0x01) << 2));
+    lane->prefix[5] = 0;
+    lane->prefix[6] = 0;
+    lane->prefix[7] = 0;
+
+    memset(lane->state, 0, sizeof(lane->state));
+    lane->total_length = EIA2_PREFIX_SIZE + job->length;
+    lane->blocks_no = (lane->total_length + SEC_SW_AES_BLOCK_SIZE - 1) / SEC_SW_AES_BLOCK_SIZE;
+    lane->next_block = 0;
+    lane->job = job;
+}
+
+static void eia2_lane_absorb_block(eia2_lane_t *lane)
+{
+    uint32_t offset = lane->next_block * SEC_SW_AES_BLOCK_SIZE;
+    const uint8_t *message = lane->job->message;
+    uint32_t i;
+
+    if (likely(offset >= EIA2_PREFIX_SIZE &&
+               offset + SEC_SW_AES_BLOCK_SIZE < lane->total_length))
+    {
+        // Fast path: a full block entirely inside the message and not the last one.
+        message += offset - EIA2_PREFIX_SIZE;
+        for (i = 0; i < SEC_SW_AES_BLOCK_SIZE; i++)
+        {
+            lane->state[i] ^= message[i];
+        }
+        return;
+    }
+
+    // The first block (which holds the prefix) or the last block (which is
+    // completed with a subkey and, if needed, with padding).
+    for (i = 0; i < SEC_SW_AES_BLOCK_SIZE; i++)
+    {
+        uint32_t pos = offset + i;
+        uint8_t byte;
+
+        if (pos < EIA2_PREFIX_SIZE)
+        {
+            byte = lane->prefix[pos];
+        }
+        else if (pos < lane->total_length)
+        {
+            byte = message[pos - EIA2_PREFIX_SIZE];
+        }
+        else
+        {
+            byte = (pos == lane->total_length) ? 0x80 : 0x00;
+        }
+        lane->state[i] ^= byte;
+    }
+
+    if (lane->next_block == lane->blocks_no - 1)
+    {
+        const uint8_t *subkey = (lane->total_length % SEC_SW_AES_BLOCK_SIZE == 0) ?
+                                lane->k1 : lane->k2;
+        for (i = 0; i < SEC_SW_AES_BLOCK_SIZE; i++)
+        {
+            lane->state[i] ^= subkey[i];
+        }
+    }
+}
+
+#if (SEC_SW_AES_CONSTANT_TIME == ON)
+static inline uint32_t aes_gf_mul_x4(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0;
+    int i;
+
+    for (i = 0; i < 8; i++)
+    {
+        // Add a to the bytes whose bit i of b is set, then a = a * x modulo the AES polynomial
+        r ^= a & (((b >> i) & BYTES_X4(0x01)) * 0xFF);
+        a = ((a & BYTES_X4(0x7F)) << 1) ^ (((a >> 7) & BYTES_X4(0x01)) * 0x1B);
+    }
+
+    return r;
+}
+
+static inline uint32_t aes_sub_word_ct(uint32_t x)
+{
+    uint32_t y;
+    uint32_t inv;
+    int i;
+
+    // x^-1 = x^254 = x^2 * x^4 * ... * x^128, with 0 mapped to 0
+    y = aes_gf_mul_x4(x, x);
+    inv = y;
+    for (i = 0; i < 6; i++)
+    {
+        y = aes_gf_mul_x4(y, y);
+        inv = aes_gf_mul_x4(inv, y);
+    }
+
+    return inv ^ ROL8_X4(inv, 1) ^ ROL8_X4(inv, 2) ^ ROL8_X4(inv, 3) ^ ROL8_X4(inv, 4) ^
+           BYTES_X4(0x63);
+}
+
+static void aes128_encrypt_block_ct(const uint32_t *rk, uint8_t *block)
+{
+    uint32_t s[4];
+    uint32_t t[4];
+    int r;
+    int c;
+
+    for (c = 0; c < 4; c++)
+    {
+        s[c] = SEC_SW_GET_U32_BE(block + 4 * c) ^ rk[c];
+    }
+
+    for (r = 1; r <= AES128_ROUNDS; r++)
+    {
+        for (c = 0; c < 4; c++)
+        {
+            s[c] = aes_sub_word_ct(s[c]);
+        }
+
+        // ShiftRows: row i of column c comes from column c + i
+        for (c = 0; c < 4; c++)
+        {
+            t[c] = (s[c] & 0xFF000000) ^ (s[(c + 1) & 3] & 0x00FF0000) ^
+                   (s[(c + 2) & 3] & 0x0000FF00) ^ (s[(c + 3) & 3] & 0x000000FF);
+        }
+
+        for (c = 0; c < 4; c++)
+        {
+            uint32_t w = t[c];
+
+            if (r < AES128_ROUNDS)
+            {
+                // MixColumns: a'[i] = {02}.(a[i] ^ a[i+1]) ^ a[i+1] ^ a[i+2] ^ a[i+3].
+                // The branch depends only on the round number.
+                uint32_t u = w ^ ROL32(w, 8);
+
+                w = (((u & BYTES_X4(0x7F)) << 1) ^ (((u >> 7) & BYTES_X4(0x01)) * 0x1B)) ^
+                    ROL32(w, 8) ^ ROL32(w, 16) ^ ROL32(w, 24);
+            }
+            s[c] = w ^ rk[4 * r + c];
+        }
+    }
+
+    for (c = 0; c < 4; c++)
+    {
+        SEC_SW_PUT_U32_BE(block + 4 * c, s[c]);
+    }
+}
+#endif // (SEC_SW_AES_CONSTANT_TIME == ON)
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+void sec_sw_aes128_expand_key(const uint8_t *key, uint32_t *rk)
+{
+    int i;
+
+    rk[0] = SEC_SW_GET_U32_BE(key);
+    rk[1] = SEC_SW_GET_U32_BE(key + 4);
+    rk[2] = SEC_SW_GET_U32_BE(key + 8);
+    rk[3] = SEC_SW_GET_U32_BE(key + 12);
+
+    for (i = 0; i < AES128_ROUNDS; i++)
+    {
+        uint32_t t = rk[3];
+
+#if (SEC_SW_AES_CONSTANT_TIME == ON)
+        rk[4] = rk[0] ^ aes_rcon[i] ^ aes_sub_word_ct(ROL32(t, 8));
+#else // (SEC_SW_AES_CONSTANT_TIME == ON)
+        rk[4] = rk[0] ^ aes_rcon[i] ^
+                ((uint32_t)aes_sbox[(t >> 16) & 0xFF] << 24) ^
+                ((uint32_t)aes_sbox[(t >> 8) & 0xFF] << 16) ^
+                ((uint32_t)aes_sbox[t & 0xFF] << 8) ^
+                ((uint32_t)aes_sbox[t >> 24]);
+#endif // (SEC_SW_AES_CONSTANT_TIME == ON)
+        rk[5] = rk[1] ^ rk[4];
+        rk[6] = rk[2] ^ rk[5];
+        rk[7] = rk[3] ^ rk[6];
+        rk += 4;
+    }
+}
+
+void sec_sw_aes128_encrypt_lanes(const uint32_t * const *rk,
+                                 uint8_t * const *blocks,
+                                 uint32_t lanes_no)
+{
+#if (SEC_SW_AES_CONSTANT_TIME == ON)
+    uint32_t l;
+
+    ASSERT(lanes_no <= SEC_SW_CRYPTO_LANES);
+
+    for (l = 0; l < lanes_no; l++)
+    {
+        aes128_encrypt_block_ct(rk[l], blocks[l]);
+    }
+#else // (SEC_SW_AES_CONSTANT_TIME == ON)
+    uint32_t s[SEC_SW_CRYPTO_LANES][4];
+    uint32_t t[SEC_SW_CRYPTO_LANES][4];
+    uint32_t l;
+    int r;
+
+    ASSERT(lanes_no <= SEC_SW_CRYPTO_LANES);
+
+    for (l = 0; l < lanes_no; l++)
+    {
+        s[l][0] = SEC_SW_GET_U32_BE(blocks[l]) ^ rk[l][0];
+        s[l][1] = SEC_SW_GET_U32_BE(blocks[l] + 4) ^ rk[l][1];
+        s[l][2] = SEC_SW_GET_U32_BE(blocks[l] + 8) ^ rk[l][2];
+        s[l][3] = SEC_SW_GET_U32_BE(blocks[l] + 12) ^ rk[l][3];
+    }
+
+    for (r = 1; r < AES128_ROUNDS; r++)
+    {
+        // The lanes are independent: same round for all lanes, then next round.
+        for (l = 0; l < lanes_no; l++)
+        {
+            const uint32_t *k = rk[l] + 4 * r;
+            uint32_t *x = s[l];
+
+            t[l][0] = aes_te0[x[0] >> 24] ^ ROR32(aes_te0[(x[1] >> 16) & 0xFF], 8) ^
+                      ROR32(aes_te0[(x[2] >> 8) & 0xFF], 16) ^ ROR32(aes_te0[x[3] & 0xFF], 24) ^ k[0];
+            t[l][1] = aes_te0[x[1] >> 24] ^ ROR32(aes_te0[(x[2] >> 16) & 0xFF], 8) ^
+                      ROR32(aes_te0[(x[3] >> 8) & 0xFF], 16) ^ ROR32(aes_te0[x[0] & 0xFF], 24) ^ k[1];
+            t[l][2] = aes_te0[x[2] >> 24] ^ ROR32(aes_te0[(x[3] >> 16) & 0xFF], 8) ^
+                      ROR32(aes_te0[(x[0] >> 8) & 0xFF], 16) ^ ROR32(aes_te0[x[1] & 0xFF], 24) ^ k[2];
+            t[l][3] = aes_te0[x[3] >> 24] ^ ROR32(aes_te0[(x[0] >> 16) & 0xFF], 8) ^
+                      ROR32(aes_te0[(x[1] >> 8) & 0xFF], 16) ^ ROR32(aes_te0[x[2] & 0xFF], 24) ^ k[3];
+        }
+        memcpy(s, t, lanes_no * sizeof(s[0]));
+    }
+
+    // Last round: no MixColumns
+    for (l = 0; l < lanes_no; l++)
+    {
+        const uint32_t *k = rk[l] + 4 * AES128_ROUNDS;
+        uint32_t *x = s[l];
+        int c;
+
+        for (c = 0; c < 4; c++)
+        {
+            uint32_t v = ((uint32_t)aes_sbox[x[c] >> 24] << 24) ^
+                         ((uint32_t)aes_sbox[(x[(c + 1) & 3] >> 16) & 0xFF] << 16) ^
+                         ((uint32_t)aes_sbox[(x[(c + 2) & 3] >> 8) & 0xFF] << 8) ^
+                         ((uint32_t)aes_sbox[x[(c + 3) & 3] & 0xFF]) ^ k[c];
+            SEC_SW_PUT_U32_BE(blocks[l] + 4 * c, v);
+        }
+    }
+#endif // (SEC_SW_AES_CONSTANT_TIME == ON)
+}
+
+sec_return_code_t sec_sw_eia2_compute_batch(sec_sw_eia2_job_t *jobs, uint32_t jobs_no)
+{
+    eia2_lane_t lanes[SEC_SW_CRYPTO_LANES];
+    const uint32_t *rk[SEC_SW_CRYPTO_LANES];
+    uint8_t *blocks[SEC_SW_CRYPTO_LANES];
+    eia2_lane_t *active[SEC_SW_CRYPTO_LANES];
+    uint32_t next_job = 0;
+    uint32_t active_no;
+    uint32_t i;
+
+    SEC_ASSERT(jobs != NULL || jobs_no == 0, SEC_INVALID_INPUT_PARAM, "jobs is NULL");
+#ifdef DEBUG
+    for (i = 0; i < jobs_no; i++)
+    {
+        SEC_ASSERT(jobs[i].key != NULL, SEC_INVALID_INPUT_PARAM, "key is NULL for job %d", i);
+        SEC_ASSERT(jobs[i].message != NULL || jobs[i].length == 0, SEC_INVALID_INPUT_PARAM,
+                   "message is NULL for job %d", i);
+    }
+#endif
+
+    for (i = 0; i < SEC_SW_CRYPTO_LANES; i++)
+    {
+        lanes[i].job = NULL;
+        lanes[i].key = NULL;
+    }
+
+    do
+    {
+        // Refill the idle lanes and collect the lanes with work to do
+        active_no = 0;
+        for (i = 0; i < SEC_SW_CRYPTO_LANES; i++)
+        {
+            eia2_lane_t *lane = &lanes[i];
+
+            if (lane->job == NULL)
+            {
+                if (next_job == jobs_no)
+                {
+                    continue;
+                }
+                eia2_lane_load_job(lane, &jobs[next_job++]);
+            }
+
+            eia2_lane_absorb_block(lane);
+            rk[active_no] = lane->rk;
+            blocks[active_no] = lane->state;
+            active[active_no] = lane;
+            active_no++;
+        }
+
+        if (active_no == 0)
+        {
+            break;
+        }
+
+        sec_sw_aes128_encrypt_lanes(rk, blocks, active_no);
+
+        for (i = 0; i < active_no; i++)
+        {
+            eia2_lane_t *lane = active[i];
+
+            if (++lane->next_block == lane->blocks_no)
+            {
+                memcpy(lane->job->mac_i, lane->state, EIA2_MAC_I_SIZE);
+                lane->job = NULL;
+            }
+        }
+    }while(1);
+
+    return SEC_SUCCESS;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
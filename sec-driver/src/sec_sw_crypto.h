@@ -0,0 +1,196 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEC_SW_CRYPTO_H
+#define SEC_SW_CRYPTO_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include <string.h>
+#include "fsl_sec.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+/** Size in bytes of an AES block */
+#define SEC_SW_AES_BLOCK_SIZE       16
+
+/** Number of 32 bit round key words for AES-128 */
+#define SEC_SW_AES128_RK_WORDS      44
+
+/** Read a big endian 32 bit word from a byte array, regardless of host endianness */
+#define SEC_SW_GET_U32_BE(p)  \
+    (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+     ((uint32_t)(p)[2] << 8)  |  (uint32_t)(p)[3])
+
+/** Write a 32 bit word to a byte array in big endian format, regardless of host endianness */
+#define SEC_SW_PUT_U32_BE(p, v) \
+    do { \
+        (p)[0] = (uint8_t)((v) >> 24); \
+        (p)[1] = (uint8_t)((v) >> 16); \
+        (p)[2] = (uint8_t)((v) >> 8);  \
+        (p)[3] = (uint8_t)(v);         \
+    } while(0)
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Expands an AES-128 key into the round keys used by the software AES engine.
+ *
+ * @param [in]  key     128 bit AES key.
+ * @param [out] rk      Array of #SEC_SW_AES128_RK_WORDS round key words.
+ */
+void sec_sw_aes128_expand_key(const uint8_t *key, uint32_t *rk);
+
+/** @brief Encrypts one or more independent AES-128 blocks.
+ *
+ * Each lane is encrypted with its own key schedule. The rounds of all lanes
+ * are interleaved, so that the table lookups of the different lanes can be
+ * issued back to back by the core instead of waiting on each other.
+ *
+ * @param [in]     rk       Array of lanes_no pointers to expanded keys.
+ * @param [in,out] blocks   Array of lanes_no pointers to 16 byte blocks,
+ *                          encrypted in place.
+ * @param [in]     lanes_no Number of lanes. Must not exceed #SEC_SW_CRYPTO_LANES.
+ */
+void sec_sw_aes128_encrypt_lanes(const uint32_t * const *rk,
+                                 uint8_t * const *blocks,
+                                 uint32_t lanes_no);
+
+/** @brief Generates 128-EEA1 (SNOW 3G f8) keystream for one or more COUNT values
+ * of the same key, bearer and direction.
+ *
+ * The clocking of all lanes is interleaved, in the same way as for
+ * sec_sw_aes128_encrypt_lanes().
+ *
+ * @param [in]  key         128 bit ciphering key.
+ * @param [in]  counts      Array of lanes_no COUNT values, one per lane.
+ * @param [in]  bearer      Radio bearer id, 5 bits.
+ * @param [in]  direction   Direction bit.
+ * @param [out] ks          Array of lanes_no pointers to keystream buffers of length bytes.
+ * @param [in]  length      Number of keystream bytes to generate per lane.
+ * @param [in]  lanes_no    Number of lanes. Must not exceed #SEC_SW_CRYPTO_LANES.
+ */
+void sec_sw_snow3g_keystream_lanes(const uint8_t *key,
+                                   const uint32_t *counts,
+                                   uint8_t bearer,
+                                   uint8_t direction,
+                                   uint8_t * const *ks,
+                                   uint32_t length,
+                                   uint32_t lanes_no);
+
+/** @brief Generates the PDCP User Plane keystream for one COUNT value, with
+ * 128-EEA1 (SNOW 3G f8) or 128-EEA2 (AES-CTR).
+ *
+ * @param [in]  cipher_algorithm    #SEC_ALG_SNOW or #SEC_ALG_AES.
+ * @param [in]  key                 128 bit ciphering key. Used for #SEC_ALG_SNOW.
+ * @param [in]  aes_rk              Key expanded with sec_sw_aes128_expand_key(). Used for #SEC_ALG_AES.
+ * @param [in]  count               The COUNT value.
+ * @param [in]  bearer              Radio bearer id, 5 bits.
+ * @param [in]  direction           Direction bit.
+ * @param [out] ks                  Keystream buffer. For #SEC_ALG_AES, length is rounded up
+ *                                  to a multiple of 16 bytes and the buffer must be that large.
+ * @param [in]  length              Number of keystream bytes to generate.
+ */
+void sec_sw_pdcp_keystream(uint8_t cipher_algorithm,
+                           const uint8_t *key,
+                           const uint32_t *aes_rk,
+                           uint32_t count,
+                           uint8_t bearer,
+                           uint8_t direction,
+                           uint8_t *ks,
+                           uint32_t length);
+
+/** @brief XORs data with keystream, a 64 bit word at a time.
+ *
+ * memcpy() makes the accesses safe for any alignment and is turned by the
+ * compiler into plain loads and stores.
+ *
+ * @param [out] out     Output buffer. Can be the same as in.
+ * @param [in]  in      Input buffer.
+ * @param [in]  ks      Keystream.
+ * @param [in]  length  Number of bytes.
+ */
+static inline void sec_sw_xor(uint8_t *out, const uint8_t *in, const uint8_t *ks, uint32_t length)
+{
+    uint32_t i;
+
+    for (i = 0; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
+    {
+        uint64_t d, k;
+
+        memcpy(&d, in + i, sizeof(d));
+        memcpy(&k, ks + i, sizeof(k));
+        d ^= k;
+        memcpy(out + i, &d, sizeof(d));
+    }
+    for (; i < length; i++)
+    {
+        out[i] = in[i] ^ ks[i];
+    }
+}
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_SW_CRYPTO_H */
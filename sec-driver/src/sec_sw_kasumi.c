@@ -0,0 +1,441 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "fsl_sec.h"
+#include "sec_sw_crypto.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Number of rounds of the KASUMI block cipher */
+#define KASUMI_ROUNDS           8
+
+/** Size in bytes of a KASUMI block */
+#define KASUMI_BLOCK_SIZE       8
+
+/** Size in bytes of a KASUMI key */
+#define KASUMI_KEY_SIZE         16
+
+/** Key modifier used by f8 for deriving the key that encrypts the IV */
+#define KASUMI_F8_KEY_MODIFIER  0x55
+
+/** Rotate left a 16 bit word */
+#define ROL16(x, n)             ((uint16_t)(((x) << (n)) | ((x) >> (16 - (n)))))
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+/** KASUMI subkeys for all the rounds, as defined in 3GPP TS 35.202 */
+typedef struct kasumi_key_sched_s
+{
+    uint16_t    kl1[KASUMI_ROUNDS];     /*< FL subkey KLi,1 */
+    uint16_t    kl2[KASUMI_ROUNDS];     /*< FL subkey KLi,2 */
+    uint16_t    ko1[KASUMI_ROUNDS];     /*< FO subkey KOi,1 */
+    uint16_t    ko2[KASUMI_ROUNDS];     /*< FO subkey KOi,2 */
+    uint16_t    ko3[KASUMI_ROUNDS];     /*< FO subkey KOi,3 */
+    uint16_t    ki1[KASUMI_ROUNDS];     /*< FI subkey KIi,1 */
+    uint16_t    ki2[KASUMI_ROUNDS];     /*< FI subkey KIi,2 */
+    uint16_t    ki3[KASUMI_ROUNDS];     /*< FI subkey KIi,3 */
+}kasumi_key_sched_t;
+
+/** State of one lane of the multi-buffer KASUMI f8 kernel */
+typedef struct f8_lane_s
+{
+    sec_sw_kasumi_f8_job_t  *job;           /*< Job currently processed on this lane. NULL if lane is idle. */
+    const uint8_t           *key;           /*< Key the subkeys were derived from */
+    kasumi_key_sched_t      ks;             /*< Subkeys for CK */
+    kasumi_key_sched_t      ks_mod;         /*< Subkeys for CK xor KM, used only for the IV */
+    uint32_t                a[2];           /*< A = KASUMI[CK xor KM](IV) */
+    uint32_t                ksb[2];         /*< Last keystream block */
+    uint32_t                block_cnt;      /*< Index of the next keystream block */
+    uint32_t                offset;         /*< Offset in the PDU of the next byte to be ciphered */
+}f8_lane_t;
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+/** KASUMI S7 substitution box */
+static const uint16_t kasumi_s7[128] = {
+     54, 50, 62, 56, 22, 34, 94, 96, 38,  6, 63, 93,  2, 18,123, 33,
+     55,113, 39,114, 21, 67, 65, 12, 47, 73, 46, 27, 25,111,124, 81,
+     53,  9,121, 79, 52, 60, 58, 48,101,127, 40,120,104, 70, 71, 43,
+     20,122, 72, 61, 23,109, 13,100, 77,  1, 16,  7, 82, 10,105, 98,
+    117,116, 76, 11, 89,106,  0,125,118, 99, 86, 69, 30, 57,126, 87,
+    112, 51, 17,  5, 95, 14, 90, 84, 91,  8, 35,103, 32, 97, 28, 66,
+    102, 31, 26, 45, 75,  4, 85, 92, 37, 74, 80, 49, 68, 29,115, 44,
+     64,107,108, 24,110, 83, 36, 78, 42, 19, 15, 41, 88,119, 59,  3};
+/** KASUMI S9 substitution box */
+static const uint16_t kasumi_s9[512] = {
+    167,239,161,379,391,334,  9,338, 38,226, 48,358,452,385, 90,397,
+    183,253,147,331,415,340, 51,362,306,500,262, 82,216,159,356,177,
+    175,241,489, 37,206, 17,  0,333, 44,254,378, 58,143,220, 81,400,
+     95,  3,315,245, 54,235,218,405,472,264,172,494,371,290,399, 76,
+    165,197,395,121,257,480,423,212,240, 28,462,176,406,507,288,223,
+    501,407,249,265, 89,186,221,428,164, 74,440,196,458,421,350,163,
+    232,158,134,354, 13,250,491,142,191, 69,193,425,152,227,366,135,
+    344,300,276,242,437,320,113,278, 11,243, 87,317, 36, 93,496, 27,
+    487,446,482, 41, 68,156,457,131,326,403,339, 20, 39,115,442,124,
+    475,384,508, 53,112,170,479,151,126,169, 73,268,279,321,168,364,
+    363,292, 46,499,393,327,324, 24,456,267,157,460,488,426,309,229,
+    439,506,208,271,349,401,434,236, 16,209,359, 52, 56,120,199,277,
+    465,416,252,287,246,  6, 83,305,420,345,153,502, 65, 61,244,282,
+    173,222,418, 67,386,368,261,101,476,291,195,430, 49, 79,166,330,
+    280,383,373,128,382,408,155,495,367,388,274,107,459,417, 62,454,
+    132,225,203,316,234, 14,301, 91,503,286,424,211,347,307,140,374,
+     35,103,125,427, 19,214,453,146,498,314,444,230,256,329,198,285,
+     50,116, 78,410, 10,205,510,171,231, 45,139,467, 29, 86,505, 32,
+     72, 26,342,150,313,490,431,238,411,325,149,473, 40,119,174,355,
+    185,233,389, 71,448,273,372, 55,110,178,322, 12,469,392,369,190,
+      1,109,375,137,181, 88, 75,308,260,484, 98,272,370,275,412,111,
+    336,318,  4,504,492,259,304, 77,337,435, 21,357,303,332,483, 18,
+     47, 85, 25,497,474,289,100,269,296,478,270,106, 31,104,433, 84,
+    414,486,394, 96, 99,154,511,148,413,361,409,255,162,215,302,201,
+    266,351,343,144,441,365,108,298,251, 34,182,509,138,210,335,133,
+    311,352,328,141,396,346,123,319,450,281,429,228,443,481, 92,404,
+    485,422,248,297, 23,213,130,466, 22,217,283, 70,294,360,419,127,
+    312,377,  7,468,194,  2,117,295,463,258,224,447,247,187, 80,398,
+    284,353,105,390,299,471,470,184, 57,200,348, 63,204,188, 33,451,
+     97, 30,310,219, 94,160,129,493, 64,179,263,102,189,207,114,402,
+    438,477,387,122,192, 42,381,  5,145,118,180,449,293,323,136,380,
+     43, 66, 60,455,341,445,202,432,  8,237, 15,376,436,464, 59,461};
+/** Constants used by the KASUMI key schedule for deriving K'j */
+static const uint16_t kasumi_c[KASUMI_ROUNDS] = {
+    0x0123, 0x4567, 0x89AB, 0xCDEF, 0xFEDC, 0xBA98, 0x7654, 0x3210
+};
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+/** @brief Derives the KASUMI subkeys from a 128 bit key.
+ *
+ * @param [in]  key         128 bit key.
+ * @param [in]  modifier    Byte xor-ed into each byte of the key before deriving the subkeys.
+ * @param [out] ks          The subkeys.
+ */
+static void kasumi_key_schedule(const uint8_t *key, uint8_t modifier, kasumi_key_sched_t *ks);
+
+/** @brief KASUMI FI function.
+ *
+ * @param [in] in       16 bit input.
+ * @param [in] subkey   16 bit KIi,j subkey.
+ *
+ * @retval 16 bit output
+ */
+static inline uint16_t kasumi_fi(uint16_t in, uint16_t subkey);
+
+/** @brief KASUMI FO function for round r.
+ *
+ * @param [in] in       32 bit input.
+ * @param [in] ks       The subkeys.
+ * @param [in] r        Index of the round, from 0.
+ *
+ * @retval 32 bit output
+ */
+static inline uint32_t kasumi_fo(uint32_t in, const kasumi_key_sched_t *ks, int r);
+
+/** @brief KASUMI FL function for round r.
+ *
+ * @param [in] in       32 bit input.
+ * @param [in] ks       The subkeys.
+ * @param [in] r        Index of the round, from 0.
+ *
+ * @retval 32 bit output
+ */
+static inline uint32_t kasumi_fl(uint32_t in, const kasumi_key_sched_t *ks, int r);
+
+/** @brief Encrypts one 64 bit block on each of the given lanes.
+ *
+ * The rounds of all lanes are interleaved, the same way sec_sw_aes128_encrypt_lanes() does.
+ *
+ * @param [in]     ks       Array of lanes_no pointers to subkeys.
+ * @param [in,out] blocks   Array of lanes_no blocks, stored as two 32 bit words
+ *                          (most significant first). Encrypted in place.
+ * @param [in]     lanes_no Number of lanes. Must not exceed #SEC_SW_CRYPTO_LANES.
+ */
+static void kasumi_encrypt_lanes(const kasumi_key_sched_t * const *ks,
+                                 uint32_t (*blocks)[2],
+                                 uint32_t lanes_no);
+
+/** @brief Starts processing a new job on a lane: derives the subkeys if needed and computes A.
+ *
+ * @param [in,out] lane     The lane.
+ * @param [in]     job      The job.
+ */
+static void f8_lane_load_job(f8_lane_t *lane, sec_sw_kasumi_f8_job_t *job);
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+static void kasumi_key_schedule(const uint8_t *key, uint8_t modifier, kasumi_key_sched_t *ks)
+{
+    uint16_t k[KASUMI_ROUNDS];
+    uint16_t kp[KASUMI_ROUNDS];
+    int n;
+
+    for (n = 0; n < KASUMI_ROUNDS; n++)
+    {
+        k[n] = (uint16_t)(((key[2 * n] ^ modifier) << 8) | (key[2 * n + 1] ^ modifier));
+        kp[n] = k[n] ^ kasumi_c[n];
+    }
+
+    for (n = 0; n < KASUMI_ROUNDS; n++)
+    {
+        ks->kl1[n] = ROL16(k[n], 1);
+        ks->kl2[n] = kp[(n + 2) & 7];
+        ks->ko1[n] = ROL16(k[(n + 1) & 7], 5);
+        ks->ko2[n] = ROL16(k[(n + 5) & 7], 8);
+        ks->ko3[n] = ROL16(k[(n + 6) & 7], 13);
+        ks->ki1[n] = kp[(n + 4) & 7];
+        ks->ki2[n] = kp[(n + 3) & 7];
+        ks->ki3[n] = kp[(n + 7) & 7];
+    }
+}
+
+static inline uint16_t kasumi_fi(uint16_t in, uint16_t subkey)
+{
+    uint16_t nine = in >> 7;
+    uint16_t seven = in & 0x7F;
+
+    nine = kasumi_s9[nine] ^ seven;
+    seven = kasumi_s7[seven] ^ (nine & 0x7F);
+
+    seven ^= subkey >> 9;
+    nine ^= subkey & 0x1FF;
+
+    nine = kasumi_s9[nine] ^ seven;
+    seven = kasumi_s7[seven] ^ (nine & 0x7F);
+
+    return (uint16_t)((seven << 9) | nine);
+}
+
+static inline uint32_t kasumi_fo(uint32_t in, const kasumi_key_sched_t *ks, int r)
+{
+    uint16_t left = (uint16_t)(in >> 16);
+    uint16_t right = (uint16_t)in;
+
+    left = kasumi_fi(left ^ ks->ko1[r], ks->ki1[r]) ^ right;
+    right = kasumi_fi(right ^ ks->ko2[r], ks->ki2[r]) ^ left;
+    left = kasumi_fi(left ^ ks->ko3[r], ks->ki3[r]) ^ right;
+
+    return ((uint32_t)right << 16) | left;
+}
+
+static inline uint32_t kasumi_fl(uint32_t in, const kasumi_key_sched_t *ks, int r)
+{
+    uint16_t left = (uint16_t)(in >> 16);
+    uint16_t right = (uint16_t)in;
+    uint16_t t;
+
+    t = left & ks->kl1[r];
+    right ^= ROL16(t, 1);
+    t = right | ks->kl2[r];
+    left ^= ROL16(t, 1);
+
+    return ((uint32_t)left << 16) | right;
+}
+
+static void kasumi_encrypt_lanes(const kasumi_key_sched_t * const *ks,
+                                 uint32_t (*blocks)[2],
+                                 uint32_t lanes_no)
+{
+    uint32_t l;
+    int r;
+
+    ASSERT(lanes_no <= SEC_SW_CRYPTO_LANES);
+
+    for (r = 0; r < KASUMI_ROUNDS; r += 2)
+    {
+        // Odd rounds: FL then FO, applied on the left half
+        for (l = 0; l < lanes_no; l++)
+        {
+            blocks[l][1] ^= kasumi_fo(kasumi_fl(blocks[l][0], ks[l], r), ks[l], r);
+        }
+        // Even rounds: FO then FL, applied on the right half
+        for (l = 0; l < lanes_no; l++)
+        {
+            blocks[l][0] ^= kasumi_fl(kasumi_fo(blocks[l][1], ks[l], r + 1), ks[l], r + 1);
+        }
+    }
+}
+
+static void f8_lane_load_job(f8_lane_t *lane, sec_sw_kasumi_f8_job_t *job)
+{
+    const kasumi_key_sched_t *ks_mod = &lane->ks_mod;
+    uint32_t a[1][2];
+
+    // Consecutive PDUs of the same RLC context share the key, do not
+    // derive the subkeys again.
+    if (lane->key != job->key)
+    {
+        kasumi_key_schedule(job->key, 0, &lane->ks);
+        kasumi_key_schedule(job->key, KASUMI_F8_KEY_MODIFIER, &lane->ks_mod);
+        lane->key = job->key;
+    }
+
+    // IV = COUNT || BEARER || DIRECTION || 0^26
+    a[0][0] = job->count;
+    a[0][1] = ((uint32_t)(job->bearer & 0x1F) << 27) | ((uint32_t)(job->direction & 0x01) << 26);
+    kasumi_encrypt_lanes(&ks_mod, a, 1);
+
+    lane->a[0] = a[0][0];
+    lane->a[1] = a[0][1];
+    lane->ksb[0] = 0;
+    lane->ksb[1] = 0;
+    lane->block_cnt = 0;
+    lane->offset = 0;
+    lane->job = job;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+sec_return_code_t sec_sw_kasumi_f8_batch(sec_sw_kasumi_f8_job_t *jobs, uint32_t jobs_no)
+{
+    f8_lane_t lanes[SEC_SW_CRYPTO_LANES];
+    const kasumi_key_sched_t *ks[SEC_SW_CRYPTO_LANES];
+    uint32_t blocks[SEC_SW_CRYPTO_LANES][2];
+    f8_lane_t *active[SEC_SW_CRYPTO_LANES];
+    uint32_t next_job = 0;
+    uint32_t active_no;
+    uint32_t i;
+
+    SEC_ASSERT(jobs != NULL || jobs_no == 0, SEC_INVALID_INPUT_PARAM, "jobs is NULL");
+#ifdef DEBUG
+    for (i = 0; i < jobs_no; i++)
+    {
+        SEC_ASSERT(jobs[i].key != NULL, SEC_INVALID_INPUT_PARAM, "key is NULL for job %d", i);
+        SEC_ASSERT((jobs[i].in != NULL && jobs[i].out != NULL) || jobs[i].length == 0,
+                   SEC_INVALID_INPUT_PARAM, "in or out is NULL for job %d", i);
+    }
+#endif
+
+    for (i = 0; i < SEC_SW_CRYPTO_LANES; i++)
+    {
+        lanes[i].job = NULL;
+        lanes[i].key = NULL;
+    }
+
+    do
+    {
+        // Refill the idle lanes and prepare the input of the next keystream block:
+        // KSB(n) = KASUMI[CK](A xor BLKCNT xor KSB(n-1))
+        active_no = 0;
+        for (i = 0; i < SEC_SW_CRYPTO_LANES; i++)
+        {
+            f8_lane_t *lane = &lanes[i];
+
+            while (lane->job == NULL && next_job < jobs_no)
+            {
+                f8_lane_load_job(lane, &jobs[next_job++]);
+                if (lane->job->length == 0)
+                {
+                    lane->job = NULL;
+                }
+            }
+            if (lane->job == NULL)
+            {
+                continue;
+            }
+
+            blocks[active_no][0] = lane->a[0] ^ lane->ksb[0];
+            blocks[active_no][1] = lane->a[1] ^ lane->ksb[1] ^ lane->block_cnt;
+            ks[active_no] = &lane->ks;
+            active[active_no] = lane;
+            active_no++;
+        }
+
+        if (active_no == 0)
+        {
+            break;
+        }
+
+        kasumi_encrypt_lanes(ks, blocks, active_no);
+
+        for (i = 0; i < active_no; i++)
+        {
+            f8_lane_t *lane = active[i];
+            sec_sw_kasumi_f8_job_t *job = lane->job;
+            uint8_t ksb[KASUMI_BLOCK_SIZE];
+            uint32_t bytes = job->length - lane->offset;
+            uint32_t j;
+
+            lane->ksb[0] = blocks[i][0];
+            lane->ksb[1] = blocks[i][1];
+            SEC_SW_PUT_U32_BE(ksb, blocks[i][0]);
+            SEC_SW_PUT_U32_BE(ksb + 4, blocks[i][1]);
+
+            if (bytes > KASUMI_BLOCK_SIZE)
+            {
+                bytes = KASUMI_BLOCK_SIZE;
+            }
+            for (j = 0; j < bytes; j++)
+            {
+                job->out[lane->offset + j] = job->in[lane->offset + j] ^ ksb[j];
+            }
+
+            lane->offset += bytes;
+            lane->block_cnt++;
+            if (lane->offset == job->length)
+            {
+                lane->job = NULL;
+            }
+        }
+    }while(1);
+
+    return SEC_SUCCESS;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,160 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "fsl_sec.h"
+#include "sec_sw_crypto.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+/** @brief Generates 128-EEA2 (AES-CTR) keystream, a whole number of 16 byte blocks.
+ *
+ * @param [in]  rk          Expanded AES key.
+ * @param [in]  count       The COUNT value.
+ * @param [in]  iv          Second word of the counter block: BEARER || DIRECTION || 0..0
+ * @param [out] ks          Keystream buffer of blocks_no * 16 bytes.
+ * @param [in]  blocks_no   Number of keystream blocks to generate.
+ */
+static void pdcp_keystream_aes(const uint32_t *rk,
+                               uint32_t count,
+                               uint32_t iv,
+                               uint8_t *ks,
+                               uint32_t blocks_no);
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+static void pdcp_keystream_aes(const uint32_t *rk,
+                               uint32_t count,
+                               uint32_t iv,
+                               uint8_t *ks,
+                               uint32_t blocks_no)
+{
+    const uint32_t *lanes_rk[SEC_SW_CRYPTO_LANES];
+    uint8_t *blocks[SEC_SW_CRYPTO_LANES];
+    uint32_t lanes_no;
+    uint32_t b;
+    uint32_t l;
+
+    // Counter block i is COUNT || BEARER || DIRECTION || 0..0 || i
+    for (b = 0; b < blocks_no; b++)
+    {
+        uint8_t *block = ks + b * SEC_SW_AES_BLOCK_SIZE;
+
+        SEC_SW_PUT_U32_BE(block, count);
+        SEC_SW_PUT_U32_BE(block + 4, iv);
+        SEC_SW_PUT_U32_BE(block + 8, 0);
+        SEC_SW_PUT_U32_BE(block + 12, b);
+    }
+
+    // The counter blocks are independent: encrypt them in place, SEC_SW_CRYPTO_LANES at a time
+    for (b = 0; b < blocks_no; b += lanes_no)
+    {
+        lanes_no = blocks_no - b;
+        if (lanes_no > SEC_SW_CRYPTO_LANES)
+        {
+            lanes_no = SEC_SW_CRYPTO_LANES;
+        }
+
+        for (l = 0; l < lanes_no; l++)
+        {
+            lanes_rk[l] = rk;
+            blocks[l] = ks + (b + l) * SEC_SW_AES_BLOCK_SIZE;
+        }
+        sec_sw_aes128_encrypt_lanes(lanes_rk, blocks, lanes_no);
+    }
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+void sec_sw_pdcp_keystream(uint8_t cipher_algorithm,
+                           const uint8_t *key,
+                           const uint32_t *aes_rk,
+                           uint32_t count,
+                           uint8_t bearer,
+                           uint8_t direction,
+                           uint8_t *ks,
+                           uint32_t length)
+{
+    uint32_t iv = ((uint32_t)bearer << 27) | ((uint32_t)(direction & 0x1) << 26);
+
+    ASSERT(cipher_algorithm == SEC_ALG_SNOW || cipher_algorithm == SEC_ALG_AES);
+
+    if (cipher_algorithm == SEC_ALG_SNOW)
+    {
+        sec_sw_snow3g_keystream_lanes(key, &count, bearer, direction, &ks, length, 1);
+    }
+    else
+    {
+        pdcp_keystream_aes(aes_rk, count, iv, ks,
+                           (length + SEC_SW_AES_BLOCK_SIZE - 1) / SEC_SW_AES_BLOCK_SIZE);
+    }
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,183 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <errno.h>
+#include "fsl_sec.h"
+#include "fsl_sec_time.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+/* Frequency of the counter, in ticks per second. 0 until found by sec_time_get_frequency(). */
+static volatile uint64_t g_time_frequency = 0;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+static uint64_t time_calibrate(void)
+{
+    struct timespec start_ts, end_ts, delay;
+    uint64_t start, end, ns;
+
+    delay.tv_sec = 0;
+    delay.tv_nsec = SEC_TIME_CALIBRATION_MS * 1000000;
+
+    // CLOCK_MONOTONIC_RAW is not slewed by NTP while it is compared with the counter
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_ts);
+    start = sec_time_read_start();
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR);
+    end = sec_time_read_end();
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_ts);
+
+    ns = (uint64_t)(end_ts.tv_sec - start_ts.tv_sec) * SEC_TIME_NS_PER_SECOND +
+         end_ts.tv_nsec - start_ts.tv_nsec;
+    if (ns == 0)
+    {
+        return 0;
+    }
+
+    return ((end - start) * SEC_TIME_NS_PER_SECOND) / ns;
+}
+
+#if defined(__powerpc__)
+static uint64_t time_read_timebase_frequency(void)
+{
+    unsigned long long timebase = 0;
+    char line[128];
+    FILE *cpuinfo;
+
+    // The time base frequency is reported by the kernel as "timebase : <Hz>"
+    cpuinfo = fopen("/proc/cpuinfo", "r");
+    if (cpuinfo == NULL)
+    {
+        return 0;
+    }
+    while (fgets(line, sizeof(line), cpuinfo) != NULL)
+    {
+        if (sscanf(line, "timebase : %llu", &timebase) == 1)
+        {
+            break;
+        }
+    }
+    fclose(cpuinfo);
+
+    return timebase;
+}
+#endif
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+uint64_t sec_time_get_frequency(void)
+{
+    uint64_t frequency = g_time_frequency;
+
+    if (likely(frequency != 0))
+    {
+        return frequency;
+    }
+
+    // Threads calling this concurrently the first time find the same frequency,
+    // so whichever stores it last does no harm
+#if defined(__x86_64__) || defined(__i386__)
+    frequency = time_calibrate();
+#elif defined(__aarch64__)
+    asm volatile("mrs %0, cntfrq_el0" : "=r" (frequency));
+#elif defined(__powerpc__)
+    frequency = time_read_timebase_frequency();
+#else
+    frequency = SEC_TIME_NS_PER_SECOND;
+#endif
+
+    // Some firmware does not publish the frequency
+    if (frequency == 0)
+    {
+        frequency = time_calibrate();
+    }
+    if (frequency == 0)
+    {
+        SEC_ERROR("Failed to find the frequency of the %s counter, assuming 1 GHz", SEC_TIME_SOURCE);
+        frequency = SEC_TIME_NS_PER_SECOND;
+    }
+    SEC_INFO("The %s counter runs at %llu Hz", SEC_TIME_SOURCE, (unsigned long long)frequency);
+
+    g_time_frequency = frequency;
+
+    return frequency;
+}
+
+uint64_t sec_time_ticks_to_ns(uint64_t ticks)
+{
+    uint64_t frequency = sec_time_get_frequency();
+
+    // Whole seconds first, so that the multiplication does not overflow
+    return (ticks / frequency) * SEC_TIME_NS_PER_SECOND +
+           ((ticks % frequency) * SEC_TIME_NS_PER_SECOND) / frequency;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
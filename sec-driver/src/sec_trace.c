@@ -0,0 +1,291 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "fsl_sec.h"
+#include "sec_trace.h"
+#include "sec_utils.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+#if (SEC_ENABLE_TRACE == ON)
+/** The trace buffer of a thread. Written only by the thread, read by sec_trace_dump(). */
+typedef struct sec_trace_buffer_s
+{
+    /** Next buffer in the list of all the buffers */
+    struct sec_trace_buffer_s *next;
+    /** Kernel id of the thread */
+    uint32_t thread_id;
+    /** Events recorded since the buffer was allocated or cleared. The last
+     *  #SEC_TRACE_BUFFER_SIZE of them are kept. */
+    uint64_t events_no;
+    /** The events, in a ring */
+    sec_trace_event_t events[SEC_TRACE_BUFFER_SIZE];
+}sec_trace_buffer_t;
+#endif // (SEC_ENABLE_TRACE == ON)
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+#if (SEC_ENABLE_TRACE == ON)
+/* The trace buffers of all the threads that recorded events */
+static sec_trace_buffer_t *g_trace_buffers = NULL;
+/* Protects the list of trace buffers */
+static pthread_mutex_t g_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+/* The trace buffer of the calling thread */
+static __thread sec_trace_buffer_t *t_trace_buffer = NULL;
+/* Set if the trace buffer of the calling thread could not be allocated */
+static __thread uint32_t t_trace_no_buffer = FALSE;
+
+/* Clock of the timestamps and its frequency. A frequency of 0 stands for
+ * the frequency of the default clock, found when the trace is dumped. */
+static sec_trace_clock_t g_trace_clock = sec_time_read;
+static uint64_t g_trace_ticks_per_second = 0;
+#endif // (SEC_ENABLE_TRACE == ON)
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+volatile uint32_t g_sec_trace_enabled = FALSE;
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+#if (SEC_ENABLE_TRACE == ON)
+static sec_trace_buffer_t* trace_alloc_buffer(void)
+{
+    sec_trace_buffer_t *buffer;
+
+    buffer = malloc(sizeof(sec_trace_buffer_t));
+    if (buffer == NULL)
+    {
+        SEC_ERROR("Failed to allocate the trace buffer of the thread");
+        t_trace_no_buffer = TRUE;
+        return NULL;
+    }
+
+    buffer->thread_id = (uint32_t)syscall(SYS_gettid);
+    buffer->events_no = 0;
+
+    pthread_mutex_lock(&g_trace_lock);
+    buffer->next = g_trace_buffers;
+    g_trace_buffers = buffer;
+    pthread_mutex_unlock(&g_trace_lock);
+
+    t_trace_buffer = buffer;
+
+    return buffer;
+}
+#endif // (SEC_ENABLE_TRACE == ON)
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+void sec_trace_record(uint16_t type, uint16_t jr_id, uint32_t arg)
+{
+#if (SEC_ENABLE_TRACE == ON)
+    sec_trace_buffer_t *buffer = t_trace_buffer;
+    sec_trace_event_t *event;
+
+    if (unlikely(buffer == NULL))
+    {
+        if (t_trace_no_buffer == TRUE || (buffer = trace_alloc_buffer()) == NULL)
+        {
+            return;
+        }
+    }
+
+    event = &buffer->events[buffer->events_no & (SEC_TRACE_BUFFER_SIZE - 1)];
+    event->timestamp = g_trace_clock();
+    event->type = type;
+    event->jr_id = jr_id;
+    event->arg = arg;
+    buffer->events_no++;
+#endif // (SEC_ENABLE_TRACE == ON)
+}
+
+sec_return_code_t sec_trace_enable(uint32_t enable)
+{
+#if (SEC_ENABLE_TRACE == ON)
+    g_sec_trace_enabled = (enable != FALSE) ? TRUE : FALSE;
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Event trace is not enabled");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_TRACE == ON)
+}
+
+sec_return_code_t sec_trace_set_clock(sec_trace_clock_t clock, uint64_t ticks_per_second)
+{
+#if (SEC_ENABLE_TRACE == ON)
+    if (clock == NULL)
+    {
+        g_trace_clock = sec_time_read;
+        g_trace_ticks_per_second = 0;
+        return SEC_SUCCESS;
+    }
+
+    SEC_ASSERT(ticks_per_second != 0, SEC_INVALID_INPUT_PARAM, "ticks_per_second is 0");
+
+    g_trace_clock = clock;
+    g_trace_ticks_per_second = ticks_per_second;
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Event trace is not enabled");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_TRACE == ON)
+}
+
+void sec_trace_clear(void)
+{
+#if (SEC_ENABLE_TRACE == ON)
+    sec_trace_buffer_t *buffer;
+
+    pthread_mutex_lock(&g_trace_lock);
+    for (buffer = g_trace_buffers; buffer != NULL; buffer = buffer->next)
+    {
+        buffer->events_no = 0;
+    }
+    pthread_mutex_unlock(&g_trace_lock);
+#endif // (SEC_ENABLE_TRACE == ON)
+}
+
+sec_return_code_t sec_trace_dump(const char *file_name)
+{
+#if (SEC_ENABLE_TRACE == ON)
+    sec_trace_file_header_t file_header;
+    sec_trace_thread_header_t thread_header;
+    sec_trace_buffer_t *buffer;
+    uint32_t first;
+    size_t written = 0;
+    size_t expected = 0;
+    FILE *file;
+
+    SEC_ASSERT(file_name != NULL, SEC_INVALID_INPUT_PARAM, "file_name is NULL");
+
+    file = fopen(file_name, "wb");
+    if (file == NULL)
+    {
+        SEC_ERROR("Cannot open %s", file_name);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    pthread_mutex_lock(&g_trace_lock);
+
+    memset(&file_header, 0, sizeof(file_header));
+    file_header.magic = SEC_TRACE_FILE_MAGIC;
+    file_header.version = SEC_TRACE_FILE_VERSION;
+    file_header.ticks_per_second = (g_trace_ticks_per_second != 0) ?
+                                   g_trace_ticks_per_second : sec_time_get_frequency();
+    for (buffer = g_trace_buffers; buffer != NULL; buffer = buffer->next)
+    {
+        file_header.threads_no++;
+    }
+    written += fwrite(&file_header, sizeof(file_header), 1, file);
+    expected++;
+
+    for (buffer = g_trace_buffers; buffer != NULL; buffer = buffer->next)
+    {
+        thread_header.thread_id = buffer->thread_id;
+        thread_header.events_no = (buffer->events_no < SEC_TRACE_BUFFER_SIZE) ?
+                                  (uint32_t)buffer->events_no : SEC_TRACE_BUFFER_SIZE;
+        thread_header.lost_no = buffer->events_no - thread_header.events_no;
+        written += fwrite(&thread_header, sizeof(thread_header), 1, file);
+        expected++;
+
+        // Oldest event first: from the position of the next event to the end of
+        // the ring, then from its start
+        first = (uint32_t)(buffer->events_no - thread_header.events_no) & (SEC_TRACE_BUFFER_SIZE - 1);
+        if (first + thread_header.events_no > SEC_TRACE_BUFFER_SIZE)
+        {
+            written += fwrite(&buffer->events[first], sizeof(sec_trace_event_t),
+                              SEC_TRACE_BUFFER_SIZE - first, file);
+            written += fwrite(&buffer->events[0], sizeof(sec_trace_event_t),
+                              first + thread_header.events_no - SEC_TRACE_BUFFER_SIZE, file);
+        }
+        else
+        {
+            written += fwrite(&buffer->events[first], sizeof(sec_trace_event_t),
+                              thread_header.events_no, file);
+        }
+        expected += thread_header.events_no;
+    }
+
+    pthread_mutex_unlock(&g_trace_lock);
+
+    if (fclose(file) != 0 || written != expected)
+    {
+        SEC_ERROR("Failed to write %s", file_name);
+        return SEC_INVALID_INPUT_PARAM;
+    }
+
+    return SEC_SUCCESS;
+#else
+    SEC_ERROR("Event trace is not enabled");
+    return SEC_INVALID_INPUT_PARAM;
+#endif // (SEC_ENABLE_TRACE == ON)
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,113 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SEC_TRACE_H
+#define SEC_TRACE_H
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+
+extern "C"{
+/* *INDENT-ON* */
+#endif
+
+/*==============================================================================
+                                INCLUDE FILES
+==============================================================================*/
+#include <stdint.h>
+#include "fsl_sec.h"
+#include "sec_utils.h"
+
+/*==============================================================================
+                              DEFINES AND MACROS
+==============================================================================*/
+#if (SEC_TRACE_BUFFER_SIZE & (SEC_TRACE_BUFFER_SIZE - 1)) != 0
+#error "SEC_TRACE_BUFFER_SIZE must be a power of 2"
+#endif
+
+#if (SEC_ENABLE_TRACE == ON)
+/** Record an event of the binary trace, if recording is switched on.
+ *  The arguments are evaluated only then. */
+#define SEC_TRACE(type, jr_id, arg) \
+    do { \
+        if (unlikely(g_sec_trace_enabled)) \
+        { \
+            sec_trace_record((type), (jr_id), (arg)); \
+        } \
+    } while(0)
+#else
+#define SEC_TRACE(type, jr_id, arg)
+#endif // (SEC_ENABLE_TRACE == ON)
+
+/*==============================================================================
+                                    ENUMS
+==============================================================================*/
+
+/*==============================================================================
+                         STRUCTURES AND OTHER TYPEDEFS
+==============================================================================*/
+
+/*==============================================================================
+                                 CONSTANTS
+==============================================================================*/
+
+/*==============================================================================
+                         GLOBAL VARIABLE DECLARATIONS
+==============================================================================*/
+/** #TRUE while events are recorded, see sec_trace_enable() */
+extern volatile uint32_t g_sec_trace_enabled;
+
+/*==============================================================================
+                            FUNCTION PROTOTYPES
+==============================================================================*/
+
+/** @brief Records an event in the trace buffer of the calling thread.
+ *
+ * The buffer is allocated when the thread records its first event. If the
+ * allocation fails, the events of the thread are not recorded.
+ *
+ * @param [in] type     One of ::sec_trace_event_type_t.
+ * @param [in] jr_id    Id of the Job Ring.
+ * @param [in] arg      Depends on the type of the event.
+ */
+void sec_trace_record(uint16_t type, uint16_t jr_id, uint32_t arg);
+
+/*============================================================================*/
+
+#ifdef __cplusplus
+/* *INDENT-OFF* */
+}
+/* *INDENT-ON* */
+#endif
+
+#endif  /* SEC_TRACE_H */
@@ -48,6 +48,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <time.h>
+#include "fsl_sec_time.h"
 
 /*==============================================================================
                               DEFINES AND MACROS
@@ -259,6 +261,19 @@
                             FUNCTION PROTOTYPES
 ==============================================================================*/
 
+/** @brief Reads a free running time base, used by the driver to measure latencies.
+ * Only the difference between two readings is meaningful. This is the low half of
+ * the counter of sec_time_read(), serialized if #SEC_TIME_SERIALIZE is ON.
+ */
+static inline uint32_t sec_get_timebase(void)
+{
+#if (SEC_TIME_SERIALIZE == ON)
+    return (uint32_t)sec_time_read_start();
+#else
+    return (uint32_t)sec_time_read();
+#endif
+}
+
 /*============================================================================*/
 
 
@@ -32,16 +32,13 @@
 #ifndef __TEST_COMMON__
 #define __TEST_COMMON__
 
-/* Alternate Time Base */
-#define SPR_ATBL	526
-#define SPR_ATBU	527
+#include <stdint.h>
+#include "fsl_sec_time.h"
 
-#define mfspr(reg) \
-({ \
-	register_t ret; \
-	asm volatile("mfspr %0, %1" : "=r" (ret) : "i" (reg) : "memory"); \
-	ret; \
-})
+/* Low half of the counter of SEC driver, for cycle counts and latencies.
+ * See SEC_TIME_SOURCE for the counter and sec_time_ticks_to_ns(). */
+#define GET_TICKS() \
+	((uint32_t)sec_time_read())
 
 #define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
 
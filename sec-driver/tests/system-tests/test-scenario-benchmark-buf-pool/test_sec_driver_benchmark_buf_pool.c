@@ -0,0 +1,429 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*==================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <malloc.h> // memalign...
+
+// SEC user space driver related
+#include "fsl_sec.h"
+
+#include "test_sec_driver_benchmark_buf_pool.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+// Options set by the user
+#define THREADS_SET         0x00000001
+#define BURST_SET           0x00000002
+#define DATA_ROOM_SET       0x00000004
+#define NUM_ITER_SET        0x00000008
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+// Allocator under test
+typedef enum allocator_e
+{
+    ALLOCATOR_BUF_POOL = 0,
+    ALLOCATOR_MEMALIGN
+}allocator_t;
+
+// Per thread data
+typedef struct thread_data_s
+{
+    pthread_t thread;
+    allocator_t allocator;
+    uint64_t total_ns;
+    int error;
+}thread_data_t;
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static users_params_t user_param;
+
+static thread_data_t threads[MAX_THREADS_NUMBER];
+
+static sec_buf_pool_t *buf_pool = NULL;
+
+// Released by the main thread once all the threads were created
+static pthread_barrier_t start_barrier;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+static int validate_params(void);
+static void print_usage(char *prg_name);
+static uint64_t get_time_ns(void);
+static dma_addr_t test_vtop(void *v);
+static void* buf_pool_thread_routine(void *arg);
+static void* memalign_thread_routine(void *arg);
+static int run_threads(allocator_t allocator);
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+/* Nanoseconds from the counter of SEC driver, so that the results of the
+ * different platforms are comparable */
+static uint64_t get_time_ns(void)
+{
+    return sec_time_ticks_to_ns(sec_time_read());
+}
+
+static dma_addr_t test_vtop(void *v)
+{
+    // The memory area comes from memalign(), pretend it is mapped 1:1
+    return (dma_addr_t)(uintptr_t)v;
+}
+
+static void* buf_pool_thread_routine(void *arg)
+{
+    thread_data_t *td = (thread_data_t*)arg;
+    sec_packet_t packets[MAX_BURST_SIZE];
+    uint8_t *data = NULL;
+    uint64_t start_ns;
+    sec_return_code_t ret_code;
+    int i, j;
+
+    pthread_barrier_wait(&start_barrier);
+
+    start_ns = get_time_ns();
+    for (i = 0; i < user_param.num_iter; i++)
+    {
+        ret_code = sec_buf_pool_alloc_bulk(buf_pool, packets, user_param.burst_size);
+        if (ret_code != SEC_SUCCESS)
+        {
+            fprintf(stderr,"sec_buf_pool_alloc_bulk returned error %d on iteration %d\n", ret_code, i);
+            td->error = 1;
+            break;
+        }
+        for (j = 0; j < user_param.burst_size; j++)
+        {
+            data = sec_buf_pool_ptov(buf_pool, packets[j].address + packets[j].offset);
+            *data = (uint8_t)i;
+        }
+        sec_buf_pool_free_bulk(buf_pool, packets, user_param.burst_size);
+    }
+    td->total_ns = get_time_ns() - start_ns;
+
+    sec_buf_pool_flush_cache(buf_pool);
+    test_printf("thread done\n");
+
+    return NULL;
+}
+
+static void* memalign_thread_routine(void *arg)
+{
+    thread_data_t *td = (thread_data_t*)arg;
+    sec_packet_t packets[MAX_BURST_SIZE];
+    uint8_t *bufs[MAX_BURST_SIZE];
+    uint32_t buf_size = BUF_HEADROOM + user_param.data_room + BUF_TAILROOM;
+    uint64_t start_ns;
+    int i, j;
+
+    pthread_barrier_wait(&start_barrier);
+
+    start_ns = get_time_ns();
+    for (i = 0; i < user_param.num_iter; i++)
+    {
+        for (j = 0; j < user_param.burst_size; j++)
+        {
+            bufs[j] = memalign(L1_CACHE_BYTES, buf_size);
+            if (bufs[j] == NULL)
+            {
+                fprintf(stderr,"memalign failed on iteration %d\n", i);
+                td->error = 1;
+                return NULL;
+            }
+            packets[j].address = test_vtop(bufs[j]);
+            packets[j].offset = BUF_HEADROOM;
+            packets[j].tail_offset = BUF_HEADROOM + user_param.data_room;
+            packets[j].length = 0;
+            bufs[j][packets[j].offset] = (uint8_t)i;
+        }
+        for (j = 0; j < user_param.burst_size; j++)
+        {
+            free(bufs[j]);
+        }
+    }
+    td->total_ns = get_time_ns() - start_ns;
+    test_printf("thread done\n");
+
+    return NULL;
+}
+
+static int run_threads(allocator_t allocator)
+{
+    uint64_t total_ns = 0;
+    uint64_t total_bufs;
+    int i;
+
+    pthread_barrier_init(&start_barrier, NULL, user_param.threads_no + 1);
+
+    for (i = 0; i < user_param.threads_no; i++)
+    {
+        threads[i].allocator = allocator;
+        threads[i].total_ns = 0;
+        threads[i].error = 0;
+        if (pthread_create(&threads[i].thread, NULL,
+                           allocator == ALLOCATOR_BUF_POOL ? buf_pool_thread_routine : memalign_thread_routine,
+                           &threads[i]) != 0)
+        {
+            fprintf(stderr,"pthread_create failed for thread %d\n", i);
+            return 1;
+        }
+    }
+    pthread_barrier_wait(&start_barrier);
+
+    for (i = 0; i < user_param.threads_no; i++)
+    {
+        pthread_join(threads[i].thread, NULL);
+        if (threads[i].error)
+        {
+            return 1;
+        }
+        total_ns += threads[i].total_ns;
+    }
+    pthread_barrier_destroy(&start_barrier);
+
+    // total_ns is the sum of the time spent by all the threads, which run in parallel
+    total_bufs = (uint64_t)user_param.num_iter * user_param.burst_size * user_param.threads_no;
+    printf("%s:\n", allocator == ALLOCATOR_BUF_POOL ? "sec_buf_pool" : "memalign/free");
+    printf("    Avg. time per buffer = %llu ns\n", (unsigned long long)(total_ns / total_bufs));
+    printf("    Buffers per second = %.0f\n",
+           total_ns ? ((double)total_bufs * user_param.threads_no * 1e9) / total_ns : 0.0);
+
+    return 0;
+}
+
+static int validate_params(void)
+{
+    if( !(user_param.opt_mask & THREADS_SET) )
+    {
+        user_param.threads_no = DEFAULT_THREADS_NUMBER;
+    }
+    if( user_param.threads_no == 0 || user_param.threads_no > MAX_THREADS_NUMBER )
+    {
+        fprintf(stderr,"Number of threads must be between 1 and %d\n", MAX_THREADS_NUMBER);
+        return 1;
+    }
+
+    if( !(user_param.opt_mask & BURST_SET) )
+    {
+        user_param.burst_size = DEFAULT_BURST_SIZE;
+    }
+    if( user_param.burst_size == 0 || user_param.burst_size > MAX_BURST_SIZE )
+    {
+        fprintf(stderr,"Burst size must be between 1 and %d\n", MAX_BURST_SIZE);
+        return 1;
+    }
+
+    if( !(user_param.opt_mask & DATA_ROOM_SET) )
+    {
+        user_param.data_room = DEFAULT_DATA_ROOM;
+    }
+    if( user_param.data_room == 0 || user_param.data_room > MAX_DATA_ROOM )
+    {
+        fprintf(stderr,"Data room must be between 1 and %d\n", MAX_DATA_ROOM);
+        return 1;
+    }
+
+    if( !(user_param.opt_mask & NUM_ITER_SET) )
+    {
+        user_param.num_iter = DEFAULT_NUM_ITER;
+    }
+    if( user_param.num_iter == 0 )
+    {
+        fprintf(stderr,"Number of iterations must be greater than 0\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static void print_usage(char *prg_name)
+{
+    printf("Usage: %s"
+           " [-t threads]"
+           " [-b burst_size]"
+           " [-s data_room]"
+           " [-n iterations]"
+           "\n"
+           "\n\n\t-t Number of threads. Default %d."
+           "\n\n\t-b Number of buffers allocated and freed in one call. Default %d."
+           "\n\n\t-s Data room of a buffer. Default %d."
+           "\n\n\t-n Number of iterations run by each thread. Default %d."
+           "\n\n\n",prg_name, DEFAULT_THREADS_NUMBER, DEFAULT_BURST_SIZE,
+           DEFAULT_DATA_ROOM, DEFAULT_NUM_ITER);
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+int main(int argc, char ** argv)
+{
+    sec_buf_pool_config_t pool_config;
+    sec_return_code_t ret_code;
+    uint32_t buf_size;
+    void *memory_area;
+    int ret = 0;
+    int c;
+
+    /* Make sure the user options are cleared */
+    memset(&user_param, 0x00, sizeof(users_params_t));
+
+    while ((c = getopt (argc, argv, "t:b:s:n:h")) != -1)
+    {
+        switch (c)
+        {
+            case 't':
+                user_param.threads_no = atoi(optarg);
+                printf("Number of threads %d\n",user_param.threads_no);
+                user_param.opt_mask |= THREADS_SET;
+                break;
+            case 'b':
+                user_param.burst_size = atoi(optarg);
+                printf("Burst size %d\n",user_param.burst_size);
+                user_param.opt_mask |= BURST_SET;
+                break;
+            case 's':
+                user_param.data_room = atoi(optarg);
+                printf("Data room %d\n",user_param.data_room);
+                user_param.opt_mask |= DATA_ROOM_SET;
+                break;
+            case 'n':
+                user_param.num_iter = atoi(optarg);
+                printf("Number of iterations: %s\n", optarg);
+                user_param.opt_mask |= NUM_ITER_SET;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            case '?':
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if( validate_params() )
+    {
+        fprintf(stderr,"Error in options!\n");
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Find the frequency of the counter before measuring, it may take a calibration
+    sec_time_get_frequency();
+
+    // Enough buffers for every thread to hold one burst and fill its cache
+    buf_size = (BUF_HEADROOM + user_param.data_room + BUF_TAILROOM + L1_CACHE_BYTES - 1) & ~(L1_CACHE_BYTES - 1);
+    pool_config.memory_area_size = buf_size * user_param.threads_no *
+                                   (user_param.burst_size + SEC_BUF_POOL_CACHE_SIZE);
+    memory_area = memalign(L1_CACHE_BYTES, pool_config.memory_area_size);
+    if (memory_area == NULL)
+    {
+        fprintf(stderr,"Cannot allocate %u bytes for the buffer pool\n", pool_config.memory_area_size);
+        return 1;
+    }
+
+    pool_config.memory_area = memory_area;
+    pool_config.headroom = BUF_HEADROOM;
+    pool_config.data_room = user_param.data_room;
+    pool_config.tailroom = BUF_TAILROOM;
+    pool_config.vtop = test_vtop;
+
+    ret_code = sec_buf_pool_create(&pool_config, &buf_pool);
+    if (ret_code != SEC_SUCCESS)
+    {
+        fprintf(stderr,"sec_buf_pool_create returned error %d\n", ret_code);
+        free(memory_area);
+        return 1;
+    }
+
+    ret = run_threads(ALLOCATOR_BUF_POOL);
+    if (ret == 0)
+    {
+        ret = run_threads(ALLOCATOR_MEMALIGN);
+    }
+
+    if (ret == 0 && sec_buf_pool_get_free_no(buf_pool) != pool_config.memory_area_size / buf_size)
+    {
+        fprintf(stderr,"%u buffers are missing from the pool\n",
+                pool_config.memory_area_size / buf_size - sec_buf_pool_get_free_no(buf_pool));
+        ret = 1;
+    }
+
+    sec_buf_pool_destroy(buf_pool);
+    free(memory_area);
+
+    if (ret != 0)
+    {
+        printf("test_sec_driver_benchmark_buf_pool: FAILED\n");
+        return 1;
+    }
+
+    printf("test_sec_driver_benchmark_buf_pool: PASSED\n");
+    return 0;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
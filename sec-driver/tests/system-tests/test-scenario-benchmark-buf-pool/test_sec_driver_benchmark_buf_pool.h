@@ -1,4 +1,4 @@
-/* Copyright (c) 2012 Freescale Semiconductor, Inc.
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -30,8 +30,8 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef TEST_BENCHMARK_SINGLE_THREADS
-#define TEST_BENCHMARK_SINGLE_THREADS
+#ifndef TEST_BENCHMARK_BUF_POOL_H
+#define TEST_BENCHMARK_BUF_POOL_H
 
 /*==============================================================================
                                 INCLUDE FILES
@@ -40,23 +40,28 @@
 /*==============================================================================
                               DEFINES AND MACROS
 ==============================================================================*/
-#ifdef USDPAA
-/* The size of the DMA-able memory zone to be allocated through the test */
-#define DMAMEM_SIZE	0x4000000
-#endif
 /******************************************************************************/
 // START OF CONFIGURATION SECTION
 /******************************************************************************/
 
-//////////////////////////////////////////////////////////////////////////////
-// Number of PDCP contexts options
-//////////////////////////////////////////////////////////////////////////////
+// Maximum number of threads
+#define MAX_THREADS_NUMBER          16
+
+// Maximum number of buffers allocated and freed in one call
+#define MAX_BURST_SIZE              256
+
+// Maximum data room of a buffer
+#define MAX_DATA_ROOM               9600
 
-// The number of PDCP contexts used. Each DRB will have 2 PDCP contexts, one for each direction.
-// This is the number of PDCP context on one direction:DL/UL.
-// The total number of PDCP contexts used is PDCP_CONTEXT_NUMBER * 2.
-#define PDCP_CONTEXT_NUMBER         (UE_NUMBER * DRB_PER_UE)
-//#define PDCP_CONTEXT_NUMBER         1
+// Headroom and tailroom of the buffers
+#define BUF_HEADROOM                128
+#define BUF_TAILROOM                32
+
+// Default values, used when the corresponding option is not given
+#define DEFAULT_THREADS_NUMBER      1
+#define DEFAULT_BURST_SIZE          32
+#define DEFAULT_DATA_ROOM           1600
+#define DEFAULT_NUM_ITER            100000
 
 //////////////////////////////////////////////////////////////////////////////
 // Logging Options
@@ -64,20 +69,14 @@
 
 // Disable test application logging
 #define test_printf(format, ...)
-// Disable test application logging for clock cycle measurements
-#define profile_printf(format, ...)
 
 // Enable test application logging
 // #define test_printf(format, ...) printf("%s(): " format "\n", __FUNCTION__,  ##__VA_ARGS__)
-// Enable test application logging for clock cycle measurements
-//#define profile_printf(format, ...) printf("%s(): " format "\n", __FUNCTION__,  ##__VA_ARGS__)
-
 
 /******************************************************************************/
 // END OF CONFIGURATION SECTION
 /******************************************************************************/
 
-
 /*==============================================================================
                                     ENUMS
 ==============================================================================*/
@@ -86,13 +85,9 @@
                          STRUCTURES AND OTHER TYPEDEFS
 ==============================================================================*/
 typedef struct user_params_s{
-    char int_alg[PATH_MAX];
-    char enc_alg[PATH_MAX];
-    char direction[PATH_MAX];
-    char hdr_len[PATH_MAX];
-    char test_type[PATH_MAX];
-    uint8_t max_frags;
-    uint16_t payload_size;
+    uint32_t threads_no;
+    uint32_t burst_size;
+    uint32_t data_room;
     uint32_t num_iter;
     uint32_t opt_mask;
 }users_params_t;
@@ -111,4 +106,4 @@ typedef struct user_params_s{
 /*============================================================================*/
 
 
-#endif  /* TEST_BENCHMARK_SINGLE_THREADS */
+#endif  /* TEST_BENCHMARK_BUF_POOL_H */
@@ -0,0 +1,383 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*==================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+
+// SEC user space driver related
+#include "fsl_sec.h"
+
+#include "test_sec_driver_benchmark_sw.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+// Options set by the user
+#define ENC_ALG_SET         0x00000001
+#define MODE_SET            0x00000002
+#define PAYLOAD_SET         0x00000004
+#define BATCH_SET           0x00000008
+#define CTX_SET             0x00000010
+#define NUM_ITER_SET        0x00000020
+
+// Mandatory options
+#define BMASK_SEC_SW_BENCHMARK  (ENC_ALG_SET | MODE_SET | PAYLOAD_SET)
+
+// Size of a RLC ciphering key
+#define TEST_KEY_LEN        16
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+// RLC context as seen by the benchmark: only what the software kernel needs
+typedef struct rlc_context_s
+{
+    uint8_t key[TEST_KEY_LEN];
+    uint32_t hfn;
+    uint16_t sn;
+    uint8_t bearer;
+    uint8_t direction;
+}rlc_context_t;
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static users_params_t user_param;
+
+static rlc_context_t rlc_contexts[MAX_CONTEXT_NUMBER];
+static sec_sw_kasumi_f8_job_t jobs[MAX_BATCH_SIZE];
+static uint8_t packets[MAX_BATCH_SIZE][MAX_PAYLOAD_SIZE];
+
+// SN size in bits for the selected RLC mode
+static uint8_t sn_size;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+static int validate_params(void);
+static void print_usage(char *prg_name);
+static void setup_contexts(void);
+static void prepare_batch(void);
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+static void setup_contexts(void)
+{
+    int i, j;
+
+    for (i = 0; i < user_param.ctx_no; i++)
+    {
+        for (j = 0; j < TEST_KEY_LEN; j++)
+        {
+            rlc_contexts[i].key[j] = (uint8_t)rand();
+        }
+        rlc_contexts[i].hfn = (uint32_t)rand() & ((1 << (32 - sn_size)) - 1);
+        rlc_contexts[i].sn = 0;
+        rlc_contexts[i].bearer = (uint8_t)(i & 0x1F);
+        rlc_contexts[i].direction = (uint8_t)(i & 0x01);
+    }
+
+    for (i = 0; i < MAX_BATCH_SIZE; i++)
+    {
+        for (j = 0; j < MAX_PAYLOAD_SIZE; j++)
+        {
+            packets[i][j] = (uint8_t)rand();
+        }
+    }
+}
+
+static void prepare_batch(void)
+{
+    int i;
+
+    // Consecutive PDUs belong to the same context, the way they are
+    // usually dequeued from a bearer.
+    for (i = 0; i < user_param.batch_size; i++)
+    {
+        rlc_context_t *ctx = &rlc_contexts[(i * user_param.ctx_no) / user_param.batch_size];
+
+        jobs[i].key = ctx->key;
+        jobs[i].in = packets[i];
+        jobs[i].out = packets[i];
+        jobs[i].length = user_param.payload_size;
+        jobs[i].count = (ctx->hfn << sn_size) | ctx->sn;
+        jobs[i].bearer = ctx->bearer;
+        jobs[i].direction = ctx->direction;
+
+        ctx->sn = (ctx->sn + 1) & ((1 << sn_size) - 1);
+        if (ctx->sn == 0)
+        {
+            ctx->hfn = (ctx->hfn + 1) & ((1 << (32 - sn_size)) - 1);
+        }
+    }
+}
+
+static int validate_params(void)
+{
+    if( (user_param.opt_mask & BMASK_SEC_SW_BENCHMARK) != BMASK_SEC_SW_BENCHMARK)
+    {
+        fprintf(stderr,"Missing mandatory option\n");
+        return 1;
+    }
+
+    if( strcmp(user_param.enc_alg,"KASUMI") != 0 )
+    {
+        fprintf(stderr,"Invalid encryption algorithm selected: %s\n",user_param.enc_alg);
+        return 1;
+    }
+
+    if( strcmp(user_param.mode,"UM") == 0 || strcmp(user_param.mode,"UNACKED") == 0 )
+    {
+        sn_size = RLC_UNACKED_MODE;
+    }
+    else if( strcmp(user_param.mode,"AM") == 0 || strcmp(user_param.mode,"ACKED") == 0 )
+    {
+        sn_size = RLC_ACKED_MODE;
+    }
+    else
+    {
+        fprintf(stderr,"Invalid RLC mode selected: %s\n",user_param.mode);
+        return 1;
+    }
+
+    if( user_param.payload_size == 0 || user_param.payload_size > MAX_PAYLOAD_SIZE )
+    {
+        fprintf(stderr,"Payload size must be between 1 and %d\n", MAX_PAYLOAD_SIZE);
+        return 1;
+    }
+
+    if( !(user_param.opt_mask & BATCH_SET) )
+    {
+        user_param.batch_size = DEFAULT_BATCH_SIZE;
+    }
+    if( user_param.batch_size == 0 || user_param.batch_size > MAX_BATCH_SIZE )
+    {
+        fprintf(stderr,"Batch size must be between 1 and %d\n", MAX_BATCH_SIZE);
+        return 1;
+    }
+
+    if( !(user_param.opt_mask & CTX_SET) )
+    {
+        user_param.ctx_no = DEFAULT_CONTEXT_NUMBER;
+    }
+    if( user_param.ctx_no == 0 || user_param.ctx_no > MAX_CONTEXT_NUMBER )
+    {
+        fprintf(stderr,"Number of contexts must be between 1 and %d\n", MAX_CONTEXT_NUMBER);
+        return 1;
+    }
+    if( user_param.ctx_no > user_param.batch_size )
+    {
+        user_param.ctx_no = user_param.batch_size;
+    }
+
+    if( !(user_param.opt_mask & NUM_ITER_SET) )
+    {
+        user_param.num_iter = DEFAULT_NUM_ITER;
+    }
+    if( user_param.num_iter == 0 )
+    {
+        fprintf(stderr,"Number of iterations must be greater than 0\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static void print_usage(char *prg_name)
+{
+    printf("Usage: %s"
+           " -e encryption_alg"
+           " -m rlc_mode"
+           " -s payload_size"
+           " [-b batch_size]"
+           " [-c contexts]"
+           " [-n iterations]"
+           "\n"
+           "\n\n\t-e Select the encryption algorithm to be used."
+           "\n\t\tValid values are:"
+           "\n\t\t\to KASUMI"
+           "\n\n\t-m Selects the RLC mode."
+           "\n\t\tValid values:"
+           "\n\t\t\to UM or UNACKED - SN is 7 bits"
+           "\n\t\t\to AM or ACKED - SN is 12 bits"
+           "\n\n\t-s Select the payload size of the packets."
+           "\n\t\tNOTE: It does NOT include the header size."
+           "\n\n\t-b Number of PDUs submitted in one call. Default %d."
+           "\n\n\t-c Number of RLC contexts the PDUs of a call are spread over. Default %d."
+           "\n\n\t-n Number of iterations to be run. Default %d."
+           "\n\n\n",prg_name, DEFAULT_BATCH_SIZE, DEFAULT_CONTEXT_NUMBER, DEFAULT_NUM_ITER);
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+int main(int argc, char ** argv)
+{
+    sec_return_code_t ret_code;
+    uint64_t start_ticks;
+    uint64_t total_ticks = 0;
+    uint64_t total_ns;
+    uint64_t total_packets;
+    int c;
+    int i;
+    cpu_set_t cpu_mask; /* processor 0 */
+
+    /* bind process to processor 0 */
+    CPU_ZERO(&cpu_mask);
+    CPU_SET(0, &cpu_mask);
+    if(sched_setaffinity(0, sizeof(cpu_mask), &cpu_mask) < 0)
+    {
+        perror("sched_setaffinity");
+    }
+
+    /* Make sure the user options are cleared */
+    memset(&user_param, 0x00, sizeof(users_params_t));
+
+    while ((c = getopt (argc, argv, "e:m:s:b:c:n:h")) != -1)
+    {
+        switch (c)
+        {
+            case 'e':
+                strncpy(user_param.enc_alg, optarg, sizeof(user_param.enc_alg) - 1);
+                printf("Selected encryption algorithm: %s\n",optarg);
+                user_param.opt_mask |= ENC_ALG_SET;
+                break;
+            case 'm':
+                strncpy(user_param.mode, optarg, sizeof(user_param.mode) - 1);
+                printf("Selected RLC mode: %s\n",optarg);
+                user_param.opt_mask |= MODE_SET;
+                break;
+            case 's':
+                user_param.payload_size = atoi(optarg);
+                printf("Payload size %d\n",user_param.payload_size);
+                user_param.opt_mask |= PAYLOAD_SET;
+                break;
+            case 'b':
+                user_param.batch_size = atoi(optarg);
+                printf("Batch size %d\n",user_param.batch_size);
+                user_param.opt_mask |= BATCH_SET;
+                break;
+            case 'c':
+                user_param.ctx_no = atoi(optarg);
+                printf("Number of contexts %d\n",user_param.ctx_no);
+                user_param.opt_mask |= CTX_SET;
+                break;
+            case 'n':
+                user_param.num_iter = atoi(optarg);
+                printf("Number of iterations: %s\n", optarg);
+                user_param.opt_mask |= NUM_ITER_SET;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            case '?':
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if( validate_params() )
+    {
+        fprintf(stderr,"Error in options!\n");
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Find the frequency of the counter before measuring, it may take a calibration
+    sec_time_get_frequency();
+
+    srand(0);
+    setup_contexts();
+
+    for (i = 0; i < user_param.num_iter; i++)
+    {
+        // Building the batch is the caller's job, it is not part of the measurement
+        prepare_batch();
+
+        start_ticks = sec_time_read_start();
+        ret_code = sec_sw_kasumi_f8_batch(jobs, user_param.batch_size);
+        total_ticks += sec_time_read_end() - start_ticks;
+
+        if (ret_code != SEC_SUCCESS)
+        {
+            fprintf(stderr,"sec_sw_kasumi_f8_batch returned error %d on iteration %d\n", ret_code, i);
+            return 1;
+        }
+        test_printf("iteration %d done\n", i);
+    }
+
+    total_packets = (uint64_t)user_param.num_iter * user_param.batch_size;
+    total_ns = sec_time_ticks_to_ns(total_ticks);
+    printf("Software lanes = %d\n", SEC_SW_CRYPTO_LANES);
+    printf("Total packets = %llu\n", (unsigned long long)total_packets);
+    printf("Avg. time per batch = %llu ns\n", (unsigned long long)(total_ns / user_param.num_iter));
+    printf("Avg. time per packet = %llu ns\n", (unsigned long long)(total_ns / total_packets));
+    printf("Avg. %s ticks per packet = %llu\n", SEC_TIME_SOURCE,
+           (unsigned long long)(total_ticks / total_packets));
+    printf("Throughput = %llu Mbps\n",
+           (unsigned long long)(total_ns ? (total_packets * user_param.payload_size * 8 * 1000) / total_ns : 0));
+
+    printf("test_sec_driver_benchmark_sw: PASSED\n");
+    return 0;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,4 @@
-/* Copyright (c) 2012 Freescale Semiconductor, Inc.
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -30,8 +30,8 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef TEST_BACK_TO_BACK
-#define TEST_BACK_TO_BACK
+#ifndef TEST_BENCHMARK_SW_H
+#define TEST_BENCHMARK_SW_H
 
 /*==============================================================================
                                 INCLUDE FILES
@@ -40,23 +40,23 @@
 /*==============================================================================
                               DEFINES AND MACROS
 ==============================================================================*/
-#ifdef USDPAA
-/* The size of the DMA-able memory zone to be allocated through the test */
-#define DMAMEM_SIZE	0x4000000
-#endif
 /******************************************************************************/
 // START OF CONFIGURATION SECTION
 /******************************************************************************/
 
-//////////////////////////////////////////////////////////////////////////////
-// Number of PDCP contexts options
-//////////////////////////////////////////////////////////////////////////////
+// Maximum number of RLC contexts the PDUs of a batch are spread over
+#define MAX_CONTEXT_NUMBER          64
+
+// Maximum number of PDUs submitted in one call
+#define MAX_BATCH_SIZE              1024
 
-// The number of PDCP contexts used. Each DRB will have 2 PDCP contexts, one for each direction.
-// This is the number of PDCP context on one direction:DL/UL.
-// The total number of PDCP contexts used is PDCP_CONTEXT_NUMBER * 2.
-#define PDCP_CONTEXT_NUMBER         (UE_NUMBER * DRB_PER_UE)
-//#define PDCP_CONTEXT_NUMBER         1
+// Maximum payload size of a PDU
+#define MAX_PAYLOAD_SIZE            1600
+
+// Default values, used when the corresponding option is not given
+#define DEFAULT_CONTEXT_NUMBER      16
+#define DEFAULT_BATCH_SIZE          64
+#define DEFAULT_NUM_ITER            10000
 
 //////////////////////////////////////////////////////////////////////////////
 // Logging Options
@@ -64,20 +64,14 @@
 
 // Disable test application logging
 #define test_printf(format, ...)
-// Disable test application logging for clock cycle measurements
-#define profile_printf(format, ...)
 
 // Enable test application logging
 // #define test_printf(format, ...) printf("%s(): " format "\n", __FUNCTION__,  ##__VA_ARGS__)
-// Enable test application logging for clock cycle measurements
-// #define profile_printf(format, ...) printf("%s(): " format "\n", __FUNCTION__,  ##__VA_ARGS__)
-
 
 /******************************************************************************/
 // END OF CONFIGURATION SECTION
 /******************************************************************************/
 
-
 /*==============================================================================
                                     ENUMS
 ==============================================================================*/
@@ -86,13 +80,11 @@
                          STRUCTURES AND OTHER TYPEDEFS
 ==============================================================================*/
 typedef struct user_params_s{
-    char int_alg[PATH_MAX];
     char enc_alg[PATH_MAX];
-    char direction[PATH_MAX];
-    char hdr_len[PATH_MAX];
-    char test_type[PATH_MAX];
-    uint8_t max_frags;
+    char mode[PATH_MAX];
     uint16_t payload_size;
+    uint32_t batch_size;
+    uint32_t ctx_no;
     uint32_t num_iter;
     uint32_t opt_mask;
 }users_params_t;
@@ -111,4 +103,4 @@ typedef struct user_params_s{
 /*============================================================================*/
 
 
-#endif  /* TEST_BACK_TO_BACK */
+#endif  /* TEST_BENCHMARK_SW_H */
@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+# Runs test_sec_driver_benchmark for a range of context counts and packet sizes
+# and appends the JSON results to the file given as first argument.
+# The other arguments are passed to every run, e.g.:
+#     ./run_benchmarks.sh results.json -T 2 -j 2 -m burst
+#
+# CONTEXTS, SIZES, CHURN and LOAD can be overridden from the environment. CHURN is
+# a list of context churn rates (-c), 0 for no context churn. LOAD is a list of
+# offered rates in packets per second (-R), 0 for closed loop.
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 results.json [benchmark options]"
+    exit 1
+fi
+
+RESULTS=$1
+shift
+
+BENCHMARK=${BENCHMARK:-./test_sec_driver_benchmark}
+CONTEXTS=${CONTEXTS:-"2 16 64 256 1024"}
+SIZES=${SIZES:-"64 512 1000 1400 40:7,576:4,1400:1"}
+CHURN=${CHURN:-"0"}
+LOAD=${LOAD:-"0"}
+
+for ctx in $CONTEXTS; do
+    for size in $SIZES; do
+        for churn in $CHURN; do
+            for load in $LOAD; do
+                echo "contexts $ctx, sizes $size, churn $churn, load $load"
+                $BENCHMARK "$@" -C $ctx -s $size -c $churn -R $load -o "$RESULTS" > /dev/null || exit 1
+            done
+        done
+    done
+done
@@ -0,0 +1,2666 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <signal.h>
+#include <linux/limits.h>
+#include <malloc.h>
+#include <math.h>
+
+#include "fsl_sec.h"
+#ifdef USDPAA
+#include <usdpaa/dma_mem.h>
+#include <flib/protoshared.h>
+#else
+// For shared memory allocator
+#include "fsl_usmmgr.h"
+#endif
+// Common methods across tests
+#include "common.h"
+
+#include "test_sec_driver_benchmark.h"
+
+/*==================================================================================================
+                                     LOCAL CONSTANTS
+==================================================================================================*/
+
+// The size of a PDCP buffer, headroom included.
+// The input and output buffers provided to SEC driver have the same size.
+#define PDCP_BUFFER_SIZE   1600
+
+#define IRQ_COALESCING_COUNT    10
+#define IRQ_COALESCING_TIMER    100
+
+#define JOB_RING_POLL_UNLIMITED -1
+
+// How long a worker thread waits for the IRQ of a job ring, in IRQ and NAPI modes
+#define IRQ_WAIT_US             1000
+
+// Alignment in bytes for input/output packets allocated from DMA-memory zone
+#define BUFFER_ALIGNEMENT L1_CACHE_BYTES
+
+/* Maximium length, in bytes, for a confidentiality /integrity key */
+#define MAX_KEY_LENGTH    16
+
+/* Value used for conversion seconds->microseconds */
+#define MEGA              1000000
+
+// Headroom of the packets. Must be at least 8, for statistics reasons
+#define TEST_OFFSET 8
+
+/** Length of the MAC_I */
+#define ICV_LEN 4
+
+/** Maximum number of latency samples kept per thread and iteration, for percentiles */
+#define LATENCY_SAMPLES_NO  (64 * 1024)
+
+// Defaults of the command line options
+#define DEFAULT_THREADS_NO      1
+#define DEFAULT_JOB_RINGS_NO    2
+#define DEFAULT_CONTEXTS_NO     16
+#define DEFAULT_QUEUE_DEPTH     4
+#define DEFAULT_PACKETS_NO      100000
+#define DEFAULT_BURST_SIZE      32
+#define DEFAULT_PAYLOAD_SIZE    1000
+#define DEFAULT_CHURN_THREADS_NO 1
+#define DEFAULT_ARRIVAL_BURST   8
+
+// Contexts kept alive per job ring by a control thread. Each operation deletes the
+// oldest of them and creates a new one in its place.
+#define CHURN_CONTEXTS_PER_JOB_RING 4
+
+/* Value used for conversion seconds->nanoseconds */
+#define GIGA              1000000000
+
+// For keeping the code relatively the same between HW versions
+#define dma_mem_memalign    test_memalign
+#define dma_mem_free        test_free
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+/* Forward declarations */
+struct bench_context_s;
+struct bench_thread_s;
+
+/* A packet slot of a context. The slots of a context are used round robin,
+ * since SEC driver notifies the packets of a context in order. */
+typedef struct bench_packet_s
+{
+    sec_packet_t *in_packet;        /**< Input packet, with its fragments */
+    sec_packet_t *out_packet;       /**< Output packet, with its fragments */
+    struct bench_context_s *ctx;    /**< Context to which this packet belongs */
+    uint32_t payload_size;          /**< Payload size, without PDCP header and MAC-I */
+    uint32_t size_idx;              /**< Index of the payload size in the size distribution */
+    uint32_t submit_ticks;          /**< Timestamp taken when the packet was submitted */
+    uint32_t in_use;                /**< The packet was sent and is not yet notified */
+}bench_packet_t;
+
+typedef struct bench_context_s
+{
+    sec_context_handle_t sec_ctx;           /**< Handle of the SEC driver context */
+    sec_pdcp_context_info_t cfg;            /**< Configuration of the context */
+    uint32_t job_ring;                      /**< Index of the job ring of the context */
+    struct bench_thread_s *thread;          /**< Thread producing and consuming on the job ring */
+    bench_packet_t *packets;                /**< Packet slots, queue depth of them */
+    uint8_t *buffers;                       /**< DMA memory of the input and output buffers */
+    uint32_t next_packet;                   /**< Next packet slot to send */
+    uint32_t next_count;                    /**< Keystream cache: COUNT of the next packet sent */
+}bench_context_t;
+
+/* A worker thread. Each thread is the producer and the consumer of its job rings:
+ * job ring j is served by thread j % threads_no. */
+typedef struct bench_thread_s
+{
+    pthread_t thread;
+    uint32_t tid;
+    uint32_t job_rings[MAX_SEC_JOB_RINGS];  /**< Job rings served by the thread */
+    uint32_t job_rings_no;
+    uint32_t irq_wait[MAX_SEC_JOB_RINGS];   /**< NAPI mode: wait for the IRQ before the next poll */
+    bench_context_t **contexts;             /**< Contexts of the job rings of the thread */
+    uint32_t contexts_no;
+    uint32_t next_ctx;                      /**< Next context to send packets on */
+    uint32_t ctx_sent;                      /**< Packets sent on next_ctx since it was selected */
+    sec_burst_packet_t burst[MAX_SUBMIT_BURST]; /**< Burst mode: packets not yet submitted */
+    uint32_t burst_no;
+    /** Context of the last packet submitted on each job ring, to count the context switches */
+    sec_context_handle_t last_sec_ctx[MAX_SEC_JOB_RINGS];
+    uint32_t linearize;                     /**< -x: this iteration linearizes the fragmented packets */
+
+    // Results of the current iteration
+    uint32_t packets_to_send;
+    uint32_t packets_sent;
+    uint32_t packets_received;
+    uint64_t bytes_received;
+    uint32_t errors;
+    uint64_t submit_ticks;
+    uint64_t poll_ticks;
+    uint64_t latency_sum;
+    uint32_t latency_max;
+    uint32_t latency_no;
+    uint32_t *latency_samples;
+    uint64_t queue_ticks;                   /**< Open loop: time from arrival to submission */
+    uint32_t ctx_switches;                  /**< Packets submitted with another context than the previous one */
+    uint32_t mismatches;                    /**< -V: packets whose output is not the expected one */
+    struct timespec start_time;
+    struct timespec end_time;
+
+    // Open loop arrivals
+    uint64_t next_arrival;                  /**< Arrival time of the next packet, in ticks of sec_time_read() */
+    uint32_t burst_arrivals;                /**< Packets of the current burst already arrived */
+    unsigned int seed;                      /**< Seed of the inter-arrival times */
+}__attribute__((aligned(L1_CACHE_BYTES))) bench_thread_t;
+
+/* A control thread, creating and deleting contexts on its job rings at the churn rate
+ * while the worker threads send packets. Control thread k owns the job rings j with
+ * j % churn threads == k, since the contexts of a job ring are kept by SEC driver in a
+ * pool that must be used by a single thread. */
+typedef struct bench_churn_thread_s
+{
+    pthread_t thread;
+    uint32_t tid;
+    uint32_t job_rings[MAX_SEC_JOB_RINGS];  /**< Job rings on which the thread creates contexts */
+    uint32_t job_rings_no;
+    sec_pdcp_context_info_t cfg;            /**< Configuration of all the contexts of the thread */
+    /** Contexts alive. Slot i is on job ring job_rings[i % job_rings_no]. */
+    sec_context_handle_t contexts[MAX_SEC_JOB_RINGS * CHURN_CONTEXTS_PER_JOB_RING];
+    uint32_t next_slot;                     /**< Slot of the next context to replace */
+
+    // Results of the current iteration
+    uint32_t created;
+    uint32_t deleted;
+    uint32_t failures;                      /**< Contexts that could not be created */
+    uint64_t create_ticks;
+    uint64_t delete_ticks;
+    uint32_t create_max;
+    uint32_t delete_max;
+    struct timespec start_time;
+    struct timespec end_time;
+}__attribute__((aligned(L1_CACHE_BYTES))) bench_churn_thread_t;
+
+/* Results of an iteration, for all the threads */
+typedef struct bench_results_s
+{
+    uint32_t iteration;
+    uint64_t time_us;
+    uint32_t packets_sent;
+    uint32_t packets_received;
+    uint64_t bytes_received;
+    uint32_t errors;
+    uint32_t pps;
+    uint32_t mbps;
+    uint32_t submit_ticks_per_packet;
+    uint32_t poll_ticks_per_packet;
+    uint32_t cpu_load;
+    uint32_t latency_avg;
+    uint32_t latency_p50;
+    uint32_t latency_p90;
+    uint32_t latency_p99;
+    uint32_t latency_p999;
+    uint32_t latency_max;
+    uint64_t queue_ns_avg;          /**< Open loop: time from arrival to submission */
+    uint32_t ctx_switches;          /**< Packets submitted on a job ring with another context than the previous one */
+    uint32_t mismatches;            /**< -V: packets whose output is not the expected one */
+    uint32_t linearized;            /**< -x: the fragmented packets were linearized by SEC driver */
+    uint32_t contexts_created;      /**< Contexts created by the control threads */
+    uint32_t contexts_deleted;      /**< Contexts deleted by the control threads */
+    uint32_t churn_failures;        /**< Contexts the control threads could not create */
+    uint32_t churn_rate;            /**< Contexts created per second, for all the control threads */
+    uint32_t create_ticks_avg;
+    uint32_t create_ticks_max;
+    uint32_t delete_ticks_avg;
+    uint32_t delete_ticks_max;
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    uint64_t jr_full;           /**< Packets rejected by SEC driver because a job ring was full */
+    uint64_t empty_polls;       /**< Polls of a job ring that returned no packet */
+    uint64_t irq_enables;       /**< IRQ re-enables done by SEC driver */
+    uint64_t polls;             /**< Polls of a job ring */
+    uint64_t packets_polled;    /**< Packets notified by the polls */
+    uint64_t callback_ticks;    /**< Time spent in the callbacks, if SEC_ENABLE_CALLBACK_TIMING is ON */
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+}bench_results_t;
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+// configuration data for SEC driver
+static sec_config_t sec_config_data;
+
+// job ring handles provided by SEC driver
+static const sec_job_ring_descriptor_t *job_ring_descriptors = NULL;
+
+#ifndef USDPAA
+fsl_usmmgr_t g_usmmgr;
+#endif
+
+/* Parameters given by the user and copied when parsing the cmd. line */
+static users_params_t user_param;
+
+static const char *mode_names[] = {"poll", "burst", "irq", "napi"};
+static const char *arrival_names[] = {"poisson", "constant", "bursty"};
+
+static uint32_t test_cipher_algorithm = -1;
+static uint32_t test_integrity_algorithm = -1;
+static uint32_t test_user_plane = -1;
+static uint32_t test_sn_size = -1;
+static uint32_t test_direction = -1;
+static uint32_t test_pdcp_hdr_len = -1;
+static uint32_t test_icv_len;
+
+/* Contexts doing encapsulation and decapsulation. Both are used alternately. */
+static uint8_t test_encap;
+static uint8_t test_decap;
+
+/* Keys, in DMA memory, shared by all contexts */
+static uint8_t *test_crypto_key;
+static uint8_t *test_auth_key;
+
+static uint8_t test_bearer;
+static uint32_t test_hfn;
+static uint32_t test_hfn_threshold;
+
+static uint32_t test_num_frags;
+static uint32_t test_num_iter;
+static bench_mode_t test_mode;
+static uint32_t test_threads_no;
+static uint32_t test_job_rings_no;
+static uint32_t test_contexts_no;
+static uint32_t test_queue_depth;
+static uint32_t test_packets_no;
+static uint32_t test_burst_size;
+static uint32_t test_ctx_run;
+static uint32_t test_serialize_ticks;
+static uint32_t test_churn_rate;
+static uint32_t test_churn_threads_no;
+
+/* -x: odd iterations use SG tables, even iterations let SEC driver linearize the packets */
+static uint32_t test_sg_crossover;
+
+/* -K: COUNT values for which keystream is generated after each packet sent on an
+ * encapsulation context. 0 disables the keystream cache. */
+static uint32_t test_ks_cache_budget;
+
+/* -D: provide a P2V function to SEC driver, which lets it process packets on the CPU */
+static uint32_t test_cpu_dispatch;
+
+/* -V: check the output of each packet */
+static uint32_t test_verify;
+
+/* Open loop: packets per second offered by all the threads, 0 in closed loop */
+static uint32_t test_offered_rate;
+static bench_arrival_t test_arrival;
+static uint32_t test_arrival_burst;
+/* Mean time between two arrivals on a thread, in ticks of sec_time_read() */
+static double test_arrival_gap;
+
+/* Packet size distribution */
+static packet_size_t test_sizes[MAX_PACKET_SIZES];
+static uint32_t test_sizes_no;
+static uint32_t test_sizes_weight;
+
+/* Plaintext random data, input of encapsulation. */
+static uint8_t test_data_encap[PDCP_BUFFER_SIZE];
+
+/* Encapsulated data, input of decapsulation. One for each payload size, generated
+ * by SEC from test_data_encap before the benchmark starts. */
+static uint8_t test_data_decap[MAX_PACKET_SIZES][PDCP_BUFFER_SIZE];
+
+static bench_context_t test_contexts[MAX_CONTEXTS];
+static bench_thread_t test_threads[MAX_THREADS];
+static bench_churn_thread_t test_churn_threads[MAX_CHURN_THREADS];
+
+/* Set when the worker threads are done, to stop the control threads */
+static volatile int test_churn_stop;
+
+/* Latency samples of all the threads, for percentiles */
+static uint32_t all_latency_samples[MAX_THREADS * LATENCY_SAMPLES_NO];
+
+/* JSON results, one object per line and iteration. NULL if not requested. */
+static FILE *json_out;
+
+/* Set on CTRL-C */
+static volatile int test_should_exit;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/** @brief Initialize SEC driver with the requested number of job rings. */
+static int setup_sec_environment(void);
+
+/** @brief Delete the contexts, release SEC driver and the memory of the test application. */
+static int cleanup_sec_environment(void);
+
+/** @brief Create the contexts, allocate and populate their packets. */
+static int create_contexts(void);
+
+/** @brief Generates the input of the decapsulation contexts, by encapsulating
+ * test_data_encap with SEC, once for each payload size. */
+static int generate_decap_vectors(void);
+
+/** @brief Runs the worker threads for an iteration and collects their results. */
+static int run_iteration(uint32_t iteration, bench_results_t *results);
+
+/** @brief The worker thread function, for one iteration.
+ * The thread sends packets on the contexts of its job rings, round robin, until the
+ * packets of the iteration are sent, and polls its job rings until all of them are
+ * notified. */
+static void* bench_thread_routine(void *arg);
+
+/** @brief The control thread function, for one iteration.
+ * The thread replaces one of its contexts with a new one at the churn rate, until
+ * the worker threads are done, then deletes its contexts. */
+static void* churn_thread_routine(void *arg);
+
+/** @brief Callback called by SEC driver for each packet processed.
+ * Takes the latency sample of the packet and frees its slot. */
+static int done_cbk(const sec_packet_t *in_packet,
+                    const sec_packet_t *out_packet,
+                    ua_context_handle_t ua_ctx_handle,
+                    uint32_t status,
+                    uint32_t error_info);
+
+/* Returns the physical address corresponding to the virtual
+ * address passed as a parameter.
+ */
+#ifdef USDPAA
+dma_addr_t test_vtop(void *v);
+#define test_vtop __dma_mem_vtop
+
+void *test_ptov(dma_addr_t p);
+#define test_ptov __dma_mem_ptov
+
+void *test_memalign(size_t align, size_t size);
+#define test_memalign __dma_mem_memalign
+
+void test_free(void *ptr, size_t size);
+#define test_free(ptr, size) __dma_mem_free(ptr)
+#else
+static inline dma_addr_t test_vtop(void *v)
+{
+    return fsl_usmmgr_v2p(v,g_usmmgr);
+}
+
+static inline void* test_ptov(dma_addr_t p)
+{
+    return fsl_usmmgr_p2v(p,g_usmmgr);
+}
+/* Allocates an aligned memory area from the FSL USMMGR pool */
+static void * test_memalign(size_t align, size_t size);
+
+/* Frees a previously allocated FSL USMMGR memory region */
+static void test_free(void *ptr, size_t size);
+#endif
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+#ifndef USDPAA
+static void * test_memalign(size_t align, size_t size)
+{
+    int ret;
+    range_t r = {0,0,size};
+
+    ret = fsl_usmmgr_memalign(&r,align,g_usmmgr);
+    if(ret != 0){
+        printf("FSL USMMGR memalign failed: %d",ret);
+        return NULL;
+    }
+    return r.vaddr;
+}
+
+static void test_free(void *ptr, size_t size)
+{
+   range_t r;
+
+   r.vaddr = ptr;
+   fsl_usmmgr_free(&r,g_usmmgr);
+}
+#endif
+
+/* Timestamp taken before a measured call and at submission, see SEC_TIME_SOURCE */
+static inline uint32_t get_ticks(void)
+{
+    return (uint32_t)(test_serialize_ticks ? sec_time_read_start() : sec_time_read());
+}
+
+/* Timestamp taken after a measured call and at notification */
+static inline uint32_t get_ticks_end(void)
+{
+    return (uint32_t)(test_serialize_ticks ? sec_time_read_end() : sec_time_read());
+}
+
+static uint64_t timespec_diff_us(const struct timespec *start, const struct timespec *end)
+{
+    return (uint64_t)(end->tv_sec - start->tv_sec) * MEGA +
+           (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static int timespec_before(const struct timespec *a, const struct timespec *b)
+{
+    return (a->tv_sec < b->tv_sec) || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+static void timespec_add_ns(struct timespec *t, uint64_t ns)
+{
+    ns += t->tv_nsec;
+    t->tv_sec += ns / GIGA;
+    t->tv_nsec = ns % GIGA;
+}
+
+/* Returns the payload size of a new packet, drawn from the packet size distribution */
+static uint32_t pick_payload_size(uint32_t *size_idx)
+{
+    uint32_t r = rand() % test_sizes_weight;
+    uint32_t i;
+
+    for (i = 0; i < test_sizes_no - 1; i++)
+    {
+        if (r < test_sizes[i].weight)
+        {
+            break;
+        }
+        r -= test_sizes[i].weight;
+    }
+    *size_idx = i;
+
+    return test_sizes[i].payload_size;
+}
+
+/* Describes a packet of length bytes at TEST_OFFSET in buffer, split in test_num_frags
+ * fragments if fragmented is set */
+static void fill_packet(sec_packet_t *packet, uint8_t *buffer, uint32_t length, int fragmented)
+{
+    uint32_t frags_no = fragmented ? test_num_frags : 1;
+    uint32_t fragment_length = length / frags_no;
+    dma_addr_t address;
+    uint32_t rem_len;
+    uint32_t i;
+
+    /* First fragment is special, it has the headroom */
+    packet[0].address = test_vtop(buffer);
+    packet[0].offset = TEST_OFFSET;
+    packet[0].length = fragment_length;
+    packet[0].total_length = length;
+    packet[0].num_fragments = frags_no - 1;
+
+    address = packet[0].address + TEST_OFFSET + fragment_length;
+    rem_len = length - fragment_length;
+
+    for (i = 1; i < frags_no; i++)
+    {
+        packet[i].address = address;
+        packet[i].offset = 0;
+        packet[i].length = (i == frags_no - 1) ? rem_len : fragment_length;
+
+        address += packet[i].length;
+        rem_len -= packet[i].length;
+    }
+    if (frags_no == 1)
+    {
+        packet[0].length = length;
+        rem_len = 0;
+    }
+    assert(rem_len == 0);
+}
+
+static void fill_context_cfg(sec_pdcp_context_info_t *cfg,
+                             sec_out_cbk callback,
+                             uint32_t proto_dir)
+{
+    memset(cfg, 0, sizeof(sec_pdcp_context_info_t));
+
+    cfg->notify_packet = callback;
+    cfg->protocol_direction = proto_dir;
+    cfg->bearer = test_bearer;
+    cfg->packet_direction = test_direction;
+    cfg->hfn = test_hfn;
+    cfg->hfn_threshold = test_hfn_threshold;
+
+    /* Enable HFN value override */
+    cfg->hfn_ov_en = 1;
+
+    cfg->user_plane = test_user_plane;
+    cfg->sn_size = test_sn_size;
+    cfg->cipher_algorithm = test_cipher_algorithm;
+    cfg->cipher_key = test_crypto_key;
+    cfg->cipher_key_len = MAX_KEY_LENGTH;
+
+    if (test_user_plane == PDCP_CONTROL_PLANE)
+    {
+        cfg->integrity_algorithm = test_integrity_algorithm;
+        cfg->integrity_key = test_auth_key;
+        cfg->integrity_key_len = MAX_KEY_LENGTH;
+    }
+}
+
+static void generate_test_vectors(void)
+{
+    int i = 0;
+
+    for(i = 0; i < PDCP_BUFFER_SIZE; i++)
+    {
+        test_data_encap[i] = rand() & 0xFF;
+    }
+
+    for( i = 0; i < MAX_KEY_LENGTH; i++ )
+    {
+        test_crypto_key[i] = rand() & 0xFF;
+        test_auth_key[i] = rand() & 0xFF;
+    }
+
+    test_bearer = rand() &0x1F;
+
+    if(test_user_plane == PDCP_CONTROL_PLANE)
+    {
+        test_hfn = rand() & 0x07FFFFFF;
+    }
+    else if(test_pdcp_hdr_len == 1)
+    {
+        /* Short SN */
+        test_hfn = rand() & 0x01FFFFFF;
+    }
+    else
+    {
+        /* Long SN */
+        test_hfn = rand() & 0x000FFFFF;
+    }
+
+    test_hfn_threshold = test_hfn + 1; /* Threshold reach indication will be
+                                          ignored on poll */
+}
+
+static int test_vector_encap_done(const sec_packet_t *in_packet,
+                                  const sec_packet_t *out_packet,
+                                  ua_context_handle_t ua_ctx_handle,
+                                  uint32_t status,
+                                  uint32_t error_info)
+{
+    uint32_t size_idx = (uint32_t)(uintptr_t)ua_ctx_handle;
+
+    assert(status == SEC_STATUS_SUCCESS);
+    memcpy(test_data_decap[size_idx],
+           test_ptov(out_packet->address + out_packet->offset),
+           out_packet->length);
+
+    return SEC_RETURN_SUCCESS;
+}
+
+static int generate_decap_vectors(void)
+{
+    sec_pdcp_context_info_t cfg;
+    sec_context_handle_t sec_ctx;
+    sec_packet_t in_packet;
+    sec_packet_t out_packet;
+    uint8_t *buffers;
+    uint32_t packets_out;
+    uint32_t length;
+    uint32_t i;
+    int retries;
+    int ret_code;
+
+    buffers = dma_mem_memalign(BUFFER_ALIGNEMENT, 2 * PDCP_BUFFER_SIZE);
+    assert(buffers != NULL);
+
+    fill_context_cfg(&cfg, test_vector_encap_done, PDCP_ENCAPSULATION);
+    ret_code = sec_create_pdcp_context(job_ring_descriptors[0].job_ring_handle, &cfg, &sec_ctx);
+    assert(ret_code == SEC_SUCCESS);
+
+    for (i = 0; i < test_sizes_no; i++)
+    {
+        length = test_pdcp_hdr_len + test_sizes[i].payload_size;
+
+        memset(&in_packet, 0, sizeof(in_packet));
+        memset(&out_packet, 0, sizeof(out_packet));
+        memcpy(buffers + TEST_OFFSET, test_data_encap, length);
+        fill_packet(&in_packet, buffers, length, 0);
+        fill_packet(&out_packet, buffers + PDCP_BUFFER_SIZE, length + test_icv_len, 0);
+
+        ret_code = sec_process_packet_hfn_ov(sec_ctx,
+                                             &in_packet,
+                                             &out_packet,
+                                             test_hfn,
+                                             (ua_context_handle_t)(uintptr_t)i);
+        assert(ret_code == SEC_SUCCESS);
+
+        retries = 1000;
+        do
+        {
+            usleep(100);
+            packets_out = 0;
+            ret_code = sec_poll_job_ring(job_ring_descriptors[0].job_ring_handle,
+                                         JOB_RING_POLL_UNLIMITED,
+                                         &packets_out);
+            assert(ret_code == SEC_SUCCESS);
+        }while(packets_out == 0 && --retries != 0);
+
+        if (packets_out == 0)
+        {
+            fprintf(stderr, "No notification from SEC for the decapsulation vector\n");
+            return 1;
+        }
+    }
+
+    ret_code = sec_delete_pdcp_context(sec_ctx);
+    assert(ret_code == SEC_SUCCESS);
+
+    dma_mem_free(buffers, 2 * PDCP_BUFFER_SIZE);
+
+    return 0;
+}
+
+static void populate_packet(bench_context_t *ctx, uint32_t pkt_idx)
+{
+    bench_packet_t *pkt = &ctx->packets[pkt_idx];
+    uint8_t *in_buffer = ctx->buffers + (2 * pkt_idx) * PDCP_BUFFER_SIZE;
+    uint8_t *out_buffer = in_buffer + PDCP_BUFFER_SIZE;
+    uint32_t size_idx;
+    uint32_t length;
+
+    pkt->ctx = ctx;
+    pkt->in_use = 0;
+    pkt->payload_size = pick_payload_size(&size_idx);
+    pkt->size_idx = size_idx;
+    length = test_pdcp_hdr_len + pkt->payload_size;
+
+    /* Encapsulation reads fragments and writes a single buffer, decapsulation the reverse */
+    if (ctx->cfg.protocol_direction == PDCP_ENCAPSULATION)
+    {
+        memcpy(in_buffer + TEST_OFFSET, test_data_encap, length);
+        fill_packet(pkt->in_packet, in_buffer, length, 1);
+        fill_packet(pkt->out_packet, out_buffer, length + test_icv_len, 0);
+    }
+    else
+    {
+        memcpy(in_buffer + TEST_OFFSET, test_data_decap[size_idx], length + test_icv_len);
+        fill_packet(pkt->in_packet, in_buffer, length + test_icv_len, 0);
+        fill_packet(pkt->out_packet, out_buffer, length, 1);
+    }
+}
+
+/* Keystream cache: writes the SN of the next COUNT of an encapsulation context in the
+ * header of a packet and returns the HFN to send it with. The COUNT is consumed only
+ * when the packet is sent, so that the packets of the context have consecutive COUNTs. */
+static uint32_t set_packet_count(bench_context_t *ctx, uint32_t pkt_idx)
+{
+    uint8_t *hdr = ctx->buffers + (2 * pkt_idx) * PDCP_BUFFER_SIZE + TEST_OFFSET;
+    uint32_t sn = ctx->next_count & ((1 << test_sn_size) - 1);
+
+    if (test_sn_size == SEC_PDCP_SN_SIZE_7)
+    {
+        hdr[0] = (hdr[0] & 0x80) | sn;
+    }
+    else
+    {
+        hdr[0] = (hdr[0] & 0xF0) | (sn >> 8);
+        hdr[1] = sn & 0xFF;
+    }
+
+    return ctx->next_count >> test_sn_size;
+}
+
+/* Checks the output of a packet: the plaintext for decapsulation, the output of SEC
+ * computed before the benchmark for encapsulation. Returns 1 if it differs.
+ * The fragments of the output are contiguous in the output buffer. */
+static int verify_packet(const bench_packet_t *pkt)
+{
+    const bench_context_t *ctx = pkt->ctx;
+    const uint8_t *out = ctx->buffers + (2 * (pkt - ctx->packets) + 1) * PDCP_BUFFER_SIZE + TEST_OFFSET;
+    uint32_t length = test_pdcp_hdr_len + pkt->payload_size;
+
+    if (ctx->cfg.protocol_direction == PDCP_DECAPSULATION)
+    {
+        return memcmp(out, test_data_encap, length) != 0;
+    }
+
+    // With the keystream cache, the SN changes from packet to packet
+    if (test_ks_cache_budget != 0)
+    {
+        return 0;
+    }
+
+    return memcmp(out, test_data_decap[pkt->size_idx], length + test_icv_len) != 0;
+}
+
+/* Counts the packets submitted on a job ring with another context than the previous
+ * packet of the job ring. SEC fetches the shared descriptor again for each of them. */
+static void count_ctx_switch(bench_thread_t *th, const bench_context_t *ctx)
+{
+    if (th->last_sec_ctx[ctx->job_ring] != ctx->sec_ctx)
+    {
+        th->last_sec_ctx[ctx->job_ring] = ctx->sec_ctx;
+        th->ctx_switches++;
+    }
+}
+
+static int create_contexts(void)
+{
+    bench_context_t *ctx;
+    bench_thread_t *th;
+    bench_churn_thread_t *churn_th;
+    uint32_t proto_dir;
+    uint32_t i, j;
+    int ret_code;
+
+    for (i = 0; i < test_threads_no; i++)
+    {
+        test_threads[i].tid = i;
+        test_threads[i].seed = rand();
+        test_threads[i].contexts = malloc(sizeof(bench_context_t*) * test_contexts_no);
+        assert(test_threads[i].contexts != NULL);
+        test_threads[i].latency_samples = malloc(sizeof(uint32_t) * LATENCY_SAMPLES_NO);
+        assert(test_threads[i].latency_samples != NULL);
+    }
+    for (i = 0; i < test_job_rings_no; i++)
+    {
+        th = &test_threads[i % test_threads_no];
+        th->job_rings[th->job_rings_no++] = i;
+    }
+    for (i = 0; i < test_churn_threads_no; i++)
+    {
+        test_churn_threads[i].tid = i;
+        fill_context_cfg(&test_churn_threads[i].cfg, done_cbk, PDCP_ENCAPSULATION);
+    }
+    for (i = 0; i < test_job_rings_no && test_churn_threads_no != 0; i++)
+    {
+        churn_th = &test_churn_threads[i % test_churn_threads_no];
+        churn_th->job_rings[churn_th->job_rings_no++] = i;
+    }
+
+    for (i = 0; i < test_contexts_no; i++)
+    {
+        ctx = &test_contexts[i];
+
+        /* Spread the contexts on the job rings. With both directions, each job ring
+         * gets encapsulation and decapsulation contexts alternately. */
+        ctx->job_ring = i % test_job_rings_no;
+        ctx->thread = &test_threads[ctx->job_ring % test_threads_no];
+        if (test_encap && test_decap)
+        {
+            proto_dir = ((i / test_job_rings_no) % 2) ? PDCP_DECAPSULATION : PDCP_ENCAPSULATION;
+        }
+        else
+        {
+            proto_dir = test_encap ? PDCP_ENCAPSULATION : PDCP_DECAPSULATION;
+        }
+        fill_context_cfg(&ctx->cfg, done_cbk, proto_dir);
+
+        /* Allocate input and output buffers from memory zone DMA-accessible to SEC engine */
+        ctx->buffers = dma_mem_memalign(BUFFER_ALIGNEMENT, 2 * PDCP_BUFFER_SIZE * test_queue_depth);
+        assert(ctx->buffers != NULL);
+
+        ctx->packets = calloc(test_queue_depth, sizeof(bench_packet_t));
+        assert(ctx->packets != NULL);
+        for (j = 0; j < test_queue_depth; j++)
+        {
+            ctx->packets[j].in_packet = memalign(BUFFER_ALIGNEMENT, sizeof(sec_packet_t) * test_num_frags);
+            assert(ctx->packets[j].in_packet != NULL);
+            memset(ctx->packets[j].in_packet, 0, sizeof(sec_packet_t) * test_num_frags);
+
+            ctx->packets[j].out_packet = memalign(BUFFER_ALIGNEMENT, sizeof(sec_packet_t) * test_num_frags);
+            assert(ctx->packets[j].out_packet != NULL);
+            memset(ctx->packets[j].out_packet, 0, sizeof(sec_packet_t) * test_num_frags);
+
+            populate_packet(ctx, j);
+        }
+
+        /* Affine the context to its job ring */
+        ret_code = sec_create_pdcp_context(job_ring_descriptors[ctx->job_ring].job_ring_handle,
+                                           &ctx->cfg,
+                                           &ctx->sec_ctx);
+        if (ret_code != SEC_SUCCESS)
+        {
+            fprintf(stderr, "sec_create_pdcp_context returned error %d for context %d\n", ret_code, i);
+            return 1;
+        }
+
+        /* Have the keystream of the first packets generated before the benchmark starts */
+        ctx->next_count = test_hfn << test_sn_size;
+        if (test_ks_cache_budget != 0 && proto_dir == PDCP_ENCAPSULATION)
+        {
+            ret_code = sec_enable_keystream_cache(ctx->sec_ctx, ctx->next_count);
+            if (ret_code != SEC_SUCCESS)
+            {
+                fprintf(stderr, "sec_enable_keystream_cache returned error %d for context %d\n", ret_code, i);
+                return 1;
+            }
+            ret_code = sec_refill_keystream_cache(ctx->sec_ctx, SEC_KEYSTREAM_CACHE_DEPTH, NULL);
+            assert(ret_code == SEC_SUCCESS);
+        }
+
+        th = ctx->thread;
+        th->contexts[th->contexts_no++] = ctx;
+    }
+
+    return 0;
+}
+
+static int setup_sec_environment(void)
+{
+    int i = 0;
+    int ret_code = 0;
+    time_t seconds;
+
+    /* Get value from system clock and use it for seed generation  */
+    time(&seconds);
+    srand((unsigned int) seconds);
+
+    test_crypto_key = dma_mem_memalign(BUFFER_ALIGNEMENT, MAX_KEY_LENGTH);
+    assert(test_crypto_key != NULL);
+    test_auth_key = dma_mem_memalign(BUFFER_ALIGNEMENT, MAX_KEY_LENGTH);
+    assert(test_auth_key != NULL);
+
+    // Allocate only the DMA memory needed for the job rings requested
+    sec_config_data.memory_area_size = sec_get_required_dma_size(&sec_config_data, test_job_rings_no);
+    sec_config_data.memory_area = dma_mem_memalign(L1_CACHE_BYTES, sec_config_data.memory_area_size);
+    assert(sec_config_data.memory_area != NULL);
+
+    sec_config_data.sec_drv_vtop = test_vtop;
+    // The driver linearizes packets and processes packets on the CPU only if it can access them
+    sec_config_data.sec_drv_ptov = (test_sg_crossover || test_ks_cache_budget || test_cpu_dispatch) ?
+                                   test_ptov : NULL;
+
+    // Fill SEC driver configuration data
+    sec_config_data.work_mode = (test_mode == BENCH_MODE_IRQ || test_mode == BENCH_MODE_NAPI) ?
+                                SEC_STARTUP_INTERRUPT_MODE : SEC_STARTUP_POLLING_MODE;
+#if (SEC_INT_COALESCING_ENABLE == ON)
+    sec_config_data.irq_coalescing_count = IRQ_COALESCING_COUNT;
+    sec_config_data.irq_coalescing_timer = IRQ_COALESCING_TIMER;
+#endif // SEC_INT_COALESCING_ENABLE == ON
+
+    ret_code = sec_init(&sec_config_data, test_job_rings_no, &job_ring_descriptors);
+    if (ret_code != SEC_SUCCESS)
+    {
+        fprintf(stderr, "sec_init::Error %d\n", ret_code);
+        return 1;
+    }
+    test_printf("thread main: initialized SEC user space driver\n");
+
+    for (i = 0; i < test_job_rings_no; i++)
+    {
+        assert(job_ring_descriptors[i].job_ring_handle != NULL);
+        assert(job_ring_descriptors[i].job_ring_irq_fd != 0);
+    }
+
+    return 0;
+}
+
+static int cleanup_sec_environment(void)
+{
+    bench_context_t *ctx;
+    uint32_t i, j;
+    int ret_code = 0;
+
+    // All the packets were notified, the contexts can be deleted right away
+    for (i = 0; i < test_contexts_no; i++)
+    {
+        if (test_contexts[i].sec_ctx != NULL)
+        {
+            ret_code = sec_delete_pdcp_context(test_contexts[i].sec_ctx);
+            assert(ret_code == SEC_SUCCESS);
+        }
+    }
+
+    // release SEC driver
+    ret_code = sec_release();
+    if (ret_code != 0)
+    {
+        test_printf("sec_release returned error\n");
+        return 1;
+    }
+    test_printf("thread main: released SEC user space driver!!\n");
+
+    for (i = 0; i < test_contexts_no; i++)
+    {
+        ctx = &test_contexts[i];
+        if (ctx->packets == NULL)
+        {
+            continue;
+        }
+        for (j = 0; j < test_queue_depth; j++)
+        {
+            free(ctx->packets[j].in_packet);
+            free(ctx->packets[j].out_packet);
+        }
+        free(ctx->packets);
+        dma_mem_free(ctx->buffers, 2 * PDCP_BUFFER_SIZE * test_queue_depth);
+    }
+    for (i = 0; i < test_threads_no; i++)
+    {
+        free(test_threads[i].contexts);
+        free(test_threads[i].latency_samples);
+    }
+
+    dma_mem_free(test_crypto_key, MAX_KEY_LENGTH);
+    dma_mem_free(test_auth_key, MAX_KEY_LENGTH);
+    dma_mem_free(sec_config_data.memory_area, sec_config_data.memory_area_size);
+
+    return 0;
+}
+
+static int done_cbk(const sec_packet_t *in_packet,
+                    const sec_packet_t *out_packet,
+                    ua_context_handle_t ua_ctx_handle,
+                    uint32_t status,
+                    uint32_t error_info)
+{
+    bench_packet_t *pkt = (bench_packet_t*)ua_ctx_handle;
+    bench_thread_t *th = pkt->ctx->thread;
+    uint32_t latency = get_ticks_end() - pkt->submit_ticks;
+
+    if (th->latency_no < LATENCY_SAMPLES_NO)
+    {
+        th->latency_samples[th->latency_no] = latency;
+    }
+    th->latency_no++;
+    th->latency_sum += latency;
+    if (latency > th->latency_max)
+    {
+        th->latency_max = latency;
+    }
+
+    if (status != SEC_STATUS_SUCCESS && status != SEC_STATUS_HFN_THRESHOLD_REACHED)
+    {
+        th->errors++;
+    }
+    else if (test_verify && verify_packet(pkt) != 0)
+    {
+        th->mismatches++;
+    }
+
+    th->packets_received++;
+    th->bytes_received += pkt->payload_size;
+    pkt->in_use = 0;
+
+    return SEC_RETURN_SUCCESS;
+}
+
+/* Returns an exponentially distributed time, of mean 'mean' */
+static double exp_random(bench_thread_t *th, double mean)
+{
+    // In (0, 1], so that the logarithm is finite
+    double u = (rand_r(&th->seed) + 1.0) / ((double)RAND_MAX + 1.0);
+
+    return -log(u) * mean;
+}
+
+/* Sets the arrival time of the next packet of an open loop thread */
+static void schedule_arrival(bench_thread_t *th)
+{
+    switch (test_arrival)
+    {
+        case BENCH_ARRIVAL_CONSTANT:
+            th->next_arrival += (uint64_t)test_arrival_gap;
+            break;
+        case BENCH_ARRIVAL_BURSTY:
+            // The packets of a burst arrive together, the bursts at the same mean rate
+            if (++th->burst_arrivals < test_arrival_burst)
+            {
+                break;
+            }
+            th->burst_arrivals = 0;
+            th->next_arrival += (uint64_t)exp_random(th, test_arrival_gap * test_arrival_burst);
+            break;
+        case BENCH_ARRIVAL_POISSON:
+        default:
+            th->next_arrival += (uint64_t)exp_random(th, test_arrival_gap);
+            break;
+    }
+}
+
+/* Submits the packets queued in burst mode. Returns 1 if some are left because a job ring is full. */
+static int submit_burst(bench_thread_t *th)
+{
+    uint32_t submitted_no = 0;
+    uint32_t start_ticks;
+    uint32_t i;
+    int ret_code;
+
+    start_ticks = get_ticks();
+    // In open loop, the latency is measured from the arrival of the packets
+    for (i = 0; i < th->burst_no && test_offered_rate == 0; i++)
+    {
+        ((bench_packet_t*)th->burst[i].ua_ctx_handle)->submit_ticks = start_ticks;
+    }
+
+    ret_code = sec_process_packet_burst(th->burst, th->burst_no, &submitted_no);
+    th->submit_ticks += get_ticks_end() - start_ticks;
+
+    if (ret_code != SEC_SUCCESS && ret_code != SEC_JR_IS_FULL)
+    {
+        fprintf(stderr, "thread #%d: sec_process_packet_burst returned error %d\n", th->tid, ret_code);
+        assert(0);
+    }
+
+    // The packets submitted are at the start of the burst, in the order SEC driver enqueued them
+    for (i = 0; i < submitted_no; i++)
+    {
+        count_ctx_switch(th, ((bench_packet_t*)th->burst[i].ua_ctx_handle)->ctx);
+    }
+
+    // Keep the packets not submitted, in the order SEC driver left them
+    th->burst_no -= submitted_no;
+    memmove(th->burst, &th->burst[submitted_no], th->burst_no * sizeof(sec_burst_packet_t));
+
+    return (th->burst_no != 0);
+}
+
+/* Sends packets on the contexts of the thread, round robin, until the packets of the
+ * iteration are sent, no context has a free packet slot or a job ring is full. */
+static void produce(bench_thread_t *th)
+{
+    bench_context_t *ctx;
+    bench_packet_t *pkt;
+    uint32_t idle_contexts = 0;
+    uint32_t start_ticks;
+    uint32_t hfn;
+    int ret_code;
+
+    if (th->burst_no != 0 && submit_burst(th) != 0)
+    {
+        return;
+    }
+
+    while (th->packets_sent < th->packets_to_send && idle_contexts < th->contexts_no)
+    {
+        // In open loop, poll until the next packet arrives. A packet that arrived while
+        // no slot was free or the job ring was full is sent late, the wait counts in its latency.
+        if (test_offered_rate != 0 && sec_time_read() < th->next_arrival)
+        {
+            break;
+        }
+
+        ctx = th->contexts[th->next_ctx];
+        pkt = &ctx->packets[ctx->next_packet];
+
+        if (pkt->in_use || th->ctx_sent >= test_ctx_run)
+        {
+            // Go to the next context
+            idle_contexts += pkt->in_use ? 1 : 0;
+            th->next_ctx = (th->next_ctx + 1) % th->contexts_no;
+            th->ctx_sent = 0;
+            continue;
+        }
+
+        hfn = test_hfn;
+        if (test_ks_cache_budget != 0 && ctx->cfg.protocol_direction == PDCP_ENCAPSULATION)
+        {
+            hfn = set_packet_count(ctx, ctx->next_packet);
+        }
+
+        if (test_mode == BENCH_MODE_BURST)
+        {
+            th->burst[th->burst_no].sec_ctx_handle = ctx->sec_ctx;
+            th->burst[th->burst_no].in_packet = pkt->in_packet;
+            th->burst[th->burst_no].out_packet = pkt->out_packet;
+            th->burst[th->burst_no].hfn_ov_val = hfn;
+            th->burst[th->burst_no].ua_ctx_handle = (ua_context_handle_t)pkt;
+            th->burst_no++;
+            pkt->submit_ticks = (uint32_t)th->next_arrival;
+        }
+        else
+        {
+            start_ticks = get_ticks();
+            pkt->submit_ticks = (test_offered_rate != 0) ? (uint32_t)th->next_arrival : start_ticks;
+            ret_code = sec_process_packet_hfn_ov(ctx->sec_ctx,
+                                                 pkt->in_packet,
+                                                 pkt->out_packet,
+                                                 hfn,
+                                                 (ua_context_handle_t)pkt);
+            th->submit_ticks += get_ticks_end() - start_ticks;
+            if (ret_code == SEC_JR_IS_FULL)
+            {
+                // Poll, then send again on the same context
+                return;
+            }
+            if (ret_code != SEC_SUCCESS)
+            {
+                fprintf(stderr, "thread #%d: sec_process_packet returned error %d\n", th->tid, ret_code);
+                assert(0);
+            }
+            count_ctx_switch(th, ctx);
+        }
+
+        pkt->in_use = 1;
+        ctx->next_packet = (ctx->next_packet + 1) % test_queue_depth;
+        th->packets_sent++;
+        th->ctx_sent++;
+        idle_contexts = 0;
+
+        if (test_ks_cache_budget != 0 && ctx->cfg.protocol_direction == PDCP_ENCAPSULATION)
+        {
+            // Generate keystream for the next packets of the context, while SEC works
+            ctx->next_count++;
+            ret_code = sec_refill_keystream_cache(ctx->sec_ctx, test_ks_cache_budget, NULL);
+            assert(ret_code == SEC_SUCCESS);
+        }
+
+        if (test_offered_rate != 0)
+        {
+            th->queue_ticks += (uint32_t)sec_time_read() - (uint32_t)th->next_arrival;
+            schedule_arrival(th);
+        }
+
+        if (th->burst_no == test_burst_size && submit_burst(th) != 0)
+        {
+            return;
+        }
+    }
+
+    // Don't keep packets queued while polling
+    if (th->burst_no != 0)
+    {
+        submit_burst(th);
+    }
+}
+
+/* How long a thread can wait for an IRQ: in open loop, not past the next arrival */
+static uint32_t get_irq_wait_us(const bench_thread_t *th)
+{
+    uint64_t now;
+    uint64_t wait_us;
+
+    if (test_offered_rate == 0 || th->packets_sent == th->packets_to_send || test_should_exit)
+    {
+        return IRQ_WAIT_US;
+    }
+
+    now = sec_time_read();
+    if (now >= th->next_arrival)
+    {
+        return 0;
+    }
+    wait_us = sec_time_ticks_to_ns(th->next_arrival - now) / 1000;
+
+    return (wait_us < IRQ_WAIT_US) ? (uint32_t)wait_us : IRQ_WAIT_US;
+}
+
+/* Waits for the IRQ of a job ring, at most wait_us. Returns 1 if it was raised. */
+static int wait_for_irq(uint32_t job_ring, uint32_t wait_us)
+{
+    int fd = job_ring_descriptors[job_ring].job_ring_irq_fd;
+    struct timeval tv;
+    fd_set readfds;
+    int irq_count;
+    int ret;
+
+    FD_ZERO(&readfds);
+    FD_SET(fd, &readfds);
+
+    tv.tv_sec = 0;
+    tv.tv_usec = wait_us;
+
+    select(fd + 1, &readfds, NULL, NULL, &tv);
+    if (!FD_ISSET(fd, &readfds))
+    {
+        return 0;
+    }
+
+    // Now read the IRQ counter
+    ret = read(fd, &irq_count, sizeof(irq_count));
+    assert(ret == sizeof(irq_count));
+
+    return 1;
+}
+
+/* Retrieves the notifications available on the job rings of the thread */
+static void consume(bench_thread_t *th)
+{
+    uint32_t packets_out;
+    uint32_t start_ticks;
+    uint32_t job_ring;
+    uint32_t i;
+    int ret_code;
+
+    for (i = 0; i < th->job_rings_no; i++)
+    {
+        job_ring = th->job_rings[i];
+
+        if ((test_mode == BENCH_MODE_IRQ || (test_mode == BENCH_MODE_NAPI && th->irq_wait[i])) &&
+            wait_for_irq(job_ring, get_irq_wait_us(th)) == 0)
+        {
+            continue;
+        }
+
+        packets_out = 0;
+        start_ticks = get_ticks();
+        ret_code = sec_poll_job_ring(job_ring_descriptors[job_ring].job_ring_handle,
+                                     JOB_RING_POLL_UNLIMITED,
+                                     &packets_out);
+        th->poll_ticks += get_ticks_end() - start_ticks;
+
+        if (ret_code == SEC_PACKET_PROCESSING_ERROR)
+        {
+            // The job ring was restarted and can be used normally again
+            th->errors++;
+        }
+        else if (ret_code != SEC_SUCCESS)
+        {
+            fprintf(stderr, "thread #%d: sec_poll_job_ring returned error %d on job ring %d\n",
+                    th->tid, ret_code, job_ring);
+            assert(0);
+        }
+
+        // NAPI: when a job ring is drained, wait for its IRQ instead of polling it
+        th->irq_wait[i] = (packets_out == 0);
+    }
+}
+
+#if (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+/* -x: linearizes the fragmented packets of the job rings of a thread, or sends them with
+ * SG tables. Called by the thread submitting on the job rings, when all the packets of
+ * the previous iteration were notified. */
+static void set_sg_linearization(const bench_thread_t *th)
+{
+    uint32_t i;
+    int ret_code;
+
+    for (i = 0; i < th->job_rings_no; i++)
+    {
+        ret_code = sec_set_sg_linearization(job_ring_descriptors[th->job_rings[i]].job_ring_handle,
+                                            th->linearize ? SEC_SG_BOUNCE_BUF_SIZE : 0,
+                                            th->linearize ? test_num_frags : 0);
+        assert(ret_code == SEC_SUCCESS);
+    }
+}
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+
+static void* bench_thread_routine(void *arg)
+{
+    bench_thread_t *th = (bench_thread_t*)arg;
+
+#if (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+    if (test_sg_crossover)
+    {
+        set_sg_linearization(th);
+    }
+#endif // (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+
+    clock_gettime(CLOCK_MONOTONIC, &th->start_time);
+    // The first packet arrives now
+    th->next_arrival = sec_time_read();
+    th->burst_arrivals = 0;
+
+    /* Stop sending on CTRL-C, but retrieve all the packets sent */
+    while (th->packets_received < th->packets_sent ||
+           (!test_should_exit && th->packets_sent < th->packets_to_send))
+    {
+        if (!test_should_exit)
+        {
+            produce(th);
+        }
+        else if (th->burst_no != 0)
+        {
+            submit_burst(th);
+        }
+
+        consume(th);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &th->end_time);
+
+    pthread_exit(NULL);
+}
+
+/* Replaces the context of the next slot of a control thread with a new one */
+static void churn_context(bench_churn_thread_t *th)
+{
+    sec_context_handle_t *slot = &th->contexts[th->next_slot];
+    uint32_t job_ring = th->job_rings[th->next_slot % th->job_rings_no];
+    uint32_t start_ticks;
+    uint32_t ticks;
+    int ret_code;
+
+    th->next_slot = (th->next_slot + 1) % (th->job_rings_no * CHURN_CONTEXTS_PER_JOB_RING);
+
+    if (*slot != NULL)
+    {
+        // No packet is sent on these contexts, so they are freed right away
+        start_ticks = get_ticks();
+        ret_code = sec_delete_pdcp_context(*slot);
+        ticks = get_ticks_end() - start_ticks;
+        if (ret_code != SEC_SUCCESS)
+        {
+            fprintf(stderr, "control thread #%d: sec_delete_pdcp_context returned error %d\n",
+                    th->tid, ret_code);
+            assert(0);
+        }
+        *slot = NULL;
+        th->deleted++;
+        th->delete_ticks += ticks;
+        if (ticks > th->delete_max)
+        {
+            th->delete_max = ticks;
+        }
+    }
+
+    start_ticks = get_ticks();
+    ret_code = sec_create_pdcp_context(job_ring_descriptors[job_ring].job_ring_handle,
+                                       &th->cfg,
+                                       slot);
+    ticks = get_ticks_end() - start_ticks;
+    if (ret_code == SEC_DRIVER_NO_FREE_CONTEXTS)
+    {
+        *slot = NULL;
+        th->failures++;
+        return;
+    }
+    if (ret_code != SEC_SUCCESS)
+    {
+        fprintf(stderr, "control thread #%d: sec_create_pdcp_context returned error %d\n",
+                th->tid, ret_code);
+        assert(0);
+    }
+    th->created++;
+    th->create_ticks += ticks;
+    if (ticks > th->create_max)
+    {
+        th->create_max = ticks;
+    }
+}
+
+static void* churn_thread_routine(void *arg)
+{
+    bench_churn_thread_t *th = (bench_churn_thread_t*)arg;
+    uint64_t period_ns = GIGA / test_churn_rate;
+    struct timespec next;
+    uint32_t i;
+    int ret_code;
+
+    clock_gettime(CLOCK_MONOTONIC, &th->start_time);
+    next = th->start_time;
+
+    while (!test_churn_stop && !test_should_exit)
+    {
+        // Absolute deadlines, so that the rate does not drift with the time of the calls.
+        // If the thread falls behind, it catches up without sleeping.
+        timespec_add_ns(&next, period_ns);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+        churn_context(th);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &th->end_time);
+
+    // Start the next iteration without contexts
+    for (i = 0; i < th->job_rings_no * CHURN_CONTEXTS_PER_JOB_RING; i++)
+    {
+        if (th->contexts[i] != NULL)
+        {
+            ret_code = sec_delete_pdcp_context(th->contexts[i]);
+            assert(ret_code == SEC_SUCCESS);
+            th->contexts[i] = NULL;
+        }
+    }
+
+    pthread_exit(NULL);
+}
+
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+/* Sums the counters of the job rings kept by SEC driver */
+static void get_jr_counters(sec_statistics_ext_t *total)
+{
+    sec_statistics_ext_t stats;
+    uint32_t i;
+    int ret_code;
+
+    memset(total, 0, sizeof(sec_statistics_ext_t));
+    for (i = 0; i < test_job_rings_no; i++)
+    {
+        stats.size = sizeof(stats);
+        ret_code = sec_get_stats_ext(job_ring_descriptors[i].job_ring_handle, &stats);
+        assert(ret_code == SEC_SUCCESS);
+
+        total->jr_full += stats.jr_full;
+        total->empty_polls += stats.empty_polls;
+        total->irq_enables += stats.irq_enables;
+        total->polls += stats.polls;
+        total->packets_completed += stats.packets_completed;
+        total->callback_ticks += stats.callback_ticks;
+    }
+}
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+
+static int compare_latency(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+static int run_iteration(uint32_t iteration, bench_results_t *results)
+{
+    bench_thread_t *th;
+    bench_churn_thread_t *churn_th;
+    pthread_attr_t attr;
+    cpu_set_t cpu_mask;
+    struct rusage usage_start;
+    struct rusage usage_end;
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    sec_statistics_ext_t counters_start;
+    sec_statistics_ext_t counters_end;
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+    struct timespec start_time;
+    struct timespec end_time;
+    uint64_t submit_ticks = 0;
+    uint64_t poll_ticks = 0;
+    uint64_t latency_sum = 0;
+    uint64_t cpu_us;
+    uint32_t samples_no = 0;
+    uint32_t latency_no = 0;
+    uint64_t create_ticks = 0;
+    uint64_t delete_ticks = 0;
+    uint64_t queue_ticks = 0;
+    uint64_t churn_us;
+    long cpus_no = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t i;
+    int ret_code;
+
+    memset(results, 0, sizeof(bench_results_t));
+    results->iteration = iteration;
+    results->linearized = test_sg_crossover && (iteration % 2 == 0);
+
+    for (i = 0; i < test_threads_no; i++)
+    {
+        th = &test_threads[i];
+        th->packets_to_send = test_packets_no / test_threads_no +
+                              (i < test_packets_no % test_threads_no ? 1 : 0);
+        th->packets_sent = 0;
+        th->packets_received = 0;
+        th->bytes_received = 0;
+        th->errors = 0;
+        th->submit_ticks = 0;
+        th->poll_ticks = 0;
+        th->latency_sum = 0;
+        th->latency_max = 0;
+        th->latency_no = 0;
+        th->queue_ticks = 0;
+        th->ctx_switches = 0;
+        th->mismatches = 0;
+        memset(th->last_sec_ctx, 0, sizeof(th->last_sec_ctx));
+        th->linearize = results->linearized;
+    }
+    for (i = 0; i < test_churn_threads_no; i++)
+    {
+        churn_th = &test_churn_threads[i];
+        churn_th->created = 0;
+        churn_th->deleted = 0;
+        churn_th->failures = 0;
+        churn_th->create_ticks = 0;
+        churn_th->delete_ticks = 0;
+        churn_th->create_max = 0;
+        churn_th->delete_max = 0;
+    }
+
+    getrusage(RUSAGE_SELF, &usage_start);
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    get_jr_counters(&counters_start);
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+
+    /* The control threads go on the cores after those of the worker threads */
+    test_churn_stop = 0;
+    for (i = 0; i < test_churn_threads_no; i++)
+    {
+        pthread_attr_init(&attr);
+        CPU_ZERO(&cpu_mask);
+        CPU_SET((test_threads_no + i) % (cpus_no > 0 ? cpus_no : 1), &cpu_mask);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_mask), &cpu_mask);
+
+        ret_code = pthread_create(&test_churn_threads[i].thread, &attr,
+                                  &churn_thread_routine, &test_churn_threads[i]);
+        pthread_attr_destroy(&attr);
+        if (ret_code != 0)
+        {
+            fprintf(stderr, "pthread_create returned error %d\n", ret_code);
+            return 1;
+        }
+    }
+
+    for (i = 0; i < test_threads_no; i++)
+    {
+        /* Each thread on its own core, if there are enough */
+        pthread_attr_init(&attr);
+        CPU_ZERO(&cpu_mask);
+        CPU_SET(i % (cpus_no > 0 ? cpus_no : 1), &cpu_mask);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_mask), &cpu_mask);
+
+        ret_code = pthread_create(&test_threads[i].thread, &attr, &bench_thread_routine, &test_threads[i]);
+        pthread_attr_destroy(&attr);
+        if (ret_code != 0)
+        {
+            fprintf(stderr, "pthread_create returned error %d\n", ret_code);
+            return 1;
+        }
+    }
+
+    for (i = 0; i < test_threads_no; i++)
+    {
+        pthread_join(test_threads[i].thread, NULL);
+    }
+    test_churn_stop = 1;
+    for (i = 0; i < test_churn_threads_no; i++)
+    {
+        pthread_join(test_churn_threads[i].thread, NULL);
+    }
+
+    start_time = test_threads[0].start_time;
+    end_time = test_threads[0].end_time;
+    for (i = 0; i < test_threads_no; i++)
+    {
+        th = &test_threads[i];
+
+        /* The iteration lasts from the first thread started to the last one done */
+        if (timespec_before(&th->start_time, &start_time))
+        {
+            start_time = th->start_time;
+        }
+        if (timespec_before(&end_time, &th->end_time))
+        {
+            end_time = th->end_time;
+        }
+
+        results->packets_sent += th->packets_sent;
+        results->packets_received += th->packets_received;
+        results->bytes_received += th->bytes_received;
+        results->errors += th->errors;
+        results->ctx_switches += th->ctx_switches;
+        results->mismatches += th->mismatches;
+        submit_ticks += th->submit_ticks;
+        poll_ticks += th->poll_ticks;
+        latency_sum += th->latency_sum;
+        latency_no += th->latency_no;
+        queue_ticks += th->queue_ticks;
+        if (th->latency_max > results->latency_max)
+        {
+            results->latency_max = th->latency_max;
+        }
+
+        memcpy(&all_latency_samples[samples_no], th->latency_samples,
+               sizeof(uint32_t) * (th->latency_no < LATENCY_SAMPLES_NO ? th->latency_no : LATENCY_SAMPLES_NO));
+        samples_no += (th->latency_no < LATENCY_SAMPLES_NO ? th->latency_no : LATENCY_SAMPLES_NO);
+    }
+
+    getrusage(RUSAGE_SELF, &usage_end);
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    get_jr_counters(&counters_end);
+    results->jr_full = counters_end.jr_full - counters_start.jr_full;
+    results->empty_polls = counters_end.empty_polls - counters_start.empty_polls;
+    results->irq_enables = counters_end.irq_enables - counters_start.irq_enables;
+    results->polls = counters_end.polls - counters_start.polls;
+    results->packets_polled = counters_end.packets_completed - counters_start.packets_completed;
+    results->callback_ticks = counters_end.callback_ticks - counters_start.callback_ticks;
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+
+    results->time_us = timespec_diff_us(&start_time, &end_time);
+    if (results->time_us == 0)
+    {
+        results->time_us = 1;
+    }
+    results->pps = (uint32_t)(((uint64_t)results->packets_received * MEGA) / results->time_us);
+    results->mbps = (uint32_t)((results->bytes_received * 8) / results->time_us);
+
+    if (results->packets_sent != 0)
+    {
+        results->submit_ticks_per_packet = (uint32_t)(submit_ticks / results->packets_sent);
+    }
+    if (results->packets_received != 0)
+    {
+        results->poll_ticks_per_packet = (uint32_t)(poll_ticks / results->packets_received);
+    }
+    if (results->packets_sent != 0)
+    {
+        results->queue_ns_avg = sec_time_ticks_to_ns(queue_ticks / results->packets_sent);
+    }
+
+    /* CPU time of all the threads, relative to the time of the cores they run on */
+    cpu_us = (usage_end.ru_utime.tv_sec - usage_start.ru_utime.tv_sec) * (uint64_t)MEGA +
+             (usage_end.ru_utime.tv_usec - usage_start.ru_utime.tv_usec) +
+             (usage_end.ru_stime.tv_sec - usage_start.ru_stime.tv_sec) * (uint64_t)MEGA +
+             (usage_end.ru_stime.tv_usec - usage_start.ru_stime.tv_usec);
+    results->cpu_load = (uint32_t)((cpu_us * 100) /
+                                   (results->time_us * (test_threads_no + test_churn_threads_no)));
+
+    /* Contexts per second of all the control threads, each over the time it ran */
+    for (i = 0; i < test_churn_threads_no; i++)
+    {
+        churn_th = &test_churn_threads[i];
+
+        results->contexts_created += churn_th->created;
+        results->contexts_deleted += churn_th->deleted;
+        results->churn_failures += churn_th->failures;
+        create_ticks += churn_th->create_ticks;
+        delete_ticks += churn_th->delete_ticks;
+        if (churn_th->create_max > results->create_ticks_max)
+        {
+            results->create_ticks_max = churn_th->create_max;
+        }
+        if (churn_th->delete_max > results->delete_ticks_max)
+        {
+            results->delete_ticks_max = churn_th->delete_max;
+        }
+        churn_us = timespec_diff_us(&churn_th->start_time, &churn_th->end_time);
+        if (churn_us != 0)
+        {
+            results->churn_rate += (uint32_t)(((uint64_t)churn_th->created * MEGA) / churn_us);
+        }
+    }
+    if (results->contexts_created != 0)
+    {
+        results->create_ticks_avg = (uint32_t)(create_ticks / results->contexts_created);
+    }
+    if (results->contexts_deleted != 0)
+    {
+        results->delete_ticks_avg = (uint32_t)(delete_ticks / results->contexts_deleted);
+    }
+
+    if (latency_no != 0)
+    {
+        results->latency_avg = (uint32_t)(latency_sum / latency_no);
+    }
+    if (samples_no != 0)
+    {
+        qsort(all_latency_samples, samples_no, sizeof(uint32_t), compare_latency);
+        results->latency_p50 = all_latency_samples[((uint64_t)(samples_no - 1) * 500) / 1000];
+        results->latency_p90 = all_latency_samples[((uint64_t)(samples_no - 1) * 900) / 1000];
+        results->latency_p99 = all_latency_samples[((uint64_t)(samples_no - 1) * 990) / 1000];
+        results->latency_p999 = all_latency_samples[((uint64_t)(samples_no - 1) * 999) / 1000];
+    }
+
+    return 0;
+}
+
+static void print_results(const bench_results_t *results)
+{
+    printf("Iteration %d:\n"
+           "Sent %u packets. Received %u packets. Errors %u.\n"
+           "Time %llu usec. Receive PPS: %u. Receive Mbps: %u.\n"
+           "Avg. process ticks per packet = %u (%llu ns). Avg. poll ticks per packet = %u (%llu ns).\n"
+           "CPU load = %u%%.\n"
+           "Latency (submit to notification) ticks: avg = %u, p50 = %u, p90 = %u, "
+           "p99 = %u, p99.9 = %u, max = %u\n"
+           "Latency (submit to notification) ns: avg = %llu, p50 = %llu, p90 = %llu, "
+           "p99 = %llu, p99.9 = %llu, max = %llu\n"
+           "Ticks of the %s counter at %llu Hz.\n",
+           results->iteration,
+           results->packets_sent, results->packets_received, results->errors,
+           (unsigned long long)results->time_us, results->pps, results->mbps,
+           results->submit_ticks_per_packet,
+           (unsigned long long)sec_time_ticks_to_ns(results->submit_ticks_per_packet),
+           results->poll_ticks_per_packet,
+           (unsigned long long)sec_time_ticks_to_ns(results->poll_ticks_per_packet),
+           results->cpu_load,
+           results->latency_avg, results->latency_p50, results->latency_p90,
+           results->latency_p99, results->latency_p999, results->latency_max,
+           (unsigned long long)sec_time_ticks_to_ns(results->latency_avg),
+           (unsigned long long)sec_time_ticks_to_ns(results->latency_p50),
+           (unsigned long long)sec_time_ticks_to_ns(results->latency_p90),
+           (unsigned long long)sec_time_ticks_to_ns(results->latency_p99),
+           (unsigned long long)sec_time_ticks_to_ns(results->latency_p999),
+           (unsigned long long)sec_time_ticks_to_ns(results->latency_max),
+           SEC_TIME_SOURCE, (unsigned long long)sec_time_get_frequency());
+    if (test_offered_rate != 0)
+    {
+        printf("Open loop: offered %u PPS, %s arrivals. Avg. wait from arrival to submission %llu ns.\n",
+               test_offered_rate, arrival_names[test_arrival],
+               (unsigned long long)results->queue_ns_avg);
+    }
+    printf("Context switches between consecutive jobs of a job ring (shared descriptor fetches): "
+           "%u for %u contexts.\n", results->ctx_switches, test_contexts_no);
+    if (test_sg_crossover)
+    {
+        printf("Fragmented packets %s.\n",
+               results->linearized ? "linearized by SEC driver" : "sent with SG tables");
+    }
+    if (test_verify)
+    {
+        printf("Output of the packets checked: %u mismatches.\n", results->mismatches);
+    }
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    printf("Job ring full %llu times. Empty polls %llu. IRQ re-enables %llu.\n",
+           (unsigned long long)results->jr_full,
+           (unsigned long long)results->empty_polls,
+           (unsigned long long)results->irq_enables);
+    printf("Polls %llu, %.2f%% empty, %.2f packets per poll. Time in callbacks %llu ns.\n",
+           (unsigned long long)results->polls,
+           results->polls ? 100.0 * results->empty_polls / results->polls : 0.0,
+           results->polls ? (double)results->packets_polled / results->polls : 0.0,
+           (unsigned long long)sec_time_ticks_to_ns(results->callback_ticks));
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+    if (test_churn_threads_no != 0)
+    {
+        printf("Context churn: created %u, deleted %u, failed %u. %u contexts/s (target %u).\n"
+               "Create ns: avg = %llu, max = %llu. Delete ns: avg = %llu, max = %llu.\n",
+               results->contexts_created, results->contexts_deleted, results->churn_failures,
+               results->churn_rate, test_churn_rate * test_churn_threads_no,
+               (unsigned long long)sec_time_ticks_to_ns(results->create_ticks_avg),
+               (unsigned long long)sec_time_ticks_to_ns(results->create_ticks_max),
+               (unsigned long long)sec_time_ticks_to_ns(results->delete_ticks_avg),
+               (unsigned long long)sec_time_ticks_to_ns(results->delete_ticks_max));
+    }
+}
+
+/* Writes the configuration and the results of an iteration as one JSON object on a line */
+/* -x: compares an iteration with SG tables and the next one, with linearization */
+static void print_crossover(const bench_results_t *sg_results, const bench_results_t *lin_results)
+{
+    uint32_t sg_ticks = sg_results->submit_ticks_per_packet + sg_results->poll_ticks_per_packet;
+    uint32_t lin_ticks = lin_results->submit_ticks_per_packet + lin_results->poll_ticks_per_packet;
+
+    printf("Crossover: packets in %u fragments take %u ticks with SG tables, %u ticks with "
+           "linearization. Cheaper with %s.\n",
+           test_num_frags, sg_ticks, lin_ticks,
+           lin_ticks < sg_ticks ? "linearization" : "SG tables");
+}
+
+static void print_results_json(const bench_results_t *results)
+{
+    uint32_t i;
+
+    fprintf(json_out,
+            "{\"benchmark\":\"sec_pdcp\",\"iteration\":%u,"
+            "\"config\":{\"plane\":\"%s\",\"cipher\":\"%s\",\"integrity\":\"%s\","
+            "\"sn_size\":%u,\"direction\":\"%s\",\"protocol\":\"%s\","
+            "\"threads\":%u,\"job_rings\":%u,\"contexts\":%u,\"queue_depth\":%u,"
+            "\"fragments\":%u,\"packets\":%u,\"mode\":\"%s\",\"burst_size\":%u,"
+            "\"context_run\":%u,\"churn_rate\":%u,\"churn_threads\":%u,"
+            "\"offered_pps\":%u,\"arrival\":\"%s\",\"arrival_burst\":%u,"
+            "\"linearization\":%s,\"keystream_cache_budget\":%u,\"cpu_dispatch\":%s,\"sizes\":[",
+            results->iteration,
+            test_user_plane == PDCP_CONTROL_PLANE ? "control" : "data",
+            user_param.enc_alg,
+            test_user_plane == PDCP_CONTROL_PLANE ? user_param.int_alg : "NULL",
+            test_sn_size,
+            test_direction == PDCP_DOWNLINK ? "DL" : "UL",
+            (test_encap && test_decap) ? "both" : test_encap ? "encap" : "decap",
+            test_threads_no, test_job_rings_no, test_contexts_no, test_queue_depth,
+            test_num_frags - 1, test_packets_no, mode_names[test_mode],
+            test_mode == BENCH_MODE_BURST ? test_burst_size : 1,
+            test_ctx_run, test_churn_rate, test_churn_threads_no,
+            test_offered_rate, test_offered_rate ? arrival_names[test_arrival] : "closed",
+            test_arrival == BENCH_ARRIVAL_BURSTY ? test_arrival_burst : 1,
+            results->linearized ? "true" : "false", test_ks_cache_budget,
+            test_cpu_dispatch ? "true" : "false");
+    for (i = 0; i < test_sizes_no; i++)
+    {
+        fprintf(json_out, "%s{\"payload\":%u,\"weight\":%u}",
+                i ? "," : "", test_sizes[i].payload_size, test_sizes[i].weight);
+    }
+    fprintf(json_out,
+            "]},\"results\":{\"time_us\":%llu,\"packets_sent\":%u,\"packets_received\":%u,"
+            "\"errors\":%u,\"context_switches\":%u,\"throughput\":{\"pps\":%u,\"mbps\":%u},"
+            "\"ticks\":{\"source\":\"%s\",\"per_second\":%llu,\"serialized\":%s},"
+            "\"ticks_per_packet\":{\"source\":\"%s\",\"submit\":%u,\"poll\":%u},"
+            "\"ns_per_packet\":{\"submit\":%llu,\"poll\":%llu},"
+            "\"cpu_load_percent\":%u,"
+            "\"latency_ticks\":{\"source\":\"%s\",\"avg\":%u,\"p50\":%u,\"p90\":%u,"
+            "\"p99\":%u,\"p999\":%u,\"max\":%u},"
+            "\"latency_ns\":{\"avg\":%llu,\"p50\":%llu,\"p90\":%llu,"
+            "\"p99\":%llu,\"p999\":%llu,\"max\":%llu}",
+            (unsigned long long)results->time_us,
+            results->packets_sent, results->packets_received, results->errors,
+            results->ctx_switches, results->pps, results->mbps,
+            SEC_TIME_SOURCE, (unsigned long long)sec_time_get_frequency(),
+            test_serialize_ticks ? "true" : "false",
+            SEC_TIME_SOURCE, results->submit_ticks_per_packet, results->poll_ticks_per_packet,
+            (unsigned long long)sec_time_ticks_to_ns(results->submit_ticks_per_packet),
+            (unsigned long long)sec_time_ticks_to_ns(results->poll_ticks_per_packet),
+            results->cpu_load,
+            SEC_TIME_SOURCE, results->latency_avg, results->latency_p50, results->latency_p90,
+            results->latency_p99, results->latency_p999, results->latency_max,
+            (unsigned long long)sec_time_ticks_to_ns(results->latency_avg),
+            (unsigned long long)sec_time_ticks_to_ns(results->latency_p50),
+            (unsigned long long)sec_time_ticks_to_ns(results->latency_p90),
+            (unsigned long long)sec_time_ticks_to_ns(results->latency_p99),
+            (unsigned long long)sec_time_ticks_to_ns(results->latency_p999),
+            (unsigned long long)sec_time_ticks_to_ns(results->latency_max));
+    if (test_offered_rate != 0)
+    {
+        fprintf(json_out, ",\"queue_ns\":{\"avg\":%llu}", (unsigned long long)results->queue_ns_avg);
+    }
+    if (test_verify)
+    {
+        fprintf(json_out, ",\"mismatches\":%u", results->mismatches);
+    }
+#if (SEC_ENABLE_JR_COUNTERS == ON)
+    fprintf(json_out,
+            ",\"driver\":{\"jr_full\":%llu,\"empty_polls\":%llu,\"irq_enables\":%llu,"
+            "\"polls\":%llu,\"packets_polled\":%llu,\"callback_ns\":%llu}",
+            (unsigned long long)results->jr_full,
+            (unsigned long long)results->empty_polls,
+            (unsigned long long)results->irq_enables,
+            (unsigned long long)results->polls,
+            (unsigned long long)results->packets_polled,
+            (unsigned long long)sec_time_ticks_to_ns(results->callback_ticks));
+#endif // (SEC_ENABLE_JR_COUNTERS == ON)
+    if (test_churn_threads_no != 0)
+    {
+        fprintf(json_out,
+                ",\"churn\":{\"created\":%u,\"deleted\":%u,\"failures\":%u,\"contexts_per_second\":%u,"
+                "\"create_ns\":{\"avg\":%llu,\"max\":%llu},\"delete_ns\":{\"avg\":%llu,\"max\":%llu}}",
+                results->contexts_created, results->contexts_deleted, results->churn_failures,
+                results->churn_rate,
+                (unsigned long long)sec_time_ticks_to_ns(results->create_ticks_avg),
+                (unsigned long long)sec_time_ticks_to_ns(results->create_ticks_max),
+                (unsigned long long)sec_time_ticks_to_ns(results->delete_ticks_avg),
+                (unsigned long long)sec_time_ticks_to_ns(results->delete_ticks_max));
+    }
+    fprintf(json_out, "}}\n");
+    fflush(json_out);
+}
+
+/* Parses the packet size distribution: "size" or "size:weight,size:weight,..." */
+static int parse_sizes(const char *sizes)
+{
+    const char *p = sizes;
+    char *end;
+    uint32_t size;
+    uint32_t weight;
+
+    test_sizes_no = 0;
+    test_sizes_weight = 0;
+
+    while (*p != '\0')
+    {
+        if (test_sizes_no == MAX_PACKET_SIZES)
+        {
+            fprintf(stderr, "At most %d packet sizes can be given\n", MAX_PACKET_SIZES);
+            return -1;
+        }
+
+        size = strtoul(p, &end, 10);
+        weight = 1;
+        if (end == p)
+        {
+            return -1;
+        }
+        p = end;
+        if (*p == ':')
+        {
+            weight = strtoul(p + 1, &end, 10);
+            if (end == p + 1 || weight == 0)
+            {
+                return -1;
+            }
+            p = end;
+        }
+        if (*p == ',')
+        {
+            p++;
+        }
+        else if (*p != '\0')
+        {
+            return -1;
+        }
+
+        test_sizes[test_sizes_no].payload_size = size;
+        test_sizes[test_sizes_no].weight = weight;
+        test_sizes_no++;
+        test_sizes_weight += weight;
+    }
+
+    return (test_sizes_no == 0) ? -1 : 0;
+}
+
+static int validate_params(void)
+{
+    uint32_t i;
+    uint32_t max_payload_size;
+    uint32_t largest_payload = 0;
+
+    struct{
+        char alg_name[PATH_MAX];
+        uint32_t alg;
+    }algos[] = {
+        {"SNOW", SEC_ALG_SNOW },
+        {"AES", SEC_ALG_AES },
+        {"NULL", SEC_ALG_NULL }
+    };
+    struct{
+        char test_type_name[PATH_MAX];
+        uint32_t test_type;
+    }test_types[] = {
+        { "CONTROL", PDCP_CONTROL_PLANE },
+        { "CPLANE", PDCP_CONTROL_PLANE },
+        { "DATA", PDCP_DATA_PLANE },
+        { "UPLANE", PDCP_DATA_PLANE }
+    };
+    struct{
+        char dir_name[PATH_MAX];
+        uint32_t dir;
+    }test_dirs[] = {
+        {"UL", PDCP_UPLINK },
+        {"UPLINK", PDCP_UPLINK },
+        {"DL", PDCP_DOWNLINK },
+        {"DOWNLINK", PDCP_DOWNLINK }
+    };
+    struct{
+        char hdr_len_name[PATH_MAX];
+        uint32_t sn_size;
+        uint8_t hdr_len;
+    }test_hdrs[] = {
+        {"SHORT", SEC_PDCP_SN_SIZE_7, 1},
+        {"7", SEC_PDCP_SN_SIZE_7, 1},
+        {"LONG", SEC_PDCP_SN_SIZE_12, 2},
+        {"12", SEC_PDCP_SN_SIZE_12, 2}
+    };
+    /* The modes that can be used with the notification type SEC driver is built with */
+    struct{
+        char mode_name[PATH_MAX];
+        bench_mode_t mode;
+        int notification_type;
+    }test_modes[] = {
+        {"POLL", BENCH_MODE_POLL, SEC_NOTIFICATION_TYPE_POLL},
+        {"BURST", BENCH_MODE_BURST, SEC_NOTIFICATION_TYPE_POLL},
+        {"IRQ", BENCH_MODE_IRQ, SEC_NOTIFICATION_TYPE_IRQ},
+        {"NAPI", BENCH_MODE_NAPI, SEC_NOTIFICATION_TYPE_NAPI}
+    };
+
+    for (i = 0; i < ARRAY_SIZE(algos); i++)
+    {
+        if(!strncasecmp(user_param.int_alg, algos[i].alg_name,PATH_MAX))
+        {
+            test_integrity_algorithm = algos[i].alg;
+        }
+
+        if(!strncasecmp(user_param.enc_alg, algos[i].alg_name,PATH_MAX))
+        {
+            test_cipher_algorithm = algos[i].alg;
+        }
+    }
+
+    for (i = 0; i < ARRAY_SIZE(test_types); i++)
+    {
+        if(!strncasecmp(user_param.test_type, test_types[i].test_type_name, PATH_MAX))
+        {
+            test_user_plane = test_types[i].test_type;
+            break;
+        }
+    }
+    if (test_user_plane == -1)
+    {
+        fprintf(stderr,"Invalid test type: %s\n",user_param.test_type);
+        return -1;
+    }
+
+    if ((test_integrity_algorithm == -1) &&
+        (test_user_plane == PDCP_CONTROL_PLANE))
+    {
+        fprintf(stderr,"Invalid integrity algorithm: %s\n",user_param.int_alg);
+        return -1;
+    }
+
+    if (test_cipher_algorithm == -1)
+    {
+        fprintf(stderr,"Invalid encryption algorithm: %s\n",user_param.enc_alg);
+        return -1;
+    }
+
+    for (i = 0; i<ARRAY_SIZE(test_dirs); i++)
+    {
+        if(!strncasecmp(user_param.direction, test_dirs[i].dir_name,PATH_MAX))
+        {
+            test_direction = test_dirs[i].dir;
+            break;
+        }
+    }
+    if (test_direction == -1)
+    {
+        fprintf(stderr, "Invalid direction: %s\n", user_param.direction);
+        return -1;
+    }
+
+    if (test_user_plane == PDCP_CONTROL_PLANE)
+    {
+        test_pdcp_hdr_len = 1;
+        test_sn_size = SEC_PDCP_SN_SIZE_5;
+        test_icv_len = ICV_LEN;
+    }
+    else
+    {
+        for (i = 0; i<ARRAY_SIZE(test_hdrs); i++)
+        {
+            if(!strncasecmp(user_param.hdr_len, test_hdrs[i].hdr_len_name,PATH_MAX))
+            {
+                test_sn_size = test_hdrs[i].sn_size;
+                test_pdcp_hdr_len = test_hdrs[i].hdr_len;
+                break;
+            }
+        }
+        if (test_pdcp_hdr_len == -1)
+        {
+            fprintf(stderr, "Invalid header length: %s\n", user_param.hdr_len);
+            return -1;
+        }
+        test_icv_len = 0;
+    }
+
+    if (!strcasecmp(user_param.proto_dir, "ENCAP"))
+    {
+        test_encap = 1;
+    }
+    else if (!strcasecmp(user_param.proto_dir, "DECAP"))
+    {
+        test_decap = 1;
+    }
+    else if (!strcasecmp(user_param.proto_dir, "BOTH"))
+    {
+        test_encap = 1;
+        test_decap = 1;
+    }
+    else
+    {
+        fprintf(stderr, "Invalid protocol direction: %s\n", user_param.proto_dir);
+        return -1;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(test_modes); i++)
+    {
+        if (!strncasecmp(user_param.mode, test_modes[i].mode_name, PATH_MAX))
+        {
+            break;
+        }
+    }
+    if (i == ARRAY_SIZE(test_modes))
+    {
+        fprintf(stderr, "Invalid mode: %s\n", user_param.mode);
+        return -1;
+    }
+    if (test_modes[i].notification_type != SEC_NOTIFICATION_TYPE)
+    {
+        fprintf(stderr, "Mode %s requires SEC driver built with SEC_NOTIFICATION_TYPE %s\n",
+                mode_names[test_modes[i].mode],
+                test_modes[i].notification_type == SEC_NOTIFICATION_TYPE_POLL ? "POLL" :
+                test_modes[i].notification_type == SEC_NOTIFICATION_TYPE_IRQ ? "IRQ" : "NAPI");
+        return -1;
+    }
+    test_mode = test_modes[i].mode;
+
+    test_threads_no = user_param.threads_no;
+    test_job_rings_no = user_param.job_rings_no;
+    if (test_job_rings_no == 0 || test_job_rings_no > MAX_SEC_JOB_RINGS)
+    {
+        fprintf(stderr, "Invalid number of job rings %d (must be between 1 and %d)\n",
+                test_job_rings_no, MAX_SEC_JOB_RINGS);
+        return -1;
+    }
+    if (test_threads_no == 0 || test_threads_no > test_job_rings_no)
+    {
+        fprintf(stderr, "Invalid number of threads %d (must be between 1 and the number of job rings)\n",
+                test_threads_no);
+        return -1;
+    }
+
+    test_churn_rate = user_param.churn_rate;
+    test_churn_threads_no = (test_churn_rate != 0) ? user_param.churn_threads_no : 0;
+    if (test_churn_rate != 0 &&
+        (test_churn_threads_no == 0 || test_churn_threads_no > test_job_rings_no))
+    {
+        fprintf(stderr, "Invalid number of control threads %d (must be between 1 and the number of job rings)\n",
+                test_churn_threads_no);
+        return -1;
+    }
+    if (test_churn_rate > GIGA / 1000)
+    {
+        fprintf(stderr, "Invalid churn rate %d (must not exceed %d contexts per second)\n",
+                test_churn_rate, GIGA / 1000);
+        return -1;
+    }
+
+    /* The contexts of the control threads are on the job rings too */
+    test_contexts_no = user_param.contexts_no;
+    if (test_contexts_no < test_job_rings_no ||
+        (test_contexts_no + test_job_rings_no - 1) / test_job_rings_no +
+        (test_churn_threads_no ? CHURN_CONTEXTS_PER_JOB_RING : 0) >
+        SEC_MAX_PDCP_CONTEXTS / test_job_rings_no)
+    {
+        fprintf(stderr, "Invalid number of contexts %d (must be between the number of job rings and %d)\n",
+                test_contexts_no,
+                SEC_MAX_PDCP_CONTEXTS - (test_churn_threads_no ? CHURN_CONTEXTS_PER_JOB_RING * test_job_rings_no : 0));
+        return -1;
+    }
+
+    test_queue_depth = user_param.queue_depth;
+    if (test_queue_depth == 0 || test_queue_depth > MAX_QUEUE_DEPTH)
+    {
+        fprintf(stderr, "Invalid queue depth %d (must be between 1 and %d)\n",
+                test_queue_depth, MAX_QUEUE_DEPTH);
+        return -1;
+    }
+
+    test_packets_no = user_param.packets_no;
+    if (test_packets_no < test_threads_no)
+    {
+        fprintf(stderr, "Invalid number of packets %d\n", test_packets_no);
+        return -1;
+    }
+
+    test_burst_size = (test_mode == BENCH_MODE_BURST) ? user_param.burst_size : 0;
+    if (test_mode == BENCH_MODE_BURST &&
+        (test_burst_size == 0 || test_burst_size > MAX_SUBMIT_BURST))
+    {
+        fprintf(stderr, "Invalid burst size %d (must be between 1 and %d)\n",
+                test_burst_size, MAX_SUBMIT_BURST);
+        return -1;
+    }
+
+    test_ctx_run = user_param.ctx_run;
+    if (test_ctx_run == 0 || test_ctx_run > test_queue_depth)
+    {
+        fprintf(stderr, "Invalid number of packets sent on a context in a row %d "
+                        "(must be between 1 and the queue depth)\n", test_ctx_run);
+        return -1;
+    }
+
+    if( user_param.max_frags > SEC_MAX_SG_FRAGMENTS )
+    {
+        fprintf(stderr,"Invalid number of fragments %d "
+                        "(must not exceed %d)\n",
+                        user_param.max_frags,
+                        SEC_MAX_SG_FRAGMENTS);
+        return -1;
+    }
+    test_num_frags = user_param.max_frags + 1;
+
+    if (parse_sizes(user_param.sizes) != 0)
+    {
+        fprintf(stderr, "Invalid packet sizes: %s\n", user_param.sizes);
+        return -1;
+    }
+
+    /* Make sure that the packets fit in the buffers and can be split in fragments */
+    max_payload_size = PDCP_BUFFER_SIZE - TEST_OFFSET - test_pdcp_hdr_len - test_icv_len;
+    for (i = 0; i < test_sizes_no; i++)
+    {
+        if (test_sizes[i].payload_size == 0 ||
+            test_sizes[i].payload_size > max_payload_size ||
+            test_sizes[i].payload_size + test_pdcp_hdr_len < test_num_frags)
+        {
+            fprintf(stderr, "Invalid payload size %d (must be between 1 and %d, "
+                            "and not less than the number of fragments)\n",
+                            test_sizes[i].payload_size, max_payload_size);
+            return -1;
+        }
+        if (test_sizes[i].payload_size > largest_payload)
+        {
+            largest_payload = test_sizes[i].payload_size;
+        }
+    }
+
+    test_num_iter = user_param.num_iter;
+    test_serialize_ticks = user_param.serialize_ticks;
+
+    test_sg_crossover = user_param.sg_crossover;
+    if (test_sg_crossover)
+    {
+#if (SEC_ENABLE_SCATTER_GATHER == ON) && (SEC_ENABLE_SG_LINEARIZATION == ON)
+        if (test_num_frags == 1 || test_num_iter == 1)
+        {
+            fprintf(stderr, "Comparing SG tables with linearization requires fragments (-f) "
+                            "and at least 2 iterations (-n)\n");
+            return -1;
+        }
+        if (test_pdcp_hdr_len + largest_payload + test_icv_len > SEC_SG_BOUNCE_BUF_SIZE)
+        {
+            fprintf(stderr, "Packets of more than %d bytes are never linearized "
+                            "(bounce buffers are %d bytes)\n",
+                            SEC_SG_BOUNCE_BUF_SIZE, SEC_SG_BOUNCE_BUF_SIZE);
+        }
+#else
+        fprintf(stderr, "Comparing SG tables with linearization requires SEC driver built with "
+                        "SEC_ENABLE_SG_LINEARIZATION ON\n");
+        return -1;
+#endif
+    }
+
+    test_ks_cache_budget = user_param.ks_cache_budget;
+    if (test_ks_cache_budget != 0)
+    {
+#if (SEC_ENABLE_KEYSTREAM_CACHE == ON)
+        if (!test_encap || test_user_plane != PDCP_DATA_PLANE ||
+            (test_cipher_algorithm != SEC_ALG_SNOW && test_cipher_algorithm != SEC_ALG_AES) ||
+            test_num_frags != 1 || largest_payload > SEC_KEYSTREAM_CACHE_MAX_PAYLOAD)
+        {
+            fprintf(stderr, "Keystream cache requires encapsulation contexts, PDCP Data Plane, "
+                            "SNOW or AES encryption, no fragments and payloads of at most %d bytes\n",
+                            SEC_KEYSTREAM_CACHE_MAX_PAYLOAD);
+            return -1;
+        }
+#else
+        fprintf(stderr, "Keystream cache requires SEC driver built with SEC_ENABLE_KEYSTREAM_CACHE ON\n");
+        return -1;
+#endif
+    }
+
+    test_cpu_dispatch = user_param.cpu_dispatch;
+#if (SEC_ENABLE_HYBRID_DISPATCH == OFF) && (SEC_ENABLE_NULL_PASSTHROUGH == OFF)
+    if (test_cpu_dispatch)
+    {
+        fprintf(stderr, "CPU dispatch requires SEC driver built with SEC_ENABLE_HYBRID_DISPATCH "
+                        "or SEC_ENABLE_NULL_PASSTHROUGH ON\n");
+        return -1;
+    }
+#endif
+
+    test_verify = user_param.verify;
+
+    test_offered_rate = user_param.offered_rate;
+    test_arrival_burst = DEFAULT_ARRIVAL_BURST;
+    if (!strcasecmp(user_param.arrival, "POISSON"))
+    {
+        test_arrival = BENCH_ARRIVAL_POISSON;
+    }
+    else if (!strcasecmp(user_param.arrival, "CONSTANT"))
+    {
+        test_arrival = BENCH_ARRIVAL_CONSTANT;
+    }
+    else if (!strncasecmp(user_param.arrival, "BURSTY", strlen("BURSTY")))
+    {
+        test_arrival = BENCH_ARRIVAL_BURSTY;
+        if (user_param.arrival[strlen("BURSTY")] == ':')
+        {
+            test_arrival_burst = atoi(&user_param.arrival[strlen("BURSTY") + 1]);
+        }
+        else if (user_param.arrival[strlen("BURSTY")] != '\0')
+        {
+            test_arrival_burst = 0;
+        }
+        if (test_arrival_burst == 0)
+        {
+            fprintf(stderr, "Invalid arrival burst: %s\n", user_param.arrival);
+            return -1;
+        }
+    }
+    else
+    {
+        fprintf(stderr, "Invalid arrival process: %s\n", user_param.arrival);
+        return -1;
+    }
+    if (test_offered_rate != 0)
+    {
+        // Each thread offers its share of the rate
+        test_arrival_gap = (double)sec_time_get_frequency() * test_threads_no / test_offered_rate;
+    }
+
+    if (user_param.json_file[0] != '\0')
+    {
+        json_out = strcmp(user_param.json_file, "-") ? fopen(user_param.json_file, "a") : stdout;
+        if (json_out == NULL)
+        {
+            perror("Cannot open the JSON file");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void abort_loop()
+{
+    if (json_out != stdout)
+    {
+        printf("Intercepted CTRL-C, wait for running threads to end\n");
+    }
+    test_should_exit = 1;
+}
+
+static void print_usage(char *prg_name)
+{
+    printf("Usage: %s"
+           " [-t test_type] [-l hdr_len] [-d pkt_dir] [-e encryption_alg] [-a integrity_alg]"
+           " [-P protocol_dir] [-T threads] [-j job_rings] [-C contexts] [-q queue_depth]"
+           " [-p packets] [-n iterations] [-s sizes] [-f number_of_fragments]"
+           " [-m mode] [-b burst_size] [-r context_run] [-o json_file] [-S]"
+           " [-c churn_rate] [-k churn_threads] [-R offered_pps] [-A arrival]"
+           " [-x] [-K keystream_cache_budget] [-D] [-V]"
+           "\n"
+           "\n\n\t-t Selects PDCP Control Plane or PDCP User Plane."
+           "\n\t\tValid values: CONTROL or CPLANE, DATA or UPLANE (default)"
+           "\n\n\t-l Selects the header length, for PDCP Data Plane."
+           "\n\t\tValid values: SHORT or 7, LONG or 12 (default)"
+           "\n\n\t-d Selects the packet direction."
+           "\n\t\tValid values: UL or UPLINK, DL or DOWNLINK (default)"
+           "\n\n\t-e Selects the encryption algorithm: SNOW, AES (default) or NULL"
+           "\n\n\t-a Selects the integrity algorithm, for PDCP Control Plane: SNOW, AES (default) or NULL"
+           "\n\n\t-P Selects the processing of the contexts: ENCAP, DECAP or BOTH (default)."
+           "\n\t\tWith BOTH, each job ring has encapsulation and decapsulation contexts."
+           "\n\n\t-T Number of worker threads, at most the number of job rings (default %d)."
+           "\n\t\tJob ring j is used by thread j %% threads, which sends packets and polls on it."
+           "\n\n\t-j Number of job rings, at most %d (default %d)"
+           "\n\n\t-C Number of contexts, spread over the job rings, at most %d (default %d)"
+           "\n\n\t-q Number of packets of a context in flight at the same time, at most %d (default %d)"
+           "\n\n\t-p Number of packets sent in an iteration (default %d)"
+           "\n\n\t-n Number of iterations (default 1). 0 runs until CTRL-C."
+           "\n\n\t-s Packet size distribution: a payload size, or a list of payload:weight."
+           "\n\t\tE.g. 40:4,64:3,1400:3 for 40%% TCP ACKs, 30%% VoLTE frames and 30%% full sized packets."
+           " At most %d sizes (default %d). Sizes do NOT include the header."
+           "\n\n\t-f Number of Scatter-Gather fragments in which the input of encapsulation and"
+           " the output of decapsulation are split (default 0)"
+           "\n\n\t-m Mode of submission and notification:"
+           "\n\t\t\to POLL - sec_process_packet() and busy polling (default)"
+           "\n\t\t\to BURST - sec_process_packet_burst() and busy polling"
+           "\n\t\t\to IRQ - wait for the IRQ of a job ring before polling it."
+           " Requires SEC_NOTIFICATION_TYPE_IRQ."
+           "\n\t\t\to NAPI - poll a job ring while it has results, wait for its IRQ otherwise."
+           " Requires SEC_NOTIFICATION_TYPE_NAPI."
+           "\n\n\t-b Number of packets submitted together in BURST mode, at most %d (default %d)"
+           "\n\n\t-r Number of packets sent on a context before going to the next one (default 1)"
+           "\n\n\t-o Append the results to this file in JSON, one object per line and iteration."
+           "\n\t\tWith -o -, only the JSON results are printed, on the standard output."
+           "\n\n\t-S Serialize the counter readings around the calls to SEC driver, so that"
+           " short calls are measured exactly, at the cost of a pipeline drain per reading."
+           "\n\n\t-c Contexts created and deleted per second by each control thread, while the"
+           " packets are sent (default 0, no control thread)."
+           "\n\t\tEach control thread keeps %d contexts per job ring and replaces the oldest"
+           " one with a new one at this rate."
+           "\n\n\t-k Number of control threads, at most the number of job rings (default %d)."
+           "\n\t\tJob ring j is used by control thread j %% churn_threads."
+           "\n\n\t-R Open loop: packets per second offered by all the threads, whatever the"
+           " notifications. The latency of a packet is measured from its arrival, so it includes"
+           " the wait for a free packet slot or job ring entry (default 0, closed loop)."
+           "\n\n\t-A Arrival process in open loop:"
+           "\n\t\t\to POISSON - exponential times between packets (default)"
+           "\n\t\t\to CONSTANT - the same time between all packets"
+           "\n\t\t\to BURSTY[:n] - bursts of n packets arriving together, Poisson arrivals of"
+           " the bursts (default n = %d)"
+           "\n\n\t-x Alternate the iterations between SG tables (odd iterations) and fragmented"
+           " packets linearized by SEC driver into its bounce buffers (even iterations),"
+           " see sec_set_sg_linearization(). After each pair, prints which one is cheaper."
+           "\n\t\tRequires SEC_ENABLE_SG_LINEARIZATION, fragments (-f) and packets of at most"
+           " SEC_SG_BOUNCE_BUF_SIZE bytes."
+           "\n\n\t-K Enable the keystream cache on the encapsulation contexts and generate keystream"
+           " for up to this number of packets after each packet sent on a context (default 0)."
+           "\n\t\tRequires SEC_ENABLE_KEYSTREAM_CACHE, Data Plane with SNOW or AES, no fragments"
+           " and payloads of at most %d bytes."
+           "\n\n\t-D Let SEC driver process packets on the CPU when this completes them sooner"
+           " than SEC (hybrid dispatcher). With -e NULL, packets are copied on the CPU instead"
+           " of by SEC (NULL pass-through)."
+           "\n\t\tRequires SEC_ENABLE_HYBRID_DISPATCH or SEC_ENABLE_NULL_PASSTHROUGH."
+           "\n\n\t-V Check the output of each packet: decapsulation must give back the plaintext"
+           " that SEC encapsulated before the benchmark, encapsulation the same output as then."
+           "\n\n\n", prg_name,
+           DEFAULT_THREADS_NO, MAX_SEC_JOB_RINGS, DEFAULT_JOB_RINGS_NO,
+           MAX_CONTEXTS, DEFAULT_CONTEXTS_NO, MAX_QUEUE_DEPTH, DEFAULT_QUEUE_DEPTH,
+           DEFAULT_PACKETS_NO, MAX_PACKET_SIZES, DEFAULT_PAYLOAD_SIZE,
+           MAX_SUBMIT_BURST, DEFAULT_BURST_SIZE,
+           CHURN_CONTEXTS_PER_JOB_RING, DEFAULT_CHURN_THREADS_NO, DEFAULT_ARRIVAL_BURST,
+           SEC_KEYSTREAM_CACHE_MAX_PAYLOAD);
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char ** argv)
+{
+    bench_results_t results;
+    bench_results_t sg_results;
+    uint32_t iter;
+    int ret_code = 0;
+    int c;
+
+    /* Defaults of the user options */
+    memset(&user_param, 0x00, sizeof(users_params_t));
+    strcpy(user_param.test_type, "DATA");
+    strcpy(user_param.hdr_len, "12");
+    strcpy(user_param.direction, "DL");
+    strcpy(user_param.enc_alg, "AES");
+    strcpy(user_param.int_alg, "AES");
+    strcpy(user_param.proto_dir, "BOTH");
+    strcpy(user_param.mode, "POLL");
+    strcpy(user_param.arrival, "POISSON");
+    snprintf(user_param.sizes, sizeof(user_param.sizes), "%d", DEFAULT_PAYLOAD_SIZE);
+    user_param.num_iter = 1;
+    user_param.threads_no = DEFAULT_THREADS_NO;
+    user_param.job_rings_no = DEFAULT_JOB_RINGS_NO;
+    user_param.contexts_no = DEFAULT_CONTEXTS_NO;
+    user_param.queue_depth = DEFAULT_QUEUE_DEPTH;
+    user_param.packets_no = DEFAULT_PACKETS_NO;
+    user_param.burst_size = DEFAULT_BURST_SIZE;
+    user_param.ctx_run = 1;
+    user_param.churn_threads_no = DEFAULT_CHURN_THREADS_NO;
+
+    while ((c = getopt (argc, argv, "a:e:t:d:l:f:s:n:P:T:j:C:q:p:m:b:r:o:Sc:k:R:A:xK:DVh")) != -1)
+    {
+        switch (c)
+        {
+            case 'a':
+                strncpy(user_param.int_alg, optarg, sizeof(user_param.int_alg) - 1);
+                break;
+            case 'e':
+                strncpy(user_param.enc_alg, optarg, sizeof(user_param.enc_alg) - 1);
+                break;
+            case 't':
+                strncpy(user_param.test_type, optarg, sizeof(user_param.test_type) - 1);
+                break;
+            case 'd':
+                strncpy(user_param.direction, optarg, sizeof(user_param.direction) - 1);
+                break;
+            case 'l':
+                strncpy(user_param.hdr_len, optarg, sizeof(user_param.hdr_len) - 1);
+                break;
+            case 'f':
+                user_param.max_frags = atoi(optarg);
+                break;
+            case 's':
+                strncpy(user_param.sizes, optarg, sizeof(user_param.sizes) - 1);
+                break;
+            case 'n':
+                user_param.num_iter = atoi(optarg);
+                break;
+            case 'P':
+                strncpy(user_param.proto_dir, optarg, sizeof(user_param.proto_dir) - 1);
+                break;
+            case 'T':
+                user_param.threads_no = atoi(optarg);
+                break;
+            case 'j':
+                user_param.job_rings_no = atoi(optarg);
+                break;
+            case 'C':
+                user_param.contexts_no = atoi(optarg);
+                break;
+            case 'q':
+                user_param.queue_depth = atoi(optarg);
+                break;
+            case 'p':
+                user_param.packets_no = atoi(optarg);
+                break;
+            case 'm':
+                strncpy(user_param.mode, optarg, sizeof(user_param.mode) - 1);
+                break;
+            case 'b':
+                user_param.burst_size = atoi(optarg);
+                break;
+            case 'r':
+                user_param.ctx_run = atoi(optarg);
+                break;
+            case 'o':
+                strncpy(user_param.json_file, optarg, sizeof(user_param.json_file) - 1);
+                break;
+            case 'S':
+                user_param.serialize_ticks = 1;
+                break;
+            case 'c':
+                user_param.churn_rate = atoi(optarg);
+                break;
+            case 'k':
+                user_param.churn_threads_no = atoi(optarg);
+                break;
+            case 'R':
+                user_param.offered_rate = atoi(optarg);
+                break;
+            case 'A':
+                strncpy(user_param.arrival, optarg, sizeof(user_param.arrival) - 1);
+                break;
+            case 'x':
+                user_param.sg_crossover = 1;
+                break;
+            case 'K':
+                user_param.ks_cache_budget = atoi(optarg);
+                break;
+            case 'D':
+                user_param.cpu_dispatch = 1;
+                break;
+            case 'V':
+                user_param.verify = 1;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            case '?':
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if( validate_params() )
+    {
+        fprintf(stderr,"Error in options!\n");
+        print_usage(argv[0]);
+        return 1;
+    }
+#ifdef USDPAA
+    dma_mem_generic = dma_mem_create(DMA_MAP_FLAG_ALLOC, NULL, DMAMEM_SIZE);
+    if (!dma_mem_generic) {
+        printf("ERROR on dma_mem_create");
+        return -1;
+    }
+#else
+    /* Init FSL USMMGR */
+    g_usmmgr = fsl_usmmgr_init();
+    if(g_usmmgr == NULL){
+        perror("ERROR on fsl_usmmgr_init :");
+        return -1;
+    }
+#endif
+    /* Install CTRL-C handler */
+    signal(SIGINT, abort_loop);
+
+    /* Find the frequency of the counter now, it may take a calibration */
+    sec_time_get_frequency();
+
+    /////////////////////////////////////////////////////////////////////
+    // 1. Initialize SEC environment
+    /////////////////////////////////////////////////////////////////////
+    ret_code = setup_sec_environment();
+    if (ret_code != 0)
+    {
+        return 1;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+    // 2. Randomize input and keys, create the contexts and their packets
+    /////////////////////////////////////////////////////////////////////
+    generate_test_vectors();
+
+    if (test_decap)
+    {
+        ret_code = generate_decap_vectors();
+    }
+    if (ret_code == 0)
+    {
+        ret_code = create_contexts();
+    }
+
+    /////////////////////////////////////////////////////////////////////
+    // 3. Run the iterations
+    /////////////////////////////////////////////////////////////////////
+    for (iter = 1; ret_code == 0 && (test_num_iter == 0 || iter <= test_num_iter) && !test_should_exit; iter++)
+    {
+        ret_code = run_iteration(iter, &results);
+        if (ret_code != 0)
+        {
+            break;
+        }
+
+        if (json_out != stdout)
+        {
+            print_results(&results);
+            if (results.linearized)
+            {
+                print_crossover(&sg_results, &results);
+            }
+        }
+        if (json_out != NULL)
+        {
+            print_results_json(&results);
+        }
+        sg_results = results;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+    // 4. Cleanup SEC environment
+    /////////////////////////////////////////////////////////////////////
+    if (cleanup_sec_environment() != 0)
+    {
+        ret_code = 1;
+    }
+    if (json_out != NULL && json_out != stdout)
+    {
+        fclose(json_out);
+    }
+
+    return ret_code ? 1 : 0;
+}
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,4 @@
-/* Copyright (c) 2011 Freescale Semiconductor, Inc.
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -30,8 +30,8 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef TEST_BENCHMARK_TWO_THREADS
-#define TEST_BENCHMARK_TWO_THREADS
+#ifndef TEST_BENCHMARK
+#define TEST_BENCHMARK
 
 /*==============================================================================
                                 INCLUDE FILES
@@ -49,19 +49,29 @@
 /******************************************************************************/
 
 //////////////////////////////////////////////////////////////////////////////
-// Number of PDCP contexts options
+// Limits of the command line options
 //////////////////////////////////////////////////////////////////////////////
 
-// The number of PDCP contexts used. Each DRB will have 2 PDCP contexts, one for each direction.
-// This is the number of PDCP context on one direction:DL/UL.
-// The total number of PDCP contexts used is PDCP_CONTEXT_NUMBER * 2.
-#define PDCP_CONTEXT_NUMBER         (UE_NUMBER * DRB_PER_UE)
-//#define PDCP_CONTEXT_NUMBER         1
+// Maximum number of worker threads. Each thread is producer and consumer
+// on its own job rings, so there are at most as many threads as job rings.
+#define MAX_THREADS                 MAX_SEC_JOB_RINGS
 
+// Maximum number of PDCP contexts, for all the job rings
+#define MAX_CONTEXTS                SEC_MAX_PDCP_CONTEXTS
 
-// Enable this if test should run in infinite loop.
-// Use this for measurements of CPU load with <top> tool from Linux.
-//#define TEST_TYPE_INFINITE_LOOP
+// Maximum number of packets of a context in flight at the same time
+#define MAX_QUEUE_DEPTH             64
+
+// Maximum number of payload sizes in the packet size distribution
+#define MAX_PACKET_SIZES            8
+
+// Maximum number of packets submitted with one call of sec_process_packet_burst()
+#define MAX_SUBMIT_BURST            256
+
+// Maximum number of control threads creating and deleting contexts. The contexts of
+// a job ring are created and deleted by one thread, so there are at most as many
+// control threads as job rings.
+#define MAX_CHURN_THREADS           MAX_SEC_JOB_RINGS
 
 //////////////////////////////////////////////////////////////////////////////
 // Logging Options
@@ -75,30 +85,70 @@
 // Enable test application logging
 // #define test_printf(format, ...) printf("%s(): " format "\n", __FUNCTION__,  ##__VA_ARGS__)
 // Enable test application logging for clock cycle measurements
-// #define profile_printf(format, ...) printf("%s(): " format "\n", __FUNCTION__,  ##__VA_ARGS__)
-
+//#define profile_printf(format, ...) printf("%s(): " format "\n", __FUNCTION__,  ##__VA_ARGS__)
 
 /******************************************************************************/
 // END OF CONFIGURATION SECTION
 /******************************************************************************/
 
-
 /*==============================================================================
                                     ENUMS
 ==============================================================================*/
+/* How the worker threads submit packets and retrieve the results */
+typedef enum bench_mode_e
+{
+    BENCH_MODE_POLL = 0,    /* sec_process_packet_hfn_ov() and busy polling */
+    BENCH_MODE_BURST,       /* sec_process_packet_burst() and busy polling */
+    BENCH_MODE_IRQ,         /* wait for the job ring IRQ before polling */
+    BENCH_MODE_NAPI         /* poll while there are results, wait for the IRQ otherwise */
+}bench_mode_t;
+
+/* When the packets arrive, in open loop. In closed loop, a packet is sent as soon
+ * as a packet slot is free. */
+typedef enum bench_arrival_e
+{
+    BENCH_ARRIVAL_POISSON = 0,  /* exponential inter-arrival times */
+    BENCH_ARRIVAL_CONSTANT,     /* the same time between all packets */
+    BENCH_ARRIVAL_BURSTY        /* bursts of packets arriving together, Poisson arrivals of the bursts */
+}bench_arrival_t;
 
 /*==============================================================================
                          STRUCTURES AND OTHER TYPEDEFS
 ==============================================================================*/
+/* A payload size of the packet size distribution, with its weight */
+typedef struct packet_size_s{
+    uint32_t payload_size;
+    uint32_t weight;
+}packet_size_t;
+
 typedef struct user_params_s{
     char int_alg[PATH_MAX];
     char enc_alg[PATH_MAX];
     char direction[PATH_MAX];
     char hdr_len[PATH_MAX];
     char test_type[PATH_MAX];
-    uint8_t max_frags;
-    uint16_t payload_size;
+    char proto_dir[PATH_MAX];
+    char mode[PATH_MAX];
+    char sizes[PATH_MAX];
+    char json_file[PATH_MAX];
+    char arrival[PATH_MAX];
+    uint16_t max_frags;
     uint32_t num_iter;
+    uint32_t threads_no;
+    uint32_t job_rings_no;
+    uint32_t contexts_no;
+    uint32_t queue_depth;
+    uint32_t packets_no;
+    uint32_t burst_size;
+    uint32_t ctx_run;
+    uint32_t serialize_ticks;
+    uint32_t churn_rate;
+    uint32_t churn_threads_no;
+    uint32_t offered_rate;
+    uint32_t sg_crossover;
+    uint32_t ks_cache_budget;
+    uint32_t cpu_dispatch;
+    uint32_t verify;
     uint32_t opt_mask;
 }users_params_t;
 /*==============================================================================
@@ -116,4 +166,4 @@ typedef struct user_params_s{
 /*============================================================================*/
 
 
-#endif  /* TEST_BENCHMARK_TWO_THREADS */
+#endif  /* TEST_BENCHMARK */
@@ -131,7 +131,7 @@ static uint32_t test_hfn[] = {
     0x000fa557,
 };
 
-static uint32_t test_hfn_threshold[] = {
+static uint32_t __attribute__((unused)) test_hfn_threshold[] = {
     /* RLC w/KASUMI f8 encryption UPLINK UNACKNOWLEDGED MODE*/
     0x000fa558,
     /* RLC w/KASUMI f8 encryption DOWNLINK UNACKNOWLEDGED MODE*/
@@ -289,7 +289,7 @@ static uint32_t test_hfn[] = {
     0x01930275
 };
 
-static uint32_t test_hfn_threshold[] = {
+static const uint32_t __attribute__((unused)) test_hfn_threshold[] = {
     /* Control Plane w/AES CTR encryption + AES CMAC integrity UPLINK */
     0x01ca0b19,
     /* Control Plane w/AES CTR encryption + AES CMAC integrity DOWNLINK */
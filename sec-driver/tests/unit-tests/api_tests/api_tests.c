@@ -441,6 +441,34 @@ static void test_sec_init_invalid_params(void)
     ////////////////////////////////////
     ////////////////////////////////////
 
+    // Required DMA memory size. Invalid params
+    assert_equal(sec_get_required_dma_size(NULL, JOB_RING_NUMBER), 0);
+    assert_equal(sec_get_required_dma_size(&sec_config_data, 0), 0);
+    assert_equal(sec_get_required_dma_size(&sec_config_data, MAX_SEC_JOB_RINGS + 1), 0);
+
+    // Never more than the maximum reserved by SEC_DMA_MEMORY_SIZE
+    for (i = 1; i <= MAX_SEC_JOB_RINGS; i++)
+    {
+        assert_not_equal(sec_get_required_dma_size(&sec_config_data, i), 0);
+        assert_true_with_message(sec_get_required_dma_size(&sec_config_data, i) <= SEC_DMA_MEMORY_SIZE,
+                                 "ERROR on sec_get_required_dma_size: %d job rings need more than SEC_DMA_MEMORY_SIZE",
+                                 i);
+    }
+
+    // Init sec driver. Invalid sec_config_data.memory_area_size param: smaller than required
+    sec_config_data.memory_area_size =
+        sec_get_required_dma_size(&sec_config_data, JOB_RING_NUMBER) - L1_CACHE_BYTES;
+
+    ret = sec_init(&sec_config_data, JOB_RING_NUMBER, &job_ring_descriptors);
+    assert_equal_with_message(ret, SEC_INVALID_INPUT_PARAM,
+                              "ERROR on sec_init: expected ret[%d]. actual ret[%d]",
+                              SEC_INVALID_INPUT_PARAM, ret);
+    // Restore memory_area_size: memory_area has SEC_DMA_MEMORY_SIZE bytes
+    sec_config_data.memory_area_size = 0;
+
+    ////////////////////////////////////
+    ////////////////////////////////////
+
     // Init sec driver. Invalid job_rings_no param
     ret = sec_init(&sec_config_data, 5, &job_ring_descriptors);
     assert_equal_with_message(ret, SEC_INVALID_INPUT_PARAM,
@@ -1656,6 +1684,160 @@ static void test_sec_poll_job_ring_invalid_params(void)
 	assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_release: ret = %d", ret);
 }
 
+static void test_sec_get_stats_ext(void)
+{
+    int ret = 0;
+    uint32_t packets_out = 0;
+    sec_job_ring_handle_t jr_handle;
+    sec_statistics_ext_t stats;
+
+    printf("Running test %s\n", __FUNCTION__);
+
+    // Init sec driver. No invalid param.
+    ret = sec_init(&sec_config_data, JOB_RING_NUMBER, &job_ring_descriptors);
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on sec_init: expected ret[%d]. actual ret[%d]",
+                              SEC_SUCCESS, ret);
+    jr_handle = job_ring_descriptors[0].job_ring_handle;
+
+    // Invalid params
+    ret = sec_get_stats_ext(jr_handle, NULL);
+    assert_equal_with_message(ret, SEC_INVALID_INPUT_PARAM,
+                              "ERROR on sec_get_stats_ext: expected ret[%d]. actual ret[%d]",
+                              SEC_INVALID_INPUT_PARAM, ret);
+
+    stats.size = offsetof(sec_statistics_ext_t, packets_submitted);
+    ret = sec_get_stats_ext(jr_handle, &stats);
+    assert_equal_with_message(ret, SEC_INVALID_INPUT_PARAM,
+                              "ERROR on sec_get_stats_ext: expected ret[%d]. actual ret[%d]",
+                              SEC_INVALID_INPUT_PARAM, ret);
+
+    // Nothing submitted yet
+    memset(&stats, 0xFF, sizeof(stats));
+    stats.size = sizeof(stats);
+    ret = sec_get_stats_ext(jr_handle, &stats);
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on sec_get_stats_ext: expected ret[%d]. actual ret[%d]",
+                              SEC_SUCCESS, ret);
+    assert_equal(stats.version, SEC_STATISTICS_EXT_VERSION);
+    assert_equal(stats.size, sizeof(stats));
+    assert_equal(stats.packets_submitted, 0);
+    assert_equal(stats.packets_completed, 0);
+    assert_equal(stats.jr_full, 0);
+    assert_equal(stats.empty_polls, 0);
+    assert_equal(stats.polls, 0);
+    assert_equal(stats.callback_ticks, 0);
+
+    // An empty poll is counted
+    ret = sec_poll_job_ring(jr_handle, SEC_JOB_RING_SIZE, &packets_out);
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on sec_poll_job_ring: expected ret[%d]. actual ret[%d]",
+                              SEC_SUCCESS, ret);
+    assert_equal(packets_out, 0);
+
+    stats.size = sizeof(stats);
+    ret = sec_get_stats_ext(jr_handle, &stats);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(stats.empty_polls, 1);
+    assert_equal(stats.polls, 1);
+    assert_equal(stats.poll_weight, 0);
+
+    // release sec driver
+    ret = sec_release();
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_release: ret = %d", ret);
+}
+
+static void test_sec_get_context_stats(void)
+{
+    int ret = 0;
+    uint32_t cursor = 0;
+    uint32_t stats_no = 0;
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+    uint32_t packets_out = 0;
+    uint32_t found = 0;
+    uint32_t i;
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+    sec_job_ring_handle_t jr_handle;
+    sec_context_handle_t ctx_handle = NULL;
+    sec_context_stats_t ctx_stats[4];
+
+    printf("Running test %s\n", __FUNCTION__);
+
+    // Init sec driver. No invalid param.
+    ret = sec_init(&sec_config_data, JOB_RING_NUMBER, &job_ring_descriptors);
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on sec_init: expected ret[%d]. actual ret[%d]",
+                              SEC_SUCCESS, ret);
+    jr_handle = job_ring_descriptors[0].job_ring_handle;
+
+    ret = sec_create_pdcp_context(jr_handle, &ctx_info, &ctx_handle);
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on sec_create_pdcp_context: expected ret[%d]. actual ret[%d]",
+                              SEC_SUCCESS, ret);
+
+#if (SEC_ENABLE_CONTEXT_STATS == ON)
+    // Invalid params
+    ret = sec_get_context_stats(NULL, &ctx_stats[0]);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = sec_get_context_stats(ctx_handle, NULL);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = sec_get_contexts_stats(NULL, ctx_stats, 4, &stats_no);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+
+    // Nothing notified yet
+    ret = sec_get_context_stats(ctx_handle, &ctx_stats[0]);
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on sec_get_context_stats: expected ret[%d]. actual ret[%d]",
+                              SEC_SUCCESS, ret);
+    assert_equal(ctx_stats[0].sec_ctx_handle, ctx_handle);
+    assert_equal(ctx_stats[0].jr_handle, jr_handle);
+    assert_equal(ctx_stats[0].packets, 0);
+    assert_equal(ctx_stats[0].packets_in_flight, 0);
+
+    // One packet submitted and notified
+    send_packets(ctx_handle, 1, SEC_SUCCESS);
+    usleep(1000);
+    ret = sec_poll_job_ring(jr_handle, SEC_JOB_RING_SIZE - 1, &packets_out);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(packets_out, 1);
+
+    ret = sec_get_context_stats(ctx_handle, &ctx_stats[0]);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(ctx_stats[0].packets, 1);
+    assert_equal(ctx_stats[0].icv_failures, 0);
+    assert_equal(ctx_stats[0].packets_in_flight, 0);
+    assert_equal(ctx_stats[0].retiring, 0);
+
+    // The context is found by the iterator, a few entries at a time
+    do
+    {
+        ret = sec_get_contexts_stats(&cursor, ctx_stats, 4, &stats_no);
+        assert_equal(ret, SEC_SUCCESS);
+        for (i = 0; i < stats_no; i++)
+        {
+            if (ctx_stats[i].sec_ctx_handle == ctx_handle)
+            {
+                found++;
+                assert_equal(ctx_stats[i].packets, 1);
+            }
+        }
+    }while(stats_no == 4);
+    assert_equal(found, 1);
+#else
+    ret = sec_get_context_stats(ctx_handle, &ctx_stats[0]);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = sec_get_contexts_stats(&cursor, ctx_stats, 4, &stats_no);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+#endif // (SEC_ENABLE_CONTEXT_STATS == ON)
+
+    ret = sec_delete_pdcp_context(ctx_handle);
+    assert_equal(ret, SEC_SUCCESS);
+
+    // release sec driver
+    ret = sec_release();
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_release: ret = %d", ret);
+}
+
 static void test_poll_job_ring_scenarios(void)
 {
     int ret = 0;
@@ -2489,6 +2671,8 @@ static TestSuite * uio_tests()
     add_test(suite, test_sec_process_packet_invalid_params);
     add_test(suite, test_sec_poll_invalid_params);
     add_test(suite, test_sec_poll_job_ring_invalid_params);
+    add_test(suite, test_sec_get_stats_ext);
+    add_test(suite, test_sec_get_context_stats);
     add_test(suite, test_poll_job_ring_scenarios);
     add_test(suite, test_poll_scenarios);
     add_test(suite, test_sec_get_status_message);
@@ -2536,6 +2720,8 @@ int main(int argc, char *argv[])
     run_single_test(suite, "test_sec_process_packet_invalid_params", reporter);
     run_single_test(suite, "test_sec_poll_invalid_params", reporter);
     run_single_test(suite, "test_sec_poll_job_ring_invalid_params", reporter);
+    run_single_test(suite, "test_sec_get_stats_ext", reporter);
+    run_single_test(suite, "test_sec_get_context_stats", reporter);
     run_single_test(suite, "test_poll_job_ring_scenarios", reporter);
     run_single_test(suite, "test_poll_scenarios", reporter);
     run_single_test(suite, "test_sec_get_status_message", reporter);
@@ -0,0 +1,389 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "fsl_sec.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <malloc.h> // memalign...
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Number of buffers in the memory area used by the tests */
+#define TEST_BUF_POOL_BUFS_NO       256
+
+/** Headroom of the buffers */
+#define TEST_BUF_POOL_HEADROOM      64
+
+/** Data room of the buffers */
+#define TEST_BUF_POOL_DATA_ROOM     1500
+
+/** Tailroom of the buffers */
+#define TEST_BUF_POOL_TAILROOM      16
+
+/** Size of a buffer: headroom + data room + tailroom, rounded up to a cacheline */
+#define TEST_BUF_POOL_BUF_SIZE      \
+    ((TEST_BUF_POOL_HEADROOM + TEST_BUF_POOL_DATA_ROOM + TEST_BUF_POOL_TAILROOM + \
+      L1_CACHE_BYTES - 1) & ~(L1_CACHE_BYTES - 1))
+
+/** Size of the memory area used by the tests */
+#define TEST_BUF_POOL_MEM_SIZE      (TEST_BUF_POOL_BUFS_NO * TEST_BUF_POOL_BUF_SIZE)
+
+/** Physical address returned for the start of the memory area */
+#define TEST_BUF_POOL_PHYS_ADDR     0x10000000
+
+/** Number of threads used by the multithreaded test */
+#define TEST_BUF_POOL_THREADS_NO    4
+
+/** Number of buffers allocated at once by each thread */
+#define TEST_BUF_POOL_BURST         (TEST_BUF_POOL_BUFS_NO / (2 * TEST_BUF_POOL_THREADS_NO))
+
+/** Number of allocation rounds done by each thread */
+#define TEST_BUF_POOL_ROUNDS        10000
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static uint8_t *test_buf_mem = NULL;
+
+static sec_buf_pool_t *test_pool = NULL;
+
+/** Set by the threads of the multithreaded test when they find a buffer owned by another thread */
+static volatile int test_mt_errors = 0;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+static dma_addr_t test_vtop(void *v)
+{
+    return TEST_BUF_POOL_PHYS_ADDR + ((uint8_t*)v - test_buf_mem);
+}
+
+static void create_test_pool(void)
+{
+    sec_buf_pool_config_t config;
+    int ret = 0;
+
+    config.memory_area = test_buf_mem;
+    config.memory_area_size = TEST_BUF_POOL_MEM_SIZE;
+    config.headroom = TEST_BUF_POOL_HEADROOM;
+    config.data_room = TEST_BUF_POOL_DATA_ROOM;
+    config.tailroom = TEST_BUF_POOL_TAILROOM;
+    config.vtop = test_vtop;
+
+    ret = sec_buf_pool_create(&config, &test_pool);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_buf_pool_create: ret = %d!", ret);
+}
+
+static void test_buf_pool_layout(void)
+{
+    sec_packet_t packets[2];
+    uint8_t *buf = NULL;
+    int ret = 0;
+
+    create_test_pool();
+    assert_equal(sec_buf_pool_get_free_no(test_pool), TEST_BUF_POOL_BUFS_NO);
+
+    ret = sec_buf_pool_alloc_bulk(test_pool, packets, 2);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_buf_pool_alloc_bulk: ret = %d!", ret);
+    assert_equal(sec_buf_pool_get_free_no(test_pool), TEST_BUF_POOL_BUFS_NO - 2);
+
+    // The first buffers are at the start of the memory area, one buffer size apart
+    assert_equal_with_message(packets[0].address, TEST_BUF_POOL_PHYS_ADDR,
+                              "ERROR on sec_buf_pool_alloc_bulk: first buffer at 0x%x!",
+                              (uint32_t)packets[0].address);
+    assert_equal(packets[1].address, TEST_BUF_POOL_PHYS_ADDR + TEST_BUF_POOL_BUF_SIZE);
+    assert_equal(packets[0].offset, TEST_BUF_POOL_HEADROOM);
+    assert_equal(packets[0].tail_offset, TEST_BUF_POOL_HEADROOM + TEST_BUF_POOL_DATA_ROOM);
+    assert_equal(packets[0].length, 0);
+    assert_equal(packets[0].num_fragments, 0);
+
+    // O(1) translations in both directions
+    buf = sec_buf_pool_ptov(test_pool, packets[1].address);
+    assert_equal_with_message(buf, test_buf_mem + TEST_BUF_POOL_BUF_SIZE,
+                              "ERROR on sec_buf_pool_ptov: got %p!", buf);
+    assert_equal(sec_buf_pool_vtop(test_pool, buf + packets[1].offset),
+                 packets[1].address + TEST_BUF_POOL_HEADROOM);
+
+    sec_buf_pool_free_bulk(test_pool, packets, 2);
+    assert_equal(sec_buf_pool_get_free_no(test_pool), TEST_BUF_POOL_BUFS_NO);
+
+    sec_buf_pool_flush_cache(test_pool);
+    sec_buf_pool_destroy(test_pool);
+}
+
+static void test_buf_pool_invalid_config(void)
+{
+    sec_buf_pool_config_t config;
+    sec_buf_pool_t *pool = NULL;
+    int ret = 0;
+
+    config.memory_area = test_buf_mem + 1;
+    config.memory_area_size = TEST_BUF_POOL_MEM_SIZE - 1;
+    config.headroom = TEST_BUF_POOL_HEADROOM;
+    config.data_room = TEST_BUF_POOL_DATA_ROOM;
+    config.tailroom = TEST_BUF_POOL_TAILROOM;
+    config.vtop = test_vtop;
+
+    ret = sec_buf_pool_create(&config, &pool);
+    assert_equal_with_message(ret, SEC_INVALID_INPUT_PARAM,
+                              "ERROR on sec_buf_pool_create: unaligned area accepted, ret = %d!", ret);
+
+    // Memory area too small for one buffer
+    config.memory_area = test_buf_mem;
+    config.memory_area_size = TEST_BUF_POOL_BUF_SIZE - 1;
+    ret = sec_buf_pool_create(&config, &pool);
+    assert_equal_with_message(ret, SEC_INVALID_INPUT_PARAM,
+                              "ERROR on sec_buf_pool_create: too small area accepted, ret = %d!", ret);
+
+    ret = sec_buf_pool_create(NULL, &pool);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+}
+
+static void test_buf_pool_exhaustion(void)
+{
+    sec_packet_t packets[TEST_BUF_POOL_BUFS_NO];
+    sec_packet_t extra;
+    int ret = 0;
+    int i = 0;
+
+    create_test_pool();
+
+    // Drain the pool in small bursts, so that the cache of this thread is used
+    for (i = 0; i < TEST_BUF_POOL_BUFS_NO; i += 8)
+    {
+        ret = sec_buf_pool_alloc_bulk(test_pool, &packets[i], 8);
+        assert_equal_with_message(ret, SEC_SUCCESS,
+                                  "ERROR on sec_buf_pool_alloc_bulk: burst %d failed, ret = %d!",
+                                  i / 8, ret);
+    }
+    assert_equal(sec_buf_pool_get_free_no(test_pool), 0);
+
+    ret = sec_buf_pool_alloc_bulk(test_pool, &extra, 1);
+    assert_equal_with_message(ret, SEC_OUT_OF_MEMORY,
+                              "ERROR on sec_buf_pool_alloc_bulk: allocated from an empty pool!");
+
+    // All the buffers are distinct
+    for (i = 1; i < TEST_BUF_POOL_BUFS_NO; i++)
+    {
+        assert_not_equal(packets[i].address, packets[i - 1].address);
+    }
+
+    // An allocation that cannot be fully satisfied takes nothing
+    sec_buf_pool_free_bulk(test_pool, packets, 4);
+    ret = sec_buf_pool_alloc_bulk(test_pool, packets, 5);
+    assert_equal(ret, SEC_OUT_OF_MEMORY);
+    assert_equal(sec_buf_pool_get_free_no(test_pool), 4);
+
+    sec_buf_pool_free_bulk(test_pool, &packets[4], TEST_BUF_POOL_BUFS_NO - 4);
+    assert_equal(sec_buf_pool_get_free_no(test_pool), TEST_BUF_POOL_BUFS_NO);
+
+    // A buffer not from the pool is ignored
+    extra.address = TEST_BUF_POOL_PHYS_ADDR + TEST_BUF_POOL_MEM_SIZE;
+    sec_buf_pool_free_bulk(test_pool, &extra, 1);
+    assert_equal(sec_buf_pool_get_free_no(test_pool), TEST_BUF_POOL_BUFS_NO);
+
+    // A buffer can be allocated in one burst larger than the cache
+    ret = sec_buf_pool_alloc_bulk(test_pool, packets, TEST_BUF_POOL_BUFS_NO);
+    assert_equal(ret, SEC_SUCCESS);
+    sec_buf_pool_free_bulk(test_pool, packets, TEST_BUF_POOL_BUFS_NO);
+
+    sec_buf_pool_flush_cache(test_pool);
+    sec_buf_pool_destroy(test_pool);
+}
+
+static void* buf_pool_thread_routine(void *arg)
+{
+    sec_packet_t packets[TEST_BUF_POOL_BURST];
+    uint32_t tag = (uint32_t)(uintptr_t)arg;
+    uint32_t *buf = NULL;
+    int ret = 0;
+    int i = 0;
+    int j = 0;
+
+    for (i = 0; i < TEST_BUF_POOL_ROUNDS; i++)
+    {
+        ret = sec_buf_pool_alloc_bulk(test_pool, packets, TEST_BUF_POOL_BURST);
+        if (ret != SEC_SUCCESS)
+        {
+            // Other threads may hold buffers in their caches
+            continue;
+        }
+
+        // Mark the buffers as owned by this thread
+        for (j = 0; j < TEST_BUF_POOL_BURST; j++)
+        {
+            buf = sec_buf_pool_ptov(test_pool, packets[j].address + packets[j].offset);
+            *buf = tag;
+        }
+        // Check that no other thread got the same buffers meanwhile
+        for (j = 0; j < TEST_BUF_POOL_BURST; j++)
+        {
+            buf = sec_buf_pool_ptov(test_pool, packets[j].address + packets[j].offset);
+            if (*buf != tag)
+            {
+                test_mt_errors = 1;
+            }
+        }
+
+        sec_buf_pool_free_bulk(test_pool, packets, TEST_BUF_POOL_BURST);
+    }
+
+    sec_buf_pool_flush_cache(test_pool);
+
+    return NULL;
+}
+
+static void test_buf_pool_multithreaded(void)
+{
+    pthread_t threads[TEST_BUF_POOL_THREADS_NO];
+    int ret = 0;
+    int i = 0;
+
+    create_test_pool();
+    test_mt_errors = 0;
+
+    for (i = 0; i < TEST_BUF_POOL_THREADS_NO; i++)
+    {
+        ret = pthread_create(&threads[i], NULL, buf_pool_thread_routine, (void*)(uintptr_t)(i + 1));
+        assert_equal_with_message(ret, 0, "ERROR on pthread_create: ret = %d!", ret);
+    }
+    for (i = 0; i < TEST_BUF_POOL_THREADS_NO; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    assert_equal_with_message(test_mt_errors, 0,
+                              "ERROR: the same buffer was allocated by two threads!");
+
+    // After each thread flushed its cache, all the buffers are back in the pool
+    assert_equal_with_message(sec_buf_pool_get_free_no(test_pool), TEST_BUF_POOL_BUFS_NO,
+                              "ERROR: %d buffers free after all threads finished!",
+                              sec_buf_pool_get_free_no(test_pool));
+
+    sec_buf_pool_destroy(test_pool);
+}
+
+static TestSuite * buf_pool_tests()
+{
+    /* create test suite */
+    TestSuite * suite = create_test_suite();
+
+    /* setup/teardown functions to be called before/after each unit test */
+//    setup(suite, tests_setup);
+//    teardown(suite, tests_teardown);
+
+    /* start adding unit tests */
+    add_test(suite, test_buf_pool_layout);
+    add_test(suite, test_buf_pool_invalid_config);
+    add_test(suite, test_buf_pool_exhaustion);
+    add_test(suite, test_buf_pool_multithreaded);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    test_buf_mem = memalign(L1_CACHE_BYTES, TEST_BUF_POOL_MEM_SIZE);
+    assert(test_buf_mem != NULL);
+
+    /* create test suite */
+    TestSuite * suite = buf_pool_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_buf_pool_layout", reporter);
+    run_single_test(suite, "test_buf_pool_invalid_config", reporter);
+    run_single_test(suite, "test_buf_pool_exhaustion", reporter);
+    run_single_test(suite, "test_buf_pool_multithreaded", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    free(test_buf_mem);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,236 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "sec_burst.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Fake handle of context number ctx. The contexts are only compared, never read. */
+#define TEST_CTX(ctx)           ((sec_context_handle_t)(uintptr_t)((ctx) + 1))
+
+/** Position of a packet in the burst before it was reordered */
+#define TEST_POS(packet)        ((uint32_t)(uintptr_t)(packet).ua_ctx_handle)
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static sec_burst_packet_t test_packets[SEC_BURST_REORDER_WINDOW];
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+/** Fills the burst with the contexts in ctx, the UA handle of a packet is its position */
+static void test_fill_burst(const uint32_t *ctx, uint32_t packets_no)
+{
+    uint32_t i;
+
+    memset(test_packets, 0, sizeof(test_packets));
+    for (i = 0; i < packets_no; i++)
+    {
+        test_packets[i].sec_ctx_handle = TEST_CTX(ctx[i]);
+        test_packets[i].hfn_ov_val = ctx[i];
+        test_packets[i].ua_ctx_handle = (ua_context_handle_t)(uintptr_t)i;
+    }
+}
+
+static void test_burst_group_interleaved(void)
+{
+    const uint32_t ctx[] = {0, 1, 0, 2, 1, 0};
+    const uint32_t expected_pos[] = {0, 2, 5, 1, 4, 3};
+    uint32_t groups_no;
+    uint32_t i;
+
+    test_fill_burst(ctx, 6);
+
+    groups_no = group_burst_by_context(test_packets, 6);
+    assert_equal(groups_no, 3);
+
+    // Contexts in the order of their first packet, packets of a context in burst order
+    for (i = 0; i < 6; i++)
+    {
+        assert_equal(TEST_POS(test_packets[i]), expected_pos[i]);
+        assert_equal(test_packets[i].sec_ctx_handle, TEST_CTX(ctx[expected_pos[i]]));
+        assert_equal(test_packets[i].hfn_ov_val, ctx[expected_pos[i]]);
+    }
+}
+
+static void test_burst_group_unchanged(void)
+{
+    const uint32_t same_ctx[] = {3, 3, 3, 3};
+    const uint32_t distinct_ctx[] = {0, 1, 2, 3};
+    const uint32_t grouped_ctx[] = {2, 2, 0, 0};
+    uint32_t i;
+
+    // Nothing to reorder
+    test_fill_burst(same_ctx, 4);
+    assert_equal(group_burst_by_context(test_packets, 4), 1);
+    for (i = 0; i < 4; i++)
+    {
+        assert_equal(TEST_POS(test_packets[i]), i);
+    }
+
+    test_fill_burst(distinct_ctx, 4);
+    assert_equal(group_burst_by_context(test_packets, 4), 4);
+    for (i = 0; i < 4; i++)
+    {
+        assert_equal(TEST_POS(test_packets[i]), i);
+    }
+
+    test_fill_burst(grouped_ctx, 4);
+    assert_equal(group_burst_by_context(test_packets, 4), 2);
+    for (i = 0; i < 4; i++)
+    {
+        assert_equal(TEST_POS(test_packets[i]), i);
+    }
+
+    // Windows of 0 and 1 packets
+    assert_equal(group_burst_by_context(test_packets, 1), 1);
+    assert_equal(TEST_POS(test_packets[0]), 0);
+    assert_equal(group_burst_by_context(test_packets, 0), 0);
+}
+
+static void test_burst_group_full_window(void)
+{
+    uint32_t ctx[SEC_BURST_REORDER_WINDOW];
+    uint32_t contexts_no = SEC_BURST_REORDER_WINDOW < 4 ? SEC_BURST_REORDER_WINDOW : 4;
+    uint32_t errors = 0;
+    uint32_t i, c, pos;
+
+    // Bearers interleaved round robin, as they are received from the radio
+    for (i = 0; i < SEC_BURST_REORDER_WINDOW; i++)
+    {
+        ctx[i] = i % contexts_no;
+    }
+    test_fill_burst(ctx, SEC_BURST_REORDER_WINDOW);
+
+    assert_equal(group_burst_by_context(test_packets, SEC_BURST_REORDER_WINDOW), contexts_no);
+
+    // The group of context c holds the packets at positions c, c + contexts_no, ...
+    i = 0;
+    for (c = 0; c < contexts_no; c++)
+    {
+        for (pos = c; pos < SEC_BURST_REORDER_WINDOW; pos += contexts_no, i++)
+        {
+            if (test_packets[i].sec_ctx_handle != TEST_CTX(c) ||
+                TEST_POS(test_packets[i]) != pos)
+            {
+                errors++;
+            }
+        }
+    }
+    assert_equal(i, SEC_BURST_REORDER_WINDOW);
+    assert_equal(errors, 0);
+}
+
+static TestSuite * burst_tests()
+{
+    TestSuite *suite = create_test_suite();
+
+    add_test(suite, test_burst_group_interleaved);
+    add_test(suite, test_burst_group_unchanged);
+    add_test(suite, test_burst_group_full_window);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    /* create test suite */
+    TestSuite * suite = burst_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_burst_group_interleaved", reporter);
+    run_single_test(suite, "test_burst_group_unchanged", reporter);
+    run_single_test(suite, "test_burst_group_full_window", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
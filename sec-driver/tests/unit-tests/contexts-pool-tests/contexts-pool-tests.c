@@ -78,8 +78,8 @@ static inline dma_addr_t test_vtop(void *v)
 /*==================================================================================================
                                      GLOBAL VARIABLES
 ==================================================================================================*/
-void* global_dma_mem_free = NULL;
-void* global_dma_mem_free_original = NULL;
+void* global_dma_mem = NULL;
+sec_dma_mem_arena_t global_dma_arena;
 #ifdef USDPAA
 enum rta_sec_era rta_sec_era = RTA_SEC_ERA_2;
 #endif
@@ -99,13 +99,23 @@ static void test_contexts_pool_init_destroy(void)
 #define NO_OF_CONTEXTS 10
 
     ret = init_contexts_pool(&pool, NO_OF_CONTEXTS,
-            &global_dma_mem_free,
+            &global_dma_arena,
             THREAD_UNSAFE_POOL);
 
     assert_equal_with_message(ret, 0,
             "ERROR on init_contexts_pool: ret = %d!", ret);
 
+    // the shared descriptors are accounted to the pool
+    assert_equal_with_message(pool.dma_mem_size, NO_OF_CONTEXTS * SEC_CRYPTO_DESCRIPTOR_SIZE,
+            "ERROR on init_contexts_pool: pool uses %d bytes of DMA memory!", pool.dma_mem_size);
+    assert_equal(global_dma_arena.used_size, pool.dma_mem_size);
+
     destroy_contexts_pool(&pool);
+
+    // and returned to the arena when the pool is destroyed
+    assert_equal_with_message(global_dma_arena.used_size, 0,
+            "ERROR on destroy_contexts_pool: %d bytes of DMA memory not freed!",
+            global_dma_arena.used_size);
 }
 
 static void test_contexts_pool_get_free_contexts(void)
@@ -116,7 +126,7 @@ static void test_contexts_pool_get_free_contexts(void)
     sec_context_t* sec_ctxs[NO_OF_CONTEXTS];
 
     ret = init_contexts_pool(&pool, NO_OF_CONTEXTS,
-            &global_dma_mem_free,
+            &global_dma_arena,
             THREAD_UNSAFE_POOL);
 
     assert_equal_with_message(ret, 0,
@@ -150,7 +160,7 @@ static void test_contexts_pool_free_contexts_with_no_packets_in_flight(void)
     sec_context_t* sec_ctxs[NO_OF_CONTEXTS];
 
     ret = init_contexts_pool(&pool, NO_OF_CONTEXTS,
-            &global_dma_mem_free,
+            &global_dma_arena,
             THREAD_UNSAFE_POOL);
 
     assert_equal_with_message(ret, 0,
@@ -203,7 +213,7 @@ static void test_contexts_pool_free_contexts_with_packets_in_flight(void)
     sec_context_t* sec_ctxs[NO_OF_CONTEXTS];
 
     ret = init_contexts_pool(&pool, NO_OF_CONTEXTS,
-            &global_dma_mem_free,
+            &global_dma_arena,
             THREAD_UNSAFE_POOL);
 
     assert_equal_with_message(ret, 0,
@@ -341,15 +351,15 @@ int main(int argc, char *argv[])
     /* Because I need cacheline aligned mem in init_context_pools, I use memalign, instead of plain malloc
      *
      */
-    global_dma_mem_free = memalign(L1_CACHE_BYTES, sizeof(sec_pdcp_pdb_t)* MAX_SEC_CONTEXTS_PER_POOL * (MAX_SEC_JOB_RINGS + 1));
+    global_dma_mem = memalign(L1_CACHE_BYTES, SEC_CRYPTO_DESCRIPTOR_SIZE * MAX_SEC_CONTEXTS_PER_POOL * (MAX_SEC_JOB_RINGS + 1));
     
     g_sec_vtop = test_vtop;
 
-    assert(global_dma_mem_free != NULL);
+    assert(global_dma_mem != NULL);
 
-    // Remember start address of memory area (for free() )
-    // because it will be modified as the SEC context pool allocation uses memory from it.
-    global_dma_mem_free_original = global_dma_mem_free;
+    // The SEC context pools allocate their shared descriptors from an arena over this memory area
+    dma_mem_init(&global_dma_arena, global_dma_mem,
+                 SEC_CRYPTO_DESCRIPTOR_SIZE * MAX_SEC_CONTEXTS_PER_POOL * (MAX_SEC_JOB_RINGS + 1));
 
     /* create test suite */
     TestSuite * suite = contexts_pool_tests();
@@ -364,7 +374,7 @@ int main(int argc, char *argv[])
     destroy_test_suite(suite);
     (*reporter->destroy)(reporter);
 
-    free(global_dma_mem_free_original);
+    free(global_dma_mem);
 
     return 0;
 } /* main() */
@@ -0,0 +1,312 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "sec_dma_mem.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include <malloc.h> // memalign...
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Size of the memory area used by the tests */
+#define TEST_DMA_MEM_SIZE       4096
+
+/** Alignment of the memory area used by the tests */
+#define TEST_DMA_MEM_ALIGNMENT  4096
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static uint8_t *test_dma_mem = NULL;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+static void test_dma_mem_init_alloc_free(void)
+{
+    sec_dma_mem_arena_t arena;
+    uint32_t account = 0;
+    uint8_t *ptr = NULL;
+    int ret = 0;
+
+    ret = dma_mem_init(&arena, test_dma_mem, TEST_DMA_MEM_SIZE);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on dma_mem_init: ret = %d!", ret);
+    assert_equal(dma_mem_get_largest_free(&arena), TEST_DMA_MEM_SIZE);
+
+    // Size is rounded up to a multiple of a cacheline
+    ptr = dma_mem_alloc(&arena, L1_CACHE_BYTES + 1, 0, &account);
+    assert_equal_with_message(ptr, test_dma_mem,
+                              "ERROR on dma_mem_alloc: first region starts at %p!", ptr);
+    assert_equal(account, 2 * L1_CACHE_BYTES);
+    assert_equal(arena.used_size, 2 * L1_CACHE_BYTES);
+    assert_equal(dma_mem_get_largest_free(&arena), TEST_DMA_MEM_SIZE - 2 * L1_CACHE_BYTES);
+
+    dma_mem_free(&arena, ptr, L1_CACHE_BYTES + 1, &account);
+    assert_equal(account, 0);
+    assert_equal(arena.used_size, 0);
+    assert_equal(arena.max_used_size, 2 * L1_CACHE_BYTES);
+    assert_equal_with_message(arena.free_regions_no, 1,
+                              "ERROR on dma_mem_free: %d free regions instead of 1!",
+                              arena.free_regions_no);
+    assert_equal(dma_mem_get_largest_free(&arena), TEST_DMA_MEM_SIZE);
+}
+
+static void test_dma_mem_unaligned_area(void)
+{
+    sec_dma_mem_arena_t arena;
+    int ret = 0;
+
+    ret = dma_mem_init(&arena, test_dma_mem + 1, TEST_DMA_MEM_SIZE - 1);
+    assert_equal_with_message(ret, SEC_INVALID_INPUT_PARAM,
+                              "ERROR on dma_mem_init: unaligned area accepted, ret = %d!", ret);
+}
+
+static void test_dma_mem_out_of_memory(void)
+{
+    sec_dma_mem_arena_t arena;
+    uint32_t account = 0;
+    uint8_t *ptr = NULL;
+    int i = 0;
+
+    dma_mem_init(&arena, test_dma_mem, TEST_DMA_MEM_SIZE);
+
+    // A request larger than the area fails
+    ptr = dma_mem_alloc(&arena, TEST_DMA_MEM_SIZE + 1, 0, &account);
+    assert_equal_with_message(ptr, NULL, "ERROR on dma_mem_alloc: allocated more than the area!");
+    assert_equal(account, 0);
+
+    // Use the whole area, then the next request fails instead of overrunning it
+    for (i = 0; i < TEST_DMA_MEM_SIZE / L1_CACHE_BYTES; i++)
+    {
+        ptr = dma_mem_alloc(&arena, L1_CACHE_BYTES, 0, &account);
+        assert_equal_with_message(ptr, test_dma_mem + i * L1_CACHE_BYTES,
+                                  "ERROR on dma_mem_alloc: region %d starts at %p!", i, ptr);
+    }
+    assert_equal(arena.used_size, TEST_DMA_MEM_SIZE);
+    assert_equal(dma_mem_get_largest_free(&arena), 0);
+
+    ptr = dma_mem_alloc(&arena, 1, 0, &account);
+    assert_equal_with_message(ptr, NULL, "ERROR on dma_mem_alloc: overrun the area!");
+    assert_equal(account, TEST_DMA_MEM_SIZE);
+}
+
+static void test_dma_mem_alignment(void)
+{
+    sec_dma_mem_arena_t arena;
+    uint8_t *small = NULL;
+    uint8_t *aligned = NULL;
+    uint8_t *reused = NULL;
+
+    dma_mem_init(&arena, test_dma_mem, TEST_DMA_MEM_SIZE);
+
+    small = dma_mem_alloc(&arena, L1_CACHE_BYTES, 0, NULL);
+    assert_equal(small, test_dma_mem);
+
+    // The padding before an aligned region stays free
+    aligned = dma_mem_alloc(&arena, L1_CACHE_BYTES, 1024, NULL);
+    assert_equal_with_message((uintptr_t)aligned % 1024, 0,
+                              "ERROR on dma_mem_alloc: region %p not aligned to 1024!", aligned);
+    assert_equal(aligned, test_dma_mem + 1024);
+    assert_equal(arena.free_regions_no, 2);
+
+    // and is used by the next request that fits
+    reused = dma_mem_alloc(&arena, 1024 - L1_CACHE_BYTES, 0, NULL);
+    assert_equal_with_message(reused, test_dma_mem + L1_CACHE_BYTES,
+                              "ERROR on dma_mem_alloc: padding not reused, region at %p!", reused);
+    assert_equal(arena.free_regions_no, 1);
+    assert_equal(arena.used_size, 1024 + L1_CACHE_BYTES);
+
+    // A bad alignment is rejected
+    assert_equal(dma_mem_alloc(&arena, L1_CACHE_BYTES, 3 * L1_CACHE_BYTES, NULL), NULL);
+}
+
+static void test_dma_mem_reuse_and_merge(void)
+{
+    sec_dma_mem_arena_t arena;
+    uint32_t account_a = 0;
+    uint32_t account_b = 0;
+    uint8_t *a = NULL;
+    uint8_t *b = NULL;
+    uint8_t *c = NULL;
+
+    dma_mem_init(&arena, test_dma_mem, TEST_DMA_MEM_SIZE);
+
+    a = dma_mem_alloc(&arena, 256, 0, &account_a);
+    b = dma_mem_alloc(&arena, 512, 0, &account_b);
+    c = dma_mem_alloc(&arena, 256, 0, &account_a);
+    assert_equal(account_a, 512);
+    assert_equal(account_b, 512);
+
+    // A freed region is reused
+    dma_mem_free(&arena, b, 512, &account_b);
+    assert_equal(account_b, 0);
+    assert_equal(arena.free_regions_no, 2);
+    assert_equal_with_message(dma_mem_alloc(&arena, 384, 0, &account_b), b,
+                              "ERROR on dma_mem_alloc: freed region not reused!");
+    dma_mem_free(&arena, b, 384, &account_b);
+
+    // Adjacent free regions are merged back into one
+    dma_mem_free(&arena, a, 256, &account_a);
+    assert_equal(arena.free_regions_no, 2);
+    dma_mem_free(&arena, c, 256, &account_a);
+    assert_equal_with_message(arena.free_regions_no, 1,
+                              "ERROR on dma_mem_free: %d free regions instead of 1!",
+                              arena.free_regions_no);
+    assert_equal(arena.free_regions[0].size, TEST_DMA_MEM_SIZE);
+    assert_equal(account_a, 0);
+    assert_equal(arena.used_size, 0);
+    assert_equal(arena.max_used_size, 1024);
+}
+
+static void test_dma_mem_invalid_free(void)
+{
+    sec_dma_mem_arena_t arena;
+    uint32_t account = 0;
+    uint8_t *a = NULL;
+    uint8_t outside[L1_CACHE_BYTES];
+
+    dma_mem_init(&arena, test_dma_mem, TEST_DMA_MEM_SIZE);
+
+    a = dma_mem_alloc(&arena, 256, 0, &account);
+    dma_mem_alloc(&arena, 256, 0, &account);
+
+    dma_mem_free(&arena, a, 256, &account);
+    assert_equal(account, 256);
+
+    // Double free and regions outside the area are ignored
+    dma_mem_free(&arena, a, 256, &account);
+    assert_equal_with_message(account, 256, "ERROR on dma_mem_free: double free accounted!");
+    dma_mem_free(&arena, outside, sizeof(outside), &account);
+    dma_mem_free(&arena, test_dma_mem + TEST_DMA_MEM_SIZE - L1_CACHE_BYTES, 256, &account);
+    assert_equal(account, 256);
+    assert_equal(arena.used_size, 256);
+    assert_equal(arena.free_regions_no, 2);
+}
+
+static TestSuite * dma_mem_tests()
+{
+    /* create test suite */
+    TestSuite * suite = create_test_suite();
+
+    /* setup/teardown functions to be called before/after each unit test */
+//    setup(suite, tests_setup);
+//    teardown(suite, tests_teardown);
+
+    /* start adding unit tests */
+    add_test(suite, test_dma_mem_init_alloc_free);
+    add_test(suite, test_dma_mem_unaligned_area);
+    add_test(suite, test_dma_mem_out_of_memory);
+    add_test(suite, test_dma_mem_alignment);
+    add_test(suite, test_dma_mem_reuse_and_merge);
+    add_test(suite, test_dma_mem_invalid_free);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    test_dma_mem = memalign(TEST_DMA_MEM_ALIGNMENT, TEST_DMA_MEM_SIZE);
+    assert(test_dma_mem != NULL);
+
+    /* create test suite */
+    TestSuite * suite = dma_mem_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_dma_mem_init_alloc_free", reporter);
+    run_single_test(suite, "test_dma_mem_unaligned_area", reporter);
+    run_single_test(suite, "test_dma_mem_out_of_memory", reporter);
+    run_single_test(suite, "test_dma_mem_alignment", reporter);
+    run_single_test(suite, "test_dma_mem_reuse_and_merge", reporter);
+    run_single_test(suite, "test_dma_mem_invalid_free", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    free(test_dma_mem);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,224 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "sec_latency.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static sec_latency_histogram_t test_hist;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+static void test_latency_buckets(void)
+{
+    uint32_t errors = 0;
+    uint32_t bucket;
+    uint32_t prev_bucket = 0;
+    uint64_t latency;
+    uint32_t i;
+
+    // Low latencies have a bucket each
+    for (i = 0; i < SEC_LATENCY_HIST_SUB_BUCKETS; i++)
+    {
+        assert_equal(sec_latency_bucket(i), i);
+        assert_equal(sec_latency_bucket_max(i), i);
+    }
+
+    // Buckets grow with the latency, each latency is at most the maximum of its bucket
+    // and above the maximum of the previous bucket
+    for (latency = 0; latency <= 0xFFFFFFFFULL; latency += (latency >> 6) + 1)
+    {
+        bucket = sec_latency_bucket((uint32_t)latency);
+        if (bucket < prev_bucket || bucket >= SEC_LATENCY_HIST_BUCKETS ||
+            latency > sec_latency_bucket_max(bucket) ||
+            (bucket > 0 && latency <= sec_latency_bucket_max(bucket - 1)))
+        {
+            errors++;
+        }
+        prev_bucket = bucket;
+    }
+    assert_equal(errors, 0);
+
+    // The width of a bucket is bounded relative to the latencies it holds
+    for (i = SEC_LATENCY_HIST_SUB_BUCKETS; i < SEC_LATENCY_HIST_BUCKETS; i++)
+    {
+        uint32_t width = sec_latency_bucket_max(i) - sec_latency_bucket_max(i - 1);
+
+        if ((uint64_t)width * SEC_LATENCY_HIST_SUB_BUCKETS > (uint64_t)sec_latency_bucket_max(i - 1) + 1)
+        {
+            errors++;
+        }
+    }
+    assert_equal(errors, 0);
+
+    assert_equal(sec_latency_bucket(0xFFFFFFFF), SEC_LATENCY_HIST_BUCKETS - 1);
+    assert_equal(sec_latency_bucket_max(SEC_LATENCY_HIST_BUCKETS - 1), 0xFFFFFFFF);
+}
+
+static void test_latency_record(void)
+{
+    memset(&test_hist, 0, sizeof(test_hist));
+
+    sec_latency_record(&test_hist, 1000);
+    sec_latency_record(&test_hist, 10);
+    sec_latency_record(&test_hist, 100000);
+
+    assert_equal(test_hist.count, 3);
+    assert_equal(test_hist.sum, 101010);
+    assert_equal(test_hist.min, 10);
+    assert_equal(test_hist.max, 100000);
+    assert_equal(test_hist.buckets[sec_latency_bucket(10)], 1);
+    assert_equal(test_hist.buckets[sec_latency_bucket(1000)], 1);
+    assert_equal(test_hist.buckets[sec_latency_bucket(100000)], 1);
+}
+
+static void test_latency_percentiles(void)
+{
+    uint32_t p50, p99, p999;
+    uint32_t i;
+
+    memset(&test_hist, 0, sizeof(test_hist));
+    assert_equal(sec_latency_percentile(&test_hist, 9900), 0);
+
+    // 990 fast jobs, 9 slower and a single outlier
+    for (i = 0; i < 990; i++)
+    {
+        sec_latency_record(&test_hist, 2000 + i);
+    }
+    for (i = 0; i < 9; i++)
+    {
+        sec_latency_record(&test_hist, 20000);
+    }
+    sec_latency_record(&test_hist, 1000000);
+
+    p50 = sec_latency_percentile(&test_hist, 5000);
+    p99 = sec_latency_percentile(&test_hist, 9900);
+    p999 = sec_latency_percentile(&test_hist, 9990);
+
+    // Upper bounds of the exact values, within the resolution of the histogram
+    assert_true(p50 >= 2499 && p50 <= 2499 + 2499 / SEC_LATENCY_HIST_SUB_BUCKETS);
+    assert_true(p99 >= 2989 && p99 <= 2989 + 2989 / SEC_LATENCY_HIST_SUB_BUCKETS);
+    assert_true(p999 >= 20000 && p999 <= 20000 + 20000 / SEC_LATENCY_HIST_SUB_BUCKETS);
+
+    // Never above the highest latency recorded
+    assert_equal(sec_latency_percentile(&test_hist, 10000), 1000000);
+    assert_equal(sec_latency_percentile(&test_hist, 0), sec_latency_bucket_max(sec_latency_bucket(2000)));
+}
+
+static TestSuite * latency_tests()
+{
+    TestSuite *suite = create_test_suite();
+
+    add_test(suite, test_latency_buckets);
+    add_test(suite, test_latency_record);
+    add_test(suite, test_latency_percentiles);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    /* create test suite */
+    TestSuite * suite = latency_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_latency_buckets", reporter);
+    run_single_test(suite, "test_latency_record", reporter);
+    run_single_test(suite, "test_latency_percentiles", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
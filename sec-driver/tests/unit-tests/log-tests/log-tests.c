@@ -0,0 +1,309 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "sec_log.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Number of threads writing to the log ring at the same time */
+#define TEST_WRITER_THREADS     4
+/** Messages written by each thread */
+#define TEST_MESSAGES_PER_WRITER    10000
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+/* Drains the log ring into a string. The caller frees it. */
+static char* drain_to_string(uint32_t max_no, uint32_t *drained_no)
+{
+    char *buf = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&buf, &size);
+
+    assert(stream != NULL);
+    *drained_no = sec_log_ring_drain(stream, max_no);
+    fclose(stream);
+
+    return buf;
+}
+
+/* Returns the number of dropped messages reported in a drained string */
+static uint32_t get_dropped_no(const char *buf)
+{
+    const char *line = buf;
+    uint32_t dropped_no = 0;
+    uint32_t n;
+
+    while (line != NULL && *line != '\0')
+    {
+        if (sscanf(line, "%u messages dropped", &n) == 1)
+        {
+            dropped_no += n;
+        }
+        line = strchr(line, '\n');
+        if (line != NULL)
+        {
+            line++;
+        }
+    }
+
+    return dropped_no;
+}
+
+static void* writer_thread(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    uint32_t i;
+
+    for (i = 0; i < TEST_MESSAGES_PER_WRITER; i++)
+    {
+        sec_log_ring_write(0, "writer %u message %u\n", id, i);
+    }
+
+    return NULL;
+}
+
+static void test_log_ring_order(void)
+{
+    uint32_t drained_no = 0;
+    char *buf;
+
+    sec_log_ring_write(0, "first %d\n", 1);
+    sec_log_ring_write(3, "second %s\n", "message");
+    // Missing end of line is added
+    sec_log_ring_write(0, "third");
+
+    buf = drain_to_string(2, &drained_no);
+    assert_equal(drained_no, 2);
+    assert_string_equal(buf, "first 1\n(3 similar messages suppressed) second message\n");
+    free(buf);
+
+    buf = drain_to_string(SEC_LOG_RING_SIZE, &drained_no);
+    assert_equal(drained_no, 1);
+    assert_string_equal(buf, "third\n");
+    free(buf);
+
+    // Nothing left
+    buf = drain_to_string(SEC_LOG_RING_SIZE, &drained_no);
+    assert_equal(drained_no, 0);
+    assert_string_equal(buf, "");
+    free(buf);
+}
+
+static void test_log_ring_full(void)
+{
+    uint32_t drained_no = 0;
+    char long_msg[2 * SEC_LOG_MSG_SIZE];
+    char expected[32];
+    char *buf;
+    uint32_t i;
+
+    for (i = 0; i < SEC_LOG_RING_SIZE + 5; i++)
+    {
+        sec_log_ring_write(0, "message %u\n", i);
+    }
+
+    buf = drain_to_string(SEC_LOG_RING_SIZE + 5, &drained_no);
+    assert_equal(drained_no, SEC_LOG_RING_SIZE);
+    assert_equal(get_dropped_no(buf), 5);
+    // The oldest messages are kept
+    assert_true(strstr(buf, "message 0\n") != NULL);
+    snprintf(expected, sizeof(expected), "message %u\n", SEC_LOG_RING_SIZE);
+    assert_true(strstr(buf, expected) == NULL);
+    free(buf);
+
+    // Long messages are truncated
+    memset(long_msg, 'x', sizeof(long_msg) - 1);
+    long_msg[sizeof(long_msg) - 1] = '\0';
+    sec_log_ring_write(0, "%s", long_msg);
+    buf = drain_to_string(1, &drained_no);
+    assert_equal(drained_no, 1);
+    assert_equal(strlen(buf), SEC_LOG_MSG_SIZE);
+    free(buf);
+}
+
+static void test_log_rate_limit(void)
+{
+    sec_log_site_t site;
+    uint32_t suppressed_no = 0xFFFFFFFF;
+    uint32_t allowed_no = 0;
+    uint32_t i;
+
+    memset(&site, 0, sizeof(site));
+
+    // A burst of messages within the same second
+    for (i = 0; i < SEC_LOG_RATE_LIMIT_BURST + 20; i++)
+    {
+        if (sec_log_site_allow(&site, 1000, &suppressed_no))
+        {
+            allowed_no++;
+            assert_equal(suppressed_no, 0);
+        }
+    }
+    assert_equal(allowed_no, SEC_LOG_RATE_LIMIT_BURST);
+
+    // The first message of the next interval reports the suppressed ones
+    assert_true(sec_log_site_allow(&site, 1000 + SEC_LOG_RATE_LIMIT_INTERVAL, &suppressed_no));
+    assert_equal(suppressed_no, 20);
+    assert_true(sec_log_site_allow(&site, 1000 + SEC_LOG_RATE_LIMIT_INTERVAL, &suppressed_no));
+    assert_equal(suppressed_no, 0);
+}
+
+static void test_log_ring_threads(void)
+{
+    pthread_t threads[TEST_WRITER_THREADS];
+    uint32_t drained_total = 0;
+    uint32_t dropped_total = 0;
+    uint32_t drained_no = 0;
+    char *buf;
+    int i;
+
+    for (i = 0; i < TEST_WRITER_THREADS; i++)
+    {
+        assert_equal(pthread_create(&threads[i], NULL, writer_thread, (void*)(uintptr_t)i), 0);
+    }
+
+    // Drain while the writers run
+    for (i = 0; i < 1000; i++)
+    {
+        buf = drain_to_string(SEC_LOG_RING_SIZE, &drained_no);
+        drained_total += drained_no;
+        dropped_total += get_dropped_no(buf);
+        free(buf);
+    }
+
+    for (i = 0; i < TEST_WRITER_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    buf = drain_to_string(TEST_WRITER_THREADS * TEST_MESSAGES_PER_WRITER, &drained_no);
+    drained_total += drained_no;
+    dropped_total += get_dropped_no(buf);
+    free(buf);
+
+    // Every message was either written out or counted as dropped
+    assert_equal(drained_total + dropped_total, TEST_WRITER_THREADS * TEST_MESSAGES_PER_WRITER);
+}
+
+static TestSuite * log_tests()
+{
+    TestSuite *suite = create_test_suite();
+
+    add_test(suite, test_log_ring_order);
+    add_test(suite, test_log_ring_full);
+    add_test(suite, test_log_rate_limit);
+    add_test(suite, test_log_ring_threads);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    /* create test suite */
+    TestSuite * suite = log_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_log_ring_order", reporter);
+    run_single_test(suite, "test_log_ring_full", reporter);
+    run_single_test(suite, "test_log_rate_limit", reporter);
+    run_single_test(suite, "test_log_ring_threads", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
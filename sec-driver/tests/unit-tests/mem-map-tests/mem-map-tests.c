@@ -0,0 +1,363 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "sec_mem_map.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Size of each memory region used by the tests */
+#define TEST_REGION_SIZE        4096
+
+/** Number of memory regions used by the tests */
+#define TEST_REGIONS_NO         4
+
+/** Physical address of the first memory region. Region i is at TEST_PHYS_BASE + i * TEST_PHYS_STRIDE */
+#define TEST_PHYS_BASE          0x10000000
+#define TEST_PHYS_STRIDE        0x01000000
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+/** Memory of the regions. The regions are registered out of order and with
+ * gaps between them: only the even ones are registered by default. */
+static uint8_t test_mem[TEST_REGIONS_NO][TEST_REGION_SIZE];
+
+static sec_mem_map_t test_map;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+/** Physical address of a byte of test_mem */
+static dma_addr_t test_phys(int region, uint32_t offset)
+{
+    return TEST_PHYS_BASE + region * TEST_PHYS_STRIDE + offset;
+}
+
+static void test_setup(void)
+{
+    int ret = 0;
+
+    mem_map_init(&test_map);
+
+    ret = mem_map_add(&test_map, test_mem[2], test_phys(2, 0), TEST_REGION_SIZE);
+    assert_equal(ret, SEC_SUCCESS);
+    ret = mem_map_add(&test_map, test_mem[0], test_phys(0, 0), TEST_REGION_SIZE);
+    assert_equal(ret, SEC_SUCCESS);
+}
+
+static void test_mem_map_add_sorted(void)
+{
+    int ret = 0;
+    uint32_t i = 0;
+
+    test_setup();
+    ret = mem_map_add(&test_map, test_mem[3], test_phys(3, 0), TEST_REGION_SIZE);
+    assert_equal(ret, SEC_SUCCESS);
+
+    assert_equal(test_map.regions_no, 3);
+    for (i = 1; i < test_map.regions_no; i++)
+    {
+        if (test_map.regions[i - 1].end > test_map.regions[i].start)
+        {
+            break;
+        }
+    }
+    assert_equal_with_message(i, test_map.regions_no,
+                              "ERROR on mem_map_add: region %d is out of order!", i);
+}
+
+static void test_mem_map_add_invalid(void)
+{
+    int ret = 0;
+
+    test_setup();
+
+    // Overlaps the end of region 0 and the start of region 2
+    ret = mem_map_add(&test_map, test_mem[0] + TEST_REGION_SIZE - 1, test_phys(1, 0), 2);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = mem_map_add(&test_map, test_mem[1], test_phys(1, 0), TEST_REGION_SIZE + 1);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = mem_map_add(&test_map, test_mem[0], test_phys(0, 0), TEST_REGION_SIZE);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+
+    ret = mem_map_add(&test_map, test_mem[1], test_phys(1, 0), 0);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = mem_map_add(&test_map, (void*)(UINTPTR_MAX - 10), test_phys(1, 0), TEST_REGION_SIZE);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+
+    assert_equal(test_map.regions_no, 2);
+
+    // Exactly fills the gap
+    ret = mem_map_add(&test_map, test_mem[1], test_phys(1, 0), TEST_REGION_SIZE);
+    assert_equal(ret, SEC_SUCCESS);
+}
+
+static void test_mem_map_full(void)
+{
+    int ret = 0;
+    uint32_t i = 0;
+
+    mem_map_init(&test_map);
+
+    // Regions of one byte each
+    for (i = 0; i < SEC_MAX_MEM_REGIONS; i++)
+    {
+        ret = mem_map_add(&test_map, &test_mem[0][i], test_phys(0, i), 1);
+        if (ret != SEC_SUCCESS)
+        {
+            break;
+        }
+    }
+    assert_equal(ret, SEC_SUCCESS);
+
+    ret = mem_map_add(&test_map, test_mem[1], test_phys(1, 0), TEST_REGION_SIZE);
+    assert_equal(ret, SEC_OUT_OF_MEMORY);
+}
+
+static void test_mem_map_vtop(void)
+{
+    dma_addr_t p = 0;
+    uint32_t hint = 0;
+    int ret = 0;
+
+    test_setup();
+
+    ret = mem_map_vtop(&test_map, test_mem[2] + 100, 10, &hint, &p);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(p, test_phys(2, 100));
+    assert_equal(hint, 1);
+
+    // Same region as the hint
+    ret = mem_map_vtop(&test_map, test_mem[2], TEST_REGION_SIZE, &hint, &p);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(p, test_phys(2, 0));
+
+    // Another region than the hint
+    ret = mem_map_vtop(&test_map, test_mem[0] + TEST_REGION_SIZE - 1, 1, &hint, &p);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(p, test_phys(0, TEST_REGION_SIZE - 1));
+    assert_equal(hint, 0);
+
+    // A stale hint is ignored
+    hint = 5;
+    ret = mem_map_vtop(&test_map, test_mem[2] + 1, 1, &hint, &p);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(p, test_phys(2, 1));
+    assert_equal(hint, 1);
+}
+
+static void test_mem_map_vtop_invalid(void)
+{
+    dma_addr_t p = 0;
+    uint32_t hint = 0;
+    int ret = 0;
+
+    test_setup();
+
+    // Not registered: in the gap, after the last region, crossing the end of a region
+    ret = mem_map_vtop(&test_map, test_mem[1] + 100, 1, &hint, &p);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = mem_map_vtop(&test_map, test_mem[3], 1, &hint, &p);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = mem_map_vtop(&test_map, test_mem[0] + 100, TEST_REGION_SIZE, &hint, &p);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    // Crossing the end of the hinted region
+    ret = mem_map_vtop(&test_map, test_mem[0] + 100, TEST_REGION_SIZE - 100, &hint, &p);
+    assert_equal(ret, SEC_SUCCESS);
+    ret = mem_map_vtop(&test_map, test_mem[0] + 100, TEST_REGION_SIZE - 99, &hint, &p);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+
+    // Empty map
+    mem_map_init(&test_map);
+    ret = mem_map_vtop(&test_map, test_mem[0], 1, &hint, &p);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+}
+
+static void test_mem_map_remove(void)
+{
+    dma_addr_t p = 0;
+    uint32_t hint = 0;
+    int ret = 0;
+
+    test_setup();
+
+    ret = mem_map_remove(&test_map, test_mem[0] + 1);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+
+    ret = mem_map_remove(&test_map, test_mem[0]);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(test_map.regions_no, 1);
+
+    ret = mem_map_vtop(&test_map, test_mem[0], 1, &hint, &p);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    ret = mem_map_vtop(&test_map, test_mem[2], 1, &hint, &p);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(p, test_phys(2, 0));
+}
+
+static void test_mem_map_iov_to_packet(void)
+{
+    struct iovec iov[3];
+    sec_packet_t packet[3];
+    uint32_t hint = 0;
+    int ret = 0;
+
+    test_setup();
+
+    iov[0].iov_base = test_mem[0] + 8;
+    iov[0].iov_len = 100;
+    iov[1].iov_base = test_mem[2];
+    iov[1].iov_len = TEST_REGION_SIZE;
+    iov[2].iov_base = test_mem[0] + 200;
+    iov[2].iov_len = 1;
+
+    memset(packet, 0xFF, sizeof(packet));
+    ret = mem_map_iov_to_packet(&test_map, iov, 3, &hint, packet);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(packet[0].address, test_phys(0, 8));
+    assert_equal(packet[0].length, 100);
+    assert_equal(packet[0].offset, 0);
+    assert_equal(packet[0].num_fragments, 2);
+    assert_equal(packet[0].total_length, 100 + TEST_REGION_SIZE + 1);
+    assert_equal(packet[1].address, test_phys(2, 0));
+    assert_equal(packet[1].length, TEST_REGION_SIZE);
+    assert_equal(packet[1].num_fragments, 0);
+    assert_equal(packet[2].address, test_phys(0, 200));
+    assert_equal(packet[2].offset, 0);
+
+    // A single entry is a packet without fragments
+    ret = mem_map_iov_to_packet(&test_map, iov, 1, &hint, packet);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(packet[0].num_fragments, 0);
+    assert_equal(packet[0].total_length, 100);
+
+    // Empty entry, entry outside of the regions
+    iov[2].iov_len = 0;
+    ret = mem_map_iov_to_packet(&test_map, iov, 3, &hint, packet);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+    iov[2].iov_len = 1;
+    iov[2].iov_base = test_mem[1];
+    ret = mem_map_iov_to_packet(&test_map, iov, 3, &hint, packet);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+}
+
+static TestSuite * mem_map_tests()
+{
+    TestSuite *suite = create_test_suite();
+
+    add_test(suite, test_mem_map_add_sorted);
+    add_test(suite, test_mem_map_add_invalid);
+    add_test(suite, test_mem_map_full);
+    add_test(suite, test_mem_map_vtop);
+    add_test(suite, test_mem_map_vtop_invalid);
+    add_test(suite, test_mem_map_remove);
+    add_test(suite, test_mem_map_iov_to_packet);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    /* create test suite */
+    TestSuite * suite = mem_map_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_mem_map_add_sorted", reporter);
+    run_single_test(suite, "test_mem_map_add_invalid", reporter);
+    run_single_test(suite, "test_mem_map_full", reporter);
+    run_single_test(suite, "test_mem_map_vtop", reporter);
+    run_single_test(suite, "test_mem_map_vtop_invalid", reporter);
+    run_single_test(suite, "test_mem_map_remove", reporter);
+    run_single_test(suite, "test_mem_map_iov_to_packet", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,367 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "sec_null_passthrough.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Length of the input and output test buffers */
+#define TEST_BUF_SIZE           (NULL_PASSTHROUGH_MAX_LENGTH + 64)
+
+/** Headroom left before the packets in the test buffers */
+#define TEST_OFFSET             16
+
+/** Value of the bytes of the output buffer not written by the pass-through */
+#define TEST_FILL               0xA5
+
+/** Fake physical addresses of the input and output test buffers */
+#define TEST_IN_PHYS            0x10000000
+#define TEST_OUT_PHYS           0x20000000
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static uint8_t test_in_buf[TEST_BUF_SIZE];
+static uint8_t test_out_buf[TEST_BUF_SIZE];
+static uint8_t test_expected_buf[TEST_BUF_SIZE];
+
+static sec_pdcp_context_info_t test_ctx_info;
+static sec_packet_t test_in_packet;
+static sec_packet_t test_out_packet;
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+/** Translates the fake physical addresses of the test buffers */
+static void* test_ptov(dma_addr_t p)
+{
+    if (p >= TEST_OUT_PHYS)
+    {
+        return test_out_buf + (p - TEST_OUT_PHYS);
+    }
+    return test_in_buf + (p - TEST_IN_PHYS);
+}
+
+/** Sets up a NULL algorithm context and the packets: an input packet of in_length bytes
+ * and an output buffer of out_length bytes, each at TEST_OFFSET in its buffer */
+static void test_setup(uint8_t user_plane,
+                       uint8_t protocol_direction,
+                       uint32_t in_length,
+                       uint32_t out_length)
+{
+    uint32_t i;
+
+    memset(&test_ctx_info, 0, sizeof(test_ctx_info));
+    test_ctx_info.sn_size = (user_plane == PDCP_DATA_PLANE) ? SEC_PDCP_SN_SIZE_12 : SEC_PDCP_SN_SIZE_5;
+    test_ctx_info.user_plane = user_plane;
+    test_ctx_info.protocol_direction = protocol_direction;
+    test_ctx_info.cipher_algorithm = SEC_ALG_NULL;
+    test_ctx_info.integrity_algorithm = SEC_ALG_NULL;
+    test_ctx_info.hfn_ov_en = TRUE;
+
+    for (i = 0; i < TEST_BUF_SIZE; i++)
+    {
+        test_in_buf[i] = (uint8_t)(i * 7 + 1);
+    }
+    memset(test_out_buf, TEST_FILL, TEST_BUF_SIZE);
+    memset(test_expected_buf, TEST_FILL, TEST_BUF_SIZE);
+
+    memset(&test_in_packet, 0, sizeof(test_in_packet));
+    test_in_packet.address = TEST_IN_PHYS;
+    test_in_packet.offset = TEST_OFFSET;
+    test_in_packet.length = in_length;
+
+    memset(&test_out_packet, 0, sizeof(test_out_packet));
+    test_out_packet.address = TEST_OUT_PHYS;
+    test_out_packet.offset = TEST_OFFSET;
+    test_out_packet.length = out_length;
+}
+
+static void test_null_passthrough_eligible(void)
+{
+    sec_pdcp_context_info_t ctx_info;
+
+    memset(&ctx_info, 0, sizeof(ctx_info));
+    ctx_info.cipher_algorithm = SEC_ALG_NULL;
+    ctx_info.integrity_algorithm = SEC_ALG_NULL;
+
+    // User Plane EEA0
+    ctx_info.user_plane = PDCP_DATA_PLANE;
+    assert_equal(null_passthrough_context_eligible(&ctx_info, TRUE), TRUE);
+#ifdef USDPAA
+    assert_equal(null_passthrough_context_eligible(&ctx_info, FALSE), FALSE);
+#else
+    assert_equal(null_passthrough_context_eligible(&ctx_info, FALSE), TRUE);
+#endif
+
+    // Control Plane EEA0/EIA0 is passed through only when UA provides the HFN
+    ctx_info.user_plane = PDCP_CONTROL_PLANE;
+    assert_equal(null_passthrough_context_eligible(&ctx_info, FALSE), FALSE);
+#ifdef USDPAA
+    assert_equal(null_passthrough_context_eligible(&ctx_info, TRUE), FALSE);
+#else
+    assert_equal(null_passthrough_context_eligible(&ctx_info, TRUE), TRUE);
+#endif
+
+    // Any other algorithm needs SEC
+    ctx_info.integrity_algorithm = SEC_ALG_SNOW;
+    assert_equal(null_passthrough_context_eligible(&ctx_info, TRUE), FALSE);
+    ctx_info.user_plane = PDCP_DATA_PLANE;
+    ctx_info.integrity_algorithm = SEC_ALG_NULL;
+    ctx_info.cipher_algorithm = SEC_ALG_AES;
+    assert_equal(null_passthrough_context_eligible(&ctx_info, TRUE), FALSE);
+}
+
+static void test_null_passthrough_cplane_append_mac_i(void)
+{
+    test_setup(PDCP_CONTROL_PLANE, PDCP_ENCAPSULATION, 40, 44);
+
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), TRUE);
+
+    // The frame is copied and followed by the zero MAC-I of EIA0, nothing else is written
+    memcpy(test_expected_buf + TEST_OFFSET, test_in_buf + TEST_OFFSET, 40);
+    memset(test_expected_buf + TEST_OFFSET + 40, 0, NULL_PASSTHROUGH_MAC_I_LENGTH);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // No room for the MAC-I
+    test_setup(PDCP_CONTROL_PLANE, PDCP_ENCAPSULATION, 40, 43);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), FALSE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+}
+
+static void test_null_passthrough_cplane_strip_mac_i(void)
+{
+    test_setup(PDCP_CONTROL_PLANE, PDCP_DECAPSULATION, 44, 40);
+
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), TRUE);
+
+    // The MAC-I is not copied
+    memcpy(test_expected_buf + TEST_OFFSET, test_in_buf + TEST_OFFSET, 40);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // Shorter than a MAC-I: left to SEC, which reports the error
+    test_setup(PDCP_CONTROL_PLANE, PDCP_DECAPSULATION, NULL_PASSTHROUGH_MAC_I_LENGTH - 1, 40);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), FALSE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // In place: the MAC-I is only cut off
+    test_setup(PDCP_CONTROL_PLANE, PDCP_DECAPSULATION, 44, 44);
+    test_out_packet = test_in_packet;
+    memcpy(test_expected_buf, test_in_buf, TEST_BUF_SIZE);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), TRUE);
+    assert_equal(memcmp(test_in_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+}
+
+static void test_null_passthrough_uplane(void)
+{
+    // In place: the packet is already the result, even without a P2V function
+    test_setup(PDCP_DATA_PLANE, PDCP_ENCAPSULATION, 100, 100);
+    test_out_packet = test_in_packet;
+    memcpy(test_expected_buf, test_in_buf, TEST_BUF_SIZE);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, NULL), TRUE);
+    assert_equal(memcmp(test_in_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // Same buffer, different offsets: copied
+    test_setup(PDCP_DATA_PLANE, PDCP_DECAPSULATION, 100, 100);
+    test_out_packet.address = test_in_packet.address;
+    test_out_packet.offset = TEST_OFFSET + 8;
+    memcpy(test_expected_buf, test_in_buf, TEST_BUF_SIZE);
+    memmove(test_expected_buf + TEST_OFFSET + 8, test_expected_buf + TEST_OFFSET, 100);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), TRUE);
+    assert_equal(memcmp(test_in_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // Out of place: copied, without a MAC-I
+    test_setup(PDCP_DATA_PLANE, PDCP_ENCAPSULATION, 100, 200);
+    memcpy(test_expected_buf + TEST_OFFSET, test_in_buf + TEST_OFFSET, 100);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), TRUE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // Out of place without a P2V function: left to SEC
+    test_setup(PDCP_DATA_PLANE, PDCP_ENCAPSULATION, 100, 100);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, NULL), FALSE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+}
+
+static void test_null_passthrough_length_limit(void)
+{
+    // The longest frame the NULL descriptors copy
+    test_setup(PDCP_DATA_PLANE, PDCP_ENCAPSULATION, NULL_PASSTHROUGH_MAX_LENGTH,
+               NULL_PASSTHROUGH_MAX_LENGTH);
+    memcpy(test_expected_buf + TEST_OFFSET, test_in_buf + TEST_OFFSET, NULL_PASSTHROUGH_MAX_LENGTH);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), TRUE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // One more byte: left to SEC, which reports the error
+    test_setup(PDCP_DATA_PLANE, PDCP_ENCAPSULATION, NULL_PASSTHROUGH_MAX_LENGTH + 1,
+               NULL_PASSTHROUGH_MAX_LENGTH + 1);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), FALSE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // Fragmented packets go to SEC
+    test_setup(PDCP_CONTROL_PLANE, PDCP_ENCAPSULATION, 40, 44);
+    test_in_packet.num_fragments = 1;
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), FALSE);
+    test_in_packet.num_fragments = 0;
+    test_out_packet.num_fragments = 1;
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), FALSE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+}
+
+static void test_null_passthrough_ordering(void)
+{
+    // While SEC has packets of the context in flight, the next ones go to SEC too,
+    // so that they are notified after them
+    test_setup(PDCP_CONTROL_PLANE, PDCP_ENCAPSULATION, 40, 44);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 1, &test_in_packet,
+                                                 &test_out_packet, test_ptov), FALSE);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0xFFFFFFFF, &test_in_packet,
+                                                 &test_out_packet, test_ptov), FALSE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+
+    // Even in place User Plane packets, which are not touched
+    test_setup(PDCP_DATA_PLANE, PDCP_ENCAPSULATION, 100, 100);
+    test_out_packet = test_in_packet;
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 1, &test_in_packet,
+                                                 &test_out_packet, test_ptov), FALSE);
+
+    // Once SEC notified them, the CPU takes over again
+    test_setup(PDCP_CONTROL_PLANE, PDCP_ENCAPSULATION, 40, 44);
+    memcpy(test_expected_buf + TEST_OFFSET, test_in_buf + TEST_OFFSET, 40);
+    memset(test_expected_buf + TEST_OFFSET + 40, 0, NULL_PASSTHROUGH_MAC_I_LENGTH);
+    assert_equal(null_passthrough_process_packet(&test_ctx_info, 0, &test_in_packet,
+                                                 &test_out_packet, test_ptov), TRUE);
+    assert_equal(memcmp(test_out_buf, test_expected_buf, TEST_BUF_SIZE), 0);
+}
+
+static TestSuite * null_passthrough_tests()
+{
+    TestSuite *suite = create_test_suite();
+
+    add_test(suite, test_null_passthrough_eligible);
+    add_test(suite, test_null_passthrough_cplane_append_mac_i);
+    add_test(suite, test_null_passthrough_cplane_strip_mac_i);
+    add_test(suite, test_null_passthrough_uplane);
+    add_test(suite, test_null_passthrough_length_limit);
+    add_test(suite, test_null_passthrough_ordering);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    /* create test suite */
+    TestSuite * suite = null_passthrough_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_null_passthrough_eligible", reporter);
+    run_single_test(suite, "test_null_passthrough_cplane_append_mac_i", reporter);
+    run_single_test(suite, "test_null_passthrough_cplane_strip_mac_i", reporter);
+    run_single_test(suite, "test_null_passthrough_uplane", reporter);
+    run_single_test(suite, "test_null_passthrough_length_limit", reporter);
+    run_single_test(suite, "test_null_passthrough_ordering", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,617 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "sec_sg_utils.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include <malloc.h> // memalign...
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Physical address returned for the start of the SG tables memory */
+#define TEST_SG_TBLS_PHYS_ADDR      0x20000000
+
+/** Maximum number of fragments of a packet that fit in one table, excluding the parent buffer */
+#define TEST_MAX_FRAGMENTS          (SEC_MAX_SG_TBL_ENTRIES - 1)
+
+/** Physical address of a SG table owned by UA */
+#define TEST_UA_SG_TBL_PHYS_ADDR    0x30000000
+
+/** Mask of the length in the second word of a SG table entry */
+#define TEST_SG_ENTRY_LENGTH_MASK   0x3FFFFFFF
+
+/** Length of each fragment of a test packet */
+#define TEST_FRAGMENT_LENGTH        100
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static struct sec_sg_tbl_entry *test_sg_tbls = NULL;
+
+static sec_sg_tbl_pool_t test_pool;
+
+/** One SG context per table in the pool, enough to drain it */
+static sec_sg_context_t test_sg_ctxs[SEC_SG_TBL_POOL_TBLS_NO];
+
+static sec_packet_t test_packet[SEC_MAX_SG_FRAGMENTS + 1];
+
+/** Memory of the fragments of test_packet, seen through test_ptov() */
+static uint8_t test_fragments_mem[0x1000 * 8];
+
+/** Bounce buffers of a job, input then output */
+static uint8_t test_bounce_buf[2 * SEC_SG_BOUNCE_BUF_SIZE];
+
+/** SG table formatted as UA would, with format_sg_tbl() */
+static struct sec_sg_tbl_entry test_ua_sg_tbl[SEC_MAX_SG_FRAGMENTS + 1];
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+/** Builds a packet made of num_fragments + 1 fragments of #TEST_FRAGMENT_LENGTH bytes */
+static void prepare_test_packet(int num_fragments)
+{
+    int i = 0;
+
+    memset(test_packet, 0, sizeof(test_packet));
+    for (i = 0; i <= num_fragments; i++)
+    {
+        test_packet[i].address = 0x1000 * (i + 1);
+        test_packet[i].length = TEST_FRAGMENT_LENGTH;
+    }
+    test_packet[0].num_fragments = num_fragments;
+    test_packet[0].total_length = TEST_FRAGMENT_LENGTH * (num_fragments + 1);
+}
+
+/** Returns the number of free tables of a class */
+static uint32_t get_free_tbls_no(int class_idx)
+{
+    return test_pool.classes[class_idx].return_idx - test_pool.classes[class_idx].take_idx;
+}
+
+/** P2V for the addresses set by prepare_test_packet() */
+static void* test_ptov(dma_addr_t p)
+{
+    return test_fragments_mem + p;
+}
+
+/** Returns the address written in a SG table entry by SG_TBL_SET_ADDRESS() */
+static uint64_t get_sg_entry_address(const struct sec_sg_tbl_entry *sg_entry)
+{
+    uint64_t address = 0;
+
+    memcpy(&address, sg_entry, sizeof(address));
+    return address;
+}
+
+/** Returns the length written in a SG table entry by SG_TBL_SET_LENGTH_OFF() */
+static uint32_t get_sg_entry_length(const struct sec_sg_tbl_entry *sg_entry)
+{
+    uint64_t length_off = 0;
+
+    memcpy(&length_off, (const uint8_t*)sg_entry + sizeof(length_off), sizeof(length_off));
+    return (length_off >> 32) & TEST_SG_ENTRY_LENGTH_MASK;
+}
+
+/** Walks the chain of input SG tables built for test_packet and checks each entry.
+ * Returns the number of tables in the chain, or -1 if an entry is wrong. */
+static int check_sg_chain(const sec_sg_context_t *sg_ctx, int num_fragments)
+{
+    const sec_sg_tbl_class_t *sg_class = &test_pool.classes[sg_ctx->in_sg_tbl_class];
+    const struct sec_sg_tbl_entry *sg_tbl = sg_ctx->in_sg_tbl;
+    uint64_t address = 0;
+    uint32_t entry_idx = 0;
+    int tbls_no = 1;
+    int i = 0;
+
+    while (i <= num_fragments)
+    {
+        address = get_sg_entry_address(&sg_tbl[entry_idx]);
+
+        if (sg_tbl[entry_idx].ext == 1)
+        {
+            // Only the last entry of a table extends it, and never with the last fragment
+            if (entry_idx != sg_class->entries_no - 1 || sg_tbl[entry_idx].final == 1)
+            {
+                return -1;
+            }
+            sg_tbl = test_sg_tbls + (address - TEST_SG_TBLS_PHYS_ADDR) / SEC_SG_TBL_SIZE;
+            entry_idx = 0;
+            tbls_no++;
+            continue;
+        }
+
+        if (address != test_packet[i].address ||
+            get_sg_entry_length(&sg_tbl[entry_idx]) != TEST_FRAGMENT_LENGTH ||
+            sg_tbl[entry_idx].final != (i == num_fragments))
+        {
+            return -1;
+        }
+        entry_idx++;
+        i++;
+    }
+
+    return tbls_no;
+}
+
+static void tests_setup(void)
+{
+    memset(test_sg_tbls, 0, SEC_DMA_MEM_SG_SIZE);
+    memset(test_sg_ctxs, 0, sizeof(test_sg_ctxs));
+    init_sg_tbl_pool(&test_pool, test_sg_tbls, TEST_SG_TBLS_PHYS_ADDR);
+}
+
+static void test_sg_tbl_pool_init(void)
+{
+    assert_equal(get_free_tbls_no(0), SEC_SG_TBL_CLASS_SMALL_NO);
+    assert_equal(get_free_tbls_no(1), SEC_SG_TBL_CLASS_MEDIUM_NO);
+    assert_equal(get_free_tbls_no(2), SEC_SG_TBL_CLASS_LARGE_NO);
+
+    // The classes are laid out one after the other in the SG tables memory
+    assert_equal(test_pool.classes[0].tbls, test_sg_tbls);
+    assert_equal(test_pool.classes[1].tbls,
+                 test_sg_tbls + SEC_SG_TBL_CLASS_SMALL_NO * SEC_SG_TBL_CLASS_SMALL_ENTRIES);
+    assert_equal(test_pool.classes[2].tbls_phys,
+                 TEST_SG_TBLS_PHYS_ADDR +
+                 (SEC_SG_TBL_CLASS_SMALL_NO * SEC_SG_TBL_CLASS_SMALL_ENTRIES +
+                  SEC_SG_TBL_CLASS_MEDIUM_NO * SEC_SG_TBL_CLASS_MEDIUM_ENTRIES) * SEC_SG_TBL_SIZE);
+    assert_equal(test_pool.classes[2].tbls + SEC_SG_TBL_CLASS_LARGE_NO * SEC_SG_TBL_CLASS_LARGE_ENTRIES,
+                 test_sg_tbls + SEC_DMA_MEM_SG_TBLS_SIZE / SEC_SG_TBL_SIZE);
+}
+
+static void test_sg_tbl_pool_class_selection(void)
+{
+    sec_sg_context_t *sg_ctx = &test_sg_ctxs[0];
+    int ret = 0;
+
+    // A packet without fragments needs no table
+    prepare_test_packet(0);
+    ret = build_sg_context(&test_pool, sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, 0);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(sg_ctx->in_sg_tbl_en, 0);
+
+    // Up to 3 fragments fit in a small table
+    prepare_test_packet(3);
+    ret = build_sg_context(&test_pool, sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, 3);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on build_sg_context: ret = %d!", ret);
+    assert_equal(sg_ctx->in_sg_tbl_en, 1);
+    assert_equal_with_message(sg_ctx->in_sg_tbl_class, 0,
+                              "ERROR: 3 fragments use a table of class %d!", sg_ctx->in_sg_tbl_class);
+    assert_equal(sg_ctx->in_total_length, 4 * TEST_FRAGMENT_LENGTH);
+    assert_equal(sg_ctx->in_sg_tbl[3].final, 1);
+    assert_equal(sg_ctx->in_sg_tbl[2].final, 0);
+    assert_equal(sg_ctx->in_sg_tbl_phy,
+                 TEST_SG_TBLS_PHYS_ADDR + (sg_ctx->in_sg_tbl - test_sg_tbls) * SEC_SG_TBL_SIZE);
+    assert_equal(get_free_tbls_no(0), SEC_SG_TBL_CLASS_SMALL_NO - 1);
+
+    // 4 fragments need a medium table, on the output side
+    prepare_test_packet(4);
+    ret = build_sg_context(&test_pool, sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_OUT, 4);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(sg_ctx->out_sg_tbl_en, 1);
+    assert_equal_with_message(sg_ctx->out_sg_tbl_class, 1,
+                              "ERROR: 4 fragments use a table of class %d!", sg_ctx->out_sg_tbl_class);
+    assert_equal(sg_ctx->out_sg_tbl[4].final, 1);
+    assert_equal(get_free_tbls_no(1), SEC_SG_TBL_CLASS_MEDIUM_NO - 1);
+
+    // Both tables go back to their classes
+    release_sg_context(&test_pool, sg_ctx);
+    assert_equal(sg_ctx->in_sg_tbl_en, 0);
+    assert_equal(sg_ctx->out_sg_tbl_en, 0);
+    assert_equal(get_free_tbls_no(0), SEC_SG_TBL_CLASS_SMALL_NO);
+    assert_equal(get_free_tbls_no(1), SEC_SG_TBL_CLASS_MEDIUM_NO);
+
+    // The maximum number of fragments needs a large table
+    prepare_test_packet(TEST_MAX_FRAGMENTS);
+    ret = build_sg_context(&test_pool, sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, TEST_MAX_FRAGMENTS);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(sg_ctx->in_sg_tbl_class, 2);
+    assert_equal(sg_ctx->in_sg_tbl[TEST_MAX_FRAGMENTS].final, 1);
+    release_sg_context(&test_pool, sg_ctx);
+    assert_equal(get_free_tbls_no(2), SEC_SG_TBL_CLASS_LARGE_NO);
+}
+
+static void test_sg_tbl_pool_exhaustion(void)
+{
+    int ret = 0;
+    int i = 0;
+
+    prepare_test_packet(1);
+
+    // Packets with one fragment take all the small tables, then the bigger ones.
+    // Assert once after the loop: CGreen cannot carry an assertion per table.
+    for (i = 0; i < SEC_SG_TBL_POOL_TBLS_NO; i++)
+    {
+        ret = build_sg_context(&test_pool, &test_sg_ctxs[i], test_packet, SEC_SG_CONTEXT_TYPE_IN, 1);
+        if (ret != SEC_SUCCESS)
+        {
+            break;
+        }
+    }
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on build_sg_context: packet %d got no table, ret = %d!", i, ret);
+    assert_equal(test_sg_ctxs[SEC_SG_TBL_CLASS_SMALL_NO - 1].in_sg_tbl_class, 0);
+    assert_equal(test_sg_ctxs[SEC_SG_TBL_CLASS_SMALL_NO].in_sg_tbl_class, 1);
+    assert_equal(test_sg_ctxs[SEC_SG_TBL_POOL_TBLS_NO - 1].in_sg_tbl_class, 2);
+
+    // No table left: UA must poll and retry
+    ret = build_sg_context(&test_pool, &test_sg_ctxs[0], test_packet, SEC_SG_CONTEXT_TYPE_OUT, 1);
+    assert_equal_with_message(ret, SEC_JR_IS_FULL,
+                              "ERROR on build_sg_context: got a table from an empty pool, ret = %d!", ret);
+    assert_equal(test_sg_ctxs[0].out_sg_tbl_en, 0);
+
+    // Tables returned out of order are taken again
+    release_sg_context(&test_pool, &test_sg_ctxs[5]);
+    release_sg_context(&test_pool, &test_sg_ctxs[2]);
+    assert_equal(get_free_tbls_no(0), 2);
+
+    ret = build_sg_context(&test_pool, &test_sg_ctxs[5], test_packet, SEC_SG_CONTEXT_TYPE_IN, 1);
+    assert_equal(ret, SEC_SUCCESS);
+    ret = build_sg_context(&test_pool, &test_sg_ctxs[2], test_packet, SEC_SG_CONTEXT_TYPE_IN, 1);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_not_equal(test_sg_ctxs[5].in_sg_tbl, test_sg_ctxs[2].in_sg_tbl);
+
+    for (i = 0; i < SEC_SG_TBL_POOL_TBLS_NO; i++)
+    {
+        release_sg_context(&test_pool, &test_sg_ctxs[i]);
+    }
+    assert_equal(get_free_tbls_no(0), SEC_SG_TBL_CLASS_SMALL_NO);
+    assert_equal(get_free_tbls_no(1), SEC_SG_TBL_CLASS_MEDIUM_NO);
+    assert_equal(get_free_tbls_no(2), SEC_SG_TBL_CLASS_LARGE_NO);
+}
+
+static void test_sg_tbl_pool_invalid_fragments(void)
+{
+    sec_sg_context_t *sg_ctx = &test_sg_ctxs[0];
+    int ret = 0;
+
+    // Total length does not match the fragments
+    prepare_test_packet(2);
+    test_packet[0].total_length += 1;
+
+    ret = build_sg_context(&test_pool, sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, 2);
+    assert_equal_with_message(ret, SEC_INVALID_INPUT_PARAM,
+                              "ERROR on build_sg_context: invalid fragments accepted, ret = %d!", ret);
+
+    // The table taken stays with the job until the caller releases it
+    assert_equal(get_free_tbls_no(0), SEC_SG_TBL_CLASS_SMALL_NO - 1);
+    release_sg_context(&test_pool, sg_ctx);
+    assert_equal(get_free_tbls_no(0), SEC_SG_TBL_CLASS_SMALL_NO);
+}
+
+static void test_sg_tbl_pool_chain(void)
+{
+    sec_sg_context_t *sg_ctx = &test_sg_ctxs[0];
+    int num_fragments = 0;
+    int tbls_no = 0;
+    int ret = 0;
+
+    // Packets with 33 and up to #SEC_MAX_SG_FRAGMENTS fragments use chains of large tables.
+    // Assert once after the loop: CGreen cannot carry an assertion per packet.
+    for (num_fragments = SEC_MAX_SG_TBL_ENTRIES - 1; num_fragments <= SEC_MAX_SG_FRAGMENTS; num_fragments++)
+    {
+        prepare_test_packet(num_fragments);
+        ret = build_sg_context(&test_pool, sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, num_fragments);
+        if (ret != SEC_SUCCESS)
+        {
+            break;
+        }
+        tbls_no = check_sg_chain(sg_ctx, num_fragments);
+        if (tbls_no != SEC_SG_TBL_CHAIN_LEN(num_fragments) ||
+            sg_ctx->in_sg_tbl_class != SEC_SG_TBL_CLASSES_NO - 1 ||
+            sg_ctx->in_total_length != TEST_FRAGMENT_LENGTH * (num_fragments + 1))
+        {
+            break;
+        }
+        release_sg_context(&test_pool, sg_ctx);
+        if (get_free_tbls_no(2) != SEC_SG_TBL_CLASS_LARGE_NO)
+        {
+            break;
+        }
+    }
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on build_sg_context: %d fragments, ret = %d!", num_fragments, ret);
+    assert_equal_with_message(num_fragments, SEC_MAX_SG_FRAGMENTS + 1,
+                              "ERROR: wrong chain of %d tables for %d fragments!", tbls_no, num_fragments);
+
+    // 32 fragments need 33 entries: the 32nd fragment goes in a second table
+    prepare_test_packet(SEC_MAX_SG_TBL_ENTRIES);
+    ret = build_sg_context(&test_pool, sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_OUT, SEC_MAX_SG_TBL_ENTRIES);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(sg_ctx->out_sg_tbls_no, 2);
+    assert_equal(sg_ctx->out_sg_tbl[SEC_MAX_SG_TBL_ENTRIES - 1].ext, 1);
+    assert_equal(get_free_tbls_no(2), SEC_SG_TBL_CLASS_LARGE_NO - 2);
+    release_sg_context(&test_pool, sg_ctx);
+    assert_equal(get_free_tbls_no(2), SEC_SG_TBL_CLASS_LARGE_NO);
+}
+
+static void test_sg_tbl_pool_chain_exhaustion(void)
+{
+    int chains_no = SEC_SG_TBL_CLASS_LARGE_NO / SEC_SG_TBL_CHAIN_LEN(SEC_MAX_SG_FRAGMENTS);
+    int ret = 0;
+    int i = 0;
+
+    prepare_test_packet(SEC_MAX_SG_FRAGMENTS);
+
+    for (i = 0; i < chains_no; i++)
+    {
+        ret = build_sg_context(&test_pool, &test_sg_ctxs[i], test_packet,
+                               SEC_SG_CONTEXT_TYPE_IN, SEC_MAX_SG_FRAGMENTS);
+        if (ret != SEC_SUCCESS)
+        {
+            break;
+        }
+    }
+    assert_equal_with_message(ret, SEC_SUCCESS,
+                              "ERROR on build_sg_context: chain %d not built, ret = %d!", i, ret);
+
+    // Not enough large tables left for a whole chain: none is taken
+    ret = build_sg_context(&test_pool, &test_sg_ctxs[chains_no], test_packet,
+                           SEC_SG_CONTEXT_TYPE_IN, SEC_MAX_SG_FRAGMENTS);
+    assert_equal(ret, SEC_JR_IS_FULL);
+    assert_equal(test_sg_ctxs[chains_no].in_sg_tbl_en, 0);
+    assert_equal(get_free_tbls_no(2),
+                 SEC_SG_TBL_CLASS_LARGE_NO - chains_no * SEC_SG_TBL_CHAIN_LEN(SEC_MAX_SG_FRAGMENTS));
+
+    // A chain released out of order is rebuilt from the returned tables
+    release_sg_context(&test_pool, &test_sg_ctxs[1]);
+    ret = build_sg_context(&test_pool, &test_sg_ctxs[chains_no], test_packet,
+                           SEC_SG_CONTEXT_TYPE_IN, SEC_MAX_SG_FRAGMENTS);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(check_sg_chain(&test_sg_ctxs[chains_no], SEC_MAX_SG_FRAGMENTS),
+                 SEC_SG_TBL_CHAIN_LEN(SEC_MAX_SG_FRAGMENTS));
+
+    for (i = 0; i <= chains_no; i++)
+    {
+        release_sg_context(&test_pool, &test_sg_ctxs[i]);
+    }
+    assert_equal(get_free_tbls_no(2), SEC_SG_TBL_CLASS_LARGE_NO);
+}
+
+static void test_sg_tbl_pool_ua_tbl(void)
+{
+    sec_sg_context_t *sg_ctx = &test_sg_ctxs[0];
+    int ret = 0;
+
+    // A table formatted by UA is validated once, when it is built
+    prepare_test_packet(5);
+    ret = format_sg_tbl(test_packet, test_ua_sg_tbl);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on format_sg_tbl: ret = %d!", ret);
+    assert_equal(get_sg_entry_address(&test_ua_sg_tbl[3]), test_packet[3].address);
+    assert_equal(get_sg_entry_length(&test_ua_sg_tbl[3]), TEST_FRAGMENT_LENGTH);
+    assert_equal(test_ua_sg_tbl[5].final, 1);
+    assert_equal(test_ua_sg_tbl[4].final, 0);
+    assert_equal(test_ua_sg_tbl[4].ext, 0);
+
+    // It is submitted without taking a table from the pool
+    use_sg_tbl(sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, TEST_UA_SG_TBL_PHYS_ADDR);
+    assert_equal(sg_ctx->in_sg_tbl_en, 1);
+    assert_equal(sg_ctx->in_sg_tbl_phy, TEST_UA_SG_TBL_PHYS_ADDR);
+    assert_equal(sg_ctx->in_total_length, 6 * TEST_FRAGMENT_LENGTH);
+
+    prepare_test_packet(0);
+    use_sg_tbl(sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_OUT, 0);
+    assert_equal(sg_ctx->out_sg_tbl_en, 0);
+
+    // Nothing goes back to the pool when the job is dequeued
+    release_sg_context(&test_pool, sg_ctx);
+    assert_equal(sg_ctx->in_sg_tbl_en, 0);
+    assert_equal(get_free_tbls_no(0), SEC_SG_TBL_CLASS_SMALL_NO);
+    assert_equal(get_free_tbls_no(1), SEC_SG_TBL_CLASS_MEDIUM_NO);
+    assert_equal(get_free_tbls_no(2), SEC_SG_TBL_CLASS_LARGE_NO);
+
+    // More fragments than fit in a table of the pool do not need a chain
+    prepare_test_packet(SEC_MAX_SG_FRAGMENTS);
+    ret = format_sg_tbl(test_packet, test_ua_sg_tbl);
+    assert_equal(ret, SEC_SUCCESS);
+    assert_equal(test_ua_sg_tbl[SEC_MAX_SG_TBL_ENTRIES - 1].ext, 0);
+    assert_equal(test_ua_sg_tbl[SEC_MAX_SG_FRAGMENTS].final, 1);
+
+    // Invalid fragments are rejected
+    prepare_test_packet(5);
+    test_packet[0].total_length += 1;
+    ret = format_sg_tbl(test_packet, test_ua_sg_tbl);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+
+    prepare_test_packet(5);
+    test_packet[2].address = 0;
+    ret = format_sg_tbl(test_packet, test_ua_sg_tbl);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+
+    prepare_test_packet(0);
+    ret = format_sg_tbl(test_packet, test_ua_sg_tbl);
+    assert_equal(ret, SEC_INVALID_INPUT_PARAM);
+}
+
+static void test_sg_tbl_pool_linearize(void)
+{
+    sec_sg_context_t *sg_ctx = &test_sg_ctxs[0];
+    uint32_t frag_length = SEC_SG_BOUNCE_BUF_SIZE / 4;
+    uint32_t ret = 0;
+    int i = 0;
+
+    sg_ctx->bounce_buf = test_bounce_buf;
+
+    // A short packet with 4 fragments is copied to the input bounce buffer
+    prepare_test_packet(3);
+    memset(test_fragments_mem, 0, sizeof(test_fragments_mem));
+    for (i = 0; i <= 3; i++)
+    {
+        test_packet[i].length = frag_length;
+        test_packet[i].offset = i;
+        memset(test_fragments_mem + test_packet[i].address + i, 'a' + i, frag_length);
+    }
+    test_packet[0].total_length = 4 * frag_length;
+
+    ret = linearize_sg_packet(sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, test_ptov);
+    assert_equal(ret, TRUE);
+    assert_equal(sg_ctx->in_bounce_en, 1);
+    assert_equal(sg_ctx->in_sg_tbl_en, 0);
+    assert_equal(sg_ctx->in_total_length, 4 * frag_length);
+    assert_equal(test_bounce_buf[0], 'a');
+    assert_equal(test_bounce_buf[frag_length - 1], 'a');
+    assert_equal(test_bounce_buf[frag_length], 'b');
+    assert_equal(test_bounce_buf[4 * frag_length - 1], 'd');
+
+    // The output is copied back to the fragments when the job is dequeued
+    ret = linearize_sg_packet(sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_OUT, test_ptov);
+    assert_equal(ret, TRUE);
+    assert_equal(sg_ctx->out_bounce_en, 1);
+
+    memset(test_bounce_buf + SEC_SG_BOUNCE_BUF_SIZE, 'x', 3 * frag_length);
+    memset(test_bounce_buf + SEC_SG_BOUNCE_BUF_SIZE + 3 * frag_length, 'y', frag_length);
+    scatter_bounce_buf(sg_ctx, test_packet, test_ptov);
+    assert_equal(test_fragments_mem[test_packet[0].address + 0], 'x');
+    assert_equal(test_fragments_mem[test_packet[2].address + 2 + frag_length - 1], 'x');
+    assert_equal(test_fragments_mem[test_packet[3].address + 3], 'y');
+    // Bytes before the offset of a fragment are left untouched
+    assert_equal(test_fragments_mem[test_packet[3].address + 2], 0);
+
+    // Released like any other job
+    release_sg_context(&test_pool, sg_ctx);
+    assert_equal(sg_ctx->in_bounce_en, 0);
+    assert_equal(sg_ctx->out_bounce_en, 0);
+    assert_equal(get_free_tbls_no(0), SEC_SG_TBL_CLASS_SMALL_NO);
+
+    // Longer than a bounce buffer, or fragments longer than the packet: a SG table is needed
+    test_packet[0].total_length = SEC_SG_BOUNCE_BUF_SIZE + 1;
+    test_packet[3].length = frag_length + 1;
+    ret = linearize_sg_packet(sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, test_ptov);
+    assert_equal(ret, FALSE);
+
+    test_packet[0].total_length = 4 * frag_length;
+    ret = linearize_sg_packet(sg_ctx, test_packet, SEC_SG_CONTEXT_TYPE_IN, test_ptov);
+    assert_equal(ret, FALSE);
+    assert_equal(sg_ctx->in_bounce_en, 0);
+}
+
+static TestSuite * sg_tbl_pool_tests()
+{
+    /* create test suite */
+    TestSuite * suite = create_test_suite();
+
+    /* setup/teardown functions to be called before/after each unit test */
+    setup(suite, tests_setup);
+//    teardown(suite, tests_teardown);
+
+    /* start adding unit tests */
+    add_test(suite, test_sg_tbl_pool_init);
+    add_test(suite, test_sg_tbl_pool_class_selection);
+    add_test(suite, test_sg_tbl_pool_exhaustion);
+    add_test(suite, test_sg_tbl_pool_invalid_fragments);
+    add_test(suite, test_sg_tbl_pool_chain);
+    add_test(suite, test_sg_tbl_pool_chain_exhaustion);
+    add_test(suite, test_sg_tbl_pool_ua_tbl);
+    add_test(suite, test_sg_tbl_pool_linearize);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    test_sg_tbls = memalign(L1_CACHE_BYTES, SEC_DMA_MEM_SG_SIZE);
+    assert(test_sg_tbls != NULL);
+
+    /* create test suite */
+    TestSuite * suite = sg_tbl_pool_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_sg_tbl_pool_init", reporter);
+    run_single_test(suite, "test_sg_tbl_pool_class_selection", reporter);
+    run_single_test(suite, "test_sg_tbl_pool_exhaustion", reporter);
+    run_single_test(suite, "test_sg_tbl_pool_invalid_fragments", reporter);
+    run_single_test(suite, "test_sg_tbl_pool_chain", reporter);
+    run_single_test(suite, "test_sg_tbl_pool_chain_exhaustion", reporter);
+    run_single_test(suite, "test_sg_tbl_pool_ua_tbl", reporter);
+    run_single_test(suite, "test_sg_tbl_pool_linearize", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    free(test_sg_tbls);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,265 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "fsl_sec.h"
+#include "sec_sw_crypto.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+// WCDMA RLC test vectors, shared with the system tests
+#include "test_sec_driver_wcdma_test_vectors.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Number of jobs submitted at once in the batch tests. Not a multiple
+ * of the number of lanes, to exercise partially filled lanes. */
+#define TEST_BATCH_SIZE     (SEC_SW_CRYPTO_LANES * 5 + 3)
+
+/** Maximum payload length used in the batch tests */
+#define TEST_MAX_MSG_LEN    300
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static uint8_t test_messages[TEST_BATCH_SIZE][TEST_MAX_MSG_LEN];
+static uint8_t test_results[TEST_BATCH_SIZE][TEST_MAX_MSG_LEN];
+static uint8_t test_keys[3][TEST_KEY_LEN];
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+/** @brief Computes COUNT-C for a test scenario, from its HFN and the SN in its RLC header.
+ *
+ * @param [in] scenario     Index of the test scenario.
+ *
+ * @retval COUNT-C
+ */
+static uint32_t get_count_c(int scenario);
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+static uint32_t get_count_c(int scenario)
+{
+    const uint8_t *hdr = test_hdr[scenario];
+    uint32_t sn;
+
+    if (test_data_mode[scenario] == RLC_UNACKED_MODE)
+    {
+        // UM header: SN(7) | E(1)
+        sn = hdr[0] >> 1;
+    }
+    else
+    {
+        // AM header: D/C(1) | SN(12) | P(1) | HE(2)
+        sn = ((((uint32_t)hdr[0] << 8) | hdr[1]) >> 3) & 0xFFF;
+    }
+
+    return (test_hfn[scenario] << test_data_mode[scenario]) | sn;
+}
+
+static void test_kasumi_f8_wcdma_vectors(void)
+{
+    static uint8_t out[MAX_NUM_SCENARIOS][TEST_MAX_MSG_LEN];
+    sec_sw_kasumi_f8_job_t jobs[MAX_NUM_SCENARIOS];
+    int scenarios[MAX_NUM_SCENARIOS];
+    uint32_t jobs_no = 0;
+    int i;
+    int ret;
+
+    // UM and AM, uplink and downlink, in the same batch
+    for (i = 0; i < MAX_NUM_SCENARIOS; i++)
+    {
+        if (test_scenarios[i].cipher_algorithm != SEC_ALG_RLC_CRYPTO_KASUMI)
+        {
+            continue;
+        }
+
+        assert(test_data_in_len[i] <= TEST_MAX_MSG_LEN);
+        jobs[jobs_no].key = test_crypto_key[i];
+        jobs[jobs_no].in = test_data_in[i];
+        jobs[jobs_no].out = out[jobs_no];
+        jobs[jobs_no].length = test_data_in_len[i];
+        jobs[jobs_no].count = get_count_c(i);
+        jobs[jobs_no].bearer = test_bearer[i];
+        jobs[jobs_no].direction = test_packet_direction[i];
+        scenarios[jobs_no] = i;
+        jobs_no++;
+    }
+    assert_true_with_message(jobs_no > 0, "No RLC KASUMI test vectors found");
+
+    ret = sec_sw_kasumi_f8_batch(jobs, jobs_no);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_kasumi_f8_batch: ret = %d!", ret);
+
+    for (i = 0; i < jobs_no; i++)
+    {
+        int scenario = scenarios[i];
+
+        assert_equal_with_message(test_data_out_len[scenario], test_data_in_len[scenario],
+                "Unexpected output length for test scenario %d", scenario);
+        assert_true_with_message(memcmp(out[i], test_data_out[scenario], test_data_out_len[scenario]) == 0,
+                "Wrong ciphertext for test scenario %d", scenario);
+    }
+}
+
+static void test_kasumi_f8_batch_matches_single(void)
+{
+    sec_sw_kasumi_f8_job_t batch[TEST_BATCH_SIZE];
+    sec_sw_kasumi_f8_job_t single;
+    uint8_t result[TEST_MAX_MSG_LEN];
+    int i;
+    int ret;
+
+    for (i = 0; i < sizeof(test_keys); i++)
+    {
+        ((uint8_t*)test_keys)[i] = (uint8_t)rand();
+    }
+
+    // Mix lengths (including empty payloads and block multiples) and keys, with runs
+    // of jobs on the same key, as they would come from a few busy contexts.
+    for (i = 0; i < TEST_BATCH_SIZE; i++)
+    {
+        int j;
+
+        for (j = 0; j < TEST_MAX_MSG_LEN; j++)
+        {
+            test_messages[i][j] = (uint8_t)rand();
+        }
+        batch[i].key = test_keys[(i / 3) % 3];
+        batch[i].in = test_messages[i];
+        batch[i].out = test_results[i];
+        batch[i].length = (i % 4 == 0) ? (i * 8) % TEST_MAX_MSG_LEN : (uint32_t)(rand() % TEST_MAX_MSG_LEN);
+        batch[i].count = (uint32_t)rand();
+        batch[i].bearer = (uint8_t)(rand() & 0x1F);
+        batch[i].direction = (uint8_t)(rand() & 0x01);
+    }
+
+    ret = sec_sw_kasumi_f8_batch(batch, TEST_BATCH_SIZE);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_kasumi_f8_batch: ret = %d!", ret);
+
+    for (i = 0; i < TEST_BATCH_SIZE; i++)
+    {
+        single = batch[i];
+        single.out = result;
+        memset(result, 0, sizeof(result));
+
+        ret = sec_sw_kasumi_f8_batch(&single, 1);
+        assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_kasumi_f8_batch: ret = %d!", ret);
+
+        assert_true_with_message(memcmp(result, test_results[i], batch[i].length) == 0,
+                "Payload ciphered in batch differs from the one ciphered alone for job %d", i);
+    }
+
+    // Deciphering in place restores the original payloads
+    for (i = 0; i < TEST_BATCH_SIZE; i++)
+    {
+        batch[i].in = test_results[i];
+    }
+    ret = sec_sw_kasumi_f8_batch(batch, TEST_BATCH_SIZE);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_kasumi_f8_batch: ret = %d!", ret);
+
+    for (i = 0; i < TEST_BATCH_SIZE; i++)
+    {
+        assert_true_with_message(memcmp(test_results[i], test_messages[i], batch[i].length) == 0,
+                "Deciphered payload differs from the original one for job %d", i);
+    }
+
+    // An empty batch is valid
+    ret = sec_sw_kasumi_f8_batch(batch, 0);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_kasumi_f8_batch: ret = %d!", ret);
+}
+
+static TestSuite * sw_crypto_rlc_tests()
+{
+    /* create test suite */
+    TestSuite * suite = create_test_suite();
+
+    /* start adding unit tests */
+    add_test(suite, test_kasumi_f8_wcdma_vectors);
+    add_test(suite, test_kasumi_f8_batch_matches_single);
+
+    return suite;
+} /* sw_crypto_rlc_tests() */
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* create test suite */
+    TestSuite * suite = sw_crypto_rlc_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    srand(0);
+
+    /* Run tests */
+    run_single_test(suite, "test_kasumi_f8_wcdma_vectors", reporter);
+    run_single_test(suite, "test_kasumi_f8_batch_matches_single", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
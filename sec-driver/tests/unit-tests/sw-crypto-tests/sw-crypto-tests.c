@@ -0,0 +1,461 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "fsl_sec.h"
+#include "sec_sw_crypto.h"
+#include "sec_keystream_cache.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+// PDCP test vectors, shared with the system tests
+#include "test_sec_driver_test_vectors.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Number of jobs submitted at once in the batch tests. Not a multiple
+ * of the number of lanes, to exercise partially filled lanes. */
+#define TEST_BATCH_SIZE     (SEC_SW_CRYPTO_LANES * 5 + 3)
+
+/** Maximum message length used in the batch tests */
+#define TEST_MAX_MSG_LEN    300
+
+/** Size of the MAC-I */
+#define TEST_MAC_I_LEN      4
+
+/** Room for the longest PDU of the test vectors, plus AES keystream rounding */
+#define TEST_MAX_PDU_LEN    1024
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+/** FIPS-197 Appendix C.1 AES-128 test vector */
+static const uint8_t fips197_key[] = {0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,
+                                      0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f};
+static const uint8_t fips197_pt[]  = {0x00,0x11,0x22,0x33,0x44,0x55,0x66,0x77,
+                                      0x88,0x99,0xaa,0xbb,0xcc,0xdd,0xee,0xff};
+static const uint8_t fips197_ct[]  = {0x69,0xc4,0xe0,0xd8,0x6a,0x7b,0x04,0x30,
+                                      0xd8,0xcd,0xb7,0x80,0x70,0xb4,0xc5,0x5a};
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+static uint8_t test_messages[TEST_BATCH_SIZE][TEST_MAX_MSG_LEN];
+static uint8_t test_keys[3][TEST_KEY_LEN];
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+static void test_aes128_fips197(void)
+{
+    uint32_t rk[SEC_SW_AES128_RK_WORDS];
+    uint8_t block[SEC_SW_CRYPTO_LANES][SEC_SW_AES_BLOCK_SIZE];
+    const uint32_t *rks[SEC_SW_CRYPTO_LANES];
+    uint8_t *blocks[SEC_SW_CRYPTO_LANES];
+    int i;
+
+    sec_sw_aes128_expand_key(fips197_key, rk);
+
+    for (i = 0; i < SEC_SW_CRYPTO_LANES; i++)
+    {
+        memcpy(block[i], fips197_pt, sizeof(fips197_pt));
+        rks[i] = rk;
+        blocks[i] = block[i];
+    }
+
+    sec_sw_aes128_encrypt_lanes(rks, blocks, SEC_SW_CRYPTO_LANES);
+
+    for (i = 0; i < SEC_SW_CRYPTO_LANES; i++)
+    {
+        assert_true_with_message(memcmp(block[i], fips197_ct, sizeof(fips197_ct)) == 0,
+                "Wrong AES-128 ciphertext on lane %d", i);
+    }
+}
+
+static void test_eia2_pdcp_cplane_vectors(void)
+{
+    static uint8_t pdus[MAX_NUM_SCENARIOS][TEST_MAX_MSG_LEN];
+    sec_sw_eia2_job_t jobs[MAX_NUM_SCENARIOS];
+    int scenarios[MAX_NUM_SCENARIOS];
+    uint32_t jobs_no = 0;
+    int i;
+    int ret;
+
+    // The MAC-I is in clear at the end of the PDU only if there is no ciphering.
+    for (i = 0; i < MAX_NUM_SCENARIOS; i++)
+    {
+        if (test_scenarios[i].type != PDCP_CONTROL_PLANE ||
+            test_scenarios[i].cipher_algorithm != SEC_ALG_NULL ||
+            test_scenarios[i].integrity_algorithm != SEC_ALG_AES)
+        {
+            continue;
+        }
+
+        // The vectors keep the header apart from the payload: rebuild the PDU
+        assert(PDCP_CTRL_PLANE_HEADER_LENGTH + test_data_in_len[i] <= TEST_MAX_MSG_LEN);
+        memcpy(pdus[jobs_no], test_hdr[i], PDCP_CTRL_PLANE_HEADER_LENGTH);
+        memcpy(pdus[jobs_no] + PDCP_CTRL_PLANE_HEADER_LENGTH, test_data_in[i], test_data_in_len[i]);
+
+        jobs[jobs_no].key = test_auth_key[i];
+        jobs[jobs_no].message = pdus[jobs_no];
+        jobs[jobs_no].length = PDCP_CTRL_PLANE_HEADER_LENGTH + test_data_in_len[i];
+        jobs[jobs_no].count = (test_hfn[i] << SEC_PDCP_SN_SIZE_5) | (test_hdr[i][0] & 0x1F);
+        jobs[jobs_no].bearer = test_bearer[i];
+        jobs[jobs_no].direction = test_packet_direction[i];
+        scenarios[jobs_no] = i;
+        jobs_no++;
+    }
+    assert_true_with_message(jobs_no > 0, "No PDCP Control Plane AES CMAC test vectors found");
+
+    ret = sec_sw_eia2_compute_batch(jobs, jobs_no);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_eia2_compute_batch: ret = %d!", ret);
+
+    for (i = 0; i < jobs_no; i++)
+    {
+        int scenario = scenarios[i];
+
+        assert_true_with_message(memcmp(jobs[i].mac_i,
+                                        test_data_out[scenario] + test_data_out_len[scenario] - TEST_MAC_I_LEN,
+                                        TEST_MAC_I_LEN) == 0,
+                                 "Wrong MAC-I for test scenario %d", scenario);
+    }
+}
+
+static void test_eia2_batch_matches_single(void)
+{
+    sec_sw_eia2_job_t batch[TEST_BATCH_SIZE];
+    sec_sw_eia2_job_t single;
+    int i;
+    int ret;
+
+    for (i = 0; i < sizeof(test_keys); i++)
+    {
+        ((uint8_t*)test_keys)[i] = (uint8_t)rand();
+    }
+
+    // Mix lengths (including empty messages and block multiples) and keys, with runs
+    // of jobs on the same key, as they would come from a few busy contexts.
+    for (i = 0; i < TEST_BATCH_SIZE; i++)
+    {
+        int j;
+
+        for (j = 0; j < TEST_MAX_MSG_LEN; j++)
+        {
+            test_messages[i][j] = (uint8_t)rand();
+        }
+        batch[i].key = test_keys[(i / 3) % 3];
+        batch[i].message = test_messages[i];
+        batch[i].length = (i % 4 == 0) ? (i * 8) % TEST_MAX_MSG_LEN : (uint32_t)(rand() % TEST_MAX_MSG_LEN);
+        batch[i].count = (uint32_t)rand();
+        batch[i].bearer = (uint8_t)(rand() & 0x1F);
+        batch[i].direction = (uint8_t)(rand() & 0x01);
+    }
+
+    ret = sec_sw_eia2_compute_batch(batch, TEST_BATCH_SIZE);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_eia2_compute_batch: ret = %d!", ret);
+
+    for (i = 0; i < TEST_BATCH_SIZE; i++)
+    {
+        single = batch[i];
+        memset(single.mac_i, 0, sizeof(single.mac_i));
+
+        ret = sec_sw_eia2_compute_batch(&single, 1);
+        assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_eia2_compute_batch: ret = %d!", ret);
+
+        assert_true_with_message(memcmp(single.mac_i, batch[i].mac_i, TEST_MAC_I_LEN) == 0,
+                "MAC-I computed in batch differs from the one computed alone for job %d", i);
+    }
+
+    // An empty batch is valid
+    ret = sec_sw_eia2_compute_batch(batch, 0);
+    assert_equal_with_message(ret, SEC_SUCCESS, "ERROR on sec_sw_eia2_compute_batch: ret = %d!", ret);
+}
+
+static void test_ks_cache_pdcp_uplane_vectors(void)
+{
+    sec_pdcp_context_info_t ctx_info;
+    struct sec_ks_cache_t *cache = NULL;
+    const uint8_t *ks = NULL;
+    uint8_t out[SEC_KEYSTREAM_CACHE_MAX_PAYLOAD];
+    uint32_t count;
+    uint32_t sn;
+    uint32_t len;
+    uint32_t generated;
+    int vectors_no = 0;
+    int i;
+    int j;
+
+    for (i = 0; i < MAX_NUM_SCENARIOS; i++)
+    {
+        if (test_scenarios[i].type != PDCP_DATA_PLANE ||
+            (test_scenarios[i].cipher_algorithm != SEC_ALG_SNOW &&
+             test_scenarios[i].cipher_algorithm != SEC_ALG_AES))
+        {
+            continue;
+        }
+
+        memset(&ctx_info, 0, sizeof(ctx_info));
+        ctx_info.sn_size = test_data_sns[i];
+        ctx_info.bearer = test_bearer[i];
+        ctx_info.packet_direction = test_packet_direction[i];
+        ctx_info.cipher_algorithm = test_scenarios[i].cipher_algorithm;
+        ctx_info.cipher_key = test_crypto_key[i];
+        ctx_info.cipher_key_len = TEST_KEY_LEN;
+
+        sn = (test_data_sns[i] == SEC_PDCP_SN_SIZE_7) ?
+             (test_hdr[i][0] & 0x7F) : (((test_hdr[i][0] & 0x0F) << 8) | test_hdr[i][1]);
+        count = (test_hfn[i] << test_data_sns[i]) | sn;
+
+        // Start a few COUNT values before, so that the PDU is not in the first lane
+        cache = sec_ks_cache_create(&ctx_info, count - 2);
+        assert_true_with_message(cache != NULL, "Failed to create keystream cache");
+
+        generated = sec_ks_cache_refill(cache, SEC_KEYSTREAM_CACHE_DEPTH);
+        assert_equal_with_message(generated, SEC_KEYSTREAM_CACHE_DEPTH,
+                "Wrong number of keystream entries generated: %d", generated);
+
+        ks = sec_ks_cache_lookup(cache, count);
+        assert_true_with_message(ks != NULL, "Keystream cache miss for test scenario %d", i);
+
+        // The cache holds the first SEC_KEYSTREAM_CACHE_MAX_PAYLOAD bytes of keystream
+        len = test_data_in_len[i] < SEC_KEYSTREAM_CACHE_MAX_PAYLOAD ?
+              test_data_in_len[i] : SEC_KEYSTREAM_CACHE_MAX_PAYLOAD;
+        for (j = 0; j < len; j++)
+        {
+            out[j] = test_data_in[i][j] ^ ks[j];
+        }
+        assert_true_with_message(memcmp(out, test_data_out[i], len) == 0,
+                "Wrong keystream for test scenario %d", i);
+
+        sec_ks_cache_destroy(cache);
+        vectors_no++;
+    }
+    assert_true_with_message(vectors_no > 0, "No PDCP User Plane SNOW/AES test vectors found");
+}
+
+static void test_pdcp_keystream_full_pdu(void)
+{
+    static uint8_t ks[TEST_MAX_PDU_LEN];
+    static uint8_t out[TEST_MAX_PDU_LEN];
+    uint32_t aes_rk[SEC_SW_AES128_RK_WORDS];
+    uint32_t count;
+    uint32_t sn;
+    uint32_t len;
+    int vectors_no = 0;
+    int i;
+
+    for (i = 0; i < MAX_NUM_SCENARIOS; i++)
+    {
+        if (test_scenarios[i].type != PDCP_DATA_PLANE ||
+            (test_scenarios[i].cipher_algorithm != SEC_ALG_SNOW &&
+             test_scenarios[i].cipher_algorithm != SEC_ALG_AES))
+        {
+            continue;
+        }
+
+        len = test_data_in_len[i];
+        assert_true_with_message(len <= TEST_MAX_PDU_LEN - SEC_SW_AES_BLOCK_SIZE,
+                "PDU of test scenario %d is too long: %d", i, len);
+
+        sn = (test_data_sns[i] == SEC_PDCP_SN_SIZE_7) ?
+             (test_hdr[i][0] & 0x7F) : (((test_hdr[i][0] & 0x0F) << 8) | test_hdr[i][1]);
+        count = (test_hfn[i] << test_data_sns[i]) | sn;
+
+        sec_sw_aes128_expand_key(test_crypto_key[i], aes_rk);
+
+        // The whole PDU, of any length, the way the hybrid dispatcher ciphers it
+        sec_sw_pdcp_keystream(test_scenarios[i].cipher_algorithm, test_crypto_key[i], aes_rk,
+                              count, test_bearer[i], test_packet_direction[i], ks, len);
+        sec_sw_xor(out, test_data_in[i], ks, len);
+        assert_true_with_message(memcmp(out, test_data_out[i], len) == 0,
+                "Wrong ciphertext for test scenario %d", i);
+
+        // In place
+        memcpy(out, test_data_in[i], len);
+        sec_sw_xor(out, out, ks, len);
+        assert_true_with_message(memcmp(out, test_data_out[i], len) == 0,
+                "Wrong in place ciphertext for test scenario %d", i);
+
+        vectors_no++;
+    }
+    assert_true_with_message(vectors_no > 0, "No PDCP User Plane SNOW/AES test vectors found");
+}
+
+static void test_ks_cache_window(void)
+{
+    static uint8_t ks_copy[SEC_KEYSTREAM_CACHE_DEPTH][SEC_KEYSTREAM_CACHE_MAX_PAYLOAD];
+    sec_pdcp_context_info_t ctx_info;
+    struct sec_ks_cache_t *cache = NULL;
+    struct sec_ks_cache_t *single = NULL;
+    const uint8_t *ks = NULL;
+    uint32_t first_count = 0xFFFFFFF0; // wraps around inside the window
+    uint32_t generated;
+    int alg;
+    int i;
+
+    for (i = 0; i < sizeof(test_keys); i++)
+    {
+        ((uint8_t*)test_keys)[i] = (uint8_t)rand();
+    }
+
+    for (alg = SEC_ALG_SNOW; alg <= SEC_ALG_AES; alg++)
+    {
+        memset(&ctx_info, 0, sizeof(ctx_info));
+        ctx_info.sn_size = SEC_PDCP_SN_SIZE_12;
+        ctx_info.bearer = 0x15;
+        ctx_info.packet_direction = 1;
+        ctx_info.cipher_algorithm = alg;
+        ctx_info.cipher_key = test_keys[alg];
+        ctx_info.cipher_key_len = TEST_KEY_LEN;
+
+        cache = sec_ks_cache_create(&ctx_info, first_count);
+        assert_true_with_message(cache != NULL, "Failed to create keystream cache");
+
+        // Budget is honored, and the cache never holds more than its depth
+        generated = sec_ks_cache_refill(cache, 3);
+        assert_equal_with_message(generated, 3, "Budget not honored: %d entries generated", generated);
+        generated = sec_ks_cache_refill(cache, 1000);
+        assert_equal_with_message(generated, SEC_KEYSTREAM_CACHE_DEPTH - 3,
+                "Cache overfilled: %d entries generated", generated);
+        generated = sec_ks_cache_refill(cache, 1000);
+        assert_equal_with_message(generated, 0, "Full cache refilled: %d entries generated", generated);
+
+        for (i = 0; i < SEC_KEYSTREAM_CACHE_DEPTH; i++)
+        {
+            ks = sec_ks_cache_lookup(cache, first_count + i);
+            assert_true_with_message(ks != NULL, "Keystream cache miss for COUNT 0x%x", first_count + i);
+            memcpy(ks_copy[i], ks, SEC_KEYSTREAM_CACHE_MAX_PAYLOAD);
+        }
+
+        // Entries generated in parallel lanes match the entries generated one at a time
+        for (i = 0; i < SEC_KEYSTREAM_CACHE_DEPTH; i++)
+        {
+            single = sec_ks_cache_create(&ctx_info, first_count + i);
+            assert_true_with_message(single != NULL, "Failed to create keystream cache");
+            sec_ks_cache_refill(single, 1);
+            ks = sec_ks_cache_lookup(single, first_count + i);
+            assert_true_with_message(ks != NULL && memcmp(ks, ks_copy[i], SEC_KEYSTREAM_CACHE_MAX_PAYLOAD) == 0,
+                    "Keystream for COUNT 0x%x differs when generated alone", first_count + i);
+            sec_ks_cache_destroy(single);
+        }
+
+        // Consumed entries, and entries older than the last consumed one, are gone
+        assert_true_with_message(sec_ks_cache_lookup(cache, first_count) == NULL,
+                "Consumed keystream entry was returned again");
+
+        // A miss resynchronizes the cache right after the missed COUNT
+        sec_ks_cache_refill(cache, 4);
+        assert_true_with_message(sec_ks_cache_lookup(cache, first_count + 100) == NULL,
+                "Keystream cache hit for a COUNT that was not generated");
+        sec_ks_cache_refill(cache, 4);
+        assert_true_with_message(sec_ks_cache_lookup(cache, first_count + 102) != NULL,
+                "Keystream cache miss after resynchronization");
+        assert_true_with_message(sec_ks_cache_lookup(cache, first_count + 101) == NULL,
+                "Skipped keystream entry was returned");
+
+        sec_ks_cache_destroy(cache);
+    }
+}
+
+static TestSuite * sw_crypto_tests()
+{
+    /* create test suite */
+    TestSuite * suite = create_test_suite();
+
+    /* start adding unit tests */
+    add_test(suite, test_aes128_fips197);
+    add_test(suite, test_eia2_pdcp_cplane_vectors);
+    add_test(suite, test_eia2_batch_matches_single);
+    add_test(suite, test_ks_cache_pdcp_uplane_vectors);
+    add_test(suite, test_ks_cache_window);
+    add_test(suite, test_pdcp_keystream_full_pdu);
+
+    return suite;
+} /* sw_crypto_tests() */
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* create test suite */
+    TestSuite * suite = sw_crypto_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    srand(0);
+
+    /* Run tests */
+    run_single_test(suite, "test_aes128_fips197", reporter);
+    run_single_test(suite, "test_eia2_pdcp_cplane_vectors", reporter);
+    run_single_test(suite, "test_eia2_batch_matches_single", reporter);
+    run_single_test(suite, "test_ks_cache_pdcp_uplane_vectors", reporter);
+    run_single_test(suite, "test_ks_cache_window", reporter);
+    run_single_test(suite, "test_pdcp_keystream_full_pdu", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,207 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/*=================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include "fsl_sec.h"
+#include "fsl_sec_time.h"
+#include "cgreen.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Number of consecutive readings checked */
+#define TEST_READINGS_NO    10000
+/** Duration of the sleep measured both with the counter and with CLOCK_MONOTONIC */
+#define TEST_SLEEP_NS       50000000ULL
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL CONSTANTS
+==================================================================================================*/
+
+/*==================================================================================================
+                                     GLOBAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+
+static uint64_t get_monotonic_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * SEC_TIME_NS_PER_SECOND + ts.tv_nsec;
+}
+
+static void test_time_read_monotonic(void)
+{
+    uint64_t previous;
+    uint64_t now;
+    uint32_t errors = 0;
+    int i;
+
+    // The plain and the serialized readings come from the same counter
+    previous = sec_time_read();
+    for (i = 0; i < TEST_READINGS_NO; i++)
+    {
+        now = (i % 3 == 0) ? sec_time_read() : (i % 3 == 1) ? sec_time_read_start() : sec_time_read_end();
+        if (now < previous)
+        {
+            errors++;
+        }
+        previous = now;
+    }
+    assert_equal(errors, 0);
+
+    // The counter runs
+    now = sec_time_read();
+    while (sec_time_read() == now);
+}
+
+static void test_time_frequency(void)
+{
+    uint64_t frequency = sec_time_get_frequency();
+
+    assert_not_equal(frequency, 0);
+    // The frequency is found once
+    assert_true(sec_time_get_frequency() == frequency);
+
+    assert_true(sec_time_ticks_to_ns(0) == 0);
+    assert_true(sec_time_ticks_to_ns(frequency) == SEC_TIME_NS_PER_SECOND);
+    assert_true(sec_time_ticks_to_ns(frequency * 3600) == 3600 * SEC_TIME_NS_PER_SECOND);
+    assert_true(sec_time_ticks_to_ns(frequency / 2) <= SEC_TIME_NS_PER_SECOND / 2);
+    assert_true(sec_time_ticks_to_ns(frequency / 2) >= SEC_TIME_NS_PER_SECOND / 2 - 1);
+}
+
+static void test_time_against_clock(void)
+{
+    struct timespec delay;
+    uint64_t start_ns, end_ns;
+    uint64_t start, end;
+    uint64_t clock_ns, counter_ns;
+
+    sec_time_get_frequency();
+
+    delay.tv_sec = 0;
+    delay.tv_nsec = TEST_SLEEP_NS;
+
+    start_ns = get_monotonic_ns();
+    start = sec_time_read_start();
+    nanosleep(&delay, NULL);
+    end = sec_time_read_end();
+    end_ns = get_monotonic_ns();
+
+    clock_ns = end_ns - start_ns;
+    counter_ns = sec_time_ticks_to_ns(end - start);
+
+    // The counter interval is inside the clock interval and agrees with it within 2%
+    assert_true(counter_ns <= clock_ns + clock_ns / 50);
+    assert_true(counter_ns >= clock_ns - clock_ns / 50);
+}
+
+static TestSuite * time_tests()
+{
+    TestSuite *suite = create_test_suite();
+
+    add_test(suite, test_time_read_monotonic);
+    add_test(suite, test_time_frequency);
+    add_test(suite, test_time_against_clock);
+
+    return suite;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+
+int main(int argc, char *argv[])
+{
+    /* *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** WARNING *** */
+    /* Be aware that by using run_test_suite() instead of run_single_test(), CGreen will execute
+     * each test case in a separate UNIX process, so:
+     * (1) unit tests' thread safety might need to be ensured by defining critical regions
+     *     (beware, CGreen error messages are not explanatory and intuitive enough)
+     *
+     * Although it is more difficult to maintain synchronization manually,
+     * it is recommended to run_single_test() for each test case.
+     */
+
+    /* create test suite */
+    TestSuite * suite = time_tests();
+    TestReporter * reporter = create_text_reporter();
+
+    /* Run tests */
+    run_single_test(suite, "test_time_read_monotonic", reporter);
+    run_single_test(suite, "test_time_frequency", reporter);
+    run_single_test(suite, "test_time_against_clock", reporter);
+
+    destroy_test_suite(suite);
+    (*reporter->destroy)(reporter);
+
+    return 0;
+} /* main() */
+
+/*================================================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,511 @@
+/* Copyright (c) 2013 Freescale Semiconductor, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of Freescale Semiconductor nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ *
+ * ALTERNATIVELY, this software may be distributed under the terms of the
+ * GNU General Public License ("GPL") as published by the Free Software
+ * Foundation, either version 2 of that License or (at your option) any
+ * later version.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Freescale Semiconductor ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Freescale Semiconductor BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================================================================================================
+                                        INCLUDE FILES
+==================================================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <byteswap.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "fsl_sec.h"
+
+/*==================================================================================================
+                                     LOCAL DEFINES
+==================================================================================================*/
+/** Magic number of a CTF packet header */
+#define CTF_MAGIC   0xC1FC1FC1
+
+/*==================================================================================================
+                          LOCAL TYPEDEFS (STRUCTURES, UNIONS, ENUMS)
+==================================================================================================*/
+/** Output formats */
+typedef enum output_format_e
+{
+    FORMAT_CHROME,
+    FORMAT_CTF,
+}output_format_t;
+
+/** The events of a thread read from the trace file */
+typedef struct thread_trace_s
+{
+    sec_trace_thread_header_t header;
+    sec_trace_event_t *events;
+}thread_trace_t;
+
+/** The contents of a trace file */
+typedef struct trace_s
+{
+    sec_trace_file_header_t header;
+    thread_trace_t *threads;
+}trace_t;
+
+/*==================================================================================================
+                                      LOCAL CONSTANTS
+==================================================================================================*/
+/** Event names, indexed by ::sec_trace_event_type_t */
+static const char *event_names[SEC_TRACE_EVENT_TYPES_NO] =
+{
+    "unknown",
+    "submit",
+    "jr_full",
+    "doorbell",
+    "harvest",
+    "callback",
+    "callback",
+    "jr_flush",
+    "jr_reset",
+    "jr_reset",
+    "irq_enable",
+};
+
+/** Names of the CTF events, unique per type, indexed by ::sec_trace_event_type_t */
+static const char *ctf_event_names[SEC_TRACE_EVENT_TYPES_NO] =
+{
+    "unknown",
+    "submit",
+    "jr_full",
+    "doorbell",
+    "harvest",
+    "callback_enter",
+    "callback_exit",
+    "jr_flush",
+    "jr_reset_begin",
+    "jr_reset_end",
+    "irq_enable",
+};
+
+/*==================================================================================================
+                                      LOCAL VARIABLES
+==================================================================================================*/
+
+/*==================================================================================================
+                                 LOCAL FUNCTION PROTOTYPES
+==================================================================================================*/
+
+/*==================================================================================================
+                                     LOCAL FUNCTIONS
+==================================================================================================*/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-f chrome|ctf] -i <trace file> -o <output>\n"
+            "Converts a trace written by sec_trace_dump() of the SEC user space driver.\n"
+            "  -f chrome  JSON for chrome://tracing or Perfetto, written to the output file,\n"
+            "             or to stdout if the output is '-'. This is the default.\n"
+            "  -f ctf     Common Trace Format, written to the output directory: a metadata\n"
+            "             file and a stream per thread, readable with babeltrace or Trace Compass.\n",
+            name);
+}
+
+static int read_trace(const char *file_name, trace_t *trace)
+{
+    uint32_t swap = 0;
+    uint32_t i, j;
+    FILE *file;
+
+    file = fopen(file_name, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot open %s: %s\n", file_name, strerror(errno));
+        return -1;
+    }
+
+    if (fread(&trace->header, sizeof(trace->header), 1, file) != 1)
+    {
+        fprintf(stderr, "%s is too short\n", file_name);
+        fclose(file);
+        return -1;
+    }
+
+    // A trace from a host of different endianness, e.g. taken on the target
+    // and converted on a workstation
+    if (trace->header.magic == bswap_32(SEC_TRACE_FILE_MAGIC))
+    {
+        swap = 1;
+        trace->header.version = bswap_32(trace->header.version);
+        trace->header.ticks_per_second = bswap_64(trace->header.ticks_per_second);
+        trace->header.threads_no = bswap_32(trace->header.threads_no);
+    }
+    else if (trace->header.magic != SEC_TRACE_FILE_MAGIC)
+    {
+        fprintf(stderr, "%s is not a SEC driver trace\n", file_name);
+        fclose(file);
+        return -1;
+    }
+    if (trace->header.version != SEC_TRACE_FILE_VERSION)
+    {
+        fprintf(stderr, "%s has version %u, only version %u is supported\n",
+                file_name, trace->header.version, SEC_TRACE_FILE_VERSION);
+        fclose(file);
+        return -1;
+    }
+
+    trace->threads = calloc(trace->header.threads_no, sizeof(thread_trace_t));
+    if (trace->threads == NULL && trace->header.threads_no != 0)
+    {
+        fprintf(stderr, "Out of memory\n");
+        fclose(file);
+        return -1;
+    }
+
+    for (i = 0; i < trace->header.threads_no; i++)
+    {
+        thread_trace_t *thread = &trace->threads[i];
+
+        if (fread(&thread->header, sizeof(thread->header), 1, file) != 1)
+        {
+            fprintf(stderr, "%s is truncated\n", file_name);
+            fclose(file);
+            return -1;
+        }
+        if (swap)
+        {
+            thread->header.thread_id = bswap_32(thread->header.thread_id);
+            thread->header.events_no = bswap_32(thread->header.events_no);
+            thread->header.lost_no = bswap_64(thread->header.lost_no);
+        }
+
+        thread->events = malloc((size_t)thread->header.events_no * sizeof(sec_trace_event_t));
+        if (thread->events == NULL && thread->header.events_no != 0)
+        {
+            fprintf(stderr, "Out of memory\n");
+            fclose(file);
+            return -1;
+        }
+        if (fread(thread->events, sizeof(sec_trace_event_t), thread->header.events_no, file) !=
+            thread->header.events_no)
+        {
+            fprintf(stderr, "%s is truncated\n", file_name);
+            fclose(file);
+            return -1;
+        }
+        for (j = 0; swap && j < thread->header.events_no; j++)
+        {
+            thread->events[j].timestamp = bswap_64(thread->events[j].timestamp);
+            thread->events[j].type = bswap_16(thread->events[j].type);
+            thread->events[j].jr_id = bswap_16(thread->events[j].jr_id);
+            thread->events[j].arg = bswap_32(thread->events[j].arg);
+        }
+
+        if (thread->header.lost_no != 0)
+        {
+            fprintf(stderr, "Thread %u: %llu older events were overwritten\n",
+                    thread->header.thread_id, (unsigned long long)thread->header.lost_no);
+        }
+    }
+
+    fclose(file);
+
+    return 0;
+}
+
+static const char* get_event_name(const char **names, uint16_t type)
+{
+    return (type < SEC_TRACE_EVENT_TYPES_NO) ? names[type] : names[0];
+}
+
+static int write_chrome(const trace_t *trace, const char *output)
+{
+    uint64_t start = UINT64_MAX;
+    double us_per_tick;
+    const char *phase;
+    uint32_t first = 1;
+    uint32_t i, j;
+    FILE *out;
+
+    // Timestamps are relative to the first event of all the threads
+    for (i = 0; i < trace->header.threads_no; i++)
+    {
+        if (trace->threads[i].header.events_no != 0 &&
+            trace->threads[i].events[0].timestamp < start)
+        {
+            start = trace->threads[i].events[0].timestamp;
+        }
+    }
+
+    if (trace->header.ticks_per_second == 0)
+    {
+        fprintf(stderr, "The clock frequency is unknown, the timestamps are shown in ticks\n");
+        us_per_tick = 1.0;
+    }
+    else
+    {
+        us_per_tick = 1000000.0 / trace->header.ticks_per_second;
+    }
+
+    out = (strcmp(output, "-") == 0) ? stdout : fopen(output, "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Cannot open %s: %s\n", output, strerror(errno));
+        return -1;
+    }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for (i = 0; i < trace->header.threads_no; i++)
+    {
+        const thread_trace_t *thread = &trace->threads[i];
+
+        fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"name\":\"thread %u\"}}",
+                first ? "" : ",\n", thread->header.thread_id, thread->header.thread_id);
+        first = 0;
+
+        for (j = 0; j < thread->header.events_no; j++)
+        {
+            const sec_trace_event_t *event = &thread->events[j];
+
+            // Callbacks and job ring resets are shown as durations, the rest as instants
+            switch (event->type)
+            {
+                case SEC_TRACE_CALLBACK_ENTER:
+                case SEC_TRACE_JR_RESET_BEGIN:
+                    phase = "\"B\"";
+                    break;
+                case SEC_TRACE_CALLBACK_EXIT:
+                case SEC_TRACE_JR_RESET_END:
+                    phase = "\"E\"";
+                    break;
+                default:
+                    phase = "\"i\",\"s\":\"t\"";
+                    break;
+            }
+            fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"sec\",\"ph\":%s,\"ts\":%.3f,"
+                    "\"pid\":1,\"tid\":%u,\"args\":{\"jr\":%u,\"arg\":%u}}",
+                    get_event_name(event_names, event->type), phase,
+                    (event->timestamp - start) * us_per_tick,
+                    thread->header.thread_id, event->jr_id, event->arg);
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout && fclose(out) != 0)
+    {
+        fprintf(stderr, "Failed to write %s\n", output);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int write_ctf_metadata(const trace_t *trace, const char *output)
+{
+    char path[4096];
+    uint32_t type;
+    FILE *out;
+
+    snprintf(path, sizeof(path), "%s/metadata", output);
+    out = fopen(path, "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    // The streams are written in the byte order of this host
+    fprintf(out,
+            "/* CTF 1.8 */\n\n"
+            "typealias integer { size = 16; align = 8; signed = false; } := uint16_t;\n"
+            "typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n\n"
+            "trace {\n"
+            "    major = 1;\n"
+            "    minor = 8;\n"
+            "    byte_order = %s;\n"
+            "    packet.header := struct {\n"
+            "        uint32_t magic;\n"
+            "        uint32_t stream_id;\n"
+            "    };\n"
+            "};\n\n"
+            "clock {\n"
+            "    name = sec_clock;\n"
+            "    freq = %llu;\n"
+            "};\n\n"
+            "typealias integer { size = 64; align = 8; signed = false; map = clock.sec_clock.value; }"
+            " := uint64_clock_t;\n\n"
+            "stream {\n"
+            "    id = 0;\n"
+            "    event.header := struct {\n"
+            "        uint16_t id;\n"
+            "        uint64_clock_t timestamp;\n"
+            "    };\n"
+            "};\n",
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            "be",
+#else
+            "le",
+#endif
+            (unsigned long long)(trace->header.ticks_per_second != 0 ?
+                                 trace->header.ticks_per_second : 1000000000ULL));
+
+    for (type = SEC_TRACE_SUBMIT; type < SEC_TRACE_EVENT_TYPES_NO; type++)
+    {
+        fprintf(out,
+                "\nevent {\n"
+                "    name = \"%s\";\n"
+                "    id = %u;\n"
+                "    stream_id = 0;\n"
+                "    fields := struct {\n"
+                "        uint16_t jr_id;\n"
+                "        uint32_t arg;\n"
+                "    };\n"
+                "};\n",
+                ctf_event_names[type], type);
+    }
+
+    if (fclose(out) != 0)
+    {
+        fprintf(stderr, "Failed to write %s\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int write_ctf(const trace_t *trace, const char *output)
+{
+    const uint32_t packet_header[2] = { CTF_MAGIC, 0 };
+    char path[4096];
+    uint32_t i, j;
+    FILE *out;
+
+    if (mkdir(output, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "Cannot create %s: %s\n", output, strerror(errno));
+        return -1;
+    }
+
+    if (write_ctf_metadata(trace, output) != 0)
+    {
+        return -1;
+    }
+
+    // One stream per thread, made of a single packet
+    for (i = 0; i < trace->header.threads_no; i++)
+    {
+        const thread_trace_t *thread = &trace->threads[i];
+        size_t written = 0;
+
+        snprintf(path, sizeof(path), "%s/stream_%u", output, thread->header.thread_id);
+        out = fopen(path, "wb");
+        if (out == NULL)
+        {
+            fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+            return -1;
+        }
+
+        written += fwrite(packet_header, sizeof(packet_header), 1, out);
+        for (j = 0; j < thread->header.events_no; j++)
+        {
+            const sec_trace_event_t *event = &thread->events[j];
+
+            // Fields are byte aligned, as declared in the metadata
+            written += fwrite(&event->type, sizeof(event->type), 1, out);
+            written += fwrite(&event->timestamp, sizeof(event->timestamp), 1, out);
+            written += fwrite(&event->jr_id, sizeof(event->jr_id), 1, out);
+            written += fwrite(&event->arg, sizeof(event->arg), 1, out);
+        }
+
+        if (fclose(out) != 0 || written != 1 + 4 * (size_t)thread->header.events_no)
+        {
+            fprintf(stderr, "Failed to write %s\n", path);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*==================================================================================================
+                                     GLOBAL FUNCTIONS
+==================================================================================================*/
+int main(int argc, char *argv[])
+{
+    output_format_t format = FORMAT_CHROME;
+    const char *input = NULL;
+    const char *output = NULL;
+    trace_t trace;
+    int ret;
+    int c;
+
+    while ((c = getopt(argc, argv, "f:i:o:h")) != -1)
+    {
+        switch (c)
+        {
+            case 'f':
+                if (strcmp(optarg, "chrome") == 0)
+                {
+                    format = FORMAT_CHROME;
+                }
+                else if (strcmp(optarg, "ctf") == 0)
+                {
+                    format = FORMAT_CTF;
+                }
+                else
+                {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'i':
+                input = optarg;
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (input == NULL || output == NULL)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    memset(&trace, 0, sizeof(trace));
+    if (read_trace(input, &trace) != 0)
+    {
+        return 1;
+    }
+
+    ret = (format == FORMAT_CHROME) ? write_chrome(&trace, output) : write_ctf(&trace, output);
+
+    return (ret == 0) ? 0 : 1;
+}